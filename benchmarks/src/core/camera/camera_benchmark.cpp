@@ -0,0 +1,69 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <benchmark/benchmark.h>
+#include "core/camera/perspectivecamera.h"
+
+static void BM_GenerateRayPerPixel(benchmark::State& state)
+{
+    PerspectiveCamera camera;
+    camera.SetTransform(Transform::GetTranslationMatrix({ 1, 2, 3 }) * Transform::GetRotationMatrix({ 0.1, 0.2, 0.3 }));
+    camera.GetFilm().SetTileSize(32);
+    const FilmTile& tile = camera.GetFilm().GetTile(0);
+    RayBatch rays;
+    rays.Resize((size_t)tile.GetSize().x * tile.GetSize().y);
+
+    for (auto _ : state)
+    {
+        for (int y = 0, i = 0; y < tile.GetSize().y; ++y)
+        {
+            for (int x = 0; x < tile.GetSize().x; ++x, ++i)
+            {
+                const Point2i pixel = tile.TileToFilmSpace({ x, y });
+                rays.SetRay(i, camera.GenerateRay(pixel, Camera::GetCameraSample(pixel, 0)));
+            }
+        }
+
+        benchmark::DoNotOptimize(rays.m_DirectionZ.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * rays.GetSize());
+}
+
+static void BM_GenerateRaysPerTile(benchmark::State& state)
+{
+    PerspectiveCamera camera;
+    camera.SetTransform(Transform::GetTranslationMatrix({ 1, 2, 3 }) * Transform::GetRotationMatrix({ 0.1, 0.2, 0.3 }));
+    camera.GetFilm().SetTileSize(32);
+    const FilmTile& tile = camera.GetFilm().GetTile(0);
+    RayBatch rays;
+
+    for (auto _ : state)
+    {
+        camera.GenerateRays(tile, 0, rays);
+        benchmark::DoNotOptimize(rays.m_DirectionZ.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * rays.GetSize());
+}
+
+BENCHMARK(BM_GenerateRayPerPixel);
+BENCHMARK(BM_GenerateRaysPerTile);
+
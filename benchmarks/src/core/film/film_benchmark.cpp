@@ -0,0 +1,83 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include "core/film/film.h"
+#include "core/film/standardresolution.h"
+
+constexpr int NumPositions = 4096;
+
+static std::vector<Point2i> GeneratePixelPositions(const Resolution& resolution)
+{
+    std::mt19937 rng(0);
+    std::uniform_int_distribution<int> distX(0, resolution.GetWidth() - 1);
+    std::uniform_int_distribution<int> distY(0, resolution.GetHeight() - 1);
+    std::vector<Point2i> positions(NumPositions);
+
+    for (Point2i& p : positions)
+        p = Point2i(distX(rng), distY(rng));
+
+    return positions;
+}
+
+static void BM_FilmGetTile(benchmark::State& state)
+{
+    Film film;
+    film.SetResolution(Resolution1920X1080());
+    std::vector<Point2i> positions = GeneratePixelPositions(film.GetResolution());
+    int i = 0;
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(&film.GetTile(positions[i++ % NumPositions]));
+}
+
+static void BM_FilmGetTileUnchecked(benchmark::State& state)
+{
+    Film film;
+    film.SetResolution(Resolution1920X1080());
+    std::vector<Point2i> positions = GeneratePixelPositions(film.GetResolution());
+    int i = 0;
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(&film.GetTileUnchecked(positions[i++ % NumPositions]));
+}
+
+static void BM_FilmAddSample(benchmark::State& state)
+{
+    Film film;
+    film.SetResolution(Resolution1920X1080());
+    std::vector<Point2i> positions = GeneratePixelPositions(film.GetResolution());
+    const XyzCoefficients xyz(0.2, 0.3, 0.4);
+    int i = 0;
+
+    for (auto _ : state)
+    {
+        const Point2i& p = positions[i++ % NumPositions];
+        film.AddSample(Point2(p.x + 0.5, p.y + 0.5), xyz);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_FilmGetTile);
+BENCHMARK(BM_FilmGetTileUnchecked);
+BENCHMARK(BM_FilmAddSample);
+
@@ -0,0 +1,107 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include "core/film/filmtile.h"
+#include "core/film/filter/boxfilter.h"
+#include "core/film/filter/gaussianfilter.h"
+
+constexpr int TileSize = 64;
+constexpr int NumPositions = 4096;
+
+static std::vector<Point2> GenerateSamplePositions()
+{
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<double> dist(0.0, TileSize);
+    std::vector<Point2> positions(NumPositions);
+
+    for (Point2& p : positions)
+        p = Point2(dist(rng), dist(rng));
+
+    return positions;
+}
+
+static void BM_FilmTileSplatPixel(benchmark::State& state)
+{
+    FilmTile tile({ 0, 0 }, { TileSize, TileSize });
+    std::vector<Point2> positions = GenerateSamplePositions();
+    const XyzCoefficients xyz(0.2, 0.3, 0.4);
+    int i = 0;
+
+    for (auto _ : state)
+    {
+        // Keep total coverage below one so the checked path never throws
+        const Point2& p = positions[i++ % NumPositions];
+        tile.SplatPixel({ (int)p.x, (int)p.y }, xyz, 1e-9);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_FilmTileSplatPixelUnchecked(benchmark::State& state)
+{
+    FilmTile tile({ 0, 0 }, { TileSize, TileSize });
+    std::vector<Point2> positions = GenerateSamplePositions();
+    const XyzCoefficients xyz(0.2, 0.3, 0.4);
+    int i = 0;
+
+    for (auto _ : state)
+    {
+        const Point2& p = positions[i++ % NumPositions];
+        tile.SplatPixelUnchecked({ (int)p.x, (int)p.y }, xyz, 1e-9);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_FilmTileAddSampleBox(benchmark::State& state)
+{
+    FilterTable filter(BoxFilter{});
+    FilmTile tile({ 0, 0 }, { TileSize, TileSize }, filter.GetApron());
+    std::vector<Point2> positions = GenerateSamplePositions();
+    const XyzCoefficients xyz(0.2, 0.3, 0.4);
+    int i = 0;
+
+    for (auto _ : state)
+        tile.AddSample(positions[i++ % NumPositions], xyz, filter);
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_FilmTileAddSampleGaussian(benchmark::State& state)
+{
+    FilterTable filter(GaussianFilter{});
+    FilmTile tile({ 0, 0 }, { TileSize, TileSize }, filter.GetApron());
+    std::vector<Point2> positions = GenerateSamplePositions();
+    const XyzCoefficients xyz(0.2, 0.3, 0.4);
+    int i = 0;
+
+    for (auto _ : state)
+        tile.AddSample(positions[i++ % NumPositions], xyz, filter);
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_FilmTileSplatPixel);
+BENCHMARK(BM_FilmTileSplatPixelUnchecked);
+BENCHMARK(BM_FilmTileAddSampleBox);
+BENCHMARK(BM_FilmTileAddSampleGaussian);
+
@@ -0,0 +1,128 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <benchmark/benchmark.h>
+#include <thread>
+#include "core/camera/perspectivecamera.h"
+#include "core/geometry/trianglemesh.h"
+#include "system/threading/threadpool.h"
+
+constexpr int TextureSize = 2048;
+constexpr int GridSize = 4;
+
+// Reference scene of a textured, tessellated ground plane. The texture is far larger than
+// the caches, so the cost of a frame depends on how coherently tiles in flight sample it.
+class ReferenceScene
+{
+public:
+    ReferenceScene()
+        : m_Texture(TextureSize * TextureSize)
+    {
+        std::vector<TriangleMesh::Vertex> vertices;
+        std::vector<TrianglePrimitive> faces;
+
+        for (int z = 0; z <= GridSize; ++z)
+            for (int x = 0; x <= GridSize; ++x)
+                vertices.push_back({ .m_Position = { -40.0 + 80.0 * x / GridSize, -1.0, 1.0 + 80.0 * z / GridSize }, .m_Normal = { 0, 1, 0 }, .m_Tangent = {}, .m_Bitangent = {}, .m_TexCoord = {} });
+
+        // Faces compute their bounds from the mesh, so vertices have to be set first
+        m_Mesh.SetVertices(vertices.data(), (uint32_t)vertices.size());
+
+        for (int z = 0; z < GridSize; ++z)
+        {
+            for (int x = 0; x < GridSize; ++x)
+            {
+                uint32_t v0 = x + z * (GridSize + 1);
+                faces.push_back(TrianglePrimitive(&m_Mesh, v0, v0 + 1, v0 + GridSize + 2));
+                faces.push_back(TrianglePrimitive(&m_Mesh, v0, v0 + GridSize + 2, v0 + GridSize + 1));
+            }
+        }
+
+        m_Mesh.SetFaces(faces.data(), (uint32_t)faces.size());
+
+        for (int i = 0; i < TextureSize * TextureSize; ++i)
+            m_Texture[i] = (float)((i * 2654435761u) >> 8 & 0xff) / 255.0f;
+    }
+
+    double Shade(const Ray& ray) const
+    {
+        double tHit;
+        SurfaceInteraction surface;
+
+        for (const TrianglePrimitive& face : m_Mesh.GetFaces())
+        {
+            if (!face.Intersect(ray, &tHit, &surface))
+                continue;
+
+            int u = std::clamp((int)((surface.m_Point.x + 40.0) / 80.0 * TextureSize), 0, TextureSize - 1);
+            int v = std::clamp((int)((surface.m_Point.z - 1.0) / 80.0 * TextureSize), 0, TextureSize - 1);
+            return m_Texture[u + v * TextureSize];
+        }
+
+        return 0.0;
+    }
+
+private:
+    TriangleMesh m_Mesh;
+    std::vector<float> m_Texture;
+};
+
+static void BM_RenderReferenceScene(benchmark::State& state)
+{
+    const TileOrder order = (TileOrder)state.range(0);
+    const int numThreads = std::max(1u, std::thread::hardware_concurrency());
+    const ReferenceScene scene;
+
+    PerspectiveCamera camera(90);
+    Film& film = camera.GetFilm();
+    film.SetTileSize(32);
+    film.SetTileOrder(order);
+
+    std::atomic<double> checksum = 0.0;
+
+    for (auto _ : state)
+    {
+        ThreadPool pool(numThreads);
+        const std::vector<int>& schedule = film.GetTileSchedule();
+
+        for (int i = 0; i < (int)schedule.size(); ++i)
+        {
+            // Earlier tiles in the schedule get a higher priority
+            pool.ScheduleTask(schedule.size() - i, [&](int tileIndex)
+            {
+                FilmTile& tile = film.GetTile(tileIndex);
+                double sum = 0.0;
+
+                for (int y = 0; y < tile.GetSize().y; ++y)
+                    for (int x = 0; x < tile.GetSize().x; ++x)
+                        sum += scene.Shade(camera.GenerateRay(tile.TileToFilmSpace({ x, y })));
+
+                checksum += sum;
+            }, schedule[i]);
+        }
+    }
+
+    benchmark::DoNotOptimize(checksum.load());
+    state.SetItemsProcessed(state.iterations() * film.GetNumPixels());
+    state.SetLabel(order == TileOrder::Scanline ? "Scanline" : order == TileOrder::Spiral ? "Spiral" : order == TileOrder::Hilbert ? "Hilbert" : "Morton");
+}
+
+BENCHMARK(BM_RenderReferenceScene)->DenseRange(0, 3)->Unit(benchmark::kMillisecond)->UseRealTime();
+
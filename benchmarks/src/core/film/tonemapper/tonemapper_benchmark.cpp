@@ -0,0 +1,88 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <benchmark/benchmark.h>
+#include "core/film/tonemapper/uncharted2filmictonemapper.h"
+#include "core/film/tonemapper/luttonemapper.h"
+
+constexpr int ScanlineWidth = 3840;
+
+static std::vector<RgbCoefficients> GenerateScanline()
+{
+    std::vector<RgbCoefficients> colors(ScanlineWidth);
+
+    for (int i = 0; i < ScanlineWidth; ++i)
+        colors[i] = RgbCoefficients(i * 0.003, i * 0.001, i * 0.0005);
+
+    return colors;
+}
+
+static void BM_Uncharted2TonemapPerColor(benchmark::State& state)
+{
+    Uncharted2FilmicTonemapper tonemapper;
+    std::vector<RgbCoefficients> colors = GenerateScanline();
+    std::vector<RgbCoefficients> tonemapped(ScanlineWidth);
+
+    for (auto _ : state)
+    {
+        for (int i = 0; i < ScanlineWidth; ++i)
+            tonemapped[i] = tonemapper.ApplyTonemap(colors[i]);
+
+        benchmark::DoNotOptimize(tonemapped.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * ScanlineWidth);
+}
+
+static void BM_Uncharted2TonemapBatch(benchmark::State& state)
+{
+    Uncharted2FilmicTonemapper tonemapper;
+    std::vector<RgbCoefficients> colors = GenerateScanline();
+    std::vector<RgbCoefficients> tonemapped(ScanlineWidth);
+
+    for (auto _ : state)
+    {
+        tonemapper.ApplyTonemap(colors, tonemapped);
+        benchmark::DoNotOptimize(tonemapped.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * ScanlineWidth);
+}
+
+static void BM_LutTonemapBatch(benchmark::State& state)
+{
+    Uncharted2FilmicTonemapper tonemapper;
+    LutTonemapper lut(tonemapper);
+    std::vector<RgbCoefficients> colors = GenerateScanline();
+    std::vector<RgbCoefficients> tonemapped(ScanlineWidth);
+
+    for (auto _ : state)
+    {
+        lut.ApplyTonemap(colors, tonemapped);
+        benchmark::DoNotOptimize(tonemapped.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * ScanlineWidth);
+}
+
+BENCHMARK(BM_Uncharted2TonemapPerColor);
+BENCHMARK(BM_Uncharted2TonemapBatch);
+BENCHMARK(BM_LutTonemapBatch);
+
@@ -0,0 +1,87 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include "core/geometry/trianglemesh.h"
+
+constexpr int NumRays = 4096;
+
+static void CreateTriangle(TriangleMesh& mesh)
+{
+    TriangleMesh::Vertex vertices[3];
+    vertices[0] = { .m_Position = { -1, -1, 5 }, .m_Normal = { 0, 0, -1 }, .m_Tangent = {}, .m_Bitangent = {}, .m_TexCoord = {} };
+    vertices[1] = { .m_Position = { 1, -1, 5 }, .m_Normal = { 0, 0, -1 }, .m_Tangent = {}, .m_Bitangent = {}, .m_TexCoord = {} };
+    vertices[2] = { .m_Position = { 0, 1, 5 }, .m_Normal = { 0, 0, -1 }, .m_Tangent = {}, .m_Bitangent = {}, .m_TexCoord = {} };
+    mesh.SetVertices(vertices, 3);
+
+    TrianglePrimitive face(&mesh, 0, 1, 2);
+    mesh.SetFaces(&face, 1);
+}
+
+// Rays from the origin through a square around the triangle, about half of them hit
+static std::vector<Ray> GenerateRays()
+{
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    std::vector<Ray> rays;
+
+    for (int i = 0; i < NumRays; ++i)
+        rays.emplace_back(Point3(0, 0, 0), Vector3(dist(rng) * 0.2, dist(rng) * 0.2, 1.0));
+
+    return rays;
+}
+
+static void BM_TrianglePrimitiveIntersectOcclusion(benchmark::State& state)
+{
+    TriangleMesh mesh;
+    CreateTriangle(mesh);
+    const TrianglePrimitive& face = mesh.GetFaces()[0];
+    const std::vector<Ray> rays = GenerateRays();
+    int i = 0;
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(face.Intersect(rays[i++ % NumRays]));
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_TrianglePrimitiveIntersectClosest(benchmark::State& state)
+{
+    TriangleMesh mesh;
+    CreateTriangle(mesh);
+    const TrianglePrimitive& face = mesh.GetFaces()[0];
+    const std::vector<Ray> rays = GenerateRays();
+    SurfaceInteraction surface;
+    double tHit;
+    int i = 0;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(face.Intersect(rays[i++ % NumRays], &tHit, &surface));
+        benchmark::DoNotOptimize(tHit);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_TrianglePrimitiveIntersectOcclusion);
+BENCHMARK(BM_TrianglePrimitiveIntersectClosest);
+
@@ -0,0 +1,165 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <benchmark/benchmark.h>
+#include <thread>
+#include "core/renderer/renderer.h"
+#include "core/integrator/ambientocclusionintegrator.h"
+#include "core/integrator/wavefrontintegrator.h"
+#include "core/spatial/linearaccelerator.h"
+#include "core/geometry/trianglemesh.h"
+#include "core/camera/perspectivecamera.h"
+#include "core/sampling/independentsampler.h"
+
+static void CreateQuad(TriangleMesh& mesh, const Point3& center, double halfSize)
+{
+    TriangleMesh::Vertex vertices[4];
+    vertices[0] = { .m_Position = center + Vector3(-halfSize, -halfSize, 0), .m_Normal = { 0, 0, -1 }, .m_Tangent = {}, .m_Bitangent = {}, .m_TexCoord = {} };
+    vertices[1] = { .m_Position = center + Vector3(halfSize, -halfSize, 0), .m_Normal = { 0, 0, -1 }, .m_Tangent = {}, .m_Bitangent = {}, .m_TexCoord = {} };
+    vertices[2] = { .m_Position = center + Vector3(halfSize, halfSize, 0), .m_Normal = { 0, 0, -1 }, .m_Tangent = {}, .m_Bitangent = {}, .m_TexCoord = {} };
+    vertices[3] = { .m_Position = center + Vector3(-halfSize, halfSize, 0), .m_Normal = { 0, 0, -1 }, .m_Tangent = {}, .m_Bitangent = {}, .m_TexCoord = {} };
+    mesh.SetVertices(vertices, 4);
+
+    TrianglePrimitive faces[2] = { { &mesh, 0, 1, 2 }, { &mesh, 0, 2, 3 } };
+    mesh.SetFaces(faces, 2);
+}
+
+// Traces the same paths as the wavefront integrator one sample at a time, for comparison
+class PathAtATimeIntegrator : public WavefrontIntegrator
+{
+public:
+    using WavefrontIntegrator::WavefrontIntegrator;
+
+    void IntegrateTile(Camera& camera, FilmTile& tile, Sampler& sampler, int firstSample, int numSamples, uint64_t& numRays) const override
+    {
+        Integrator::IntegrateTile(camera, tile, sampler, firstSample, numSamples, numRays);
+    }
+};
+
+static void BuildOccludedWall(std::span<TriangleMesh, 5> meshes, LinearAccelerator& scene)
+{
+    // A wall with a few smaller quads in front of it that occlude parts of it
+    CreateQuad(meshes[0], { 0, 0, 6 }, 10.0);
+    CreateQuad(meshes[1], { -1, -1, 5 }, 0.5);
+    CreateQuad(meshes[2], { 1, -1, 5.5 }, 0.75);
+    CreateQuad(meshes[3], { -1, 1, 4.5 }, 0.5);
+    CreateQuad(meshes[4], { 1, 1, 5.8 }, 0.25);
+
+    std::vector<const Geometry*> geometries;
+    for (const TriangleMesh& mesh : meshes)
+        geometries.push_back(&mesh);
+
+    scene.Build(geometries);
+}
+
+static RenderStatistics RenderOnce(const Integrator& integrator, const Sampler& sampler, int numThreads, double maxError = 0.0)
+{
+    Resolution resolution;
+    resolution.SetWidth(160);
+    resolution.SetHeight(90);
+
+    PerspectiveCamera camera(60);
+    camera.GetFilm().SetResolution(resolution);
+    camera.GetFilm().SetTileSize(16);
+
+    Renderer renderer(camera, integrator, sampler);
+    renderer.SetNumThreads(numThreads);
+
+    if (maxError > 0.0)
+        renderer.SetAdaptiveSampling(maxError, 8);
+
+    return renderer.Render();
+}
+
+static void RenderScene(benchmark::State& state, const Integrator& integrator, const Sampler& sampler, int numThreads)
+{
+    uint64_t numRays = 0;
+    double seconds = 0.0;
+
+    for (auto _ : state)
+    {
+        const RenderStatistics statistics = RenderOnce(integrator, sampler, numThreads);
+        numRays += statistics.m_NumRays;
+        seconds += statistics.m_Seconds;
+    }
+
+    state.counters["Mrays/s"] = numRays / seconds * 1e-6;
+}
+
+static void BM_RenderAmbientOcclusion(benchmark::State& state)
+{
+    TriangleMesh meshes[5];
+    LinearAccelerator scene;
+    BuildOccludedWall(meshes, scene);
+
+    AmbientOcclusionIntegrator integrator(scene, 1.0, 4);
+    IndependentSampler sampler(1);
+    RenderScene(state, integrator, sampler, (int)state.range(0));
+}
+
+template <typename PathIntegrator>
+static void BM_RenderPaths(benchmark::State& state)
+{
+    TriangleMesh meshes[5];
+    LinearAccelerator scene;
+    BuildOccludedWall(meshes, scene);
+
+    PathIntegrator integrator(scene);
+    integrator.SetAlbedo(0.8);
+    integrator.SetSun({ 0.3, 0.5, -1 }, XyzCoefficients(2.0));
+    IndependentSampler sampler(4);
+    RenderScene(state, integrator, sampler, (int)state.range(0));
+}
+
+// The unoccluded parts of the wall are lit exactly and converge after the first pass, the
+// soft shadows of the occluders keep taking samples
+static void BM_RenderAdaptive(benchmark::State& state)
+{
+    const int numThreads = (int)state.range(0);
+    TriangleMesh meshes[5];
+    LinearAccelerator scene;
+    BuildOccludedWall(meshes, scene);
+
+    WavefrontIntegrator integrator(scene);
+    integrator.SetSun({ 0.3, 0.5, -1 }, XyzCoefficients(2.0));
+    IndependentSampler sampler(64);
+
+    const double uniformSeconds = RenderOnce(integrator, sampler, numThreads).m_Seconds;
+    RenderStatistics statistics;
+    double seconds = 0.0;
+
+    for (auto _ : state)
+    {
+        statistics = RenderOnce(integrator, sampler, numThreads, 0.05);
+        seconds += statistics.m_Seconds;
+    }
+
+    const auto [minSamples, maxSamples] = std::minmax_element(statistics.m_TileSamplesPerPixel.begin(), statistics.m_TileSamplesPerPixel.end());
+    state.counters["min spp"] = *minSamples;
+    state.counters["max spp"] = *maxSamples;
+    state.counters["avg spp"] = (double)statistics.m_NumCameraRays / (160 * 90);
+    state.counters["saved %"] = 100.0 * (1.0 - seconds / state.iterations() / uniformSeconds);
+}
+
+BENCHMARK(BM_RenderAmbientOcclusion)->RangeMultiplier(2)->Range(1, std::max(1u, std::thread::hardware_concurrency()))->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_RenderPaths<PathAtATimeIntegrator>)->RangeMultiplier(2)->Range(1, std::max(1u, std::thread::hardware_concurrency()))->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_RenderPaths<WavefrontIntegrator>)->RangeMultiplier(2)->Range(1, std::max(1u, std::thread::hardware_concurrency()))->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_RenderAdaptive)->RangeMultiplier(2)->Range(1, std::max(1u, std::thread::hardware_concurrency()))->Unit(benchmark::kMillisecond)->UseRealTime();
+
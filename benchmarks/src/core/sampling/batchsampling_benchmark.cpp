@@ -0,0 +1,108 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <benchmark/benchmark.h>
+#include "core/sampling/sampling.h"
+#include "core/sampling/batchsampling.h"
+
+constexpr int BatchSize = 4096;
+
+static void GenerateInputs(std::vector<double>& u0, std::vector<double>& u1)
+{
+    Rng rng;
+    u0.resize(BatchSize);
+    u1.resize(BatchSize);
+
+    for (int i = 0; i < BatchSize; ++i)
+    {
+        u0[i] = rng.UniformDouble();
+        u1[i] = rng.UniformDouble();
+    }
+}
+
+static void BM_CosineSampleHemisphereScalar(benchmark::State& state)
+{
+    std::vector<double> u0, u1;
+    GenerateInputs(u0, u1);
+    std::vector<Point3> directions(BatchSize);
+
+    for (auto _ : state)
+    {
+        for (int i = 0; i < BatchSize; ++i)
+            directions[i] = Sampling::CosineSampleHemisphere({ u0[i], u1[i] });
+
+        benchmark::DoNotOptimize(directions.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * BatchSize);
+}
+
+static void BM_CosineSampleHemisphereBatch(benchmark::State& state)
+{
+    std::vector<double> u0, u1;
+    GenerateInputs(u0, u1);
+    std::vector<double> x(BatchSize), y(BatchSize), z(BatchSize);
+
+    for (auto _ : state)
+    {
+        BatchSampling::CosineSampleHemisphere(u0, u1, x, y, z);
+        benchmark::DoNotOptimize(z.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * BatchSize);
+}
+
+static void BM_UniformSampleSphereScalar(benchmark::State& state)
+{
+    std::vector<double> u0, u1;
+    GenerateInputs(u0, u1);
+    std::vector<Point3> directions(BatchSize);
+
+    for (auto _ : state)
+    {
+        for (int i = 0; i < BatchSize; ++i)
+            directions[i] = Sampling::UniformSampleSphere({ u0[i], u1[i] });
+
+        benchmark::DoNotOptimize(directions.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * BatchSize);
+}
+
+static void BM_UniformSampleSphereBatch(benchmark::State& state)
+{
+    std::vector<double> u0, u1;
+    GenerateInputs(u0, u1);
+    std::vector<double> x(BatchSize), y(BatchSize), z(BatchSize);
+
+    for (auto _ : state)
+    {
+        BatchSampling::UniformSampleSphere(u0, u1, x, y, z);
+        benchmark::DoNotOptimize(z.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * BatchSize);
+}
+
+BENCHMARK(BM_CosineSampleHemisphereScalar);
+BENCHMARK(BM_CosineSampleHemisphereBatch);
+BENCHMARK(BM_UniformSampleSphereScalar);
+BENCHMARK(BM_UniformSampleSphereBatch);
+
@@ -0,0 +1,134 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <benchmark/benchmark.h>
+#include "core/sampling/sampling.h"
+#include "core/sampling/independentsampler.h"
+#include "core/sampling/stratifiedsampler.h"
+#include "core/sampling/haltonsampler.h"
+#include "core/sampling/sobolsampler.h"
+
+// Convergence of each sampler on canonical integrands. Every run estimates the integral for a
+// set of pixels and reports the RMSE over them, so lower values at the same sample count mean
+// fewer samples are needed for the same image quality.
+constexpr int NumPixels = 256;
+
+enum Integrand
+{
+    // Indicator of the unit disk over [0, 1)^2, a discontinuous integrand like geometric edges
+    QuarterDisk,
+    // Smooth integrand, exp(-x^2 - y^2) over [0, 1)^2
+    Gaussian,
+    // Irradiance from a uniform sky, cos theta over the hemisphere estimated by uniform directions
+    Irradiance
+};
+
+static double GetReference(Integrand integrand)
+{
+    switch (integrand)
+    {
+    case QuarterDisk:
+        return SMath::Pi / 4.0;
+    case Gaussian:
+        return std::pow(std::sqrt(SMath::Pi) / 2.0 * std::erf(1.0), 2.0);
+    default:
+        return SMath::Pi;
+    }
+}
+
+static double Evaluate(Integrand integrand, const Point2& u)
+{
+    switch (integrand)
+    {
+    case QuarterDisk:
+        return u.x * u.x + u.y * u.y < 1.0 ? 1.0 : 0.0;
+    case Gaussian:
+        return std::exp(-u.x * u.x - u.y * u.y);
+    default:
+        return Sampling::UniformSampleHemisphere(u).y / Sampling::UniformHemispherePdf();
+    }
+}
+
+static void RunConvergence(benchmark::State& state, Sampler& sampler)
+{
+    const Integrand integrand = (Integrand)state.range(1);
+    const int samplesPerPixel = sampler.GetSamplesPerPixel();
+    const double reference = GetReference(integrand);
+    double rmse = 0.0;
+
+    for (auto _ : state)
+    {
+        double squaredError = 0.0;
+
+        for (int pixel = 0; pixel < NumPixels; ++pixel)
+        {
+            double estimate = 0.0;
+
+            for (int i = 0; i < samplesPerPixel; ++i)
+            {
+                sampler.StartPixelSample({ pixel % 16, pixel / 16 }, i);
+                estimate += Evaluate(integrand, sampler.Get2D());
+            }
+
+            const double error = estimate / samplesPerPixel - reference;
+            squaredError += error * error;
+        }
+
+        rmse = std::sqrt(squaredError / NumPixels);
+        benchmark::DoNotOptimize(rmse);
+    }
+
+    state.counters["RMSE"] = rmse;
+    state.SetItemsProcessed(state.iterations() * NumPixels * samplesPerPixel);
+}
+
+static void BM_IndependentSampler(benchmark::State& state)
+{
+    IndependentSampler sampler((int)state.range(0));
+    RunConvergence(state, sampler);
+}
+
+static void BM_StratifiedSampler(benchmark::State& state)
+{
+    const int samplesPerAxis = (int)std::lround(std::sqrt((double)state.range(0)));
+    StratifiedSampler sampler(samplesPerAxis, samplesPerAxis);
+    RunConvergence(state, sampler);
+}
+
+static void BM_HaltonSampler(benchmark::State& state)
+{
+    HaltonSampler sampler((int)state.range(0));
+    RunConvergence(state, sampler);
+}
+
+static void BM_SobolSampler(benchmark::State& state)
+{
+    SobolSampler sampler((int)state.range(0));
+    RunConvergence(state, sampler);
+}
+
+// Sample counts are squares of powers of two so that every sampler can take them
+#define SAMPLER_CONVERGENCE_ARGS ArgsProduct({ { 4, 16, 64, 256, 1024 }, { QuarterDisk, Gaussian, Irradiance } })->ArgNames({ "spp", "integrand" })
+
+BENCHMARK(BM_IndependentSampler)->SAMPLER_CONVERGENCE_ARGS;
+BENCHMARK(BM_StratifiedSampler)->SAMPLER_CONVERGENCE_ARGS;
+BENCHMARK(BM_HaltonSampler)->SAMPLER_CONVERGENCE_ARGS;
+BENCHMARK(BM_SobolSampler)->SAMPLER_CONVERGENCE_ARGS;
+
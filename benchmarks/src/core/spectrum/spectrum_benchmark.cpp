@@ -0,0 +1,120 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include "core/spectrum/reflectantspectrum.h"
+
+constexpr int NumColors = 256;
+
+static std::vector<RgbCoefficients> GenerateColors()
+{
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    std::vector<RgbCoefficients> colors(NumColors);
+
+    // Random channels cover every ordering, which ReflectantSpectrum branches on
+    for (RgbCoefficients& rgb : colors)
+        rgb = RgbCoefficients(dist(rng), dist(rng), dist(rng));
+
+    return colors;
+}
+
+static void BM_SpectrumAdd(benchmark::State& state)
+{
+    Spectrum a(0.25), b(0.5);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(a.m_Coefficients);
+        Spectrum s = a + b;
+        benchmark::DoNotOptimize(s.m_Coefficients);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_SpectrumMultiply(benchmark::State& state)
+{
+    // Products are not fed back, repeated products would decay into denormals
+    Spectrum a(0.5), b(0.75);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(a.m_Coefficients);
+        Spectrum s = a * b;
+        benchmark::DoNotOptimize(s.m_Coefficients);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_SpectrumLerp(benchmark::State& state)
+{
+    const Spectrum a(0.25), b(0.75);
+    double t = 0.0;
+
+    for (auto _ : state)
+    {
+        Spectrum s = Spectrum::Lerp(a, b, t);
+        benchmark::DoNotOptimize(s.m_Coefficients);
+        t = t < 1.0 ? t + 1e-3 : 0.0;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_SampledSpectrumToXyz(benchmark::State& state)
+{
+    std::vector<SampledSpectrum> spectra;
+    for (const RgbCoefficients& rgb : GenerateColors())
+        spectra.push_back(ReflectantSpectrum(rgb));
+
+    int i = 0;
+
+    for (auto _ : state)
+    {
+        XyzCoefficients xyz = spectra[i++ % NumColors].ToXyz();
+        benchmark::DoNotOptimize(xyz);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_ReflectantSpectrumFromRgb(benchmark::State& state)
+{
+    const std::vector<RgbCoefficients> colors = GenerateColors();
+    int i = 0;
+
+    for (auto _ : state)
+    {
+        ReflectantSpectrum spectrum(colors[i++ % NumColors]);
+        benchmark::DoNotOptimize(spectrum.m_Coefficients);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_SpectrumAdd);
+BENCHMARK(BM_SpectrumMultiply);
+BENCHMARK(BM_SpectrumLerp);
+BENCHMARK(BM_SampledSpectrumToXyz);
+BENCHMARK(BM_ReflectantSpectrumFromRgb);
+
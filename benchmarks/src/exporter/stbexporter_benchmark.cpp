@@ -0,0 +1,52 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include "exporter/stbexporter.h"
+
+static void BM_StbExporterExport(benchmark::State& state)
+{
+    Resolution resolution;
+    resolution.SetWidth(1280);
+    resolution.SetHeight(720);
+
+    Film film;
+    film.SetResolution(resolution);
+    film.SetTileSize(32);
+
+    for (int y = 0; y < 720; ++y)
+        for (int x = 0; x < 1280; ++x)
+            film.GetTile({ x, y }).SplatPixel(film.GetTile({ x, y }).FilmToTileSpace({ x, y }), { x / 1280.0, y / 720.0, 0.3 }, 0.5);
+
+    StbExporter exporter;
+    exporter.SetOutputName("StbExporterBenchmark");
+    exporter.SetNumThreads((int)state.range(0));
+
+    // Includes PNG compression and writing the file
+    for (auto _ : state)
+        exporter.Export(film);
+
+    state.SetItemsProcessed(state.iterations() * film.GetNumPixels());
+    std::remove("StbExporterBenchmark.png");
+}
+
+BENCHMARK(BM_StbExporterExport)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
+
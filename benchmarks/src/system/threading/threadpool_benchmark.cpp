@@ -0,0 +1,47 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <benchmark/benchmark.h>
+#include <thread>
+#include "system/threading/threadpool.h"
+
+constexpr int NumTasks = 4096;
+
+// Tasks do next to no work, so this measures the cost of scheduling and running them, including
+// starting and joining the pool's threads
+static void BM_ThreadPoolScheduleTasks(benchmark::State& state)
+{
+    const int numThreads = (int)state.range(0);
+    std::atomic<int> counter = 0;
+
+    for (auto _ : state)
+    {
+        ThreadPool pool(numThreads);
+
+        for (int i = 0; i < NumTasks; ++i)
+            pool.ScheduleTask((double)i, [&counter]() { ++counter; });
+    }
+
+    benchmark::DoNotOptimize(counter.load());
+    state.SetItemsProcessed(state.iterations() * NumTasks);
+}
+
+BENCHMARK(BM_ThreadPoolScheduleTasks)->RangeMultiplier(2)->Range(1, std::max(1u, std::thread::hardware_concurrency()))->UseRealTime();
+
@@ -19,6 +19,146 @@
 */
 
 #include "camera.h"
+#include "core/sampling/rng.h"
+#include "core/sampling/sampler.h"
+
+Camera::Camera()
+    : m_ShutterOpen(0.0)
+    , m_ShutterClose(1.0)
+{
+    UpdateCachedTransforms();
+}
+
+void Camera::SetTransform(const Matrix4x4& transform)
+{
+    m_Transform = transform;
+    UpdateCachedTransforms();
+}
+
+void Camera::SetShutter(double shutterOpen, double shutterClose)
+{
+    if (shutterClose < shutterOpen)
+        throw std::invalid_argument("Shutter cannot close before it opens");
+
+    m_ShutterOpen = shutterOpen;
+    m_ShutterClose = shutterClose;
+}
+
+Ray Camera::GenerateRay(const Point2i& filmSpacePos, const CameraSample& sample)
+{
+    return GenerateRay(filmSpacePos, sample.m_FilmOffset);
+}
+
+void Camera::GenerateRays(const FilmTile& tile, int sampleIndex, RayBatch& rays)
+{
+    CheckCachedTransforms();
+
+    const Vector2i size = tile.GetSize();
+    rays.Resize((size_t)size.x * size.y);
+
+    for (int y = 0, i = 0; y < size.y; ++y)
+    {
+        for (int x = 0; x < size.x; ++x, ++i)
+        {
+            const Point2i pixel = tile.TileToFilmSpace({ x, y });
+            SetCameraSample(rays, i, pixel, GetCameraSample(pixel, sampleIndex));
+        }
+    }
+
+    GenerateBatchRays(rays);
+}
+
+void Camera::GenerateRays(const FilmTile& tile, int sampleIndex, Sampler& sampler, RayBatch& rays)
+{
+    CheckCachedTransforms();
+
+    const Vector2i size = tile.GetSize();
+    rays.Resize((size_t)size.x * size.y);
+
+    for (int y = 0, i = 0; y < size.y; ++y)
+    {
+        for (int x = 0; x < size.x; ++x, ++i)
+        {
+            const Point2i pixel = tile.TileToFilmSpace({ x, y });
+            sampler.StartPixelSample(pixel, sampleIndex);
+            SetCameraSample(rays, i, pixel, GetCameraSample(sampler));
+        }
+    }
+
+    GenerateBatchRays(rays);
+}
+
+void Camera::UpdateCachedTransforms()
+{
+    m_CachedResolution = m_Film.GetResolution();
+    m_InverseTransform = m_Transform.Inversed();
+    m_RasterToWorld = m_Transform * GetRasterToCamera();
+
+    m_OriginWs = (m_Transform * Point4(0, 0, 0, 1)).Resize<3>();
+    m_ForwardWs = (m_Transform * Vector4(0, 0, 1, 0)).Resize<3>().Normalized();
+    m_RasterOriginWs = (m_RasterToWorld * Point4(0, 0, 0, 1)).Resize<3>();
+    m_RasterDxWs = (m_RasterToWorld * Vector4(1, 0, 0, 0)).Resize<3>();
+    m_RasterDyWs = (m_RasterToWorld * Vector4(0, 1, 0, 0)).Resize<3>();
+}
+
+CameraSample Camera::GetCameraSample(const Point2i& filmSpacePos, int sampleIndex)
+{
+    Rng rng;
+    rng.SetPixelSample(filmSpacePos, sampleIndex);
+
+    CameraSample sample;
+    const Point2 offset = rng.UniformPoint2();
+    sample.m_FilmOffset = { offset.x, offset.y };
+    sample.m_Lens = rng.UniformPoint2();
+    sample.m_Time = rng.UniformDouble();
+    return sample;
+}
+
+CameraSample Camera::GetCameraSample(Sampler& sampler)
+{
+    CameraSample sample;
+    const Point2 offset = sampler.GetPixel2D();
+    sample.m_FilmOffset = { offset.x, offset.y };
+    sample.m_Lens = sampler.Get2D();
+    sample.m_Time = sampler.Get1D();
+    return sample;
+}
+
+Matrix4x4 Camera::GetRasterToCamera() const
+{
+    const double halfFilmWidth = m_Film.GetResolution().GetWidth() / 2.0;
+    const double halfFilmHeight = m_Film.GetResolution().GetHeight() / 2.0;
+
+    return Matrix4x4(
+        1,  0, 0, -halfFilmWidth,
+        0, -1, 0, halfFilmHeight,
+        0,  0, 0, 1,
+        0,  0, 0, 1);
+}
+
+void Camera::GenerateBatchRays(RayBatch& rays)
+{
+    for (size_t i = 0; i < rays.GetSize(); ++i)
+    {
+        const Point2i pixel = rays.GetPixel(i);
+
+        CameraSample sample;
+        sample.m_FilmOffset = { rays.m_FilmX[i] - pixel.x, rays.m_FilmY[i] - pixel.y };
+        sample.m_Lens = rays.GetLensSample(i);
+        rays.SetRay(i, GenerateRay(pixel, sample));
+    }
+}
+
+void Camera::SetCameraSample(RayBatch& rays, size_t index, const Point2i& pixel, const CameraSample& sample) const
+{
+    rays.m_PixelX[index] = pixel.x;
+    rays.m_PixelY[index] = pixel.y;
+    rays.m_FilmX[index] = pixel.x + sample.m_FilmOffset.x;
+    rays.m_FilmY[index] = pixel.y + sample.m_FilmOffset.y;
+    rays.m_LensX[index] = sample.m_Lens.x;
+    rays.m_LensY[index] = sample.m_Lens.y;
+    rays.m_Time[index] = GetShutterTime(sample.m_Time);
+}
 
 Vector3 Camera::ToWorldSpace(const Vector3& cameraSpaceVector)
 {
@@ -34,7 +174,7 @@ Point3 Camera::ToWorldSpace(const Point3& cameraSpacePoint)
 
 Vector3 Camera::ToCameraSpace(const Vector3& worldSpaceVector)
 {
-    return (m_Transform.Inversed() * worldSpaceVector.Resize<4>()).Resize<3>();
+    return (m_InverseTransform * worldSpaceVector.Resize<4>()).Resize<3>();
 }
 
 Point3 Camera::ToCameraSpace(const Point3& worldSpacePoint)
@@ -42,7 +182,7 @@ Point3 Camera::ToCameraSpace(const Point3& worldSpacePoint)
     Point4 resizedPoint = worldSpacePoint.Resize<4>();
     resizedPoint.w = 1.0;
 
-    return (m_Transform.Inversed() * resizedPoint).Resize<3>();
+    return (m_InverseTransform * resizedPoint).Resize<3>();
 }
 
 Point3 Camera::ToCameraSpace(const Point2i& filmSpacePoint)
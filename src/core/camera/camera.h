@@ -21,19 +21,51 @@
 #pragma once
 
 #include "core/film/film.h"
+#include "raybatch.h"
+
+class Sampler;
 
 class Camera
 {
 public:
-    Camera() = default;
-    ~Camera() = default;
+    Camera();
+    virtual ~Camera() = default;
 
 public:
-    inline Matrix4x4& GetTransform() { return m_Transform; }
+    inline const Matrix4x4& GetTransform() const { return m_Transform; }
     inline Film& GetFilm() { return m_Film; }
+    inline double GetShutterOpen() const { return m_ShutterOpen; }
+    inline double GetShutterClose() const { return m_ShutterClose; }
+    void SetTransform(const Matrix4x4& transform);
+
+    // Rays are spread uniformly over the time the shutter is open, geometry animated over
+    // the same interval is blurred accordingly
+    void SetShutter(double shutterOpen, double shutterClose);
+    inline double GetShutterTime(double u) const { return m_ShutterOpen + (m_ShutterClose - m_ShutterOpen) * u; }
 
 public:
+    // Offsets are in film space pixels relative to the top left corner of the pixel. Cameras
+    // with a lens generate rays through the center of the lens.
     virtual Ray GenerateRay(const Point2i& filmSpacePos, const Vector2& offset) = 0;
+    virtual Ray GenerateRay(const Point2i& filmSpacePos, const CameraSample& sample);
+
+    // Generates the primary rays of every pixel in a tile, in row major order. The first variant
+    // draws samples from GetCameraSample, the second from the sampler in the order pixel,
+    // lens and time.
+    void GenerateRays(const FilmTile& tile, int sampleIndex, RayBatch& rays);
+    void GenerateRays(const FilmTile& tile, int sampleIndex, Sampler& sampler, RayBatch& rays);
+
+    // Transforms are cached whenever the camera changes. Ray generation only reads the cache, so
+    // changes to the film resolution must be followed by a call to this, or ray generation throws.
+    // The renderer does so before it starts its threads.
+    virtual void UpdateCachedTransforms();
+    inline bool HasValidCachedTransforms() const { return m_CachedResolution == m_Film.GetResolution(); }
+
+    // Stateless camera sample for a pixel, used when no sampler is given
+    static CameraSample GetCameraSample(const Point2i& filmSpacePos, int sampleIndex);
+
+    // Draws a camera sample from a sampler that has started a pixel sample
+    static CameraSample GetCameraSample(Sampler& sampler);
 
 protected:
     friend class CameraTest_CanTransformCameraPointToWorldSpace_Test;
@@ -49,8 +81,39 @@ protected:
     Point3 ToCameraSpace(const Point3& worldSpacePoint);
     Point3 ToCameraSpace(const Point2i& filmSpacePoint);
 
+    // Maps continuous film space positions on the z = 0 plane to camera space
+    virtual Matrix4x4 GetRasterToCamera() const;
+
+    // Fills in the origins and directions of a batch whose camera samples are set
+    virtual void GenerateBatchRays(RayBatch& rays);
+    void SetCameraSample(RayBatch& rays, size_t index, const Point2i& pixel, const CameraSample& sample) const;
+
+    // Ray generation only reads the cache, which goes stale when the film is resized
+    inline void CheckCachedTransforms() const
+    {
+        if (!HasValidCachedTransforms())
+            throw std::runtime_error("Camera transforms are stale, call UpdateCachedTransforms after resizing the film");
+    }
+
+    // World space position of a film space point on the film plane
+    inline Point3 GetRasterPointWs(double filmX, double filmY) const
+    {
+        return m_RasterOriginWs + m_RasterDxWs * filmX + m_RasterDyWs * filmY;
+    }
+
 protected:
     Matrix4x4 m_Transform;
     Film m_Film;
+    double m_ShutterOpen;
+    double m_ShutterClose;
+
+    Matrix4x4 m_InverseTransform;
+    Matrix4x4 m_RasterToWorld;
+    Resolution m_CachedResolution;
+    Point3 m_OriginWs;
+    Vector3 m_ForwardWs;
+    Point3 m_RasterOriginWs;
+    Vector3 m_RasterDxWs;
+    Vector3 m_RasterDyWs;
 };
 
@@ -23,19 +23,48 @@
 OrthographicCamera::OrthographicCamera(double size)
     : m_Size(size)
 {
+    UpdateCachedTransforms();
+}
+
+void OrthographicCamera::SetSize(double size)
+{
+    m_Size = size;
+    UpdateCachedTransforms();
 }
 
 Ray OrthographicCamera::GenerateRay(const Point2i& filmSpacePos, const Vector2& offset)
+{
+    CheckCachedTransforms();
+
+    const Point3 rayOriginWs = GetRasterPointWs(filmSpacePos.x + offset.x, filmSpacePos.y + offset.y);
+    return Ray(rayOriginWs, m_ForwardWs);
+}
+
+Matrix4x4 OrthographicCamera::GetRasterToCamera() const
 {
     // Add an empirical scale such that size=1 is consistent with perspective camera
     const double sizeScale = 0.005;
     const double scaledSize = m_Size * sizeScale;
-    Point3 cameraSpaceFilmPoint = ToCameraSpace(filmSpacePos);
-    cameraSpaceFilmPoint.x += offset.x;
-    cameraSpaceFilmPoint.y += offset.y;
+    const double halfFilmWidth = m_Film.GetResolution().GetWidth() / 2.0;
+    const double halfFilmHeight = m_Film.GetResolution().GetHeight() / 2.0;
 
-    Point3 rayOriginWs = ToWorldSpace(Point3(cameraSpaceFilmPoint.x * scaledSize, cameraSpaceFilmPoint.y * scaledSize, 0));
-    Vector3 rayDirectionWs = ToWorldSpace(Vector3(0, 0, 1));
-    return Ray(rayOriginWs, rayDirectionWs);
+    return Matrix4x4(
+        scaledSize, 0,           0, -halfFilmWidth * scaledSize,
+        0,          -scaledSize, 0, halfFilmHeight * scaledSize,
+        0,          0,           0, 0,
+        0,          0,           0, 1);
+}
+
+void OrthographicCamera::GenerateBatchRays(RayBatch& rays)
+{
+    for (size_t i = 0; i < rays.GetSize(); ++i)
+    {
+        rays.m_OriginX[i] = m_RasterOriginWs.x + m_RasterDxWs.x * rays.m_FilmX[i] + m_RasterDyWs.x * rays.m_FilmY[i];
+        rays.m_OriginY[i] = m_RasterOriginWs.y + m_RasterDxWs.y * rays.m_FilmX[i] + m_RasterDyWs.y * rays.m_FilmY[i];
+        rays.m_OriginZ[i] = m_RasterOriginWs.z + m_RasterDxWs.z * rays.m_FilmX[i] + m_RasterDyWs.z * rays.m_FilmY[i];
+        rays.m_DirectionX[i] = m_ForwardWs.x;
+        rays.m_DirectionY[i] = m_ForwardWs.y;
+        rays.m_DirectionZ[i] = m_ForwardWs.z;
+    }
 }
 
@@ -30,11 +30,16 @@ public:
 
 public:
     inline double GetSize() const { return m_Size; }
-    inline void SetSize(double size) { m_Size = size; }
+    void SetSize(double size);
 
 public:
+    using Camera::GenerateRay;
     Ray GenerateRay(const Point2i& filmSpacePos, const Vector2& offset = {}) override;
 
+protected:
+    Matrix4x4 GetRasterToCamera() const override;
+    void GenerateBatchRays(RayBatch& rays) override;
+
 protected:
     double m_Size;
 };
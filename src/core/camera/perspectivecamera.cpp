@@ -19,24 +19,129 @@
 */
 
 #include "perspectivecamera.h"
+#include "core/sampling/sampling.h"
+#include "core/sampling/batchsampling.h"
 
 PerspectiveCamera::PerspectiveCamera(double fovH)
     : m_HorizontalFov(fovH)
+    , m_ApertureRadius(0.0)
+    , m_FocusDistance(1.0)
 {
+    UpdateCachedTransforms();
+}
+
+void PerspectiveCamera::SetHorizontalFov(double fovH)
+{
+    m_HorizontalFov = fovH;
+    UpdateCachedTransforms();
+}
+
+void PerspectiveCamera::SetApertureRadius(double radius)
+{
+    if (radius < 0.0)
+        throw std::invalid_argument("Aperture radius cannot be negative");
+
+    m_ApertureRadius = radius;
+    UpdateCachedTransforms();
+}
+
+void PerspectiveCamera::SetFocusDistance(double distance)
+{
+    if (distance <= 0.0)
+        throw std::invalid_argument("Focus distance must be positive");
+
+    m_FocusDistance = distance;
+    UpdateCachedTransforms();
 }
 
 Ray PerspectiveCamera::GenerateRay(const Point2i& filmSpacePos, const Vector2& offset)
 {
-    double halfFovH = m_HorizontalFov / 2.0;
-    double filmZPlane = (m_Film.GetResolution().GetWidth() / 2.0) / std::tan(SMath::DegToRad(halfFovH));
+    CheckCachedTransforms();
+
+    const Point3 filmPointWs = GetRasterPointWs(filmSpacePos.x + offset.x, filmSpacePos.y + offset.y);
+    return Ray(m_OriginWs, filmPointWs - m_OriginWs);
+}
+
+Ray PerspectiveCamera::GenerateRay(const Point2i& filmSpacePos, const CameraSample& sample)
+{
+    if (m_ApertureRadius == 0.0)
+        return GenerateRay(filmSpacePos, sample.m_FilmOffset);
+
+    CheckCachedTransforms();
+
+    // The film point is in camera space units scaled by the film distance, so the point in
+    // focus lies along the pinhole ray at the ratio of focus to film distance
+    const Point3 filmPointWs = GetRasterPointWs(filmSpacePos.x + sample.m_FilmOffset.x, filmSpacePos.y + sample.m_FilmOffset.y);
+    const Point3 focusPointWs = m_OriginWs + (filmPointWs - m_OriginWs) * m_FocusScale;
+    const Point2 lens = Sampling::ConcentricSampleDisk(sample.m_Lens);
+    const Point3 lensPointWs = m_OriginWs + m_LensDxWs * lens.x + m_LensDyWs * lens.y;
+    return Ray(lensPointWs, focusPointWs - lensPointWs);
+}
+
+void PerspectiveCamera::UpdateCachedTransforms()
+{
+    Camera::UpdateCachedTransforms();
+
+    m_FocusScale = m_FocusDistance / GetFilmDistance();
+    m_LensDxWs = (m_Transform * Vector4(m_ApertureRadius, 0, 0, 0)).Resize<3>();
+    m_LensDyWs = (m_Transform * Vector4(0, m_ApertureRadius, 0, 0)).Resize<3>();
+}
+
+Matrix4x4 PerspectiveCamera::GetRasterToCamera() const
+{
+    const double halfFilmWidth = m_Film.GetResolution().GetWidth() / 2.0;
+    const double halfFilmHeight = m_Film.GetResolution().GetHeight() / 2.0;
+
+    return Matrix4x4(
+        1,  0, 0, -halfFilmWidth,
+        0, -1, 0, halfFilmHeight,
+        0,  0, 0, GetFilmDistance(),
+        0,  0, 0, 1);
+}
+
+double PerspectiveCamera::GetFilmDistance() const
+{
+    return (m_Film.GetResolution().GetWidth() / 2.0) / std::tan(SMath::DegToRad(m_HorizontalFov / 2.0));
+}
+
+void PerspectiveCamera::GenerateBatchRays(RayBatch& rays)
+{
+    const Vector3 directionBase = m_RasterOriginWs - m_OriginWs;
+    const bool hasLens = m_ApertureRadius > 0.0;
+
+    // Lens samples are warped in place, they are not needed once the rays are generated
+    if (hasLens)
+        BatchSampling::ConcentricSampleDisk(rays.m_LensX, rays.m_LensY, rays.m_LensX, rays.m_LensY);
+
+    for (size_t i = 0; i < rays.GetSize(); ++i)
+    {
+        double dx = directionBase.x + m_RasterDxWs.x * rays.m_FilmX[i] + m_RasterDyWs.x * rays.m_FilmY[i];
+        double dy = directionBase.y + m_RasterDxWs.y * rays.m_FilmX[i] + m_RasterDyWs.y * rays.m_FilmY[i];
+        double dz = directionBase.z + m_RasterDxWs.z * rays.m_FilmX[i] + m_RasterDyWs.z * rays.m_FilmY[i];
+        double ox = m_OriginWs.x;
+        double oy = m_OriginWs.y;
+        double oz = m_OriginWs.z;
 
-    Point3 cameraSpaceFilmPoint = ToCameraSpace(filmSpacePos);
-    cameraSpaceFilmPoint.x += offset.x;
-    cameraSpaceFilmPoint.y += offset.y;
-    cameraSpaceFilmPoint.z *= filmZPlane;
+        if (hasLens)
+        {
+            const double lensX = m_LensDxWs.x * rays.m_LensX[i] + m_LensDyWs.x * rays.m_LensY[i];
+            const double lensY = m_LensDxWs.y * rays.m_LensX[i] + m_LensDyWs.y * rays.m_LensY[i];
+            const double lensZ = m_LensDxWs.z * rays.m_LensX[i] + m_LensDyWs.z * rays.m_LensY[i];
+            dx = dx * m_FocusScale - lensX;
+            dy = dy * m_FocusScale - lensY;
+            dz = dz * m_FocusScale - lensZ;
+            ox += lensX;
+            oy += lensY;
+            oz += lensZ;
+        }
 
-    Point3 rayOriginWs = ToWorldSpace(Point3(0, 0, 0));
-    Vector3 rayDirectionWs = ToWorldSpace(cameraSpaceFilmPoint - Point3(0, 0, 0));
-    return Ray(rayOriginWs, rayDirectionWs);
+        const double invLength = 1.0 / std::sqrt(dx * dx + dy * dy + dz * dz);
+        rays.m_OriginX[i] = ox;
+        rays.m_OriginY[i] = oy;
+        rays.m_OriginZ[i] = oz;
+        rays.m_DirectionX[i] = dx * invLength;
+        rays.m_DirectionY[i] = dy * invLength;
+        rays.m_DirectionZ[i] = dz * invLength;
+    }
 }
 
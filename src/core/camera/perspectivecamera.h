@@ -30,11 +30,32 @@ public:
 
 public:
     inline double GetHorizontalFov() const { return m_HorizontalFov; }
-    inline void SetHorizontalFov(double fovH) { m_HorizontalFov = fovH; }
+    inline double GetApertureRadius() const { return m_ApertureRadius; }
+    inline double GetFocusDistance() const { return m_FocusDistance; }
+    void SetHorizontalFov(double fovH);
+
+    // Thin lens depth of field. Points at the focus distance along the view direction are
+    // sharp, an aperture radius of zero gives a pinhole camera with everything in focus.
+    void SetApertureRadius(double radius);
+    void SetFocusDistance(double distance);
 
 public:
     Ray GenerateRay(const Point2i& filmSpacePos, const Vector2& offset = {}) override;
+    Ray GenerateRay(const Point2i& filmSpacePos, const CameraSample& sample) override;
+    void UpdateCachedTransforms() override;
+
+protected:
+    Matrix4x4 GetRasterToCamera() const override;
+    void GenerateBatchRays(RayBatch& rays) override;
+    double GetFilmDistance() const;
 
 protected:
     double m_HorizontalFov;
+    double m_ApertureRadius;
+    double m_FocusDistance;
+
+    // Ratio of the focus distance to the film distance, and the lens axes scaled by the aperture
+    double m_FocusScale;
+    Vector3 m_LensDxWs;
+    Vector3 m_LensDyWs;
 };
@@ -0,0 +1,93 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+// Sample values for a single camera ray. The film offset is in film space pixels relative to
+// the top left corner of the pixel, the lens and time samples are uniform in [0, 1).
+struct CameraSample
+{
+    Vector2 m_FilmOffset;
+    Point2 m_Lens = { 0.5, 0.5 };
+    double m_Time = 0.0;
+};
+
+// Primary rays of a tile in structure of arrays form, so that ray generation and the batched
+// stages that consume it can process consecutive rays with vector instructions. Each ray
+// remembers the pixel it was generated for, the continuous film space position of its
+// sample, which is where its radiance should be added to the film, and its shutter time.
+struct RayBatch
+{
+    inline size_t GetSize() const { return m_PixelX.size(); }
+    inline Point2i GetPixel(size_t index) const { return { m_PixelX[index], m_PixelY[index] }; }
+    inline Point2 GetFilmPosition(size_t index) const { return { m_FilmX[index], m_FilmY[index] }; }
+    inline Point2 GetLensSample(size_t index) const { return { m_LensX[index], m_LensY[index] }; }
+    inline double GetTime(size_t index) const { return m_Time[index]; }
+
+    inline Ray GetRay(size_t index) const
+    {
+        Ray ray;
+        ray.m_Origin = { m_OriginX[index], m_OriginY[index], m_OriginZ[index] };
+        ray.m_Direction = { m_DirectionX[index], m_DirectionY[index], m_DirectionZ[index] };
+        return ray;
+    }
+
+    inline void SetRay(size_t index, const Ray& ray)
+    {
+        m_OriginX[index] = ray.m_Origin.x;
+        m_OriginY[index] = ray.m_Origin.y;
+        m_OriginZ[index] = ray.m_Origin.z;
+        m_DirectionX[index] = ray.m_Direction.x;
+        m_DirectionY[index] = ray.m_Direction.y;
+        m_DirectionZ[index] = ray.m_Direction.z;
+    }
+
+    inline void Resize(size_t size)
+    {
+        m_PixelX.resize(size);
+        m_PixelY.resize(size);
+        m_FilmX.resize(size);
+        m_FilmY.resize(size);
+        m_LensX.resize(size);
+        m_LensY.resize(size);
+        m_Time.resize(size);
+        m_OriginX.resize(size);
+        m_OriginY.resize(size);
+        m_OriginZ.resize(size);
+        m_DirectionX.resize(size);
+        m_DirectionY.resize(size);
+        m_DirectionZ.resize(size);
+    }
+
+    std::vector<int> m_PixelX;
+    std::vector<int> m_PixelY;
+    std::vector<double> m_FilmX;
+    std::vector<double> m_FilmY;
+    std::vector<double> m_LensX;
+    std::vector<double> m_LensY;
+    std::vector<double> m_Time;
+    std::vector<double> m_OriginX;
+    std::vector<double> m_OriginY;
+    std::vector<double> m_OriginZ;
+    std::vector<double> m_DirectionX;
+    std::vector<double> m_DirectionY;
+    std::vector<double> m_DirectionZ;
+};
+
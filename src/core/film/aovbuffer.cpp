@@ -0,0 +1,130 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <istream>
+#include <ostream>
+#include "aovbuffer.h"
+
+std::string Aov::GetName(AovType type)
+{
+    switch (type)
+    {
+    case AovType::Depth:
+        return "depth";
+    case AovType::Normal:
+        return "normal";
+    case AovType::Albedo:
+        return "albedo";
+    case AovType::SampleCount:
+        return "sampleCount";
+    default:
+        throw std::invalid_argument("Unknown AOV type");
+    }
+}
+
+AovBuffer::AovBuffer(int numPixels, AovMask mask)
+{
+    Allocate(numPixels, mask);
+}
+
+void AovBuffer::Allocate(int numPixels, AovMask mask)
+{
+    if ((mask & ~Aov::All) != 0)
+        throw std::invalid_argument("AOV mask contains unknown AOVs");
+
+    m_NumPixels = numPixels;
+    m_Mask = mask;
+
+    if (mask == Aov::None)
+    {
+        m_Data.clear();
+        return;
+    }
+
+    // The sample count plane is needed to average the other AOVs, so it comes with any of them
+    int numPlanes = 1;
+
+    for (int i = 0; i < Aov::NumAovTypes; ++i)
+    {
+        const AovType type = (AovType)i;
+
+        if (type == AovType::SampleCount)
+            m_PlaneOffsets[i] = 0;
+        else if (Has(type))
+        {
+            m_PlaneOffsets[i] = numPlanes;
+            numPlanes += Aov::GetNumComponents(type);
+        }
+    }
+
+    m_Data.assign(numPlanes * (size_t)numPixels, 0);
+}
+
+void AovBuffer::Release()
+{
+    m_NumPixels = 0;
+    m_Mask = Aov::None;
+    m_Data.clear();
+    m_Data.shrink_to_fit();
+}
+
+void AovBuffer::Write(std::ostream& stream) const
+{
+    const int32_t header[2] = { m_NumPixels, (int32_t)m_Mask };
+    stream.write(reinterpret_cast<const char*>(header), sizeof(header));
+    stream.write(reinterpret_cast<const char*>(m_Data.data()), m_Data.size() * sizeof(FilmChannel));
+}
+
+void AovBuffer::Read(std::istream& stream)
+{
+    int32_t header[2] = {};
+    stream.read(reinterpret_cast<char*>(header), sizeof(header));
+
+    if (!stream.good() || header[0] < 0)
+        throw std::runtime_error("Failed to read AOV buffer");
+
+    Allocate(header[0], (AovMask)header[1]);
+    stream.read(reinterpret_cast<char*>(m_Data.data()), m_Data.size() * sizeof(FilmChannel));
+
+    if (!stream.good())
+        throw std::runtime_error("Failed to read AOV buffer");
+}
+
+void AovBuffer::Add(int index, const AovSample& sample)
+{
+    Aov::Dispatch(m_Mask, [this, index, &sample]<AovMask Mask>() { Add<Mask>(index, sample); });
+}
+
+void AovBuffer::Resolve(AovType type, int index, float* out) const
+{
+    const FilmChannel sampleCount = GetPlane(AovType::SampleCount)[index];
+
+    if (type == AovType::SampleCount)
+    {
+        out[0] = sampleCount;
+        return;
+    }
+
+    const float invSampleCount = sampleCount > 0 ? 1.0f / sampleCount : 0.0f;
+
+    for (int c = 0; c < Aov::GetNumComponents(type); ++c)
+        out[c] = GetPlane(type, c)[index] * invSampleCount;
+}
+
@@ -0,0 +1,148 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "pixelbuffer.h"
+
+// Arbitrary output variables, auxiliary per-pixel images such as denoiser guides that are
+// accumulated alongside radiance. They are box filtered and averaged over the samples of each pixel.
+enum class AovType
+{
+    Depth,
+    Normal,
+    Albedo,
+    SampleCount,
+    NumAovTypes
+};
+
+typedef uint32_t AovMask;
+
+namespace Aov
+{
+    constexpr AovMask None = 0;
+    constexpr AovMask Depth = 1u << (int)AovType::Depth;
+    constexpr AovMask Normal = 1u << (int)AovType::Normal;
+    constexpr AovMask Albedo = 1u << (int)AovType::Albedo;
+    constexpr AovMask SampleCount = 1u << (int)AovType::SampleCount;
+    constexpr AovMask All = Depth | Normal | Albedo | SampleCount;
+
+    constexpr int NumAovTypes = (int)AovType::NumAovTypes;
+
+    inline constexpr AovMask GetMask(AovType type) { return 1u << (int)type; }
+    inline constexpr int GetNumComponents(AovType type) { return type == AovType::Normal || type == AovType::Albedo ? 3 : 1; }
+
+    std::string GetName(AovType type);
+
+    // Calls function.template operator()<Mask>() with Mask equal to mask, so that loops over many
+    // samples can be compiled for exactly the AOVs a film has enabled
+    template <AovMask Mask = None, typename Function>
+    inline void Dispatch(AovMask mask, Function&& function)
+    {
+        if constexpr (Mask > All)
+            throw std::invalid_argument("AOV mask contains unknown AOVs");
+        else if (mask == Mask)
+            function.template operator()<Mask>();
+        else
+            Dispatch<Mask + 1>(mask, function);
+    }
+}
+
+// First hit attributes of a single camera sample
+struct AovSample
+{
+    double m_Depth;
+    Normal3 m_Normal;
+    RgbCoefficients m_Albedo;
+};
+
+// Structure-of-arrays storage for the enabled AOVs only. Every enabled AOV gets one plane per
+// component next to a shared sample count plane, disabled AOVs take no memory and no writes.
+class AovBuffer
+{
+public:
+    AovBuffer() = default;
+    AovBuffer(int numPixels, AovMask mask);
+    ~AovBuffer() = default;
+
+public:
+    inline int GetNumPixels() const { return m_NumPixels; }
+    inline AovMask GetMask() const { return m_Mask; }
+    inline bool IsAllocated() const { return m_NumPixels > 0 && m_Mask != Aov::None; }
+    inline bool Has(AovType type) const { return (m_Mask & Aov::GetMask(type)) != 0; }
+    inline size_t GetMemoryUsage() const { return m_Data.size() * sizeof(FilmChannel); }
+
+    inline FilmChannel* GetPlane(AovType type, int component = 0) { return m_Data.data() + (m_PlaneOffsets[(int)type] + component) * (size_t)m_NumPixels; }
+    inline const FilmChannel* GetPlane(AovType type, int component = 0) const { return m_Data.data() + (m_PlaneOffsets[(int)type] + component) * (size_t)m_NumPixels; }
+
+public:
+    // Accumulates every enabled AOV. Mask must equal the mask of the buffer, as all AOVs share
+    // one sample count. Render loops that are instantiated for their AOV mask with Aov::Dispatch
+    // compile the writes of disabled AOVs out entirely.
+    template <AovMask Mask>
+    inline void Add(int index, const AovSample& sample)
+    {
+        assert(m_Mask == Mask);
+
+        if constexpr (Mask == Aov::None)
+            return;
+
+        GetPlane(AovType::SampleCount)[index] += 1;
+
+        if constexpr ((Mask & Aov::Depth) != 0)
+            GetPlane(AovType::Depth)[index] += (FilmChannel)sample.m_Depth;
+
+        if constexpr ((Mask & Aov::Normal) != 0)
+        {
+            GetPlane(AovType::Normal, 0)[index] += (FilmChannel)sample.m_Normal.x;
+            GetPlane(AovType::Normal, 1)[index] += (FilmChannel)sample.m_Normal.y;
+            GetPlane(AovType::Normal, 2)[index] += (FilmChannel)sample.m_Normal.z;
+        }
+
+        if constexpr ((Mask & Aov::Albedo) != 0)
+        {
+            GetPlane(AovType::Albedo, 0)[index] += (FilmChannel)sample.m_Albedo[0];
+            GetPlane(AovType::Albedo, 1)[index] += (FilmChannel)sample.m_Albedo[1];
+            GetPlane(AovType::Albedo, 2)[index] += (FilmChannel)sample.m_Albedo[2];
+        }
+    }
+
+public:
+    void Allocate(int numPixels, AovMask mask);
+    void Release();
+
+    // Raw binary copies of the buffer for checkpoints. Read replaces the contents.
+    void Write(std::ostream& stream) const;
+    void Read(std::istream& stream);
+
+    // Accumulates every enabled AOV, dispatching on the mask of the buffer at runtime
+    void Add(int index, const AovSample& sample);
+
+    // Writes the average of an enabled AOV at index to its components in out, or the number
+    // of samples for the sample count AOV. Pixels without samples resolve to zero.
+    void Resolve(AovType type, int index, float* out) const;
+
+private:
+    int m_NumPixels = 0;
+    AovMask m_Mask = Aov::None;
+    int m_PlaneOffsets[Aov::NumAovTypes] = {};
+    std::vector<FilmChannel> m_Data;
+};
+
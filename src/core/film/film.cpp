@@ -19,32 +19,157 @@
 */
 
 #include "film.h"
+#include "filter/boxfilter.h"
+#include "system/platform/cacheinfo.h"
+
+constexpr int MinTileSize = 8;
+constexpr int MaxTileSize = 256;
+constexpr int MinTilesPerThread = 8;
 
 Film::Film()
-    : m_TileSize(64)
+    : m_FilterTable(BoxFilter())
+    , m_TileSize(64)
+    , m_TileOrder(TileOrder::Scanline)
+    , m_PixelLayout(PixelLayout::RowMajor)
+    , m_NumTilesX(0)
+    , m_NumTilesY(0)
+    , m_HasSplatBuffer(false)
+    , m_AovMask(Aov::None)
+    , m_IsTrackingVariance(false)
+    , m_HasSnapshots(false)
+    , m_IsSnapshot(false)
 {
     SetupTiles();
 }
 
+Film::Film(const Film& film, const std::vector<std::shared_ptr<const FilmTile>>& tiles)
+    : m_Resolution(film.m_Resolution)
+    , m_FilterTable(film.m_FilterTable)
+    , m_TileSize(film.m_TileSize)
+    , m_TileOrder(film.m_TileOrder)
+    , m_PixelLayout(film.m_PixelLayout)
+    , m_TileSchedule(film.m_TileSchedule)
+    , m_NumTilesX(film.m_NumTilesX)
+    , m_NumTilesY(film.m_NumTilesY)
+    , m_HasSplatBuffer(film.m_HasSplatBuffer)
+    , m_AovMask(film.m_AovMask)
+    , m_IsTrackingVariance(film.m_IsTrackingVariance)
+    , m_TileStates(tiles.size(), Pending)
+    , m_PublishedTiles(tiles)
+    , m_HasSnapshots(false)
+    , m_IsSnapshot(true)
+{
+    // Tiles that have not been published yet show up empty
+    for (size_t i = 0; i < m_PublishedTiles.size(); ++i)
+    {
+        if (m_PublishedTiles[i] != nullptr)
+            continue;
+
+        const FilmTile& source = film.m_Tiles[i];
+        std::shared_ptr<FilmTile> tile = std::make_shared<FilmTile>(source.GetPosition(), source.GetSize(), source.GetApron(), true, m_PixelLayout);
+        tile->AllocateAovs(m_AovMask);
+
+        if (m_IsTrackingVariance)
+            tile->AllocateVarianceBuffer();
+
+        m_PublishedTiles[i] = tile;
+    }
+}
+
 FilmTile& Film::GetTile(int index)
 {
     return m_Tiles[index];
 }
 
+const FilmTile& Film::GetTile(int index) const
+{
+    return m_IsSnapshot ? *m_PublishedTiles[index] : m_Tiles[index];
+}
+
 FilmTile& Film::GetTile(const Point2i& position)
 {
     return GetTile(GetTileIndex(position));
 }
 
+const FilmTile& Film::GetTile(const Point2i& position) const
+{
+    return GetTile(GetTileIndex(position));
+}
+
 void Film::SetResolution(const Resolution& resolution)
 {
     m_Resolution = resolution;
     SetupTiles();
 }
 
+void Film::SetFilter(const Filter& filter)
+{
+    m_FilterTable = FilterTable(filter);
+    SetupTiles();
+}
+
+void Film::SetTileSize(int tileSize)
+{
+    if (tileSize <= 0)
+        throw std::invalid_argument("Film tile size must be positive");
+
+    m_TileSize = tileSize;
+    SetupTiles();
+}
+
+void Film::SetTileOrder(TileOrder order)
+{
+    m_TileOrder = order;
+    m_TileSchedule = TileOrdering::Generate(m_TileOrder, m_NumTilesX, m_NumTilesY);
+}
+
+void Film::SetPixelLayout(PixelLayout layout)
+{
+    m_PixelLayout = layout;
+    SetupTiles();
+}
+
+void Film::AutoTuneTileSize(int numThreads)
+{
+    SetTileSize(ComputeTileSize(m_Resolution, m_FilterTable.GetApron(), numThreads, CacheInfo::GetL2CacheSize()));
+}
+
+int Film::ComputeTileSize(const Resolution& resolution, int apron, int numThreads, size_t l2CacheSize)
+{
+    const size_t bytesPerPixel = PixelBuffer::NumChannels * sizeof(FilmChannel);
+    const int64_t minNumTiles = (int64_t)std::max(1, numThreads) * MinTilesPerThread;
+    int tileSize = MaxTileSize;
+
+    while (tileSize > MinTileSize)
+    {
+        const size_t tileBytes = (size_t)(tileSize + 2 * apron) * (tileSize + 2 * apron) * bytesPerPixel;
+        const int64_t numTilesX = (resolution.GetWidth() + tileSize - 1) / tileSize;
+        const int64_t numTilesY = (resolution.GetHeight() + tileSize - 1) / tileSize;
+
+        if (tileBytes <= l2CacheSize / 2 && numTilesX * numTilesY >= minNumTiles)
+            break;
+
+        tileSize /= 2;
+    }
+
+    return tileSize;
+}
+
 void Film::SetupTiles()
 {
     m_Tiles.clear();
+    m_NumTilesX = (m_Resolution.GetWidth() + m_TileSize - 1) / m_TileSize;
+    m_NumTilesY = (m_Resolution.GetHeight() + m_TileSize - 1) / m_TileSize;
+    m_TileStates.assign(GetNumTiles(), Pending);
+    m_PublishedTiles.assign(GetNumTiles(), nullptr);
+    m_TileSchedule = TileOrdering::Generate(m_TileOrder, m_NumTilesX, m_NumTilesY);
+
+    if (IsStreaming())
+    {
+        std::string path = m_Stream->GetPath();
+        m_Stream.reset();
+        m_Stream = std::make_unique<FilmStream>(path, m_Resolution);
+    }
 
     for (int y = 0; y < m_Resolution.GetHeight(); y += m_TileSize)
     {
@@ -52,7 +177,15 @@ void Film::SetupTiles()
         {
             int sizeX = std::min(m_TileSize, m_Resolution.GetWidth() - x);
             int sizeY = std::min(m_TileSize, m_Resolution.GetHeight() - y);
-            m_Tiles.push_back(FilmTile({ x, y }, { sizeX, sizeY }));
+            m_Tiles.push_back(FilmTile({ x, y }, { sizeX, sizeY }, m_FilterTable.GetApron(), !IsStreaming(), m_PixelLayout));
+
+            if (m_HasSplatBuffer)
+                m_Tiles.back().AllocateSplatBuffer();
+
+            m_Tiles.back().AllocateAovs(m_AovMask);
+
+            if (m_IsTrackingVariance)
+                m_Tiles.back().AllocateVarianceBuffer();
         }
     }
 }
@@ -62,16 +195,273 @@ int Film::GetTileIndex(const Point2i& position) const
     if (!m_Resolution.IsWithinBounds(position))
         throw std::invalid_argument("Position is outside film bounds");
 
-    int x = position.x / m_TileSize;
-    int y = position.y / m_TileSize;
-    int numTilesX = (int)std::ceil(m_Resolution.GetWidth() / (double)m_TileSize);
-    return x + y * numTilesX;
+    return position.x / m_TileSize + (position.y / m_TileSize) * m_NumTilesX;
+}
+
+void Film::EnableSplatBuffer()
+{
+    if (IsStreaming())
+        throw std::runtime_error("Streaming films do not support splat buffers");
+
+    m_HasSplatBuffer = true;
+
+    for (FilmTile& tile : m_Tiles)
+        tile.AllocateSplatBuffer();
+}
+
+void Film::EnableAovs(AovMask mask)
+{
+    if (IsStreaming() && mask != Aov::None)
+        throw std::runtime_error("Streaming films do not support AOVs");
+
+    m_AovMask = mask;
+
+    for (FilmTile& tile : m_Tiles)
+        tile.AllocateAovs(mask);
+}
+
+void Film::EnableVarianceTracking()
+{
+    if (IsStreaming())
+        throw std::runtime_error("Streaming films do not support variance tracking");
+
+    m_IsTrackingVariance = true;
+
+    for (FilmTile& tile : m_Tiles)
+        tile.AllocateVarianceBuffer();
+}
+
+void Film::AddSample(const Point2& filmSpacePos, const XyzCoefficients& xyz)
+{
+    Point2i pixel((int)std::floor(filmSpacePos.x), (int)std::floor(filmSpacePos.y));
+    FilmTile& tile = GetTile(pixel);
+
+    if (!tile.IsResident())
+        throw std::runtime_error("Samples can only be added to tiles that have begun rendering");
+
+    tile.AddSample(filmSpacePos, xyz, m_FilterTable);
+}
+
+void Film::AddSample(const Point2& filmSpacePos, const XyzCoefficients& xyz, const AovSample& aovs)
+{
+    AddSample(filmSpacePos, xyz);
+
+    Point2i pixel((int)std::floor(filmSpacePos.x), (int)std::floor(filmSpacePos.y));
+    FilmTile& tile = GetTile(pixel);
+    tile.AddAovSample(tile.FilmToTileSpace(pixel), aovs);
+}
+
+void Film::MergeTileAprons()
+{
+    if (IsStreaming())
+        throw std::runtime_error("Streaming films merge tile aprons as tiles end");
+
+    const int tileReach = GetTileReach();
+
+    if (tileReach == 0)
+        return;
+
+    for (int y = 0; y < m_NumTilesY; ++y)
+    {
+        for (int x = 0; x < m_NumTilesX; ++x)
+        {
+            FilmTile& tile = m_Tiles[x + y * m_NumTilesX];
+
+            for (int ny = std::max(0, y - tileReach); ny <= std::min(m_NumTilesY - 1, y + tileReach); ++ny)
+                for (int nx = std::max(0, x - tileReach); nx <= std::min(m_NumTilesX - 1, x + tileReach); ++nx)
+                    tile.MergeApron(m_Tiles[nx + ny * m_NumTilesX]);
+        }
+    }
+
+    // Clear once everything is merged so that merging again does not count contributions twice
+    for (FilmTile& tile : m_Tiles)
+        tile.ClearApron();
+}
+
+void Film::EnableSnapshots()
+{
+    m_HasSnapshots = true;
+}
+
+void Film::DisableSnapshots()
+{
+    std::lock_guard<std::mutex> lock(m_PublishMutex);
+    m_HasSnapshots = false;
+    m_PublishedTiles.assign(GetNumTiles(), nullptr);
+}
+
+void Film::PublishTile(int index)
+{
+    if (!m_HasSnapshots)
+        return;
+
+    // Tiles of streaming films that are no longer in memory keep their last published version
+    if (!m_Tiles[index].IsResident())
+        return;
+
+    std::shared_ptr<const FilmTile> version = std::make_shared<const FilmTile>(m_Tiles[index]);
+
+    {
+        // Checked again under the lock so that nothing is published after DisableSnapshots
+        std::lock_guard<std::mutex> lock(m_PublishMutex);
+
+        if (m_HasSnapshots)
+            m_PublishedTiles[index].swap(version);
+    }
+
+    // The replaced version is freed here, or by the last snapshot that still holds it
 }
 
-int Film::GetNumTiles() const
+std::unique_ptr<const Film> Film::CreateSnapshot() const
 {
-    double numTilesX = m_Resolution.GetWidth() / (double)m_TileSize;
-    double numTilesY = m_Resolution.GetHeight() / (double)m_TileSize;
-    return (int)std::ceil(numTilesX) * (int)std::ceil(numTilesY);
+    if (!m_HasSnapshots)
+        throw std::runtime_error("Snapshots are not enabled for this film");
+
+    std::vector<std::shared_ptr<const FilmTile>> tiles;
+
+    {
+        std::lock_guard<std::mutex> lock(m_PublishMutex);
+        tiles = m_PublishedTiles;
+    }
+
+    return std::unique_ptr<const Film>(new Film(*this, tiles));
 }
 
+size_t Film::GetMemoryUsage() const
+{
+    size_t memoryUsage = 0;
+
+    for (int i = 0; i < GetNumTiles(); ++i)
+        memoryUsage += GetTile(i).GetMemoryUsage();
+
+    // Published versions are copies of their own, snapshots already counted theirs as tiles
+    if (!m_IsSnapshot)
+    {
+        std::lock_guard<std::mutex> lock(m_PublishMutex);
+
+        for (const std::shared_ptr<const FilmTile>& tile : m_PublishedTiles)
+        {
+            if (tile != nullptr)
+                memoryUsage += tile->GetMemoryUsage();
+        }
+    }
+
+    return memoryUsage;
+}
+
+void Film::EnableStreaming(const std::string& path)
+{
+    if (m_HasSplatBuffer)
+        throw std::runtime_error("Streaming films do not support splat buffers");
+
+    if (m_AovMask != Aov::None)
+        throw std::runtime_error("Streaming films do not support AOVs");
+
+    if (m_IsTrackingVariance)
+        throw std::runtime_error("Streaming films do not support variance tracking");
+
+    m_Stream = std::make_unique<FilmStream>(path, m_Resolution);
+    SetupTiles();
+}
+
+FilmStream& Film::GetStream()
+{
+    if (!IsStreaming())
+        throw std::runtime_error("Film is not streaming");
+
+    return *m_Stream;
+}
+
+const FilmStream& Film::GetStream() const
+{
+    if (!IsStreaming())
+        throw std::runtime_error("Film is not streaming");
+
+    return *m_Stream;
+}
+
+FilmTile& Film::BeginTile(int index)
+{
+    if (!IsStreaming())
+        return m_Tiles[index];
+
+    std::lock_guard<std::mutex> lock(m_StreamMutex);
+
+    if (m_TileStates[index] != Pending)
+        throw std::runtime_error("Film tile has already begun rendering");
+
+    m_TileStates[index] = Rendering;
+    m_Tiles[index].MakeResident();
+    return m_Tiles[index];
+}
+
+void Film::EndTile(int index)
+{
+    if (!IsStreaming())
+        return;
+
+    std::lock_guard<std::mutex> lock(m_StreamMutex);
+
+    if (m_TileStates[index] != Rendering)
+        throw std::runtime_error("Film tile has not begun rendering");
+
+    m_TileStates[index] = Rendered;
+
+    const int tileReach = GetTileReach();
+    const int tileX = index % m_NumTilesX;
+    const int tileY = index / m_NumTilesX;
+
+    // Write out every tile whose neighborhood has now been fully rendered
+    for (int y = std::max(0, tileY - tileReach); y <= std::min(m_NumTilesY - 1, tileY + tileReach); ++y)
+    {
+        for (int x = std::max(0, tileX - tileReach); x <= std::min(m_NumTilesX - 1, tileX + tileReach); ++x)
+        {
+            const int neighborIndex = x + y * m_NumTilesX;
+
+            if (m_TileStates[neighborIndex] != Rendered || !IsNeighborhoodPast(neighborIndex, Rendering))
+                continue;
+
+            FilmTile& tile = m_Tiles[neighborIndex];
+
+            for (int ny = std::max(0, y - tileReach); ny <= std::min(m_NumTilesY - 1, y + tileReach); ++ny)
+                for (int nx = std::max(0, x - tileReach); nx <= std::min(m_NumTilesX - 1, x + tileReach); ++nx)
+                    tile.MergeApron(m_Tiles[nx + ny * m_NumTilesX]);
+
+            m_Stream->WriteTile(tile);
+            m_TileStates[neighborIndex] = Written;
+        }
+    }
+
+    // Written tiles are dropped once no neighbor still needs to merge their apron
+    const int releaseReach = 2 * tileReach;
+
+    for (int y = std::max(0, tileY - releaseReach); y <= std::min(m_NumTilesY - 1, tileY + releaseReach); ++y)
+    {
+        for (int x = std::max(0, tileX - releaseReach); x <= std::min(m_NumTilesX - 1, tileX + releaseReach); ++x)
+        {
+            const int neighborIndex = x + y * m_NumTilesX;
+
+            if (m_TileStates[neighborIndex] == Written && IsNeighborhoodPast(neighborIndex, Rendered))
+                m_Tiles[neighborIndex].Release();
+        }
+    }
+}
+
+int Film::GetTileReach() const
+{
+    return (m_FilterTable.GetApron() + m_TileSize - 1) / m_TileSize;
+}
+
+bool Film::IsNeighborhoodPast(int index, TileState state) const
+{
+    const int tileReach = GetTileReach();
+    const int tileX = index % m_NumTilesX;
+    const int tileY = index / m_NumTilesX;
+
+    for (int y = std::max(0, tileY - tileReach); y <= std::min(m_NumTilesY - 1, tileY + tileReach); ++y)
+        for (int x = std::max(0, tileX - tileReach); x <= std::min(m_NumTilesX - 1, tileX + tileReach); ++x)
+            if (m_TileStates[x + y * m_NumTilesX] <= state)
+                return false;
+
+    return true;
+}
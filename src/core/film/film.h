@@ -22,6 +22,9 @@
 
 #include "resolution.h"
 #include "filmtile.h"
+#include "filmstream.h"
+#include "tileorder.h"
+#include "filter/filter.h"
 
 class Film
 {
@@ -31,24 +34,129 @@ public:
 
 public:
     inline const Resolution& GetResolution() const { return m_Resolution; }
-    inline int GetNumPixels() const { return m_Resolution.GetArea(); }
+    inline int64_t GetNumPixels() const { return m_Resolution.GetArea(); }
     inline int GetTileSize() const { return m_TileSize; }
+    inline bool HasSplatBuffer() const { return m_HasSplatBuffer; }
+    inline AovMask GetAovMask() const { return m_AovMask; }
+    inline bool HasAov(AovType type) const { return (m_AovMask & Aov::GetMask(type)) != 0; }
+    inline bool IsTrackingVariance() const { return m_IsTrackingVariance; }
+    inline const FilterTable& GetFilterTable() const { return m_FilterTable; }
+    inline int GetNumTiles() const { return m_NumTilesX * m_NumTilesY; }
+    inline TileOrder GetTileOrder() const { return m_TileOrder; }
+    inline PixelLayout GetPixelLayout() const { return m_PixelLayout; }
+    inline const std::vector<int>& GetTileSchedule() const { return m_TileSchedule; }
+    inline bool IsStreaming() const { return m_Stream != nullptr; }
+    inline bool HasSnapshots() const { return m_HasSnapshots; }
+
+    // Unchecked tile lookup for the render loop, the position must lie within the film
+    inline FilmTile& GetTileUnchecked(const Point2i& position)
+    {
+        assert(m_Resolution.IsWithinBounds(position));
+        return m_Tiles[position.x / m_TileSize + (position.y / m_TileSize) * m_NumTilesX];
+    }
 
 public:
     void SetResolution(const Resolution& resolution);
+    void SetFilter(const Filter& filter);
+    void SetTileSize(int tileSize);
+    void SetTileOrder(TileOrder order);
+    void SetPixelLayout(PixelLayout layout);
+
+    // Picks the largest power of two tile size whose pixels fit in half of the L2 cache,
+    // then shrinks it until there are enough tiles to keep every thread busy
+    void AutoTuneTileSize(int numThreads);
+    static int ComputeTileSize(const Resolution& resolution, int apron, int numThreads, size_t l2CacheSize);
 
     FilmTile& GetTile(int index);
+    const FilmTile& GetTile(int index) const;
     FilmTile& GetTile(const Point2i& position);
-    int GetNumTiles() const;
+    const FilmTile& GetTile(const Point2i& position) const;
+
+    void EnableSplatBuffer();
+
+    // Allocates storage for the AOVs in mask on every tile, AOVs outside of it cost nothing
+    void EnableAovs(AovMask mask);
+
+    // Tracks the per pixel luminance variance of every tile for adaptive sampling, see
+    // FilmTile::GetError. Only available to films that keep their tiles in memory.
+    void EnableVarianceTracking();
+
+    // Out-of-core mode for films too large to keep in memory. Tiles only hold pixel storage
+    // between BeginTile and EndTile. Once a tile and its neighbors have ended, their aprons are
+    // merged into it and it is written to the stream and dropped, so peak memory scales with
+    // the tiles in flight rather than with the image area.
+    void EnableStreaming(const std::string& path);
+    FilmStream& GetStream();
+    const FilmStream& GetStream() const;
+
+    FilmTile& BeginTile(int index);
+    void EndTile(int index);
+
+    // Reconstructs a sample into the tile under it. Contributions that reach into
+    // neighboring tiles are held in tile aprons until MergeTileAprons is called.
+    void AddSample(const Point2& filmSpacePos, const XyzCoefficients& xyz);
+    void AddSample(const Point2& filmSpacePos, const XyzCoefficients& xyz, const AovSample& aovs);
+    void MergeTileAprons();
+
+    // Copy-on-write snapshots for progressive export. PublishTile copies a tile into an immutable
+    // version that replaces the previously published one, CreateSnapshot collects the latest
+    // versions into a read-only film that can be exported while rendering continues. Snapshots
+    // share published versions with the film and with each other, only tiles that have not been
+    // published yet get an empty tile of their own. Render threads only ever wait on a pointer
+    // swap, the snapshot is assembled on the calling thread.
+    // Publishing keeps a second copy of every tile, so it is opt-in: PublishTile does nothing
+    // until EnableSnapshots is called, and DisableSnapshots releases the published versions that
+    // no snapshot holds anymore.
+    void EnableSnapshots();
+    void DisableSnapshots();
+    void PublishTile(int index);
+    std::unique_ptr<const Film> CreateSnapshot() const;
+
+    // Includes the published versions that the film keeps alive for snapshots
+    size_t GetMemoryUsage() const;
+
+private:
+    enum TileState
+    {
+        Pending,
+        Rendering,
+        Rendered,
+        Written
+    };
 
 private:
+    Film(const Film& film, const std::vector<std::shared_ptr<const FilmTile>>& tiles);
+
     void SetupTiles();
     int GetTileIndex(const Point2i& position) const;
 
+    int GetTileReach() const;
+    bool IsNeighborhoodPast(int index, TileState state) const;
+
 private:
     Resolution m_Resolution;
     std::vector<FilmTile> m_Tiles;
+    FilterTable m_FilterTable;
+
+    int m_TileSize;
+    TileOrder m_TileOrder;
+    PixelLayout m_PixelLayout;
+    std::vector<int> m_TileSchedule;
+    int m_NumTilesX;
+    int m_NumTilesY;
+    bool m_HasSplatBuffer;
+    AovMask m_AovMask;
+    bool m_IsTrackingVariance;
+
+    std::unique_ptr<FilmStream> m_Stream;
+    std::vector<TileState> m_TileStates;
+    std::mutex m_StreamMutex;
+
+    std::vector<std::shared_ptr<const FilmTile>> m_PublishedTiles;
+    mutable std::mutex m_PublishMutex;
+    std::atomic<bool> m_HasSnapshots;
 
-    const int m_TileSize;
+    // Snapshots keep no tiles of their own and read every tile from m_PublishedTiles
+    bool m_IsSnapshot;
 };
 
@@ -0,0 +1,327 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <filesystem>
+#include <sstream>
+#include "filmcheckpoint.h"
+
+const char CheckpointMagic[8] = { 'S', 'P', 'C', 'C', 'K', 'P', 'T', '1' };
+const uint32_t RecordMagic = 0x454c4954;
+
+FilmCheckpoint::FilmCheckpoint(const std::string& path)
+    : m_Path(path)
+    , m_TemporaryPath(path + ".tmp")
+    , m_FileSize(0)
+    , m_TemporaryFileSize(0)
+    , m_NumRecordsInFile(0)
+    , m_ShouldStop(false)
+    , m_NumRecordsWritten(0)
+{
+}
+
+FilmCheckpoint::~FilmCheckpoint()
+{
+    if (!IsOpen())
+        return;
+
+    try
+    {
+        Close();
+    }
+    catch (...)
+    {
+        // Write errors can only be reported through Close
+    }
+}
+
+std::vector<int> FilmCheckpoint::Open(Film& film, int samplesPerPixel)
+{
+    if (IsOpen())
+        throw std::runtime_error("Film checkpoint is already open");
+
+    if (film.IsStreaming())
+        throw std::runtime_error("Streaming films do not support checkpoints");
+
+    m_Header = GetHeader(film, samplesPerPixel);
+    m_RecordOffsets.assign(film.GetNumTiles(), -1);
+
+    std::vector<int> tileSamplesPerPixel(film.GetNumTiles(), 0);
+    std::vector<Record> records = ReadRecords(film, samplesPerPixel);
+
+    for (const Record& record : records)
+    {
+        std::istringstream stream(record.m_Data);
+        film.GetTile(record.m_TileIndex).Read(stream);
+        tileSamplesPerPixel[record.m_TileIndex] = record.m_SamplesPerPixel;
+    }
+
+    // Start over with only the latest records so that the file does not grow across resumes
+    // and appended records never follow a damaged one
+    size_t nextRecord = 0;
+    WriteTemporaryFile([&records, &nextRecord](Record& record)
+    {
+        if (nextRecord == records.size())
+            return false;
+
+        record = std::move(records[nextRecord++]);
+        return true;
+    });
+
+    ReplaceFile();
+
+    m_ShouldStop = false;
+    m_Error = nullptr;
+    m_Thread = std::thread(&FilmCheckpoint::Run, this);
+    return tileSamplesPerPixel;
+}
+
+void FilmCheckpoint::WriteTile(int tileIndex, int samplesPerPixel, const FilmTile& tile)
+{
+    if (!IsOpen())
+        throw std::runtime_error("Film checkpoint is not open");
+
+    std::ostringstream stream;
+    tile.Write(stream);
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Queue.push_back({ tileIndex, samplesPerPixel, std::move(stream).str() });
+    }
+
+    m_Condition.notify_one();
+}
+
+void FilmCheckpoint::Close()
+{
+    if (!IsOpen())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_ShouldStop = true;
+    }
+
+    m_Condition.notify_one();
+    m_Thread.join();
+    m_File.close();
+
+    if (m_Error != nullptr)
+        std::rethrow_exception(m_Error);
+}
+
+std::vector<int32_t> FilmCheckpoint::GetHeader(const Film& film, int samplesPerPixel)
+{
+    return {
+        film.GetResolution().GetWidth(),
+        film.GetResolution().GetHeight(),
+        film.GetTileSize(),
+        film.GetFilterTable().GetApron(),
+        (int32_t)film.GetPixelLayout(),
+        (int32_t)film.GetAovMask(),
+        film.HasSplatBuffer() ? 1 : 0,
+        film.IsTrackingVariance() ? 1 : 0,
+        (int32_t)sizeof(FilmChannel),
+        samplesPerPixel
+    };
+}
+
+std::vector<FilmCheckpoint::Record> FilmCheckpoint::ReadRecords(const Film& film, int samplesPerPixel) const
+{
+    std::ifstream file(m_Path, std::ios::binary);
+
+    if (!file.is_open())
+        return {};
+
+    char magic[sizeof(CheckpointMagic)] = {};
+    std::vector<int32_t> header = GetHeader(film, samplesPerPixel);
+    const std::vector<int32_t> expectedHeader = header;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(header.data()), header.size() * sizeof(int32_t));
+
+    if (!file.good() || !std::equal(magic, magic + sizeof(magic), CheckpointMagic))
+        throw std::runtime_error("File is not a film checkpoint " + m_Path);
+
+    if (header != expectedHeader)
+        throw std::runtime_error("Film checkpoint was written with other film or sampler settings " + m_Path);
+
+    // Later records of a tile replace earlier ones, reading stops at the first incomplete record
+    std::vector<int> latest(film.GetNumTiles(), -1);
+    std::vector<Record> records;
+    Record record;
+
+    while (ReadRecord(file, record))
+    {
+        if (latest[record.m_TileIndex] >= 0)
+            records[latest[record.m_TileIndex]] = std::move(record);
+        else
+        {
+            latest[record.m_TileIndex] = (int)records.size();
+            records.push_back(std::move(record));
+        }
+    }
+
+    return records;
+}
+
+bool FilmCheckpoint::ReadRecord(std::istream& stream, Record& record) const
+{
+    uint32_t recordMagic = 0;
+    int32_t recordHeader[2] = {};
+    uint64_t size = 0;
+    stream.read(reinterpret_cast<char*>(&recordMagic), sizeof(recordMagic));
+    stream.read(reinterpret_cast<char*>(recordHeader), sizeof(recordHeader));
+    stream.read(reinterpret_cast<char*>(&size), sizeof(size));
+
+    if (!stream.good() || recordMagic != RecordMagic || recordHeader[0] < 0 || recordHeader[0] >= (int32_t)m_RecordOffsets.size())
+        return false;
+
+    record.m_TileIndex = recordHeader[0];
+    record.m_SamplesPerPixel = recordHeader[1];
+    record.m_Data.assign(size, '\0');
+    stream.read(record.m_Data.data(), size);
+    return stream.good();
+}
+
+std::streamoff FilmCheckpoint::WriteRecord(std::ostream& stream, const Record& record)
+{
+    const int32_t recordHeader[2] = { record.m_TileIndex, record.m_SamplesPerPixel };
+    const uint64_t size = record.m_Data.size();
+    stream.write(reinterpret_cast<const char*>(&RecordMagic), sizeof(RecordMagic));
+    stream.write(reinterpret_cast<const char*>(recordHeader), sizeof(recordHeader));
+    stream.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    stream.write(record.m_Data.data(), size);
+    return sizeof(RecordMagic) + sizeof(recordHeader) + sizeof(size) + (std::streamoff)size;
+}
+
+void FilmCheckpoint::WriteTemporaryFile(const std::function<bool(Record&)>& nextRecord)
+{
+    std::ofstream file(m_TemporaryPath, std::ios::out | std::ios::binary | std::ios::trunc);
+
+    if (!file.is_open())
+        throw std::runtime_error("Failed to open film checkpoint " + m_TemporaryPath);
+
+    file.write(CheckpointMagic, sizeof(CheckpointMagic));
+    file.write(reinterpret_cast<const char*>(m_Header.data()), m_Header.size() * sizeof(int32_t));
+
+    m_TemporaryRecordOffsets.assign(m_RecordOffsets.size(), -1);
+    m_TemporaryFileSize = sizeof(CheckpointMagic) + m_Header.size() * sizeof(int32_t);
+    Record record;
+
+    while (nextRecord(record))
+    {
+        m_TemporaryRecordOffsets[record.m_TileIndex] = m_TemporaryFileSize;
+        m_TemporaryFileSize += WriteRecord(file, record);
+    }
+
+    file.close();
+
+    if (!file.good())
+        throw std::runtime_error("Failed to write film checkpoint " + m_TemporaryPath);
+}
+
+void FilmCheckpoint::ReplaceFile()
+{
+    // Renaming replaces the checkpoint in one step, it either still holds the old records or the new ones
+    m_File.close();
+    std::filesystem::rename(m_TemporaryPath, m_Path);
+
+    m_RecordOffsets = m_TemporaryRecordOffsets;
+    m_FileSize = m_TemporaryFileSize;
+    m_NumRecordsInFile = (int)std::count_if(m_RecordOffsets.begin(), m_RecordOffsets.end(), [](std::streamoff offset) { return offset >= 0; });
+
+    m_File.open(m_Path, std::ios::out | std::ios::binary | std::ios::app);
+
+    if (!m_File.is_open())
+        throw std::runtime_error("Failed to open film checkpoint " + m_Path);
+}
+
+void FilmCheckpoint::Compact()
+{
+    {
+        std::ifstream file(m_Path, std::ios::binary);
+        size_t tileIndex = 0;
+
+        WriteTemporaryFile([this, &file, &tileIndex](Record& record)
+        {
+            while (tileIndex < m_RecordOffsets.size() && m_RecordOffsets[tileIndex] < 0)
+                ++tileIndex;
+
+            if (tileIndex == m_RecordOffsets.size())
+                return false;
+
+            file.seekg(m_RecordOffsets[tileIndex++]);
+
+            if (!ReadRecord(file, record))
+                throw std::runtime_error("Failed to read film checkpoint " + m_Path);
+
+            return true;
+        });
+    }
+
+    ReplaceFile();
+}
+
+void FilmCheckpoint::Run()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    while (true)
+    {
+        m_Condition.wait(lock, [this]() { return m_ShouldStop || !m_Queue.empty(); });
+
+        if (m_Queue.empty())
+            return;
+
+        Record record = std::move(m_Queue.front());
+        m_Queue.pop_front();
+
+        // Writing can take a while, render threads keep queueing records in the meantime
+        lock.unlock();
+
+        if (m_Error == nullptr)
+        {
+            const std::streamoff offset = m_FileSize;
+            m_FileSize += WriteRecord(m_File, record);
+            m_File.flush();
+
+            if (m_File.good())
+            {
+                m_RecordOffsets[record.m_TileIndex] = offset;
+                ++m_NumRecordsInFile;
+                ++m_NumRecordsWritten;
+
+                try
+                {
+                    if (m_NumRecordsInFile > MaxRecordsPerTile * (int)m_RecordOffsets.size())
+                        Compact();
+                }
+                catch (...)
+                {
+                    m_Error = std::current_exception();
+                }
+            }
+            else
+                m_Error = std::make_exception_ptr(std::runtime_error("Failed to write film checkpoint " + m_Path));
+        }
+
+        lock.lock();
+    }
+}
+
@@ -0,0 +1,113 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include "film.h"
+
+// Binary checkpoint of a film that is being rendered, so that renders on machines that can be
+// preempted resume where they stopped. The file starts with a header describing the film and
+// then holds a record per tile and pass with the tile's accumulated buffers and the number of
+// samples per pixel it has received. Samplers derive their values from the pixel and sample
+// index, so those counts are all that is needed to continue the sample sequence and restoring
+// the tiles bit for bit makes the resumed image identical to an uninterrupted render.
+//
+// Records are serialized by the render threads and appended by a background thread. A record
+// cut short by the process being killed is ignored when the checkpoint is opened again. The
+// file is compacted to the latest record of each tile when it is opened and whenever it holds
+// more than MaxRecordsPerTile records per tile. Compacted files are written next to the
+// checkpoint and then renamed over it, so a kill during compaction loses no progress.
+class FilmCheckpoint
+{
+public:
+    FilmCheckpoint(const std::string& path);
+    ~FilmCheckpoint();
+
+public:
+    inline const std::string& GetPath() const { return m_Path; }
+    inline int GetNumRecordsWritten() const { return m_NumRecordsWritten; }
+    inline bool IsOpen() const { return m_Thread.joinable(); }
+
+public:
+    // Restores the tiles recorded in the checkpoint into the film and starts the background
+    // writer. Returns the samples per pixel each tile has received, zero for tiles that were
+    // not recorded. A missing file is created empty. Throws if the checkpoint was written for
+    // a film with other settings or with another number of samples per pixel.
+    std::vector<int> Open(Film& film, int samplesPerPixel);
+
+    // Queues a copy of the tile, which has received the given samples per pixel so far
+    void WriteTile(int tileIndex, int samplesPerPixel, const FilmTile& tile);
+
+    // Writes every queued record, joins the background thread and rethrows the first write error
+    void Close();
+
+    // The film settings that tiles written by one film can only be read back into another with
+    static std::vector<int32_t> GetHeader(const Film& film, int samplesPerPixel);
+
+    static constexpr int MaxRecordsPerTile = 2;
+
+private:
+    struct Record
+    {
+        int32_t m_TileIndex;
+        int32_t m_SamplesPerPixel;
+        std::string m_Data;
+    };
+
+private:
+    std::vector<Record> ReadRecords(const Film& film, int samplesPerPixel) const;
+    bool ReadRecord(std::istream& stream, Record& record) const;
+    static std::streamoff WriteRecord(std::ostream& stream, const Record& record);
+
+    // Writes the header followed by the records nextRecord returns until it returns false to
+    // the temporary file, ReplaceFile then renames it over the checkpoint
+    void WriteTemporaryFile(const std::function<bool(Record&)>& nextRecord);
+    void ReplaceFile();
+    void Compact();
+    void Run();
+
+private:
+    const std::string m_Path;
+    const std::string m_TemporaryPath;
+    std::ofstream m_File;
+    std::vector<int32_t> m_Header;
+
+    // Where the latest record of each tile starts in the file, or -1 for tiles without one
+    std::vector<std::streamoff> m_RecordOffsets;
+    std::vector<std::streamoff> m_TemporaryRecordOffsets;
+    std::streamoff m_FileSize;
+    std::streamoff m_TemporaryFileSize;
+    int m_NumRecordsInFile;
+
+    std::thread m_Thread;
+    std::mutex m_Mutex;
+    std::condition_variable m_Condition;
+    std::deque<Record> m_Queue;
+    bool m_ShouldStop;
+
+    std::atomic<int> m_NumRecordsWritten;
+    std::exception_ptr m_Error;
+};
+
@@ -0,0 +1,99 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "filmstream.h"
+
+const char StreamMagic[8] = { 'S', 'P', 'C', 'F', 'I', 'L', 'M', '1' };
+const std::streamoff HeaderSize = sizeof(StreamMagic) + 2 * sizeof(int32_t);
+const std::streamoff BytesPerPixel = 3 * sizeof(float);
+
+FilmStream::FilmStream(const std::string& path, const Resolution& resolution)
+    : m_Path(path)
+    , m_Resolution(resolution)
+{
+    m_File.open(path, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+
+    if (!m_File.is_open())
+        throw std::runtime_error("Failed to open film stream " + path);
+
+    const int32_t size[2] = { resolution.GetWidth(), resolution.GetHeight() };
+    m_File.write(StreamMagic, sizeof(StreamMagic));
+    m_File.write(reinterpret_cast<const char*>(size), sizeof(size));
+
+    // Size the file up front so tiles can be written at their final offsets in any order
+    m_File.seekp(GetPixelOffset({ resolution.GetWidth() - 1, resolution.GetHeight() - 1 }) + BytesPerPixel - 1);
+    m_File.put(0);
+
+    if (!m_File.good())
+        throw std::runtime_error("Failed to allocate film stream " + path);
+}
+
+void FilmStream::WriteTile(const FilmTile& tile)
+{
+    const Point2i position = tile.GetPosition();
+    const Vector2i size = tile.GetSize();
+    std::vector<float> row(3 * (size_t)size.x);
+
+    std::lock_guard<std::mutex> lock(m_FileMutex);
+
+    for (int y = 0; y < size.y; ++y)
+    {
+        for (FilmTile::ScanlineIterator it = tile.GetScanline(y); it.IsValid(); ++it)
+        {
+            Pixel pixel = *it;
+            XyzCoefficients xyz = pixel.m_TotalSplat > 0.0 ? pixel.m_Xyz / pixel.m_TotalSplat : XyzCoefficients(0.0);
+            row[3 * it.GetX() + 0] = (float)xyz[0];
+            row[3 * it.GetX() + 1] = (float)xyz[1];
+            row[3 * it.GetX() + 2] = (float)xyz[2];
+        }
+
+        m_File.seekp(GetPixelOffset({ position.x, position.y + y }));
+        m_File.write(reinterpret_cast<const char*>(row.data()), row.size() * sizeof(float));
+    }
+
+    if (!m_File.good())
+        throw std::runtime_error("Failed to write tile to film stream " + m_Path);
+}
+
+XyzCoefficients FilmStream::ReadPixel(const Point2i& position) const
+{
+    float xyz[3];
+    ReadScanline(position, 1, xyz);
+    return { xyz[0], xyz[1], xyz[2] };
+}
+
+void FilmStream::ReadScanline(const Point2i& position, int width, float* xyz) const
+{
+    if (width <= 0 || !m_Resolution.IsWithinBounds(position) || position.x + width > m_Resolution.GetWidth())
+        throw std::invalid_argument("Position is outside film bounds");
+
+    std::lock_guard<std::mutex> lock(m_FileMutex);
+    m_File.seekg(GetPixelOffset(position));
+    m_File.read(reinterpret_cast<char*>(xyz), width * BytesPerPixel);
+
+    if (!m_File.good())
+        throw std::runtime_error("Failed to read from film stream " + m_Path);
+}
+
+std::streamoff FilmStream::GetPixelOffset(const Point2i& position) const
+{
+    return HeaderSize + ((std::streamoff)position.y * m_Resolution.GetWidth() + position.x) * BytesPerPixel;
+}
+
@@ -0,0 +1,58 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <fstream>
+#include "resolution.h"
+#include "filmtile.h"
+
+// Scanline-ordered output file that completed film tiles are streamed into. The file
+// starts with a small header followed by one resolved XYZ triplet of 32-bit floats per
+// pixel, so tiles can be written in any order and dropped from memory right after.
+class FilmStream
+{
+public:
+    FilmStream(const std::string& path, const Resolution& resolution);
+    ~FilmStream() = default;
+
+public:
+    inline const std::string& GetPath() const { return m_Path; }
+    inline const Resolution& GetResolution() const { return m_Resolution; }
+
+public:
+    void WriteTile(const FilmTile& tile);
+    XyzCoefficients ReadPixel(const Point2i& position) const;
+
+    // Reads width resolved XYZ triplets starting at position with a single seek. Pixels of
+    // tiles that have not been written yet read as zero.
+    void ReadScanline(const Point2i& position, int width, float* xyz) const;
+
+private:
+    std::streamoff GetPixelOffset(const Point2i& position) const;
+
+private:
+    const std::string m_Path;
+    const Resolution m_Resolution;
+
+    mutable std::fstream m_File;
+    mutable std::mutex m_FileMutex;
+};
+
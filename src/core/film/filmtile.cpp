@@ -16,10 +16,17 @@
     along with this program. If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <istream>
+#include <ostream>
 #include "filmtile.h"
 
-FilmTile::FilmTile(const Point2i& pos, const Vector2i& size)
+// Splat area is accumulated at film precision, so allow for its rounding error
+const double MaxTotalSplat = 1.0 + std::max(SMath::Epsilon, 64.0 * std::numeric_limits<FilmChannel>::epsilon());
+
+FilmTile::FilmTile(const Point2i& pos, const Vector2i& size, int apron, bool isResident, PixelLayout layout)
     : m_Rect(pos.x, pos.y, size.x, size.y)
+    , m_Apron(apron)
+    , m_Layout(layout)
 {
     if (size.x <= 0 || size.y <= 0)
         throw std::invalid_argument("Film tile cannot have zero size");
@@ -27,7 +34,11 @@ FilmTile::FilmTile(const Point2i& pos, const Vector2i& size)
     if (pos.x < 0 || pos.y < 0)
         throw std::invalid_argument("Film tile cannot have negative position");
 
-    m_Pixels.resize(size.x * size.y);
+    if (apron < 0)
+        throw std::invalid_argument("Film tile cannot have a negative apron");
+
+    if (isResident)
+        MakeResident();
 }
 
 Point2i FilmTile::TileToFilmSpace(const Point2i& tileSpacePos) const
@@ -42,20 +53,32 @@ Point2i FilmTile::FilmToTileSpace(const Point2i& filmSpacePos) const
 
 int FilmTile::GetIndex(const Point2i& tileSpacePos) const
 {
-    Point2i filmSpacePos = TileToFilmSpace(tileSpacePos);
-
-    if (!m_Rect.Contains(filmSpacePos.x, filmSpacePos.y))
+    if (!IsInTile(tileSpacePos))
         throw std::invalid_argument("Point is outside of this film tile");
 
-    return tileSpacePos.x + tileSpacePos.y * m_Rect.w;
+    return GetApronIndex(tileSpacePos);
 }
 
-const Pixel& FilmTile::GetTileSpacePixel(const Point2i& tileSpacePos) const
+Pixel FilmTile::GetTileSpacePixel(const Point2i& tileSpacePos) const
 {
-    return m_Pixels[GetIndex(tileSpacePos)];
+    return GetPixelAtIndex(GetIndex(tileSpacePos));
 }
 
-const Pixel& FilmTile::GetFilmSpacePixel(const Point2i& filmSpacePos) const
+Pixel FilmTile::GetPixelAtIndex(int index) const
+{
+    Pixel pixel(m_Pixels.GetXyz(index));
+    pixel.m_TotalSplat = m_Pixels.GetWeight(index);
+
+    if (HasSplatBuffer())
+    {
+        pixel.m_Xyz += m_SplatPixels.GetXyz(index);
+        pixel.m_TotalSplat += m_SplatPixels.GetWeight(index);
+    }
+
+    return pixel;
+}
+
+Pixel FilmTile::GetFilmSpacePixel(const Point2i& filmSpacePos) const
 {
     return GetTileSpacePixel(FilmToTileSpace(filmSpacePos));
 }
@@ -70,10 +93,280 @@ void FilmTile::SplatPixel(const Point2i& tileSpacePoint, const XyzCoefficients&
     if (deltaArea > 1.0 || deltaArea <= 0.0)
         throw std::invalid_argument("A greater than 1 or smaller than 0 deltaArea is invalid");
 
-    if (deltaArea + m_Pixels[GetIndex(tileSpacePoint)].m_TotalSplat > 1.0 + SMath::Epsilon)
+    int index = GetIndex(tileSpacePoint);
+
+    if (deltaArea + m_Pixels.GetWeight(index) > MaxTotalSplat)
+        throw std::invalid_argument("Total splat area for this pixel exceeds 1 given the current delta area");
+
+    m_Pixels.Add(index, xyz, deltaArea);
+}
+
+void FilmTile::AtomicSplatPixel(const Point2i& tileSpacePoint, const XyzCoefficients& xyz, double deltaArea)
+{
+    if (deltaArea > 1.0 || deltaArea <= 0.0)
+        throw std::invalid_argument("A greater than 1 or smaller than 0 deltaArea is invalid");
+
+    // The thread that owns the tile writes its pixels without atomics
+    if (!HasSplatBuffer())
+        throw std::runtime_error("Atomic splats need a splat buffer, see AllocateSplatBuffer");
+
+    int index = GetIndex(tileSpacePoint);
+
+    // Reserve the splat area first so that concurrent splats can never push the pixel past full coverage
+    if (!m_SplatPixels.AtomicReserveWeight(index, deltaArea, MaxTotalSplat))
         throw std::invalid_argument("Total splat area for this pixel exceeds 1 given the current delta area");
 
-    m_Pixels[GetIndex(tileSpacePoint)].m_Xyz += xyz * deltaArea;
-    m_Pixels[GetIndex(tileSpacePoint)].m_TotalSplat += deltaArea;
+    m_SplatPixels.AtomicAddXyz(index, xyz * deltaArea);
+}
+
+void FilmTile::AllocateSplatBuffer()
+{
+    if (!HasSplatBuffer())
+        m_SplatPixels.Allocate(m_Pixels.GetNumPixels());
+}
+
+void FilmTile::AllocateAovs(AovMask mask)
+{
+    if (mask == Aov::None)
+        m_Aovs.Release();
+    else if (IsResident())
+        m_Aovs.Allocate(GetStorageSize(), mask);
+}
+
+void FilmTile::AddAovSample(const Point2i& tileSpacePoint, const AovSample& sample)
+{
+    if (!IsInTile(tileSpacePoint))
+        throw std::invalid_argument("Pixel is outside of this film tile");
+
+    if (HasAovs())
+        m_Aovs.Add(GetApronIndex(tileSpacePoint), sample);
+}
+
+void FilmTile::ResolveAovScanline(int tileSpaceY, AovType type, float* row) const
+{
+    if (tileSpaceY < 0 || tileSpaceY >= m_Rect.h)
+        throw std::invalid_argument("Scanline is outside of this film tile");
+
+    if (!m_Aovs.Has(type))
+        throw std::invalid_argument("AOV is not enabled for this film tile");
+
+    const int numComponents = Aov::GetNumComponents(type);
+
+    for (ScanlineIterator it = GetScanline(tileSpaceY); it.IsValid(); ++it)
+        m_Aovs.Resolve(type, it.GetIndex(), row + it.GetX() * numComponents);
+}
+
+void FilmTile::AllocateVarianceBuffer()
+{
+    if (!HasVarianceBuffer())
+        m_Variance.Allocate(m_Rect.w * m_Rect.h);
+}
+
+double FilmTile::GetPixelVariance(const Point2i& tileSpacePos) const
+{
+    if (!IsInTile(tileSpacePos))
+        throw std::invalid_argument("Pixel is outside of this film tile");
+
+    if (!HasVarianceBuffer())
+        throw std::runtime_error("Film tile does not track variance");
+
+    return m_Variance.GetVariance(GetVarianceIndex(tileSpacePos));
+}
+
+double FilmTile::GetPixelError(const Point2i& tileSpacePos) const
+{
+    if (!IsInTile(tileSpacePos))
+        throw std::invalid_argument("Pixel is outside of this film tile");
+
+    if (!HasVarianceBuffer())
+        throw std::runtime_error("Film tile does not track variance");
+
+    return m_Variance.GetRelativeError(GetVarianceIndex(tileSpacePos));
+}
+
+double FilmTile::GetError() const
+{
+    if (!HasVarianceBuffer())
+        throw std::runtime_error("Film tile does not track variance");
+
+    double error = 0.0;
+
+    for (int i = 0; i < m_Variance.GetNumPixels(); ++i)
+        error = std::max(error, m_Variance.GetRelativeError(i));
+
+    return error;
+}
+
+void FilmTile::AddSample(const Point2& filmSpacePos, const XyzCoefficients& xyz, const FilterTable& filter)
+{
+    if (HasVarianceBuffer())
+    {
+        const Point2i pixel((int)std::floor(filmSpacePos.x) - m_Rect.x, (int)std::floor(filmSpacePos.y) - m_Rect.y);
+
+        if (IsInTile(pixel))
+            m_Variance.Add(GetVarianceIndex(pixel), xyz[1]);
+    }
+
+    // Pixel centers lie at half-integer coordinates
+    const double radius = filter.GetRadius();
+    const double sampleX = filmSpacePos.x - 0.5 - m_Rect.x;
+    const double sampleY = filmSpacePos.y - 0.5 - m_Rect.y;
+
+    const int x0 = std::max((int)std::floor(sampleX - radius) + 1, -m_Apron);
+    const int y0 = std::max((int)std::floor(sampleY - radius) + 1, -m_Apron);
+    const int x1 = std::min((int)std::ceil(sampleX + radius) - 1, m_Rect.w - 1 + m_Apron);
+    const int y1 = std::min((int)std::ceil(sampleY + radius) - 1, m_Rect.h - 1 + m_Apron);
+
+    for (int y = y0; y <= y1; ++y)
+    {
+        for (int x = x0; x <= x1; ++x)
+        {
+            double weight = filter.GetWeight({ x - sampleX, y - sampleY });
+            m_Pixels.Add(GetApronIndex({ x, y }), xyz, weight);
+        }
+    }
+}
+
+void FilmTile::MergeApron(const FilmTile& neighbor)
+{
+    if (&neighbor == this)
+        return;
+
+    // Only the part of the neighbor's apron that overlaps this tile contributes
+    const int x0 = std::max(m_Rect.x, neighbor.m_Rect.x - neighbor.m_Apron);
+    const int y0 = std::max(m_Rect.y, neighbor.m_Rect.y - neighbor.m_Apron);
+    const int x1 = std::min(m_Rect.x + m_Rect.w, neighbor.m_Rect.x + neighbor.m_Rect.w + neighbor.m_Apron);
+    const int y1 = std::min(m_Rect.y + m_Rect.h, neighbor.m_Rect.y + neighbor.m_Rect.h + neighbor.m_Apron);
+
+    for (int y = y0; y < y1; ++y)
+    {
+        for (int x = x0; x < x1; ++x)
+        {
+            int index = GetApronIndex(FilmToTileSpace({ x, y }));
+            int neighborIndex = neighbor.GetApronIndex(neighbor.FilmToTileSpace({ x, y }));
+            m_Pixels.Accumulate(index, neighbor.m_Pixels, neighborIndex);
+        }
+    }
 }
 
+void FilmTile::ClearApron()
+{
+    for (int y = -m_Apron; y < m_Rect.h + m_Apron; ++y)
+    {
+        for (int x = -m_Apron; x < m_Rect.w + m_Apron; ++x)
+        {
+            if (x < 0 || y < 0 || x >= m_Rect.w || y >= m_Rect.h)
+                m_Pixels.Clear(GetApronIndex({ x, y }));
+        }
+    }
+}
+
+void FilmTile::MakeResident()
+{
+    if (!IsResident())
+        m_Pixels.Allocate(GetStorageSize());
+}
+
+void FilmTile::Write(std::ostream& stream) const
+{
+    const int32_t header[6] = { m_Rect.x, m_Rect.y, m_Rect.w, m_Rect.h, m_Apron, (int32_t)m_Layout };
+    stream.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    m_Pixels.Write(stream);
+    m_SplatPixels.Write(stream);
+    m_Aovs.Write(stream);
+    m_Variance.Write(stream);
+}
+
+void FilmTile::Read(std::istream& stream)
+{
+    int32_t header[6] = {};
+    stream.read(reinterpret_cast<char*>(header), sizeof(header));
+
+    if (!stream.good())
+        throw std::runtime_error("Failed to read film tile");
+
+    if (header[0] != m_Rect.x || header[1] != m_Rect.y || header[2] != m_Rect.w || header[3] != m_Rect.h || header[4] != m_Apron || header[5] != (int32_t)m_Layout)
+        throw std::runtime_error("Film tile was written with a different layout");
+
+    m_Pixels.Read(stream);
+    m_SplatPixels.Read(stream);
+    m_Aovs.Read(stream);
+    m_Variance.Read(stream);
+
+    if ((m_Pixels.IsAllocated() && m_Pixels.GetNumPixels() != GetStorageSize()) || (HasVarianceBuffer() && m_Variance.GetNumPixels() != m_Rect.w * m_Rect.h))
+        throw std::runtime_error("Film tile was written with a different layout");
+}
+
+void FilmTile::ReadScanline(int tileSpaceY, PixelBuffer& scanline) const
+{
+    if (tileSpaceY < 0 || tileSpaceY >= m_Rect.h)
+        throw std::invalid_argument("Scanline is outside of this film tile");
+
+    if (scanline.GetNumPixels() < m_Rect.w)
+        scanline.Allocate(m_Rect.w);
+
+    for (int c = 0; c < PixelBuffer::NumChannels; ++c)
+    {
+        const PixelBuffer::Channel channel = (PixelBuffer::Channel)c;
+        const FilmChannel* pixels = m_Pixels.GetPlane(channel);
+        const FilmChannel* splatPixels = HasSplatBuffer() ? m_SplatPixels.GetPlane(channel) : nullptr;
+        FilmChannel* row = scanline.GetPlane(channel);
+
+        if (m_Layout == PixelLayout::RowMajor)
+        {
+            const int start = GetApronIndex({ 0, tileSpaceY });
+            std::copy(pixels + start, pixels + start + m_Rect.w, row);
+
+            if (splatPixels != nullptr)
+                for (int x = 0; x < m_Rect.w; ++x)
+                    row[x] += splatPixels[start + x];
+        }
+        else
+        {
+            for (ScanlineIterator it = GetScanline(tileSpaceY); it.IsValid(); ++it)
+                row[it.GetX()] = pixels[it.GetIndex()] + (splatPixels != nullptr ? splatPixels[it.GetIndex()] : 0);
+        }
+    }
+}
+
+int FilmTile::GetStorageSize() const
+{
+    const int height = m_Rect.h + 2 * m_Apron;
+
+    if (m_Layout == PixelLayout::RowMajor)
+        return GetStride() * height;
+
+    // Morton ordered storage is padded to whole blocks
+    const int numBlocksY = (height + BlockMask) / BlockSize;
+    return GetNumBlocksX() * numBlocksY * BlockSize * BlockSize;
+}
+
+void FilmTile::Release()
+{
+    m_Pixels.Release();
+    m_SplatPixels.Release();
+    m_Aovs.Release();
+    m_Variance.Release();
+}
+
+FilmTile::ScanlineIterator::ScanlineIterator(const FilmTile& tile, int tileSpaceY)
+    : m_Tile(tile)
+    , m_X(0)
+{
+    assert(tileSpaceY >= 0 && tileSpaceY < tile.m_Rect.h);
+
+    const int x = tile.m_Apron;
+    const int y = tileSpaceY + tile.m_Apron;
+
+    if (tile.m_Layout == PixelLayout::RowMajor)
+    {
+        m_BlockIndex = 0;
+        m_BlockOffset = x + y * tile.GetStride();
+    }
+    else
+    {
+        m_BlockIndex = ((x / BlockSize) + (y / BlockSize) * tile.GetNumBlocksX()) * BlockSize * BlockSize;
+        m_BlockOffset = Morton::Encode(x & BlockMask, y & BlockMask);
+    }
+}
@@ -19,32 +19,195 @@
 #pragma once
 
 #include "pixel.h"
+#include "pixelbuffer.h"
+#include "aovbuffer.h"
+#include "variancebuffer.h"
+#include "filter/filtertable.h"
+#include "morton.h"
+
+// Order of pixels within a tile's storage. Morton order keeps 2D neighborhoods such as
+// filter footprints within fewer cache lines; it is applied per block of BlockSize squared
+// pixels so that tiles whose sides are not powers of two waste little memory.
+enum class PixelLayout
+{
+    RowMajor,
+    Morton
+};
 
 class FilmTile
 {
 public:
-    FilmTile(const Point2i& pos, const Vector2i& size);
+    FilmTile(const Point2i& pos, const Vector2i& size, int apron = 0, bool isResident = true, PixelLayout layout = PixelLayout::RowMajor);
     ~FilmTile() = default;
 
+public:
+    // Walks one row of a tile from left to right in either pixel layout. Exporters should read
+    // tiles through this rather than through per-pixel lookups.
+    class ScanlineIterator
+    {
+    public:
+        ScanlineIterator(const FilmTile& tile, int tileSpaceY);
+
+    public:
+        inline bool IsValid() const { return m_X < m_Tile.m_Rect.w; }
+        inline int GetX() const { return m_X; }
+        inline int GetIndex() const { return m_BlockIndex + m_BlockOffset; }
+        inline Pixel operator*() const { return m_Tile.GetPixelAtIndex(GetIndex()); }
+
+        inline ScanlineIterator& operator++()
+        {
+            ++m_X;
+
+            if (m_Tile.m_Layout == PixelLayout::RowMajor)
+                ++m_BlockOffset;
+            else if (((m_X + m_Tile.m_Apron) & BlockMask) != 0)
+                m_BlockOffset = Morton::IncrementX(m_BlockOffset);
+            else
+            {
+                m_BlockIndex += BlockSize * BlockSize;
+                m_BlockOffset &= Morton::OddBits;
+            }
+
+            return *this;
+        }
+
+    private:
+        const FilmTile& m_Tile;
+        int m_X;
+        int m_BlockIndex;
+        uint32_t m_BlockOffset;
+    };
+
+public:
+    static constexpr int BlockSize = 8;
+    static constexpr int BlockMask = BlockSize - 1;
+
 public:
     inline Point2i GetPosition() const { return { m_Rect.x, m_Rect.y }; }
     inline Vector2i GetSize() const { return { m_Rect.w, m_Rect.h }; }
+    inline int GetApron() const { return m_Apron; }
+    inline PixelLayout GetLayout() const { return m_Layout; }
+    inline ScanlineIterator GetScanline(int tileSpaceY) const { return ScanlineIterator(*this, tileSpaceY); }
+    inline bool HasSplatBuffer() const { return m_SplatPixels.IsAllocated(); }
+    inline bool HasAovs() const { return m_Aovs.IsAllocated(); }
+    inline AovMask GetAovMask() const { return m_Aovs.GetMask(); }
+    inline bool HasVarianceBuffer() const { return m_Variance.IsAllocated(); }
+    inline bool IsResident() const { return m_Pixels.IsAllocated(); }
+    inline size_t GetMemoryUsage() const { return m_Pixels.GetMemoryUsage() + m_SplatPixels.GetMemoryUsage() + m_Aovs.GetMemoryUsage() + m_Variance.GetMemoryUsage(); }
+    inline bool IsInTile(const Point2i& tileSpacePos) const { return tileSpacePos.x >= 0 && tileSpacePos.y >= 0 && tileSpacePos.x < m_Rect.w && tileSpacePos.y < m_Rect.h; }
+
+public:
+    // Unchecked variants of SetPixel and SplatPixel for the render loop. Arguments are
+    // only validated by assertions in debug builds and coverage is not tracked.
+    inline void SetPixelUnchecked(const Point2i& tileSpacePoint, const XyzCoefficients& xyz)
+    {
+        SplatPixelUnchecked(tileSpacePoint, xyz, 1.0);
+    }
+
+    inline void SplatPixelUnchecked(const Point2i& tileSpacePoint, const XyzCoefficients& xyz, double deltaArea)
+    {
+        assert(IsInTile(tileSpacePoint));
+        assert(deltaArea > 0.0 && deltaArea <= 1.0);
+        m_Pixels.Add(GetApronIndex(tileSpacePoint), xyz, deltaArea);
+    }
+
+    // Mask must equal the AOV mask allocated for this tile, see AovBuffer::Add
+    template <AovMask Mask>
+    inline void AddAovSampleUnchecked(const Point2i& tileSpacePoint, const AovSample& sample)
+    {
+        assert(IsInTile(tileSpacePoint));
+        m_Aovs.Add<Mask>(GetApronIndex(tileSpacePoint), sample);
+    }
 
 public:
     Point2i TileToFilmSpace(const Point2i& tileSpacePos) const;
     Point2i FilmToTileSpace(const Point2i& filmSpacePos) const;
 
-    const Pixel& GetTileSpacePixel(const Point2i& tileSpacePos) const;
-    const Pixel& GetFilmSpacePixel(const Point2i& filmSpacePos) const;
+    Pixel GetTileSpacePixel(const Point2i& tileSpacePos) const;
+    Pixel GetFilmSpacePixel(const Point2i& filmSpacePos) const;
 
     void SetPixel(const Point2i& tileSpacePoint, const XyzCoefficients& xyz);
     void SplatPixel(const Point2i& tileSpacePoint, const XyzCoefficients& xyz, double deltaArea);
 
+    // Lock-free variant of SplatPixel that may be called concurrently for the same pixel,
+    // e.g. by light tracing or bidirectional integrators splatting into arbitrary tiles.
+    // Writes go to the separate splat buffer, which must be allocated, so that they never
+    // race with the thread that owns the tile and writes its pixels non-atomically.
+    // Coverage is therefore tracked per buffer: the owner's samples and the splats may each
+    // cover a pixel fully, since checking one against the other would read the owner's
+    // pixels while it writes them. Pixels are normalized by their combined weight.
+    void AtomicSplatPixel(const Point2i& tileSpacePoint, const XyzCoefficients& xyz, double deltaArea);
+
+    void AllocateSplatBuffer();
+
+    // AOV samples land in the pixel that contains them, tiles without AOVs ignore them
+    void AllocateAovs(AovMask mask);
+    void AddAovSample(const Point2i& tileSpacePoint, const AovSample& sample);
+
+    // Writes the resolved components of one row of an AOV to row, see AovBuffer::Resolve
+    void ResolveAovScanline(int tileSpaceY, AovType type, float* row) const;
+
+    // Tracks the luminance variance of the samples added to each pixel of the tile, counting
+    // each sample only in the pixel that contains it. Apron pixels are not tracked.
+    void AllocateVarianceBuffer();
+    double GetPixelVariance(const Point2i& tileSpacePos) const;
+
+    // Relative standard error of a pixel and the largest of any pixel in the tile, see
+    // VarianceBuffer::GetRelativeError
+    double GetPixelError(const Point2i& tileSpacePos) const;
+    double GetError() const;
+
+    // Copies one row of the tile into a scanline ordered buffer, including splat contributions.
+    // The buffer is grown to the tile width if needed so that it can be reused across tiles.
+    void ReadScanline(int tileSpaceY, PixelBuffer& scanline) const;
+
+    // Tiles of out-of-core films only hold pixel storage while they are being rendered
+    void MakeResident();
+    void Release();
+
+    // Binary copy of everything accumulated in the tile, including aprons, splats, AOVs and
+    // variance, for checkpoints. Reading requires a tile of the same position, size, apron
+    // and layout and replaces its contents.
+    void Write(std::ostream& stream) const;
+    void Read(std::istream& stream);
+
+    // Reconstructs a sample at a continuous film space position into every pixel under the
+    // filter's support. Pixels outside the tile land in its apron, so that neighboring tiles
+    // can be rendered in parallel without locks and merged afterwards with MergeApron.
+    void AddSample(const Point2& filmSpacePos, const XyzCoefficients& xyz, const FilterTable& filter);
+    void MergeApron(const FilmTile& neighbor);
+    void ClearApron();
+
 private:
     friend class FilmTileTest_CanGetIndex_Test;
     int GetIndex(const Point2i& tileSpacePos) const;
 
+    inline int GetStride() const { return m_Rect.w + 2 * m_Apron; }
+    inline int GetNumBlocksX() const { return (GetStride() + BlockMask) / BlockSize; }
+
+    inline int GetApronIndex(const Point2i& tileSpacePos) const
+    {
+        const int x = tileSpacePos.x + m_Apron;
+        const int y = tileSpacePos.y + m_Apron;
+
+        if (m_Layout == PixelLayout::RowMajor)
+            return x + y * GetStride();
+
+        const int blockIndex = (x / BlockSize) + (y / BlockSize) * GetNumBlocksX();
+        return blockIndex * BlockSize * BlockSize + Morton::Encode(x & BlockMask, y & BlockMask);
+    }
+
+    inline int GetVarianceIndex(const Point2i& tileSpacePos) const { return tileSpacePos.x + tileSpacePos.y * m_Rect.w; }
+
+    int GetStorageSize() const;
+    Pixel GetPixelAtIndex(int index) const;
+
 private:
     const SMath::Rect<int> m_Rect;
-    std::vector<Pixel> m_Pixels;
+    const int m_Apron;
+    const PixelLayout m_Layout;
+    PixelBuffer m_Pixels;
+    PixelBuffer m_SplatPixels;
+    AovBuffer m_Aovs;
+    VarianceBuffer m_Variance;
 };
\ No newline at end of file
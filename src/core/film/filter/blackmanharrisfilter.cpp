@@ -0,0 +1,44 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "blackmanharrisfilter.h"
+
+BlackmanHarrisFilter::BlackmanHarrisFilter(double radius)
+    : Filter(radius)
+{
+}
+
+double BlackmanHarrisFilter::Evaluate(const Vector2& offset) const
+{
+    return BlackmanHarris1D(offset.x) * BlackmanHarris1D(offset.y);
+}
+
+double BlackmanHarrisFilter::BlackmanHarris1D(double x) const
+{
+    const double a0 = 0.35875;
+    const double a1 = 0.48829;
+    const double a2 = 0.14128;
+    const double a3 = 0.01168;
+
+    // Map [-radius, radius] onto the window's [0, 1] domain
+    double t = 2.0 * SMath::Pi * (x / (2.0 * m_Radius) + 0.5);
+    return a0 - a1 * std::cos(t) + a2 * std::cos(2.0 * t) - a3 * std::cos(3.0 * t);
+}
+
@@ -0,0 +1,40 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+class Filter
+{
+public:
+    Filter(double radius);
+    virtual ~Filter() = default;
+
+public:
+    inline double GetRadius() const { return m_Radius; }
+
+public:
+    // Offset is measured from the pixel center, in pixels. Only offsets within
+    // the filter radius on both axes are ever evaluated.
+    virtual double Evaluate(const Vector2& offset) const = 0;
+
+protected:
+    const double m_Radius;
+};
+
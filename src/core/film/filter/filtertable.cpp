@@ -0,0 +1,39 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "filtertable.h"
+
+FilterTable::FilterTable(const Filter& filter)
+    : m_Radius(filter.GetRadius())
+    , m_InvRadius(1.0 / filter.GetRadius())
+    , m_Weights(TableSize * TableSize)
+{
+    // Sample the filter at the center of each table cell. Filters are symmetric
+    // so one quadrant is enough to reconstruct the whole support.
+    for (int y = 0; y < TableSize; ++y)
+    {
+        for (int x = 0; x < TableSize; ++x)
+        {
+            Vector2 offset((x + 0.5) * m_Radius / TableSize, (y + 0.5) * m_Radius / TableSize);
+            m_Weights[x + y * TableSize] = (float)filter.Evaluate(offset);
+        }
+    }
+}
+
@@ -0,0 +1,55 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "filter.h"
+
+// Precomputed weights of a filter over one quadrant of its support, so that
+// splatting a sample is a table lookup per pixel instead of a filter evaluation.
+class FilterTable
+{
+public:
+    FilterTable(const Filter& filter);
+    ~FilterTable() = default;
+
+public:
+    inline double GetRadius() const { return m_Radius; }
+
+    // Number of pixels a tile has to extend past its bounds to receive every
+    // contribution from samples that lie within the tile
+    inline int GetApron() const { return (int)std::ceil(m_Radius + 0.5) - 1; }
+
+    inline double GetWeight(const Vector2& offset) const
+    {
+        int x = std::min((int)(std::abs(offset.x) * m_InvRadius * TableSize), TableSize - 1);
+        int y = std::min((int)(std::abs(offset.y) * m_InvRadius * TableSize), TableSize - 1);
+        return m_Weights[x + y * TableSize];
+    }
+
+public:
+    static constexpr int TableSize = 32;
+
+private:
+    double m_Radius;
+    double m_InvRadius;
+    std::vector<float> m_Weights;
+};
+
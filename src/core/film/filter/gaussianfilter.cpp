@@ -0,0 +1,40 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gaussianfilter.h"
+
+GaussianFilter::GaussianFilter(double radius, double alpha)
+    : Filter(radius)
+    , m_Alpha(alpha)
+    , m_EdgeValue(std::exp(-alpha * radius * radius))
+{
+}
+
+double GaussianFilter::Evaluate(const Vector2& offset) const
+{
+    return Gaussian(offset.x) * Gaussian(offset.y);
+}
+
+double GaussianFilter::Gaussian(double d) const
+{
+    // Offset by the value at the radius so that the filter falls off to zero at its edge
+    return std::max(0.0, std::exp(-m_Alpha * d * d) - m_EdgeValue);
+}
+
@@ -0,0 +1,48 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "mitchellfilter.h"
+
+MitchellFilter::MitchellFilter(double radius, double b, double c)
+    : Filter(radius)
+    , m_B(b)
+    , m_C(c)
+{
+}
+
+double MitchellFilter::Evaluate(const Vector2& offset) const
+{
+    return Mitchell1D(offset.x / m_Radius) * Mitchell1D(offset.y / m_Radius);
+}
+
+double MitchellFilter::Mitchell1D(double x) const
+{
+    const double& B = m_B;
+    const double& C = m_C;
+
+    // The cubic is defined over [-2, 2]
+    x = std::abs(2.0 * x);
+
+    if (x > 1.0)
+        return ((-B - 6 * C) * x * x * x + (6 * B + 30 * C) * x * x + (-12 * B - 48 * C) * x + (8 * B + 24 * C)) / 6.0;
+
+    return ((12 - 9 * B - 6 * C) * x * x * x + (-18 + 12 * B + 6 * C) * x * x + (6 - 2 * B)) / 6.0;
+}
+
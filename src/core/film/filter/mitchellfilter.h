@@ -0,0 +1,43 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "filter.h"
+
+// Mitchell-Netravali (1988) cubic filter. The default B = C = 1/3 is the
+// parameterization recommended by the paper.
+class MitchellFilter : public Filter
+{
+public:
+    MitchellFilter(double radius = 2.0, double b = 1.0 / 3.0, double c = 1.0 / 3.0);
+    ~MitchellFilter() override = default;
+
+public:
+    double Evaluate(const Vector2& offset) const override;
+
+private:
+    double Mitchell1D(double x) const;
+
+private:
+    const double m_B;
+    const double m_C;
+};
+
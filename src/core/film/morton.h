@@ -0,0 +1,83 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#ifdef SPC_USE_BMI_2
+#include <immintrin.h>
+#endif
+
+// Morton (Z-order) codes interleave the bits of two coordinates, x in the even bits and y in
+// the odd bits, so that pixels that are close in 2D are also close in memory.
+namespace Morton
+{
+    constexpr uint32_t EvenBits = 0x55555555;
+    constexpr uint32_t OddBits = 0xAAAAAAAA;
+
+    inline uint32_t SpreadBits(uint32_t v)
+    {
+#ifdef SPC_USE_BMI_2
+        return _pdep_u32(v, EvenBits);
+#else
+        v &= 0x0000ffff;
+        v = (v | (v << 8)) & 0x00ff00ff;
+        v = (v | (v << 4)) & 0x0f0f0f0f;
+        v = (v | (v << 2)) & 0x33333333;
+        v = (v | (v << 1)) & 0x55555555;
+        return v;
+#endif
+    }
+
+    inline uint32_t CompactBits(uint32_t v)
+    {
+#ifdef SPC_USE_BMI_2
+        return _pext_u32(v, EvenBits);
+#else
+        v &= 0x55555555;
+        v = (v | (v >> 1)) & 0x33333333;
+        v = (v | (v >> 2)) & 0x0f0f0f0f;
+        v = (v | (v >> 4)) & 0x00ff00ff;
+        v = (v | (v >> 8)) & 0x0000ffff;
+        return v;
+#endif
+    }
+
+    inline uint32_t Encode(uint32_t x, uint32_t y)
+    {
+        return SpreadBits(x) | (SpreadBits(y) << 1);
+    }
+
+    inline uint32_t DecodeX(uint32_t code)
+    {
+        return CompactBits(code);
+    }
+
+    inline uint32_t DecodeY(uint32_t code)
+    {
+        return CompactBits(code >> 1);
+    }
+
+    // Steps a code to its neighbor at x + 1 without decoding it
+    inline uint32_t IncrementX(uint32_t code)
+    {
+        return (((code | OddBits) + 1) & EvenBits) | (code & OddBits);
+    }
+}
+
@@ -0,0 +1,101 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <istream>
+#include <ostream>
+#include "pixelbuffer.h"
+
+PixelBuffer::PixelBuffer(int numPixels)
+{
+    Allocate(numPixels);
+}
+
+void PixelBuffer::Allocate(int numPixels)
+{
+    m_NumPixels = numPixels;
+    m_Data.assign(NumChannels * (size_t)numPixels, 0);
+}
+
+void PixelBuffer::Release()
+{
+    m_NumPixels = 0;
+    m_Data.clear();
+    m_Data.shrink_to_fit();
+}
+
+void PixelBuffer::Write(std::ostream& stream) const
+{
+    const int32_t numPixels = m_NumPixels;
+    stream.write(reinterpret_cast<const char*>(&numPixels), sizeof(numPixels));
+    stream.write(reinterpret_cast<const char*>(m_Data.data()), m_Data.size() * sizeof(FilmChannel));
+}
+
+void PixelBuffer::Read(std::istream& stream)
+{
+    int32_t numPixels = 0;
+    stream.read(reinterpret_cast<char*>(&numPixels), sizeof(numPixels));
+
+    if (!stream.good() || numPixels < 0)
+        throw std::runtime_error("Failed to read pixel buffer");
+
+    if (numPixels == 0)
+        Release();
+    else
+        Allocate(numPixels);
+
+    stream.read(reinterpret_cast<char*>(m_Data.data()), m_Data.size() * sizeof(FilmChannel));
+
+    if (!stream.good())
+        throw std::runtime_error("Failed to read pixel buffer");
+}
+
+void PixelBuffer::Accumulate(int index, const PixelBuffer& other, int otherIndex)
+{
+    for (int c = 0; c < NumChannels; ++c)
+        GetPlane((Channel)c)[index] += other.GetPlane((Channel)c)[otherIndex];
+}
+
+void PixelBuffer::Clear(int index)
+{
+    for (int c = 0; c < NumChannels; ++c)
+        GetPlane((Channel)c)[index] = 0;
+}
+
+bool PixelBuffer::AtomicReserveWeight(int index, double weight, double maxTotalWeight)
+{
+    std::atomic_ref<FilmChannel> totalWeight(GetPlane(Weight)[index]);
+    FilmChannel currentWeight = totalWeight.load(std::memory_order_relaxed);
+
+    do
+    {
+        if (currentWeight + weight > maxTotalWeight)
+            return false;
+    } while (!totalWeight.compare_exchange_weak(currentWeight, (FilmChannel)(currentWeight + weight), std::memory_order_relaxed));
+
+    return true;
+}
+
+void PixelBuffer::AtomicAddXyz(int index, const XyzCoefficients& xyz)
+{
+    std::atomic_ref<FilmChannel>(GetPlane(X)[index]).fetch_add((FilmChannel)xyz[0], std::memory_order_relaxed);
+    std::atomic_ref<FilmChannel>(GetPlane(Y)[index]).fetch_add((FilmChannel)xyz[1], std::memory_order_relaxed);
+    std::atomic_ref<FilmChannel>(GetPlane(Z)[index]).fetch_add((FilmChannel)xyz[2], std::memory_order_relaxed);
+}
+
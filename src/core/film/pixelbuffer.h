@@ -0,0 +1,90 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <iosfwd>
+
+#ifdef SPC_USE_DOUBLE_PRECISION_FILM
+typedef double FilmChannel;
+#else
+typedef float FilmChannel;
+#endif
+
+// Structure-of-arrays pixel storage. Each channel is kept in its own contiguous plane
+// so that accumulation and extraction can be vectorized across neighboring pixels.
+class PixelBuffer
+{
+public:
+    enum Channel
+    {
+        X,
+        Y,
+        Z,
+        Weight,
+        NumChannels
+    };
+
+public:
+    PixelBuffer() = default;
+    PixelBuffer(int numPixels);
+    ~PixelBuffer() = default;
+
+public:
+    inline int GetNumPixels() const { return m_NumPixels; }
+    inline bool IsAllocated() const { return m_NumPixels > 0; }
+    inline size_t GetMemoryUsage() const { return m_Data.size() * sizeof(FilmChannel); }
+
+    inline FilmChannel* GetPlane(Channel channel) { return m_Data.data() + channel * (size_t)m_NumPixels; }
+    inline const FilmChannel* GetPlane(Channel channel) const { return m_Data.data() + channel * (size_t)m_NumPixels; }
+
+    inline XyzCoefficients GetXyz(int index) const { return { GetPlane(X)[index], GetPlane(Y)[index], GetPlane(Z)[index] }; }
+    inline double GetWeight(int index) const { return GetPlane(Weight)[index]; }
+
+public:
+    inline void Add(int index, const XyzCoefficients& xyz, double weight)
+    {
+        GetPlane(X)[index] += (FilmChannel)(xyz[0] * weight);
+        GetPlane(Y)[index] += (FilmChannel)(xyz[1] * weight);
+        GetPlane(Z)[index] += (FilmChannel)(xyz[2] * weight);
+        GetPlane(Weight)[index] += (FilmChannel)weight;
+    }
+
+public:
+    void Allocate(int numPixels);
+    void Release();
+
+    // Raw binary copies of the buffer for checkpoints. Read replaces the contents.
+    void Write(std::ostream& stream) const;
+    void Read(std::istream& stream);
+
+    void Accumulate(int index, const PixelBuffer& other, int otherIndex);
+    void Clear(int index);
+
+    // Lock-free accumulation for pixels that may be written from several threads at once.
+    // The weight is reserved separately so callers can reject contributions that would overflow it.
+    bool AtomicReserveWeight(int index, double weight, double maxTotalWeight);
+    void AtomicAddXyz(int index, const XyzCoefficients& xyz);
+
+private:
+    int m_NumPixels = 0;
+    std::vector<FilmChannel> m_Data;
+};
+
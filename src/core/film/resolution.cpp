@@ -22,8 +22,6 @@
 
 constexpr int DefaultWidth = 800;
 constexpr int DefaultHeight = 480;
-constexpr int MaxWidth = 3840;
-constexpr int MaxHeight = 2160;
 
 Resolution::Resolution()
     : m_Width(DefaultWidth)
@@ -43,7 +41,7 @@ bool Resolution::operator!=(const Resolution& resolution) const
 
 void Resolution::SetWidth(int width)
 {
-    if (width > MaxWidth || width <= 0)
+    if (width <= 0)
         throw std::invalid_argument("Film width is invalid");
 
     m_Width = width;
@@ -51,7 +49,7 @@ void Resolution::SetWidth(int width)
 
 void Resolution::SetHeight(int height)
 {
-    if (height > MaxHeight || height <= 0)
+    if (height <= 0)
         throw std::invalid_argument("Film height is invalid");
 
     m_Height = height;
@@ -33,7 +33,7 @@ public:
 public:
     inline int GetWidth() const { return m_Width; }
     inline int GetHeight() const { return m_Height; }
-    inline int GetArea() const { return m_Width * m_Height; }
+    inline int64_t GetArea() const { return (int64_t)m_Width * m_Height; }
 
 public:
     void SetWidth(int width);
@@ -0,0 +1,158 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tileorder.h"
+
+std::vector<int> TileOrdering::Generate(TileOrder order, int numTilesX, int numTilesY)
+{
+    switch (order)
+    {
+    case TileOrder::Spiral:
+        return GenerateSpiral(numTilesX, numTilesY);
+    case TileOrder::Hilbert:
+        return GenerateHilbert(numTilesX, numTilesY);
+    case TileOrder::Morton:
+        return GenerateMorton(numTilesX, numTilesY);
+    case TileOrder::Scanline:
+    default:
+        return GenerateScanline(numTilesX, numTilesY);
+    }
+}
+
+std::vector<int> TileOrdering::GenerateScanline(int numTilesX, int numTilesY)
+{
+    std::vector<int> order(numTilesX * numTilesY);
+
+    for (int i = 0; i < (int)order.size(); ++i)
+        order[i] = i;
+
+    return order;
+}
+
+std::vector<int> TileOrdering::GenerateSpiral(int numTilesX, int numTilesY)
+{
+    std::vector<int> order;
+    order.reserve(numTilesX * numTilesY);
+
+    // Walk a square spiral outwards from the center tile, skipping steps that fall off the film
+    int x = (numTilesX - 1) / 2;
+    int y = (numTilesY - 1) / 2;
+    int dx = 1;
+    int dy = 0;
+
+    for (int legLength = 1; (int)order.size() < numTilesX * numTilesY; ++legLength)
+    {
+        // Every leg length is walked twice, turning after each leg
+        for (int leg = 0; leg < 2; ++leg)
+        {
+            for (int step = 0; step < legLength; ++step)
+            {
+                if (x >= 0 && x < numTilesX && y >= 0 && y < numTilesY)
+                    order.push_back(x + y * numTilesX);
+
+                x += dx;
+                y += dy;
+            }
+
+            int turn = dx;
+            dx = -dy;
+            dy = turn;
+        }
+    }
+
+    return order;
+}
+
+static int GetCurveSize(int numTilesX, int numTilesY)
+{
+    int size = 1;
+
+    while (size < numTilesX || size < numTilesY)
+        size <<= 1;
+
+    return size;
+}
+
+std::vector<int> TileOrdering::GenerateHilbert(int numTilesX, int numTilesY)
+{
+    std::vector<int> order;
+    order.reserve(numTilesX * numTilesY);
+
+    // Traverse the Hilbert curve of the enclosing power of two square and drop tiles outside the film
+    const int curveSize = GetCurveSize(numTilesX, numTilesY);
+
+    for (int d = 0; d < curveSize * curveSize; ++d)
+    {
+        int x = 0;
+        int y = 0;
+
+        for (int s = 1, t = d; s < curveSize; s <<= 1, t >>= 2)
+        {
+            int rx = 1 & (t >> 1);
+            int ry = 1 & (t ^ rx);
+
+            if (ry == 0)
+            {
+                if (rx == 1)
+                {
+                    x = s - 1 - x;
+                    y = s - 1 - y;
+                }
+
+                std::swap(x, y);
+            }
+
+            x += s * rx;
+            y += s * ry;
+        }
+
+        if (x < numTilesX && y < numTilesY)
+            order.push_back(x + y * numTilesX);
+    }
+
+    return order;
+}
+
+std::vector<int> TileOrdering::GenerateMorton(int numTilesX, int numTilesY)
+{
+    std::vector<int> order;
+    order.reserve(numTilesX * numTilesY);
+
+    const int curveSize = GetCurveSize(numTilesX, numTilesY);
+
+    for (int d = 0; d < curveSize * curveSize; ++d)
+    {
+        int x = 0;
+        int y = 0;
+
+        // Even bits of the curve index hold x and odd bits hold y
+        for (int bit = 0; (1 << bit) < curveSize; ++bit)
+        {
+            x |= ((d >> (2 * bit)) & 1) << bit;
+            y |= ((d >> (2 * bit + 1)) & 1) << bit;
+        }
+
+        if (x < numTilesX && y < numTilesY)
+            order.push_back(x + y * numTilesX);
+    }
+
+    return order;
+}
+
@@ -0,0 +1,45 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+// Order in which the tiles of a film are handed to the scheduler. Curve based orders keep
+// tiles that run at the same time next to each other on screen, so that concurrent threads
+// tend to touch the same BVH nodes and texels.
+enum class TileOrder
+{
+    Scanline,
+    Spiral,
+    Hilbert,
+    Morton
+};
+
+namespace TileOrdering
+{
+    // Each function returns every tile index of a numTilesX by numTilesY grid exactly once,
+    // in the order the tiles should be rendered. Indices are row major.
+    std::vector<int> Generate(TileOrder order, int numTilesX, int numTilesY);
+
+    std::vector<int> GenerateScanline(int numTilesX, int numTilesY);
+    std::vector<int> GenerateSpiral(int numTilesX, int numTilesY);
+    std::vector<int> GenerateHilbert(int numTilesX, int numTilesY);
+    std::vector<int> GenerateMorton(int numTilesX, int numTilesY);
+}
+
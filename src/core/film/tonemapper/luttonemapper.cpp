@@ -0,0 +1,67 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "luttonemapper.h"
+
+LutTonemapper::LutTonemapper(Tonemapper& tonemapper, double maxValue, int size)
+    : m_MaxValue(maxValue)
+    , m_InvMaxValue(1.0 / maxValue)
+    , m_LastIndex(size - 1)
+{
+    if (maxValue <= 0.0)
+        throw std::invalid_argument("Tonemapper lookup table range must be positive");
+
+    if (size < 2)
+        throw std::invalid_argument("Tonemapper lookup table needs at least two entries");
+
+    std::vector<RgbCoefficients> inputs(size);
+
+    for (int i = 0; i < size; ++i)
+    {
+        double t = (double)i / m_LastIndex;
+        inputs[i] = RgbCoefficients(t * t * maxValue);
+    }
+
+    std::vector<RgbCoefficients> outputs(size);
+    tonemapper.ApplyTonemap(inputs, outputs);
+
+    m_Table.resize(size);
+
+    for (int i = 0; i < size; ++i)
+        m_Table[i] = outputs[i][0];
+}
+
+RgbCoefficients LutTonemapper::ApplyTonemap(const RgbCoefficients& linearSpaceColor)
+{
+    return { Lookup(linearSpaceColor[0]), Lookup(linearSpaceColor[1]), Lookup(linearSpaceColor[2]) };
+}
+
+void LutTonemapper::ApplyTonemap(std::span<const RgbCoefficients> linearSpaceColors, std::span<RgbCoefficients> tonemappedColors)
+{
+    ValidateBatch(linearSpaceColors, tonemappedColors);
+
+    const double* in = reinterpret_cast<const double*>(linearSpaceColors.data());
+    double* out = reinterpret_cast<double*>(tonemappedColors.data());
+    const size_t numChannels = linearSpaceColors.size() * 3;
+
+    for (size_t i = 0; i < numChannels; ++i)
+        out[i] = Lookup(in[i]);
+}
+
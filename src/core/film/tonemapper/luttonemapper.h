@@ -0,0 +1,58 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "tonemapper.h"
+
+// Bakes the curve of another tonemapper, gamma correction included, into a 1D lookup table.
+// The table is indexed by the square root of the input to spend its precision on the shadows,
+// and inputs outside of [0, maxValue] are clamped. The tonemappers in Spectre act on every
+// channel independently and identically, so a single 1D table reproduces them up to
+// interpolation error.
+class LutTonemapper : public Tonemapper
+{
+public:
+    LutTonemapper(Tonemapper& tonemapper, double maxValue = 64.0, int size = 4096);
+    ~LutTonemapper() = default;
+
+public:
+    inline double GetMaxValue() const { return m_MaxValue; }
+    inline int GetSize() const { return (int)m_Table.size(); }
+
+public:
+    RgbCoefficients ApplyTonemap(const RgbCoefficients& linearSpaceColor) override;
+    void ApplyTonemap(std::span<const RgbCoefficients> linearSpaceColors, std::span<RgbCoefficients> tonemappedColors) override;
+
+private:
+    inline double Lookup(double linearValue) const
+    {
+        const double t = std::sqrt(std::clamp(linearValue * m_InvMaxValue, 0.0, 1.0)) * m_LastIndex;
+        const int index = std::min((int)t, m_LastIndex - 1);
+        return m_Table[index] + (m_Table[index + 1] - m_Table[index]) * (t - index);
+    }
+
+private:
+    const double m_MaxValue;
+    const double m_InvMaxValue;
+    const int m_LastIndex;
+    std::vector<double> m_Table;
+};
+
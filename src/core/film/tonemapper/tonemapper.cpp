@@ -20,7 +20,34 @@
 
 #include "tonemapper.h"
 
+static_assert(sizeof(RgbCoefficients) == 3 * sizeof(double), "Batches are processed as flat arrays of channels");
+
 RgbCoefficients Tonemapper::ApplyGammaCorrection(const RgbCoefficients& tonemappedColor, double gamma)
 {
     return tonemappedColor ^ (1.0 / gamma);
 }
+
+void Tonemapper::ApplyTonemap(std::span<const RgbCoefficients> linearSpaceColors, std::span<RgbCoefficients> tonemappedColors)
+{
+    ValidateBatch(linearSpaceColors, tonemappedColors);
+
+    for (size_t i = 0; i < linearSpaceColors.size(); ++i)
+        tonemappedColors[i] = ApplyTonemap(linearSpaceColors[i]);
+}
+
+void Tonemapper::ApplyGammaCorrection(std::span<RgbCoefficients> tonemappedColors, double gamma)
+{
+    // Channels are independent, so the batch is processed as one flat array
+    double* channels = reinterpret_cast<double*>(tonemappedColors.data());
+    const size_t numChannels = tonemappedColors.size() * 3;
+    const double invGamma = 1.0 / gamma;
+
+    for (size_t i = 0; i < numChannels; ++i)
+        channels[i] = std::pow(channels[i], invGamma);
+}
+
+void Tonemapper::ValidateBatch(std::span<const RgbCoefficients> linearSpaceColors, std::span<RgbCoefficients> tonemappedColors)
+{
+    if (linearSpaceColors.size() != tonemappedColors.size())
+        throw std::invalid_argument("Tonemapper input and output batches differ in size");
+}
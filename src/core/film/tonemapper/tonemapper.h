@@ -25,9 +25,17 @@ class Tonemapper
 public:
     virtual RgbCoefficients ApplyTonemap(const RgbCoefficients& linearSpaceColor) = 0;
 
+    // Tonemaps a batch of colors at once, e.g. a scanline during export. The default
+    // implementation calls the per color overload, tonemappers should override it with
+    // a loop the compiler can vectorize. Both spans may refer to the same colors.
+    virtual void ApplyTonemap(std::span<const RgbCoefficients> linearSpaceColors, std::span<RgbCoefficients> tonemappedColors);
+
 protected:
     friend class TonemapperTest_CanApplyGammaCorrection_Test;
 
     RgbCoefficients ApplyGammaCorrection(const RgbCoefficients& tonemappedColor, double gamma = 2.2);
+    void ApplyGammaCorrection(std::span<RgbCoefficients> tonemappedColors, double gamma = 2.2);
+
+    static void ValidateBatch(std::span<const RgbCoefficients> linearSpaceColors, std::span<RgbCoefficients> tonemappedColors);
 };
 
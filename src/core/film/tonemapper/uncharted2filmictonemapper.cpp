@@ -27,7 +27,8 @@ Uncharted2FilmicTonemapper::Uncharted2FilmicTonemapper(
     double lAngle,
     double tAmt,
     double tNum,
-    double tDenom)
+    double tDenom,
+    double exposure)
     : m_ShoulderStrength(sAmt)
     , m_LinearStrength(lAmt)
     , m_LinearAngle(lAngle)
@@ -35,16 +36,60 @@ Uncharted2FilmicTonemapper::Uncharted2FilmicTonemapper(
     , m_ToeNumerator(tNum)
     , m_ToeDenominator(tDenom)
     , m_WhitePoint(whitePoint)
+    , m_Exposure(exposure)
 {
+    PrecomputeCoefficients();
+}
+
+void Uncharted2FilmicTonemapper::SetExposure(double exposure)
+{
+    m_Exposure = exposure;
+    PrecomputeCoefficients();
 }
 
 RgbCoefficients Uncharted2FilmicTonemapper::ApplyTonemap(const RgbCoefficients& linearSpaceColor)
 {
-    RgbCoefficients col = FilmicCurve(linearSpaceColor);
-    col *= RgbCoefficients(1.0) / FilmicCurve(m_WhitePoint);
+    RgbCoefficients col = { EvaluateCurve(linearSpaceColor[0]), EvaluateCurve(linearSpaceColor[1]), EvaluateCurve(linearSpaceColor[2]) };
     return ApplyGammaCorrection(col);
 }
 
+void Uncharted2FilmicTonemapper::ApplyTonemap(std::span<const RgbCoefficients> linearSpaceColors, std::span<RgbCoefficients> tonemappedColors)
+{
+    ValidateBatch(linearSpaceColors, tonemappedColors);
+
+    // The curve is applied per channel, so the batch is processed as one flat array
+    const double* in = reinterpret_cast<const double*>(linearSpaceColors.data());
+    double* out = reinterpret_cast<double*>(tonemappedColors.data());
+    const size_t numChannels = linearSpaceColors.size() * 3;
+
+    for (size_t i = 0; i < numChannels; ++i)
+        out[i] = EvaluateCurve(in[i]);
+
+    ApplyGammaCorrection(tonemappedColors);
+}
+
+void Uncharted2FilmicTonemapper::PrecomputeCoefficients()
+{
+    const double& A = m_ShoulderStrength;
+    const double& B = m_LinearStrength;
+    const double& C = m_LinearAngle;
+    const double& D = m_ToeStrength;
+    const double& E = m_ToeNumerator;
+    const double& F = m_ToeDenominator;
+
+    // Subtracting E / F from the curve cancels its constant term, which leaves
+    // x * (x * A * (1 - E / F) + B * (C - E / F)) / (x * (x * A + B) + D * F).
+    // Exposure scales x and the white scale is folded into the numerator.
+    const double whiteScale = 1.0 / FilmicCurve(m_WhitePoint)[0];
+    const double exposure2 = m_Exposure * m_Exposure;
+
+    m_Numerator2 = A * (1.0 - E / F) * exposure2 * whiteScale;
+    m_Numerator1 = B * (C - E / F) * m_Exposure * whiteScale;
+    m_Denominator2 = A * exposure2;
+    m_Denominator1 = B * m_Exposure;
+    m_Denominator0 = D * F;
+}
+
 RgbCoefficients Uncharted2FilmicTonemapper::FilmicCurve(const RgbCoefficients& x)
 {
     const double& A = m_ShoulderStrength;
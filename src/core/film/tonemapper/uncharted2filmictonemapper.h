@@ -34,17 +34,31 @@ public:
         double lAngle = 0.10,
         double tAmt = 0.20,
         double tNum = 0.02,
-        double tDenom = 0.30
+        double tDenom = 0.30,
+        double exposure = 1.0
     );
 
 public:
+    inline double GetExposure() const { return m_Exposure; }
+
+public:
+    void SetExposure(double exposure);
+
     RgbCoefficients ApplyTonemap(const RgbCoefficients& linearSpaceColor) override;
+    void ApplyTonemap(std::span<const RgbCoefficients> linearSpaceColors, std::span<RgbCoefficients> tonemappedColors) override;
 
 private:
     friend class Uncharted2FilmicTonemapperTest_FilmicCurveValues0To1_Test;
     friend class Uncharted2FilmicTonemapperTest_Values0To1AfterTonemapping_Test;
+    friend class Uncharted2FilmicTonemapperTest_MatchesFilmicCurve_Test;
 
     RgbCoefficients FilmicCurve(const RgbCoefficients& x);
+    void PrecomputeCoefficients();
+
+    inline double EvaluateCurve(double x) const
+    {
+        return (x * (x * m_Numerator2 + m_Numerator1)) / (x * (x * m_Denominator2 + m_Denominator1) + m_Denominator0);
+    }
 
 private:
     const double m_WhitePoint;
@@ -54,5 +68,13 @@ private:
     const double m_ToeStrength;
     const double m_ToeNumerator;
     const double m_ToeDenominator;
+    double m_Exposure;
+
+    // The filmic curve, exposure and white scale folded into a single rational function
+    double m_Numerator2;
+    double m_Numerator1;
+    double m_Denominator2;
+    double m_Denominator1;
+    double m_Denominator0;
 };
 
@@ -0,0 +1,88 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <istream>
+#include <ostream>
+#include "variancebuffer.h"
+
+VarianceBuffer::VarianceBuffer(int numPixels)
+{
+    Allocate(numPixels);
+}
+
+void VarianceBuffer::Allocate(int numPixels)
+{
+    if (numPixels < 0)
+        throw std::invalid_argument("Variance buffer cannot have a negative size");
+
+    m_Counts.assign(numPixels, 0);
+    m_Means.assign(numPixels, 0.0);
+    m_M2.assign(numPixels, 0.0);
+}
+
+void VarianceBuffer::Release()
+{
+    m_Counts.clear();
+    m_Counts.shrink_to_fit();
+    m_Means.clear();
+    m_Means.shrink_to_fit();
+    m_M2.clear();
+    m_M2.shrink_to_fit();
+}
+
+void VarianceBuffer::Write(std::ostream& stream) const
+{
+    const int32_t numPixels = GetNumPixels();
+    stream.write(reinterpret_cast<const char*>(&numPixels), sizeof(numPixels));
+    stream.write(reinterpret_cast<const char*>(m_Counts.data()), m_Counts.size() * sizeof(uint32_t));
+    stream.write(reinterpret_cast<const char*>(m_Means.data()), m_Means.size() * sizeof(double));
+    stream.write(reinterpret_cast<const char*>(m_M2.data()), m_M2.size() * sizeof(double));
+}
+
+void VarianceBuffer::Read(std::istream& stream)
+{
+    int32_t numPixels = 0;
+    stream.read(reinterpret_cast<char*>(&numPixels), sizeof(numPixels));
+
+    if (!stream.good() || numPixels < 0)
+        throw std::runtime_error("Failed to read variance buffer");
+
+    if (numPixels == 0)
+        Release();
+    else
+        Allocate(numPixels);
+
+    stream.read(reinterpret_cast<char*>(m_Counts.data()), m_Counts.size() * sizeof(uint32_t));
+    stream.read(reinterpret_cast<char*>(m_Means.data()), m_Means.size() * sizeof(double));
+    stream.read(reinterpret_cast<char*>(m_M2.data()), m_M2.size() * sizeof(double));
+
+    if (!stream.good())
+        throw std::runtime_error("Failed to read variance buffer");
+}
+
+double VarianceBuffer::GetRelativeError(int index) const
+{
+    if (m_Counts[index] < 2)
+        return std::numeric_limits<double>::infinity();
+
+    const double standardError = std::sqrt(GetVariance(index) / m_Counts[index]);
+    return standardError / std::max(std::abs(m_Means[index]), MinLuminance);
+}
+
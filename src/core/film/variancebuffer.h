@@ -0,0 +1,78 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <iosfwd>
+
+// Running mean and variance of the luminance of the samples taken in each pixel, updated
+// with Welford's algorithm so that the variance is estimated in a single pass without the
+// cancellation of summing squares. Adaptive sampling uses it to decide which tiles still
+// need samples. Values are kept in double precision regardless of the film precision since
+// the squared deviations span a much larger range than the pixels themselves.
+class VarianceBuffer
+{
+public:
+    VarianceBuffer() = default;
+    VarianceBuffer(int numPixels);
+    ~VarianceBuffer() = default;
+
+public:
+    // Dark pixels are measured against this luminance rather than their own mean, so that
+    // noise too faint to see does not keep demanding samples
+    static constexpr double MinLuminance = 1e-2;
+
+public:
+    inline int GetNumPixels() const { return (int)m_Counts.size(); }
+    inline bool IsAllocated() const { return !m_Counts.empty(); }
+    inline size_t GetMemoryUsage() const { return m_Counts.size() * sizeof(uint32_t) + (m_Means.size() + m_M2.size()) * sizeof(double); }
+
+    inline uint32_t GetCount(int index) const { return m_Counts[index]; }
+    inline double GetMean(int index) const { return m_Means[index]; }
+
+    // Unbiased sample variance, zero until the pixel has two samples
+    inline double GetVariance(int index) const { return m_Counts[index] > 1 ? m_M2[index] / (m_Counts[index] - 1) : 0.0; }
+
+    inline void Add(int index, double value)
+    {
+        const uint32_t count = ++m_Counts[index];
+        const double delta = value - m_Means[index];
+        m_Means[index] += delta / count;
+        m_M2[index] += delta * (value - m_Means[index]);
+    }
+
+public:
+    void Allocate(int numPixels);
+    void Release();
+
+    // Raw binary copies of the buffer for checkpoints. Read replaces the contents.
+    void Write(std::ostream& stream) const;
+    void Read(std::istream& stream);
+
+    // Standard error of the pixel mean relative to the mean. Pixels with fewer than two
+    // samples have no variance estimate yet and report an infinite error.
+    double GetRelativeError(int index) const;
+
+private:
+    std::vector<uint32_t> m_Counts;
+    std::vector<double> m_Means;
+    std::vector<double> m_M2;
+};
+
@@ -0,0 +1,306 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "animatedtransform.h"
+
+namespace
+{
+    typedef double Matrix3[3][3];
+
+    void Multiply(const Matrix3& a, const Matrix3& b, Matrix3& result)
+    {
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j)
+                result[i][j] = a[i][0] * b[0][j] + a[i][1] * b[1][j] + a[i][2] * b[2][j];
+    }
+
+    void InverseTranspose(const Matrix3& m, Matrix3& result)
+    {
+        // The cofactor matrix divided by the determinant is the inverse transpose
+        const double c00 = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+        const double c01 = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+        const double c02 = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+        const double invDet = 1.0 / (m[0][0] * c00 + m[0][1] * c01 + m[0][2] * c02);
+
+        result[0][0] = c00 * invDet;
+        result[0][1] = c01 * invDet;
+        result[0][2] = c02 * invDet;
+        result[1][0] = (m[0][2] * m[2][1] - m[0][1] * m[2][2]) * invDet;
+        result[1][1] = (m[0][0] * m[2][2] - m[0][2] * m[2][0]) * invDet;
+        result[1][2] = (m[0][1] * m[2][0] - m[0][0] * m[2][1]) * invDet;
+        result[2][0] = (m[0][1] * m[1][2] - m[0][2] * m[1][1]) * invDet;
+        result[2][1] = (m[0][2] * m[1][0] - m[0][0] * m[1][2]) * invDet;
+        result[2][2] = (m[0][0] * m[1][1] - m[0][1] * m[1][0]) * invDet;
+    }
+
+    // Quaternions are stored as x, y, z, w
+    void ToQuaternion(const Matrix3& r, double q[4])
+    {
+        const double trace = r[0][0] + r[1][1] + r[2][2];
+
+        if (trace > 0.0)
+        {
+            const double s = 2.0 * std::sqrt(trace + 1.0);
+            q[0] = (r[2][1] - r[1][2]) / s;
+            q[1] = (r[0][2] - r[2][0]) / s;
+            q[2] = (r[1][0] - r[0][1]) / s;
+            q[3] = 0.25 * s;
+            return;
+        }
+
+        const int i = (r[1][1] > r[0][0]) ? (r[2][2] > r[1][1] ? 2 : 1) : (r[2][2] > r[0][0] ? 2 : 0);
+        const int j = (i + 1) % 3;
+        const int k = (i + 2) % 3;
+        const double s = 2.0 * std::sqrt(1.0 + r[i][i] - r[j][j] - r[k][k]);
+        q[i] = 0.25 * s;
+        q[j] = (r[j][i] + r[i][j]) / s;
+        q[k] = (r[k][i] + r[i][k]) / s;
+        q[3] = (r[k][j] - r[j][k]) / s;
+    }
+
+    void FromQuaternion(const double q[4], Matrix3& r)
+    {
+        const double x = q[0], y = q[1], z = q[2], w = q[3];
+
+        r[0][0] = 1.0 - 2.0 * (y * y + z * z);
+        r[0][1] = 2.0 * (x * y - z * w);
+        r[0][2] = 2.0 * (x * z + y * w);
+        r[1][0] = 2.0 * (x * y + z * w);
+        r[1][1] = 1.0 - 2.0 * (x * x + z * z);
+        r[1][2] = 2.0 * (y * z - x * w);
+        r[2][0] = 2.0 * (x * z - y * w);
+        r[2][1] = 2.0 * (y * z + x * w);
+        r[2][2] = 1.0 - 2.0 * (x * x + y * y);
+    }
+
+    // The Frobenius norm bounds how far a matrix can stretch a vector
+    double GetNorm(const Matrix3& m)
+    {
+        double norm = 0.0;
+
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j)
+                norm += m[i][j] * m[i][j];
+
+        return std::sqrt(norm);
+    }
+
+    Point3 GetCorner(const BoundingBox& box, int corner)
+    {
+        return Point3((corner & 1) ? box.m_Max.x : box.m_Min.x, (corner & 2) ? box.m_Max.y : box.m_Min.y, (corner & 4) ? box.m_Max.z : box.m_Min.z);
+    }
+
+    void Slerp(const double a[4], const double b[4], double t, double result[4])
+    {
+        double cosTheta = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+
+        // q and -q are the same rotation, take the shorter of the two arcs
+        const double sign = cosTheta < 0.0 ? -1.0 : 1.0;
+        cosTheta *= sign;
+
+        double wa = 1.0 - t;
+        double wb = t;
+
+        if (cosTheta < 0.9995)
+        {
+            const double theta = std::acos(cosTheta);
+            const double invSinTheta = 1.0 / std::sin(theta);
+            wa = std::sin((1.0 - t) * theta) * invSinTheta;
+            wb = std::sin(t * theta) * invSinTheta;
+        }
+
+        double length = 0.0;
+
+        for (int i = 0; i < 4; ++i)
+        {
+            result[i] = wa * a[i] + wb * sign * b[i];
+            length += result[i] * result[i];
+        }
+
+        for (int i = 0; i < 4; ++i)
+            result[i] /= std::sqrt(length);
+    }
+}
+
+AnimatedTransform::AnimatedTransform(const Matrix4x4& transform)
+    : AnimatedTransform(transform, 0.0, transform, 0.0)
+{
+}
+
+AnimatedTransform::AnimatedTransform(const Matrix4x4& startTransform, double startTime, const Matrix4x4& endTransform, double endTime)
+    : m_StartTransform(startTransform)
+    , m_EndTransform(endTransform)
+    , m_StartTime(startTime)
+    , m_EndTime(endTime)
+    , m_IsAnimated(!(startTransform == endTransform))
+{
+    if (m_IsAnimated && endTime <= startTime)
+        throw std::invalid_argument("Animated transforms require an end time after their start time");
+
+    if (m_IsAnimated)
+    {
+        m_Start = Decompose(startTransform);
+        m_End = Decompose(endTransform);
+    }
+}
+
+Matrix4x4 AnimatedTransform::Interpolate(double time) const
+{
+    if (!m_IsAnimated || time <= m_StartTime)
+        return m_StartTransform;
+
+    if (time >= m_EndTime)
+        return m_EndTransform;
+
+    const double t = (time - m_StartTime) / (m_EndTime - m_StartTime);
+
+    Components components;
+    components.m_Translation = m_Start.m_Translation * (1.0 - t) + m_End.m_Translation * t;
+    Slerp(m_Start.m_Rotation, m_End.m_Rotation, t, components.m_Rotation);
+
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            components.m_Scale[i][j] = m_Start.m_Scale[i][j] * (1.0 - t) + m_End.m_Scale[i][j] * t;
+
+    return Compose(components);
+}
+
+BoundingBox AnimatedTransform::GetMotionBounds(const BoundingBox& box) const
+{
+    BoundingBox bounds;
+    bounds.m_Min = Point3(std::numeric_limits<double>::infinity());
+    bounds.m_Max = Point3(-std::numeric_limits<double>::infinity());
+
+    if (!m_IsAnimated)
+    {
+        for (int corner = 0; corner < 8; ++corner)
+        {
+            Point4 point = GetCorner(box, corner).Resize<4>();
+            point.w = 1.0;
+            const Point3 transformed = (m_StartTransform * point).Resize<3>();
+
+            for (int i = 0; i < 3; ++i)
+            {
+                bounds.m_Min[i] = std::min(bounds.m_Min[i], transformed[i]);
+                bounds.m_Max[i] = std::max(bounds.m_Max[i], transformed[i]);
+            }
+        }
+
+        return bounds;
+    }
+
+    // Rotations preserve the norm, so rotation and scale together stretch a point by at most
+    // the scale norm, and the interpolated scales never exceed the larger keyframe norm
+    double radius = 0.0;
+
+    for (int corner = 0; corner < 8; ++corner)
+        radius = std::max(radius, (GetCorner(box, corner) - Point3(0.0)).Magnitude());
+
+    radius *= std::max(GetNorm(m_Start.m_Scale), GetNorm(m_End.m_Scale));
+
+    for (int i = 0; i < 3; ++i)
+    {
+        bounds.m_Min[i] = std::min(m_Start.m_Translation[i], m_End.m_Translation[i]) - radius;
+        bounds.m_Max[i] = std::max(m_Start.m_Translation[i], m_End.m_Translation[i]) + radius;
+    }
+
+    return bounds;
+}
+
+AnimatedTransform::Components AnimatedTransform::Decompose(const Matrix4x4& transform)
+{
+    Components components;
+    components.m_Translation = (transform * Point4(0, 0, 0, 1)).Resize<3>() - Point3(0, 0, 0);
+
+    const Vector3 columns[3] = {
+        (transform * Vector4(1, 0, 0, 0)).Resize<3>(),
+        (transform * Vector4(0, 1, 0, 0)).Resize<3>(),
+        (transform * Vector4(0, 0, 1, 0)).Resize<3>()
+    };
+
+    Matrix3 m;
+    for (int i = 0; i < 3; ++i)
+    {
+        m[0][i] = columns[i].x;
+        m[1][i] = columns[i].y;
+        m[2][i] = columns[i].z;
+    }
+
+    // Polar decomposition by averaging with the inverse transpose, which converges to the
+    // closest rotation. Whatever remains once the rotation is factored out is the scale.
+    Matrix3 rotation;
+    std::copy(&m[0][0], &m[0][0] + 9, &rotation[0][0]);
+
+    for (int iteration = 0; iteration < 100; ++iteration)
+    {
+        Matrix3 inverseTranspose;
+        InverseTranspose(rotation, inverseTranspose);
+
+        double change = 0.0;
+        for (int i = 0; i < 3; ++i)
+        {
+            for (int j = 0; j < 3; ++j)
+            {
+                const double next = 0.5 * (rotation[i][j] + inverseTranspose[i][j]);
+                change = std::max(change, std::abs(next - rotation[i][j]));
+                rotation[i][j] = next;
+            }
+        }
+
+        if (change < 1e-12)
+            break;
+    }
+
+    // Mirroring transforms converge to a reflection, which has no quaternion. Negating it
+    // moves the mirroring into the scale instead.
+    const double determinant =
+        rotation[0][0] * (rotation[1][1] * rotation[2][2] - rotation[1][2] * rotation[2][1]) -
+        rotation[0][1] * (rotation[1][0] * rotation[2][2] - rotation[1][2] * rotation[2][0]) +
+        rotation[0][2] * (rotation[1][0] * rotation[2][1] - rotation[1][1] * rotation[2][0]);
+
+    if (determinant < 0.0)
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j)
+                rotation[i][j] = -rotation[i][j];
+
+    Matrix3 inverseRotation;
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            inverseRotation[i][j] = rotation[j][i];
+
+    Multiply(inverseRotation, m, components.m_Scale);
+    ToQuaternion(rotation, components.m_Rotation);
+    return components;
+}
+
+Matrix4x4 AnimatedTransform::Compose(const Components& components)
+{
+    Matrix3 rotation, m;
+    FromQuaternion(components.m_Rotation, rotation);
+    Multiply(rotation, components.m_Scale, m);
+
+    const Vector3& t = components.m_Translation;
+    return Matrix4x4(
+        m[0][0], m[0][1], m[0][2], t.x,
+        m[1][0], m[1][1], m[1][2], t.y,
+        m[2][0], m[2][1], m[2][2], t.z,
+        0, 0, 0, 1);
+}
+
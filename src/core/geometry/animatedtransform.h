@@ -0,0 +1,71 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+// A transform that moves between two keyframes over a time interval, used for motion blur.
+// Keyframes are decomposed into translation, rotation and scale so that rotations are
+// interpolated along the shortest arc rather than by blending matrices, which would shear
+// and shrink the geometry midway. Outside of the interval the nearest keyframe is held.
+class AnimatedTransform
+{
+public:
+    AnimatedTransform(const Matrix4x4& transform = {});
+    AnimatedTransform(const Matrix4x4& startTransform, double startTime, const Matrix4x4& endTransform, double endTime);
+    ~AnimatedTransform() = default;
+
+public:
+    inline bool IsAnimated() const { return m_IsAnimated; }
+    inline const Matrix4x4& GetStartTransform() const { return m_StartTransform; }
+    inline const Matrix4x4& GetEndTransform() const { return m_EndTransform; }
+    inline double GetStartTime() const { return m_StartTime; }
+    inline double GetEndTime() const { return m_EndTime; }
+
+public:
+    Matrix4x4 Interpolate(double time) const;
+
+    // World space bounds of an object space box over the whole animation. They are exact for
+    // static transforms and conservative otherwise: translation stays between the keyframes, and
+    // rotation and scale move a point by at most the larger scale norm of the two keyframes.
+    BoundingBox GetMotionBounds(const BoundingBox& box) const;
+
+private:
+    struct Components
+    {
+        Vector3 m_Translation;
+        double m_Rotation[4];
+        double m_Scale[3][3];
+    };
+
+    friend class AnimatedTransformTest_DecomposesRotationAndScale_Test;
+    static Components Decompose(const Matrix4x4& transform);
+    static Matrix4x4 Compose(const Components& components);
+
+private:
+    Matrix4x4 m_StartTransform;
+    Matrix4x4 m_EndTransform;
+    double m_StartTime;
+    double m_EndTime;
+    bool m_IsAnimated;
+
+    Components m_Start;
+    Components m_End;
+};
+
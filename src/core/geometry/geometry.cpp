@@ -24,4 +24,60 @@ void Geometry::SetTransform(const Matrix4x4& transform)
 {
     m_Transform = transform;
     m_TransformInv = transform.Inversed();
+    m_AnimatedTransform = AnimatedTransform(transform);
 }
+
+void Geometry::SetAnimatedTransform(const AnimatedTransform& transform)
+{
+    m_Transform = transform.GetStartTransform();
+    m_TransformInv = m_Transform.Inversed();
+    m_AnimatedTransform = transform;
+}
+
+Matrix4x4 Geometry::GetTransform(double time) const
+{
+    if (!m_AnimatedTransform.IsAnimated())
+        return m_Transform;
+
+    return m_AnimatedTransform.Interpolate(time);
+}
+
+Matrix4x4 Geometry::GetTransformInv(double time) const
+{
+    if (!m_AnimatedTransform.IsAnimated())
+        return m_TransformInv;
+
+    return m_AnimatedTransform.Interpolate(time).Inversed();
+}
+
+Ray Geometry::ToObjectSpace(const Ray& ray, double time) const
+{
+    const Matrix4x4 transformInv = GetTransformInv(time);
+    Point4 origin = ray.m_Origin.Resize<4>();
+    origin.w = 1.0;
+
+    // Directions are not renormalized so that hit distances stay in world space units
+    Ray objectSpaceRay;
+    objectSpaceRay.m_Origin = (transformInv * origin).Resize<3>();
+    objectSpaceRay.m_Direction = (transformInv * ray.m_Direction.Resize<4>()).Resize<3>();
+    objectSpaceRay.m_TMax = ray.m_TMax;
+    return objectSpaceRay;
+}
+
+Normal3 Geometry::NormalToWorldSpace(const Normal3& objectSpaceNormal, double time) const
+{
+    // Normals transform with the inverse transpose. Component i of the product is the dot
+    // product of column i of the inverse with the normal.
+    const Matrix4x4 transformInv = GetTransformInv(time);
+    const Vector3 normal(objectSpaceNormal.x, objectSpaceNormal.y, objectSpaceNormal.z);
+    const Vector3 columnX = (transformInv * Vector4(1, 0, 0, 0)).Resize<3>();
+    const Vector3 columnY = (transformInv * Vector4(0, 1, 0, 0)).Resize<3>();
+    const Vector3 columnZ = (transformInv * Vector4(0, 0, 1, 0)).Resize<3>();
+
+    return Normal3(Vector3::Dot(columnX, normal), Vector3::Dot(columnY, normal), Vector3::Dot(columnZ, normal)).Normalized();
+}
+
+void Geometry::GetPrimitives(std::vector<const Primitive*>& primitives) const
+{
+}
+
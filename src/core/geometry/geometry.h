@@ -21,6 +21,9 @@
 #pragma once
 
 #include "core/spatial/accelerator.h"
+#include "animatedtransform.h"
+
+class Primitive;
 
 class Geometry
 {
@@ -32,13 +35,30 @@ public:
     inline Matrix4x4 GetTransform() const { return m_Transform; }
     inline Matrix4x4 GetTransformInv() const { return m_TransformInv; }
     inline Accelerator* GetBottomLevelAccelerator() const { return m_BottomLevelAccelerator.get(); }
+    inline const AnimatedTransform& GetAnimatedTransform() const { return m_AnimatedTransform; }
+    inline bool IsAnimated() const { return m_AnimatedTransform.IsAnimated(); }
 
 public:
     virtual void SetTransform(const Matrix4x4& transform);
+    virtual void SetAnimatedTransform(const AnimatedTransform& transform);
+
+    // Transforms at a point in time within the shutter interval, see Camera::GetShutterTime.
+    // Static geometry returns its cached transforms without interpolating.
+    Matrix4x4 GetTransform(double time) const;
+    Matrix4x4 GetTransformInv(double time) const;
+
+    // Moves a world space ray into the geometry's object space at the ray's time, so that
+    // accelerators can traverse moving geometry without rebuilding
+    Ray ToObjectSpace(const Ray& ray, double time) const;
+    Normal3 NormalToWorldSpace(const Normal3& objectSpaceNormal, double time) const;
+
+    // Appends the primitives that make up this geometry, in object space
+    virtual void GetPrimitives(std::vector<const Primitive*>& primitives) const;
     
 protected:
     Matrix4x4 m_Transform;
     Matrix4x4 m_TransformInv;
+    AnimatedTransform m_AnimatedTransform;
 
     std::unique_ptr<Accelerator> m_BottomLevelAccelerator;
 };
@@ -33,7 +33,9 @@ TrianglePrimitive::TrianglePrimitive(TriangleMesh* parentMesh, uint32_t v0, uint
 
 bool TrianglePrimitive::Intersect(const Ray& ray) const
 {
-    return false;
+    double tHit;
+    SurfaceInteraction surface;
+    return Intersect(ray, &tHit, &surface);
 }
 
 bool TrianglePrimitive::Intersect(const Ray& ray, double* tHit, SurfaceInteraction* surface) const
@@ -49,7 +51,7 @@ bool TrianglePrimitive::Intersect(const Ray& ray, double* tHit, SurfaceInteracti
     p = Vector3::Cross(ray.m_Direction, e2);
     double det = Vector3::Dot(e1, p);
 
-    if (abs(det) < SMath::Epsilon)
+    if (std::abs(det) < SMath::Epsilon)
         return false;
 
     double invDet = 1 / det;
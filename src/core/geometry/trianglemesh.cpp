@@ -37,3 +37,10 @@ void TriangleMesh::SetFaces(TrianglePrimitive* faces, uint32_t numFaces)
     m_Faces.clear();
     m_Faces.assign(faces, faces + numFaces);
 }
+
+void TriangleMesh::GetPrimitives(std::vector<const Primitive*>& primitives) const
+{
+    for (const TrianglePrimitive& face : m_Faces)
+        primitives.push_back(&face);
+}
+
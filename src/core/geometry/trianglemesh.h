@@ -47,6 +47,7 @@ public:
 public:
     void SetVertices(Vertex* vertices, uint32_t numVertices);
     void SetFaces(TrianglePrimitive* faces, uint32_t numFaces);
+    void GetPrimitives(std::vector<const Primitive*>& primitives) const override;
 
 private:
     std::vector<Vertex> m_Vertices;
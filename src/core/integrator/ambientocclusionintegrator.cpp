@@ -0,0 +1,79 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ambientocclusionintegrator.h"
+#include "core/geometry/primitives/primitive.h"
+#include "core/sampling/sampling.h"
+
+namespace
+{
+    // Offsets occlusion rays from the surface so that they do not hit it again
+    constexpr double RayEpsilon = 1e-6;
+}
+
+AmbientOcclusionIntegrator::AmbientOcclusionIntegrator(const Accelerator& scene, double maxDistance, int numSamples)
+    : Integrator(scene)
+    , m_MaxDistance(maxDistance)
+    , m_NumSamples(numSamples)
+{
+    if (maxDistance <= 0.0)
+        throw std::invalid_argument("Ambient occlusion distance must be positive");
+
+    if (numSamples < 1)
+        throw std::invalid_argument("Ambient occlusion needs at least one sample");
+}
+
+XyzCoefficients AmbientOcclusionIntegrator::Integrate(const Ray& ray, double time, Sampler& sampler, AovSample& aovs, uint64_t& numRays) const
+{
+    double tHit;
+    SurfaceInteraction surface;
+    ++numRays;
+
+    if (!m_Scene.Intersect(ray, time, &tHit, &surface))
+        return {};
+
+    // Shade the side of the surface the ray arrived from
+    Vector3 normal(surface.m_Normal.x, surface.m_Normal.y, surface.m_Normal.z);
+    if (Vector3::Dot(normal, ray.m_Direction) > 0.0)
+        normal = -normal;
+
+    aovs.m_Depth = tHit;
+    aovs.m_Normal = Normal3(normal.x, normal.y, normal.z);
+    aovs.m_Albedo = RgbCoefficients(1.0);
+
+    Vector3 tangent, bitangent;
+    CreateBasis(normal, tangent, bitangent);
+    const Point3 origin = surface.m_Point + normal * RayEpsilon;
+    int numUnoccluded = 0;
+
+    for (int i = 0; i < m_NumSamples; ++i)
+    {
+        // Cosine weighted directions cancel the cosine term, so the estimate is a plain average
+        const Point3 local = Sampling::CosineSampleHemisphere(sampler.Get2D());
+        const Vector3 direction = tangent * local.x + bitangent * local.y + normal * local.z;
+
+        ++numRays;
+        if (!m_Scene.Intersect(Ray(origin, direction, m_MaxDistance), time))
+            ++numUnoccluded;
+    }
+
+    return XyzCoefficients((double)numUnoccluded / m_NumSamples);
+}
+
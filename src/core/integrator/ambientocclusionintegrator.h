@@ -0,0 +1,45 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "integrator.h"
+
+// Shades camera hits by the fraction of the cosine weighted hemisphere around the surface that
+// is unoccluded within a maximum distance. Needs nothing but geometry, which makes it useful for
+// previewing scenes and for measuring the raw ray throughput of the renderer.
+class AmbientOcclusionIntegrator : public Integrator
+{
+public:
+    AmbientOcclusionIntegrator(const Accelerator& scene, double maxDistance = std::numeric_limits<double>::infinity(), int numSamples = 1);
+    ~AmbientOcclusionIntegrator() override = default;
+
+public:
+    inline double GetMaxDistance() const { return m_MaxDistance; }
+    inline int GetNumSamples() const { return m_NumSamples; }
+
+public:
+    XyzCoefficients Integrate(const Ray& ray, double time, Sampler& sampler, AovSample& aovs, uint64_t& numRays) const override;
+
+private:
+    const double m_MaxDistance;
+    const int m_NumSamples;
+};
+
@@ -0,0 +1,76 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "integrator.h"
+
+Integrator::Integrator(const Accelerator& scene)
+    : m_Scene(scene)
+{
+}
+
+void Integrator::IntegrateTile(Camera& camera, FilmTile& tile, Sampler& sampler, int firstSample, int numSamples, uint64_t& numRays) const
+{
+    Aov::Dispatch(camera.GetFilm().GetAovMask(), [&]<AovMask Mask>()
+    {
+        IntegrateTileSamples<Mask>(camera, tile, sampler, firstSample, numSamples, numRays);
+    });
+}
+
+template <AovMask Mask>
+void Integrator::IntegrateTileSamples(Camera& camera, FilmTile& tile, Sampler& sampler, int firstSample, int numSamples, uint64_t& numRays) const
+{
+    const Film& film = camera.GetFilm();
+
+    for (int y = 0; y < tile.GetSize().y; ++y)
+    {
+        for (int x = 0; x < tile.GetSize().x; ++x)
+        {
+            const Point2i pixel = tile.TileToFilmSpace({ x, y });
+
+            for (int s = firstSample; s < firstSample + numSamples; ++s)
+            {
+                sampler.StartPixelSample(pixel, s);
+                const CameraSample cameraSample = Camera::GetCameraSample(sampler);
+                const Ray ray = camera.GenerateRay(pixel, cameraSample);
+                const double time = camera.GetShutterTime(cameraSample.m_Time);
+
+                AovSample aovs = {};
+                const XyzCoefficients xyz = Integrate(ray, time, sampler, aovs, numRays);
+                const Point2 filmSpacePos(pixel.x + cameraSample.m_FilmOffset.x, pixel.y + cameraSample.m_FilmOffset.y);
+
+                // Samples always fall within the pixel, so they go straight to this tile
+                tile.AddSample(filmSpacePos, xyz, film.GetFilterTable());
+
+                if constexpr (Mask != Aov::None)
+                    tile.AddAovSampleUnchecked<Mask>({ x, y }, aovs);
+            }
+        }
+    }
+}
+
+void Integrator::CreateBasis(const Vector3& n, Vector3& tangent, Vector3& bitangent)
+{
+    const double sign = std::copysign(1.0, n.z);
+    const double a = -1.0 / (sign + n.z);
+    const double b = n.x * n.y * a;
+    tangent = Vector3(1.0 + sign * n.x * n.x * a, sign * b, -sign * n.x);
+    bitangent = Vector3(b, sign + n.y * n.y * a, -n.y);
+}
+
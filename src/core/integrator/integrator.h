@@ -0,0 +1,62 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "core/camera/camera.h"
+#include "core/film/aovbuffer.h"
+#include "core/spatial/accelerator.h"
+#include "core/sampling/sampler.h"
+
+// Computes the radiance arriving along camera rays. Integrators are shared between render
+// threads and must not modify themselves while integrating, per thread state lives in the
+// sampler. Every ray an integrator traces, including the camera ray, is added to numRays so
+// that the renderer can report throughput.
+class Integrator
+{
+public:
+    Integrator(const Accelerator& scene);
+    virtual ~Integrator() = default;
+
+public:
+    inline const Accelerator& GetScene() const { return m_Scene; }
+
+public:
+    // Sampler dimensions are consumed after those of the camera sample. AOVs are only filled in
+    // for camera rays that hit the scene.
+    virtual XyzCoefficients Integrate(const Ray& ray, double time, Sampler& sampler, AovSample& aovs, uint64_t& numRays) const = 0;
+
+    // Adds the samples [firstSample, firstSample + numSamples) of every pixel of a tile to it.
+    // The default integrates the samples one at a time in pixel order, integrators that trace
+    // whole tiles at once override this.
+    virtual void IntegrateTile(Camera& camera, FilmTile& tile, Sampler& sampler, int firstSample, int numSamples, uint64_t& numRays) const;
+
+protected:
+    // IntegrateTile for a film with the AOVs in Mask enabled
+    template <AovMask Mask>
+    void IntegrateTileSamples(Camera& camera, FilmTile& tile, Sampler& sampler, int firstSample, int numSamples, uint64_t& numRays) const;
+
+    // Orthonormal basis around a unit vector, from Duff et al. 2017
+    static void CreateBasis(const Vector3& n, Vector3& tangent, Vector3& bitangent);
+
+protected:
+    const Accelerator& m_Scene;
+};
+
@@ -0,0 +1,150 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "core/sampling/rng.h"
+
+// Path states of a wavefront in structure of arrays form. The persistent state of a path is
+// its next ray, its throughput, the radiance gathered so far, where its sample lands on the
+// film and its own random number stream, so paths can be reordered freely between stages
+// without changing the image. The remaining arrays are scratch space that is only valid
+// between the stages of a single bounce.
+struct PathQueue
+{
+    inline size_t GetSize() const { return m_OriginX.size(); }
+
+    inline Ray GetRay(size_t index) const
+    {
+        Ray ray;
+        ray.m_Origin = { m_OriginX[index], m_OriginY[index], m_OriginZ[index] };
+        ray.m_Direction = { m_DirectionX[index], m_DirectionY[index], m_DirectionZ[index] };
+        return ray;
+    }
+
+    inline Vector3 GetNormal(size_t index) const { return { m_NormalX[index], m_NormalY[index], m_NormalZ[index] }; }
+    inline XyzCoefficients GetRadiance(size_t index) const { return { m_RadianceX[index], m_RadianceY[index], m_RadianceZ[index] }; }
+
+    inline void SetOrigin(size_t index, const Point3& origin)
+    {
+        m_OriginX[index] = origin.x;
+        m_OriginY[index] = origin.y;
+        m_OriginZ[index] = origin.z;
+    }
+
+    inline void SetDirection(size_t index, const Vector3& direction)
+    {
+        m_DirectionX[index] = direction.x;
+        m_DirectionY[index] = direction.y;
+        m_DirectionZ[index] = direction.z;
+    }
+
+    inline void SetNormal(size_t index, const Vector3& normal)
+    {
+        m_NormalX[index] = normal.x;
+        m_NormalY[index] = normal.y;
+        m_NormalZ[index] = normal.z;
+    }
+
+    inline void AddRadiance(size_t index, const XyzCoefficients& radiance)
+    {
+        m_RadianceX[index] += radiance[0];
+        m_RadianceY[index] += radiance[1];
+        m_RadianceZ[index] += radiance[2];
+    }
+
+    inline void Resize(size_t size)
+    {
+        ForEachArray([size](auto& array) { array.resize(size); });
+    }
+
+    // Replaces the paths of this queue with the given paths of the source in order, keeping
+    // their persistent state. Used to compact and sort the queue between bounces.
+    inline void Gather(const PathQueue& source, std::span<const uint32_t> indices)
+    {
+        Resize(indices.size());
+
+        for (size_t i = 0; i < indices.size(); ++i)
+        {
+            const uint32_t j = indices[i];
+            m_OriginX[i] = source.m_OriginX[j];
+            m_OriginY[i] = source.m_OriginY[j];
+            m_OriginZ[i] = source.m_OriginZ[j];
+            m_DirectionX[i] = source.m_DirectionX[j];
+            m_DirectionY[i] = source.m_DirectionY[j];
+            m_DirectionZ[i] = source.m_DirectionZ[j];
+            m_Time[i] = source.m_Time[j];
+            m_FilmX[i] = source.m_FilmX[j];
+            m_FilmY[i] = source.m_FilmY[j];
+            m_TileX[i] = source.m_TileX[j];
+            m_TileY[i] = source.m_TileY[j];
+            m_Throughput[i] = source.m_Throughput[j];
+            m_RadianceX[i] = source.m_RadianceX[j];
+            m_RadianceY[i] = source.m_RadianceY[j];
+            m_RadianceZ[i] = source.m_RadianceZ[j];
+            m_Rng[i] = source.m_Rng[j];
+            m_IsActive[i] = 1;
+        }
+    }
+
+    template <typename Function>
+    inline void ForEachArray(Function function)
+    {
+        function(m_OriginX); function(m_OriginY); function(m_OriginZ);
+        function(m_DirectionX); function(m_DirectionY); function(m_DirectionZ);
+        function(m_Time); function(m_FilmX); function(m_FilmY);
+        function(m_TileX); function(m_TileY); function(m_Throughput);
+        function(m_RadianceX); function(m_RadianceY); function(m_RadianceZ);
+        function(m_Rng); function(m_IsActive);
+        function(m_IsHit); function(m_HitDistance); function(m_NormalX); function(m_NormalY); function(m_NormalZ);
+        function(m_ShadowWeight);
+    }
+
+    // Persistent state
+    std::vector<double> m_OriginX;
+    std::vector<double> m_OriginY;
+    std::vector<double> m_OriginZ;
+    std::vector<double> m_DirectionX;
+    std::vector<double> m_DirectionY;
+    std::vector<double> m_DirectionZ;
+    std::vector<double> m_Time;
+    std::vector<double> m_FilmX;
+    std::vector<double> m_FilmY;
+    std::vector<int> m_TileX;
+    std::vector<int> m_TileY;
+    std::vector<double> m_Throughput;
+    std::vector<double> m_RadianceX;
+    std::vector<double> m_RadianceY;
+    std::vector<double> m_RadianceZ;
+    std::vector<Rng> m_Rng;
+    std::vector<uint8_t> m_IsActive;
+
+    // Scratch state of the current bounce. Extend moves the origin of paths that hit the
+    // scene to the hit point and stores the distance to it and the normal facing the ray,
+    // shade leaves the weight of the sun contribution that the shadow stage adds if the sun
+    // is visible.
+    std::vector<uint8_t> m_IsHit;
+    std::vector<double> m_HitDistance;
+    std::vector<double> m_NormalX;
+    std::vector<double> m_NormalY;
+    std::vector<double> m_NormalZ;
+    std::vector<double> m_ShadowWeight;
+};
+
@@ -0,0 +1,405 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "wavefrontintegrator.h"
+#include "core/geometry/primitives/primitive.h"
+#include "core/sampling/batchsampling.h"
+#include "core/sampling/sampling.h"
+
+namespace
+{
+    // Offsets bounce and shadow rays from the surface so that they do not hit it again
+    constexpr double RayEpsilon = 1e-6;
+
+    // Paths are terminated randomly from this bounce on, weighted by their throughput
+    constexpr int RouletteDepth = 3;
+    constexpr double MaxSurvivalProbability = 0.95;
+
+    // Keeps the random streams of paths apart from those of the camera samples
+    constexpr uint64_t PathSeed = 0x5041544853ULL;
+
+    // Interleaves the low 10 bits of v with two zero bits each, for 3D Morton codes
+    uint32_t SpreadBits3(uint32_t v)
+    {
+        v &= 0x000003ff;
+        v = (v | (v << 16)) & 0x030000ff;
+        v = (v | (v << 8)) & 0x0300f00f;
+        v = (v | (v << 4)) & 0x030c30c3;
+        v = (v | (v << 2)) & 0x09249249;
+        return v;
+    }
+
+    uint32_t GetOctant(double x, double y, double z)
+    {
+        return (x < 0.0 ? 1 : 0) | (y < 0.0 ? 2 : 0) | (z < 0.0 ? 4 : 0);
+    }
+}
+
+WavefrontIntegrator::WavefrontIntegrator(const Accelerator& scene, int maxDepth)
+    : Integrator(scene)
+    , m_MaxDepth(maxDepth)
+    , m_Albedo(0.5)
+    , m_SkyRadiance(1.0)
+    , m_SunDirection(0, 1, 0)
+    , m_SunIrradiance(0.0)
+    , m_HasSun(false)
+{
+    if (maxDepth < 1)
+        throw std::invalid_argument("Paths need at least one bounce");
+}
+
+void WavefrontIntegrator::SetAlbedo(double albedo)
+{
+    if (albedo < 0.0 || albedo > 1.0)
+        throw std::invalid_argument("Albedo must be within [0, 1]");
+
+    m_Albedo = albedo;
+}
+
+void WavefrontIntegrator::SetSkyRadiance(const XyzCoefficients& radiance)
+{
+    m_SkyRadiance = radiance;
+}
+
+void WavefrontIntegrator::SetSun(const Vector3& direction, const XyzCoefficients& irradiance)
+{
+    if (direction.Magnitude() == 0.0)
+        throw std::invalid_argument("Sun direction must not be zero");
+
+    m_SunDirection = direction.Normalized();
+    m_SunIrradiance = irradiance;
+    m_HasSun = irradiance[0] != 0.0 || irradiance[1] != 0.0 || irradiance[2] != 0.0;
+}
+
+XyzCoefficients WavefrontIntegrator::Integrate(const Ray& ray, double time, Sampler& sampler, AovSample& aovs, uint64_t& numRays) const
+{
+    XyzCoefficients radiance;
+    double throughput = 1.0;
+    Ray current = ray;
+
+    for (int depth = 0;; ++depth)
+    {
+        double tHit;
+        SurfaceInteraction surface;
+        ++numRays;
+
+        if (!m_Scene.Intersect(current, time, &tHit, &surface))
+        {
+            radiance += m_SkyRadiance * throughput;
+            break;
+        }
+
+        Vector3 normal(surface.m_Normal.x, surface.m_Normal.y, surface.m_Normal.z);
+        if (Vector3::Dot(normal, current.m_Direction) > 0.0)
+            normal = -normal;
+
+        if (depth == 0)
+        {
+            aovs.m_Depth = tHit;
+            aovs.m_Normal = Normal3(normal.x, normal.y, normal.z);
+            aovs.m_Albedo = RgbCoefficients(m_Albedo);
+        }
+
+        const Point3 origin = surface.m_Point + normal * RayEpsilon;
+        const double cosSun = Vector3::Dot(normal, m_SunDirection);
+
+        if (m_HasSun && cosSun > 0.0)
+        {
+            ++numRays;
+            if (!m_Scene.Intersect(Ray(origin, m_SunDirection), time))
+                radiance += m_SunIrradiance * (throughput * m_Albedo * SMath::InvPi * cosSun);
+        }
+
+        // Cosine weighted bounces cancel the cosine and the 1 / pi of the diffuse BRDF
+        throughput *= m_Albedo;
+
+        if (depth + 1 >= m_MaxDepth)
+            break;
+
+        if (depth + 1 >= RouletteDepth)
+        {
+            const double survival = std::min(MaxSurvivalProbability, throughput);
+            if (sampler.Get1D() >= survival)
+                break;
+
+            throughput /= survival;
+        }
+
+        Vector3 tangent, bitangent;
+        CreateBasis(normal, tangent, bitangent);
+        const Point3 local = Sampling::CosineSampleHemisphere(sampler.Get2D());
+        current = Ray(origin, tangent * local.x + bitangent * local.y + normal * local.z);
+    }
+
+    return radiance;
+}
+
+void WavefrontIntegrator::IntegrateTile(Camera& camera, FilmTile& tile, Sampler& sampler, int firstSample, int numSamples, uint64_t& numRays) const
+{
+    const Film& film = camera.GetFilm();
+    const Vector2i size = tile.GetSize();
+    const size_t numPixels = (size_t)size.x * size.y;
+    const int endSample = firstSample + numSamples;
+    const int samplesPerWave = (int)std::max<size_t>(1, MaxWaveSize / numPixels);
+
+    RayBatch rays;
+    PathQueue paths, sorted;
+
+    for (int waveSample = firstSample; waveSample < endSample; waveSample += samplesPerWave)
+    {
+        const int numWaveSamples = std::min(samplesPerWave, endSample - waveSample);
+        paths.Resize(numWaveSamples * numPixels);
+
+        for (int s = 0; s < numWaveSamples; ++s)
+        {
+            camera.GenerateRays(tile, waveSample + s, sampler, rays);
+
+            for (size_t i = 0, j = s * numPixels; i < numPixels; ++i, ++j)
+            {
+                paths.m_OriginX[j] = rays.m_OriginX[i];
+                paths.m_OriginY[j] = rays.m_OriginY[i];
+                paths.m_OriginZ[j] = rays.m_OriginZ[i];
+                paths.m_DirectionX[j] = rays.m_DirectionX[i];
+                paths.m_DirectionY[j] = rays.m_DirectionY[i];
+                paths.m_DirectionZ[j] = rays.m_DirectionZ[i];
+                paths.m_Time[j] = rays.m_Time[i];
+                paths.m_FilmX[j] = rays.m_FilmX[i];
+                paths.m_FilmY[j] = rays.m_FilmY[i];
+                paths.m_TileX[j] = (int)(i % size.x);
+                paths.m_TileY[j] = (int)(i / size.x);
+                paths.m_Throughput[j] = 1.0;
+                paths.m_RadianceX[j] = 0.0;
+                paths.m_RadianceY[j] = 0.0;
+                paths.m_RadianceZ[j] = 0.0;
+                paths.m_Rng[j].SetPixelSample(rays.GetPixel(i), waveSample + s, PathSeed);
+                paths.m_IsActive[j] = 1;
+            }
+        }
+
+        TraceWave(tile, film, paths, sorted, numRays);
+    }
+}
+
+void WavefrontIntegrator::TraceWave(FilmTile& tile, const Film& film, PathQueue& paths, PathQueue& sorted, uint64_t& numRays) const
+{
+    const AovMask aovMask = film.GetAovMask();
+
+    for (int depth = 0; paths.GetSize() > 0; ++depth)
+    {
+        Extend(paths, numRays);
+
+        if (depth == 0 && aovMask != Aov::None)
+            Aov::Dispatch(aovMask, [this, &tile, &paths]<AovMask Mask>() { AddAovSamples<Mask>(tile, paths); });
+
+        Shade(paths, depth);
+        TraceShadowRays(paths, numRays);
+        Accumulate(tile, film, paths);
+
+        SortPaths(paths, sorted);
+        std::swap(paths, sorted);
+    }
+}
+
+void WavefrontIntegrator::Extend(PathQueue& paths, uint64_t& numRays) const
+{
+    for (size_t i = 0; i < paths.GetSize(); ++i)
+    {
+        double tHit;
+        SurfaceInteraction surface;
+        const Ray ray = paths.GetRay(i);
+        paths.m_IsHit[i] = m_Scene.Intersect(ray, paths.m_Time[i], &tHit, &surface);
+
+        if (!paths.m_IsHit[i])
+            continue;
+
+        Vector3 normal(surface.m_Normal.x, surface.m_Normal.y, surface.m_Normal.z);
+        if (Vector3::Dot(normal, ray.m_Direction) > 0.0)
+            normal = -normal;
+
+        paths.SetOrigin(i, surface.m_Point);
+        paths.SetNormal(i, normal);
+        paths.m_HitDistance[i] = tHit;
+    }
+
+    numRays += paths.GetSize();
+}
+
+template <AovMask Mask>
+void WavefrontIntegrator::AddAovSamples(FilmTile& tile, const PathQueue& paths) const
+{
+    for (size_t i = 0; i < paths.GetSize(); ++i)
+    {
+        AovSample aovs = {};
+
+        if (paths.m_IsHit[i])
+        {
+            aovs.m_Depth = paths.m_HitDistance[i];
+            aovs.m_Normal = Normal3(paths.m_NormalX[i], paths.m_NormalY[i], paths.m_NormalZ[i]);
+            aovs.m_Albedo = RgbCoefficients(m_Albedo);
+        }
+
+        tile.AddAovSampleUnchecked<Mask>({ paths.m_TileX[i], paths.m_TileY[i] }, aovs);
+    }
+}
+
+void WavefrontIntegrator::Shade(PathQueue& paths, int depth) const
+{
+    const size_t numPaths = paths.GetSize();
+    std::vector<uint32_t> bounces;
+    std::vector<double> u0, u1;
+    bounces.reserve(numPaths);
+    u0.reserve(numPaths);
+    u1.reserve(numPaths);
+
+    for (size_t i = 0; i < numPaths; ++i)
+    {
+        paths.m_ShadowWeight[i] = 0.0;
+
+        if (!paths.m_IsHit[i])
+        {
+            paths.AddRadiance(i, m_SkyRadiance * paths.m_Throughput[i]);
+            paths.m_IsActive[i] = 0;
+            continue;
+        }
+
+        const Vector3 normal = paths.GetNormal(i);
+        paths.SetOrigin(i, Point3(paths.m_OriginX[i], paths.m_OriginY[i], paths.m_OriginZ[i]) + normal * RayEpsilon);
+
+        const double cosSun = Vector3::Dot(normal, m_SunDirection);
+        if (m_HasSun && cosSun > 0.0)
+            paths.m_ShadowWeight[i] = paths.m_Throughput[i] * m_Albedo * SMath::InvPi * cosSun;
+
+        // Cosine weighted bounces cancel the cosine and the 1 / pi of the diffuse BRDF
+        paths.m_Throughput[i] *= m_Albedo;
+
+        if (depth + 1 >= m_MaxDepth)
+        {
+            paths.m_IsActive[i] = 0;
+            continue;
+        }
+
+        Rng& rng = paths.m_Rng[i];
+
+        if (depth + 1 >= RouletteDepth)
+        {
+            const double survival = std::min(MaxSurvivalProbability, paths.m_Throughput[i]);
+            if (rng.UniformDouble() >= survival)
+            {
+                paths.m_IsActive[i] = 0;
+                continue;
+            }
+
+            paths.m_Throughput[i] /= survival;
+        }
+
+        bounces.push_back((uint32_t)i);
+        u0.push_back(rng.UniformDouble());
+        u1.push_back(rng.UniformDouble());
+    }
+
+    // Warp the bounce samples of all paths at once, then rotate them around their normals
+    std::vector<double> x(bounces.size()), y(bounces.size()), z(bounces.size());
+    BatchSampling::CosineSampleHemisphere(u0, u1, x, y, z);
+
+    for (size_t b = 0; b < bounces.size(); ++b)
+    {
+        const uint32_t i = bounces[b];
+        const Vector3 normal = paths.GetNormal(i);
+
+        Vector3 tangent, bitangent;
+        CreateBasis(normal, tangent, bitangent);
+        paths.SetDirection(i, (tangent * x[b] + bitangent * y[b] + normal * z[b]).Normalized());
+    }
+}
+
+void WavefrontIntegrator::TraceShadowRays(PathQueue& paths, uint64_t& numRays) const
+{
+    if (!m_HasSun)
+        return;
+
+    for (size_t i = 0; i < paths.GetSize(); ++i)
+    {
+        if (paths.m_ShadowWeight[i] <= 0.0)
+            continue;
+
+        ++numRays;
+        const Point3 origin(paths.m_OriginX[i], paths.m_OriginY[i], paths.m_OriginZ[i]);
+        if (!m_Scene.Intersect(Ray(origin, m_SunDirection), paths.m_Time[i]))
+            paths.AddRadiance(i, m_SunIrradiance * paths.m_ShadowWeight[i]);
+    }
+}
+
+void WavefrontIntegrator::Accumulate(FilmTile& tile, const Film& film, PathQueue& paths) const
+{
+    for (size_t i = 0; i < paths.GetSize(); ++i)
+    {
+        if (!paths.m_IsActive[i])
+            tile.AddSample({ paths.m_FilmX[i], paths.m_FilmY[i] }, paths.GetRadiance(i), film.GetFilterTable());
+    }
+}
+
+void WavefrontIntegrator::SortPaths(const PathQueue& paths, PathQueue& sorted)
+{
+    // Origins are quantized to 9 bits per axis, which leaves room for the octant and a 32 bit
+    // path index in a 64 bit sort key
+    constexpr double MortonScale = 511.0;
+    Point3 minOrigin(std::numeric_limits<double>::infinity());
+    Point3 maxOrigin(-std::numeric_limits<double>::infinity());
+
+    for (size_t i = 0; i < paths.GetSize(); ++i)
+    {
+        if (!paths.m_IsActive[i])
+            continue;
+
+        minOrigin = Point3(std::min(minOrigin.x, paths.m_OriginX[i]), std::min(minOrigin.y, paths.m_OriginY[i]), std::min(minOrigin.z, paths.m_OriginZ[i]));
+        maxOrigin = Point3(std::max(maxOrigin.x, paths.m_OriginX[i]), std::max(maxOrigin.y, paths.m_OriginY[i]), std::max(maxOrigin.z, paths.m_OriginZ[i]));
+    }
+
+    const Vector3 extent = maxOrigin - minOrigin;
+    const Vector3 scale(extent.x > 0.0 ? MortonScale / extent.x : 0.0, extent.y > 0.0 ? MortonScale / extent.y : 0.0, extent.z > 0.0 ? MortonScale / extent.z : 0.0);
+
+    // The key takes the high bits and the path index the low bits, so a plain sort of the
+    // packed values orders paths by key and keeps equal keys in their original order
+    std::vector<uint64_t> keys;
+    keys.reserve(paths.GetSize());
+
+    for (size_t i = 0; i < paths.GetSize(); ++i)
+    {
+        if (!paths.m_IsActive[i])
+            continue;
+
+        const uint32_t x = (uint32_t)((paths.m_OriginX[i] - minOrigin.x) * scale.x);
+        const uint32_t y = (uint32_t)((paths.m_OriginY[i] - minOrigin.y) * scale.y);
+        const uint32_t z = (uint32_t)((paths.m_OriginZ[i] - minOrigin.z) * scale.z);
+        const uint64_t morton = SpreadBits3(x) | (SpreadBits3(y) << 1) | (SpreadBits3(z) << 2);
+        const uint64_t octant = GetOctant(paths.m_DirectionX[i], paths.m_DirectionY[i], paths.m_DirectionZ[i]);
+
+        keys.push_back((((octant << 27) | morton) << 32) | i);
+    }
+
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<uint32_t> indices(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i)
+        indices[i] = (uint32_t)keys[i];
+
+    sorted.Gather(paths, indices);
+}
+
@@ -0,0 +1,88 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "integrator.h"
+#include "pathqueue.h"
+
+// Path traces grey diffuse surfaces lit by a constant sky and an optional directional sun.
+// Integrate traces one path at a time like any other integrator, IntegrateTile instead keeps
+// the paths of many samples of a tile in a queue and advances them together one bounce at a
+// time in the stages extend, shade, shadow and accumulate. Surviving paths are sorted by
+// direction and origin before the next bounce so that neighbouring paths traverse the scene
+// coherently, and the stages work on whole arrays so that they vectorize.
+class WavefrontIntegrator : public Integrator
+{
+public:
+    WavefrontIntegrator(const Accelerator& scene, int maxDepth = 5);
+    ~WavefrontIntegrator() override = default;
+
+public:
+    inline int GetMaxDepth() const { return m_MaxDepth; }
+    inline double GetAlbedo() const { return m_Albedo; }
+    inline const XyzCoefficients& GetSkyRadiance() const { return m_SkyRadiance; }
+    inline const Vector3& GetSunDirection() const { return m_SunDirection; }
+    inline const XyzCoefficients& GetSunIrradiance() const { return m_SunIrradiance; }
+
+public:
+    void SetAlbedo(double albedo);
+    void SetSkyRadiance(const XyzCoefficients& radiance);
+
+    // The direction points towards the sun, the irradiance is measured perpendicular to it
+    void SetSun(const Vector3& direction, const XyzCoefficients& irradiance);
+
+public:
+    XyzCoefficients Integrate(const Ray& ray, double time, Sampler& sampler, AovSample& aovs, uint64_t& numRays) const override;
+
+    // Camera rays come from the sampler, the paths themselves draw from per path random
+    // number streams so that they can be reordered, see PathQueue.
+    void IntegrateTile(Camera& camera, FilmTile& tile, Sampler& sampler, int firstSample, int numSamples, uint64_t& numRays) const override;
+
+public:
+    // Upper bound on the number of paths in flight per thread, tiles with more samples than
+    // fit are traced in several waves
+    static constexpr size_t MaxWaveSize = 1 << 16;
+
+protected:
+    friend class WavefrontIntegratorTest_SortsPathsByDirectionAndOrigin_Test;
+
+    void TraceWave(FilmTile& tile, const Film& film, PathQueue& paths, PathQueue& sorted, uint64_t& numRays) const;
+
+    void Extend(PathQueue& paths, uint64_t& numRays) const;
+    template <AovMask Mask>
+    void AddAovSamples(FilmTile& tile, const PathQueue& paths) const;
+    void Shade(PathQueue& paths, int depth) const;
+    void TraceShadowRays(PathQueue& paths, uint64_t& numRays) const;
+    void Accumulate(FilmTile& tile, const Film& film, PathQueue& paths) const;
+
+    // Compacts the active paths of a queue into the other, ordered by direction octant and
+    // then along a Morton curve through their origins
+    static void SortPaths(const PathQueue& paths, PathQueue& sorted);
+
+private:
+    const int m_MaxDepth;
+    double m_Albedo;
+    XyzCoefficients m_SkyRadiance;
+    Vector3 m_SunDirection;
+    XyzCoefficients m_SunIrradiance;
+    bool m_HasSun;
+};
+
@@ -0,0 +1,199 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <chrono>
+#include <thread>
+#include "renderer.h"
+#include "system/threading/threadpool.h"
+
+Renderer::Renderer(Camera& camera, const Integrator& integrator, const Sampler& sampler)
+    : m_Camera(camera)
+    , m_Integrator(integrator)
+    , m_Sampler(sampler)
+    , m_NumThreads(std::max(1u, std::thread::hardware_concurrency()))
+    , m_MaxError(0.0)
+    , m_SamplesPerPass(0)
+    , m_Checkpoint(nullptr)
+{
+}
+
+void Renderer::SetNumThreads(int numThreads)
+{
+    if (numThreads < 1)
+        throw std::invalid_argument("Renderer needs at least one thread");
+
+    m_NumThreads = numThreads;
+}
+
+void Renderer::SetAdaptiveSampling(double maxError, int samplesPerPass)
+{
+    if (maxError <= 0.0)
+        throw std::invalid_argument("Adaptive sampling error threshold must be positive");
+
+    if (samplesPerPass < 1)
+        throw std::invalid_argument("Adaptive sampling needs at least one sample per pass");
+
+    m_MaxError = maxError;
+    m_SamplesPerPass = samplesPerPass;
+}
+
+void Renderer::DisableAdaptiveSampling()
+{
+    m_MaxError = 0.0;
+    m_SamplesPerPass = 0;
+}
+
+void Renderer::SetCheckpoint(const std::string& path)
+{
+    m_CheckpointPath = path;
+}
+
+const RenderStatistics& Renderer::Render()
+{
+    Film& film = m_Camera.GetFilm();
+    m_Camera.UpdateCachedTransforms();
+    m_Error = nullptr;
+
+    if (IsAdaptive() && !film.IsTrackingVariance())
+        film.EnableVarianceTracking();
+
+    const int samplesPerPixel = m_Sampler.GetSamplesPerPixel();
+    const int samplesPerPass = IsAdaptive() ? std::min(m_SamplesPerPass, samplesPerPixel) : samplesPerPixel;
+    m_Statistics.m_NumPasses = 0;
+
+    // Recorded tiles continue with the sample after their last recorded one
+    FilmCheckpoint checkpoint(m_CheckpointPath);
+    m_Checkpoint = HasCheckpoint() ? &checkpoint : nullptr;
+
+    if (HasCheckpoint())
+        m_Statistics.m_TileSamplesPerPixel = checkpoint.Open(film, samplesPerPixel);
+    else
+        m_Statistics.m_TileSamplesPerPixel.assign(film.GetNumTiles(), 0);
+
+    std::atomic<uint64_t> numRays = 0;
+    const auto startTime = std::chrono::steady_clock::now();
+
+    // Tiles keep their order in the schedule from pass to pass
+    std::vector<int> tiles;
+    std::copy_if(film.GetTileSchedule().begin(), film.GetTileSchedule().end(), std::back_inserter(tiles), [this](int tileIndex) { return NeedsSamples(tileIndex); });
+
+    while (!tiles.empty())
+    {
+        RenderPass(tiles, samplesPerPass, numRays);
+        ++m_Statistics.m_NumPasses;
+
+        std::vector<int> unconvergedTiles;
+
+        for (int tileIndex : tiles)
+        {
+            int& tileSamples = m_Statistics.m_TileSamplesPerPixel[tileIndex];
+            tileSamples = std::min(tileSamples + samplesPerPass, samplesPerPixel);
+
+            if (NeedsSamples(tileIndex))
+                unconvergedTiles.push_back(tileIndex);
+        }
+
+        tiles.swap(unconvergedTiles);
+    }
+
+    checkpoint.Close();
+    m_Checkpoint = nullptr;
+
+    // Streaming films merge aprons as their tiles end, resident films do it once at the end
+    // and publish again so that snapshots include the merged contributions
+    if (!film.IsStreaming())
+    {
+        film.MergeTileAprons();
+
+        for (int i = 0; i < film.GetNumTiles(); ++i)
+            film.PublishTile(i);
+    }
+
+    m_Statistics.m_Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    m_Statistics.m_NumCameraRays = 0;
+    m_Statistics.m_NumRays = numRays;
+
+    for (int i = 0; i < film.GetNumTiles(); ++i)
+    {
+        const Vector2i size = film.GetTile(i).GetSize();
+        m_Statistics.m_NumCameraRays += (uint64_t)size.x * size.y * m_Statistics.m_TileSamplesPerPixel[i];
+    }
+
+    return m_Statistics;
+}
+
+bool Renderer::NeedsSamples(int tileIndex) const
+{
+    const int tileSamples = m_Statistics.m_TileSamplesPerPixel[tileIndex];
+
+    if (tileSamples >= m_Sampler.GetSamplesPerPixel())
+        return false;
+
+    return tileSamples == 0 || !IsAdaptive() || m_Camera.GetFilm().GetTile(tileIndex).GetError() > m_MaxError;
+}
+
+void Renderer::RenderPass(const std::vector<int>& tiles, int numSamples, std::atomic<uint64_t>& numRays)
+{
+    {
+        ThreadPool pool(m_NumThreads);
+
+        // Earlier tiles in the schedule get a higher priority
+        for (int i = 0; i < (int)tiles.size(); ++i)
+        {
+            const int tileIndex = tiles[i];
+            const int firstSample = m_Statistics.m_TileSamplesPerPixel[tileIndex];
+            const int numTileSamples = std::min(numSamples, m_Sampler.GetSamplesPerPixel() - firstSample);
+            pool.ScheduleTask((double)(tiles.size() - i), [this, &numRays](int index, int first, int count) { RenderTile(index, first, count, numRays); }, tileIndex, firstSample, numTileSamples);
+        }
+    }
+
+    if (m_Error)
+        std::rethrow_exception(m_Error);
+}
+
+void Renderer::RenderTile(int tileIndex, int firstSample, int numSamples, std::atomic<uint64_t>& numRays)
+{
+    try
+    {
+        Film& film = m_Camera.GetFilm();
+        FilmTile& tile = film.BeginTile(tileIndex);
+        std::unique_ptr<Sampler> sampler = m_Sampler.Clone();
+        uint64_t numTileRays = 0;
+
+        m_Integrator.IntegrateTile(m_Camera, tile, *sampler, firstSample, numSamples, numTileRays);
+        numRays += numTileRays;
+
+        if (m_Checkpoint != nullptr)
+            m_Checkpoint->WriteTile(tileIndex, firstSample + numSamples, tile);
+
+        if (film.IsStreaming())
+            film.EndTile(tileIndex);
+        else
+            film.PublishTile(tileIndex);
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(m_ErrorMutex);
+
+        if (!m_Error)
+            m_Error = std::current_exception();
+    }
+}
+
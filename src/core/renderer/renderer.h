@@ -0,0 +1,106 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "core/camera/camera.h"
+#include "core/film/filmcheckpoint.h"
+#include "core/integrator/integrator.h"
+
+struct RenderStatistics
+{
+    uint64_t m_NumCameraRays = 0;
+    uint64_t m_NumRays = 0;
+    double m_Seconds = 0.0;
+
+    // Samples per pixel each tile received, including those restored from a checkpoint,
+    // indexed like the film's tiles, and the number of passes over the film. Without adaptive
+    // sampling every tile gets the same samples in one pass.
+    std::vector<int> m_TileSamplesPerPixel;
+    int m_NumPasses = 0;
+
+    inline double GetMraysPerSecond() const { return m_Seconds > 0.0 ? m_NumRays / m_Seconds * 1e-6 : 0.0; }
+};
+
+// Renders the camera's film by scheduling each tile as a task on a thread pool. Tiles are
+// prioritized by their position in the film's tile schedule and rendered with every sample
+// per pixel before moving on, so that progressive exports see finished tiles. Each task
+// clones the sampler, tiles are only touched by the thread rendering them and nothing is
+// locked on the sample path.
+//
+// With adaptive sampling the film is rendered in passes of a few samples per pixel. After each
+// pass only the tiles whose largest relative pixel error still exceeds the threshold are
+// scheduled again, until they converge or reach the sampler's samples per pixel, so that
+// smooth regions stop taking samples early.
+//
+// With a checkpoint every tile is recorded after each pass. Rendering again with the same
+// checkpoint, film and sampler settings restores the recorded tiles and only renders what is
+// missing, and the final image is bit for bit that of an uninterrupted render.
+class Renderer
+{
+public:
+    Renderer(Camera& camera, const Integrator& integrator, const Sampler& sampler);
+    ~Renderer() = default;
+
+public:
+    inline int GetNumThreads() const { return m_NumThreads; }
+    inline bool IsAdaptive() const { return m_MaxError > 0.0; }
+    inline double GetMaxError() const { return m_MaxError; }
+    inline int GetSamplesPerPass() const { return m_SamplesPerPass; }
+    inline bool HasCheckpoint() const { return !m_CheckpointPath.empty(); }
+    inline const std::string& GetCheckpointPath() const { return m_CheckpointPath; }
+    inline const RenderStatistics& GetStatistics() const { return m_Statistics; }
+
+public:
+    void SetNumThreads(int numThreads);
+
+    // The error is the relative standard error of a pixel, see VarianceBuffer. Enables
+    // variance tracking on the film when rendering, which rules out streaming films.
+    void SetAdaptiveSampling(double maxError, int samplesPerPass = 4);
+    void DisableAdaptiveSampling();
+
+    // Resumes from and records progress to the checkpoint at path, an empty path disables
+    // checkpoints. See FilmCheckpoint.
+    void SetCheckpoint(const std::string& path);
+
+    // Blocks until every tile has been rendered, rethrowing the first error of any tile.
+    // Tiles are published to films with snapshots enabled as they finish, see Film::PublishTile.
+    const RenderStatistics& Render();
+
+private:
+    bool NeedsSamples(int tileIndex) const;
+    void RenderPass(const std::vector<int>& tiles, int numSamples, std::atomic<uint64_t>& numRays);
+    void RenderTile(int tileIndex, int firstSample, int numSamples, std::atomic<uint64_t>& numRays);
+
+private:
+    Camera& m_Camera;
+    const Integrator& m_Integrator;
+    const Sampler& m_Sampler;
+    int m_NumThreads;
+    double m_MaxError;
+    int m_SamplesPerPass;
+    std::string m_CheckpointPath;
+    FilmCheckpoint* m_Checkpoint;
+
+    RenderStatistics m_Statistics;
+    std::mutex m_ErrorMutex;
+    std::exception_ptr m_Error;
+};
+
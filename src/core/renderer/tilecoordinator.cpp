@@ -0,0 +1,238 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <chrono>
+#include "tilecoordinator.h"
+#include "tileprotocol.h"
+
+// How often the listener checks whether the frame is done while waiting for workers to connect
+const int AcceptPollMilliseconds = 100;
+
+TileCoordinator::TileCoordinator(Film& film, int samplesPerPixel)
+    : m_Film(film)
+    , m_SamplesPerPixel(samplesPerPixel)
+    , m_TileTimeout(0.0)
+    , m_NumTilesDone(0)
+    , m_ShouldStop(false)
+    , m_NumWorkers(0)
+    , m_NumReassignedTiles(0)
+    , m_NumRays(0)
+{
+    if (samplesPerPixel < 1)
+        throw std::invalid_argument("Tile coordinator needs at least one sample per pixel");
+
+    if (film.IsStreaming())
+        throw std::invalid_argument("Distributed rendering needs a film that keeps its tiles in memory");
+}
+
+TileCoordinator::~TileCoordinator()
+{
+    StopWorkers();
+}
+
+void TileCoordinator::Listen(const std::string& address)
+{
+    m_Listener = Socket::Listen(address);
+}
+
+int TileCoordinator::GetPort() const
+{
+    return m_Listener.GetPort();
+}
+
+void TileCoordinator::SetSceneId(const std::string& sceneId)
+{
+    m_SceneId = sceneId;
+}
+
+void TileCoordinator::SetTileTimeout(double seconds)
+{
+    if (seconds < 0.0)
+        throw std::invalid_argument("Tile timeout cannot be negative");
+
+    m_TileTimeout = seconds;
+}
+
+const RenderStatistics& TileCoordinator::Run()
+{
+    if (!IsListening())
+        throw std::runtime_error("Tile coordinator is not listening");
+
+    const auto startTime = std::chrono::steady_clock::now();
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_PendingTiles.assign(m_Film.GetTileSchedule().begin(), m_Film.GetTileSchedule().end());
+        m_TileAttempts.assign(m_Film.GetNumTiles(), 0);
+        m_NumTilesDone = 0;
+        m_ShouldStop = false;
+        m_Error = nullptr;
+    }
+
+    m_Statistics.m_TileSamplesPerPixel.assign(m_Film.GetNumTiles(), 0);
+    m_NumWorkers = 0;
+    m_NumReassignedTiles = 0;
+    m_NumRays = 0;
+
+    try
+    {
+        while (!IsFinished())
+        {
+            if (!m_Listener.WaitReadable(AcceptPollMilliseconds))
+                continue;
+
+            m_Threads.emplace_back(&TileCoordinator::ServeWorker, this, m_Listener.Accept());
+        }
+    }
+    catch (...)
+    {
+        StopWorkers();
+        throw;
+    }
+
+    StopWorkers();
+    m_Listener.Close();
+
+    if (m_Error != nullptr)
+        std::rethrow_exception(m_Error);
+
+    // Aprons of returned tiles are merged once every tile is in, as in a local render
+    m_Film.MergeTileAprons();
+
+    for (int i = 0; i < m_Film.GetNumTiles(); ++i)
+        m_Film.PublishTile(i);
+
+    m_Statistics.m_Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    m_Statistics.m_NumRays = m_NumRays;
+    m_Statistics.m_NumCameraRays = (uint64_t)m_Film.GetNumPixels() * m_SamplesPerPixel;
+    m_Statistics.m_NumPasses = 1;
+    return m_Statistics;
+}
+
+bool TileCoordinator::IsFinished()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_NumTilesDone == m_Film.GetNumTiles() || m_Error != nullptr;
+}
+
+void TileCoordinator::StopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_ShouldStop = true;
+    }
+
+    m_Condition.notify_all();
+
+    for (std::thread& thread : m_Threads)
+        thread.join();
+
+    m_Threads.clear();
+}
+
+void TileCoordinator::ServeWorker(Socket socket)
+{
+    try
+    {
+        socket.SetReceiveTimeout(m_TileTimeout);
+        TileProtocol::Send(socket, TileMessageType::Hello, TileProtocol::WriteHello(m_Film, m_SamplesPerPixel, m_SceneId));
+
+        // Workers that do not match the frame disconnect before they are handed a tile
+        TileMessage message;
+        if (!TileProtocol::Receive(socket, message) || message.m_Type != TileMessageType::Ready)
+            return;
+
+        ++m_NumWorkers;
+
+        while (true)
+        {
+            int tileIndex;
+
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_Condition.wait(lock, [this]() { return m_ShouldStop || m_Error != nullptr || !m_PendingTiles.empty() || m_NumTilesDone == m_Film.GetNumTiles(); });
+
+                // Tiles that are still out with other workers may yet come back, but once every
+                // tile is done or the render has failed this worker is no longer needed
+                if (m_ShouldStop || m_Error != nullptr || m_PendingTiles.empty())
+                    break;
+
+                tileIndex = m_PendingTiles.front();
+                m_PendingTiles.pop_front();
+                ++m_TileAttempts[tileIndex];
+            }
+
+            if (!RenderTile(socket, tileIndex))
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_Mutex);
+
+                    if (m_TileAttempts[tileIndex] < MaxTileAttempts)
+                    {
+                        m_PendingTiles.push_front(tileIndex);
+                        ++m_NumReassignedTiles;
+                    }
+                    else if (m_Error == nullptr)
+                        m_Error = std::make_exception_ptr(std::runtime_error("Tile " + std::to_string(tileIndex) + " was lost by too many workers"));
+                }
+
+                m_Condition.notify_all();
+                return;
+            }
+        }
+
+        TileProtocol::Send(socket, TileMessageType::Finish);
+    }
+    catch (...)
+    {
+        // The worker left while it had no tile, there is nothing to reassign
+    }
+}
+
+bool TileCoordinator::RenderTile(Socket& socket, int tileIndex)
+{
+    try
+    {
+        TileProtocol::Send(socket, TileMessageType::Job, TileProtocol::WriteJob(tileIndex));
+
+        TileMessage message;
+        if (!TileProtocol::Receive(socket, message) || message.m_Type != TileMessageType::Result)
+            return false;
+
+        // Nobody else touches the tile until it is done or handed out again, and a result
+        // that fails to read is replaced in full by the next one
+        m_NumRays += TileProtocol::ReadResult(message.m_Payload, tileIndex, m_Film.GetTile(tileIndex));
+        m_Film.PublishTile(tileIndex);
+    }
+    catch (...)
+    {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Statistics.m_TileSamplesPerPixel[tileIndex] = m_SamplesPerPixel;
+        ++m_NumTilesDone;
+    }
+
+    m_Condition.notify_all();
+    return true;
+}
+
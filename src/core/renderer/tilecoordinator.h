@@ -0,0 +1,100 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <thread>
+#include "renderer.h"
+#include "system/network/socket.h"
+
+// Distributes the tiles of a film over worker processes, see TileWorker. Workers connect to the
+// address the coordinator listens on and are handed one tile at a time in the order of the
+// film's tile schedule, which they render with every sample per pixel and send back. Workers
+// can join at any point during the render and are only handed tiles once they have confirmed
+// that they render the same scene id and film settings. A worker that disconnects or takes
+// longer than the tile timeout is dropped and the tile it was rendering goes back to the front
+// of the queue, so the frame completes as long as one worker is left. A tile that is lost MaxTileAttempts
+// times, for example because it takes longer than the timeout on every worker, fails the render.
+//
+// Workers render with the same sampler seeds as a local Renderer would, so the distributed
+// image is bit for bit that of a local render. Adaptive sampling and checkpoints are local only.
+class TileCoordinator
+{
+public:
+    TileCoordinator(Film& film, int samplesPerPixel);
+    ~TileCoordinator();
+
+public:
+    inline bool IsListening() const { return m_Listener.IsOpen(); }
+    inline const std::string& GetSceneId() const { return m_SceneId; }
+    inline double GetTileTimeout() const { return m_TileTimeout; }
+    inline int GetNumWorkers() const { return m_NumWorkers; }
+    inline int GetNumReassignedTiles() const { return m_NumReassignedTiles; }
+    inline const RenderStatistics& GetStatistics() const { return m_Statistics; }
+
+public:
+    void Listen(const std::string& address);
+
+    // The local port of a TCP address, useful when listening on port 0
+    int GetPort() const;
+
+    // Identifies the scene of the frame, workers only take tiles when theirs is the same
+    void SetSceneId(const std::string& sceneId);
+
+    // Workers that have not returned their tile after this many seconds are considered lost,
+    // zero waits for as long as the connection stays open
+    void SetTileTimeout(double seconds);
+
+    // Blocks until every tile has been returned by a worker, then stops listening. Throws
+    // std::runtime_error once a tile has been lost MaxTileAttempts times.
+    const RenderStatistics& Run();
+
+    static constexpr int MaxTileAttempts = 5;
+
+private:
+    bool IsFinished();
+    void StopWorkers();
+    void ServeWorker(Socket socket);
+    bool RenderTile(Socket& socket, int tileIndex);
+
+private:
+    Film& m_Film;
+    const int m_SamplesPerPixel;
+    std::string m_SceneId;
+    Socket m_Listener;
+    double m_TileTimeout;
+
+    std::mutex m_Mutex;
+    std::condition_variable m_Condition;
+    std::deque<int> m_PendingTiles;
+    std::vector<int> m_TileAttempts;
+    int m_NumTilesDone;
+    bool m_ShouldStop;
+    std::exception_ptr m_Error;
+    std::vector<std::thread> m_Threads;
+
+    std::atomic<int> m_NumWorkers;
+    std::atomic<int> m_NumReassignedTiles;
+    std::atomic<uint64_t> m_NumRays;
+    RenderStatistics m_Statistics;
+};
+
@@ -0,0 +1,149 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include "tileprotocol.h"
+#include "system/compression/zlib.h"
+
+const uint32_t MessageMagic = 0x54435053;
+const uint64_t MaxPayloadSize = 1ull << 30;
+const int ZlibQuality = 5;
+
+namespace
+{
+    template <typename T>
+    void Append(std::string& out, T value)
+    {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    T Extract(const std::string& data, size_t& offset)
+    {
+        if (offset + sizeof(T) > data.size())
+            throw std::runtime_error("Tile message is truncated");
+
+        T value;
+        std::memcpy(&value, data.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return value;
+    }
+}
+
+void TileProtocol::Send(Socket& socket, TileMessageType type, const std::string& payload)
+{
+    std::string message;
+    message.reserve(16 + payload.size());
+    Append(message, MessageMagic);
+    Append(message, (uint32_t)type);
+    Append(message, (uint64_t)payload.size());
+    message += payload;
+
+    socket.Send(message.data(), message.size());
+}
+
+bool TileProtocol::Receive(Socket& socket, TileMessage& message)
+{
+    uint32_t header[4];
+
+    if (!socket.Receive(header, sizeof(header)))
+        return false;
+
+    uint64_t payloadSize;
+    std::memcpy(&payloadSize, &header[2], sizeof(payloadSize));
+
+    if (header[0] != MessageMagic || header[1] > (uint32_t)TileMessageType::Finish || payloadSize > MaxPayloadSize)
+        throw std::runtime_error("Received an invalid tile message");
+
+    message.m_Type = (TileMessageType)header[1];
+    message.m_Payload.resize(payloadSize);
+
+    if (payloadSize > 0 && !socket.Receive(message.m_Payload.data(), payloadSize))
+        throw std::runtime_error("Connection closed part way through a message");
+
+    return true;
+}
+
+std::string TileProtocol::WriteHello(const Film& film, int samplesPerPixel, const std::string& sceneId)
+{
+    const std::vector<int32_t> header = FilmCheckpoint::GetHeader(film, samplesPerPixel);
+    std::string payload(reinterpret_cast<const char*>(header.data()), header.size() * sizeof(int32_t));
+    Append(payload, (uint64_t)sceneId.size());
+    payload += sceneId;
+    return payload;
+}
+
+bool TileProtocol::IsMatchingHello(const std::string& payload, const Film& film, int samplesPerPixel, const std::string& sceneId)
+{
+    return payload == WriteHello(film, samplesPerPixel, sceneId);
+}
+
+std::string TileProtocol::WriteJob(int tileIndex)
+{
+    std::string payload;
+    Append(payload, (int32_t)tileIndex);
+    return payload;
+}
+
+int TileProtocol::ReadJob(const std::string& payload)
+{
+    size_t offset = 0;
+    return Extract<int32_t>(payload, offset);
+}
+
+std::string TileProtocol::WriteResult(int tileIndex, uint64_t numRays, const FilmTile& tile)
+{
+    std::ostringstream stream;
+    tile.Write(stream);
+
+    std::string payload;
+    Append(payload, (int32_t)tileIndex);
+    Append(payload, numRays);
+    payload += Compress(stream.str());
+    return payload;
+}
+
+uint64_t TileProtocol::ReadResult(const std::string& payload, int tileIndex, FilmTile& tile)
+{
+    size_t offset = 0;
+
+    if (Extract<int32_t>(payload, offset) != tileIndex)
+        throw std::runtime_error("Tile result is for another tile");
+
+    const uint64_t numRays = Extract<uint64_t>(payload, offset);
+    std::istringstream stream(Decompress(payload.substr(offset)));
+    tile.Read(stream);
+    return numRays;
+}
+
+std::string TileProtocol::Compress(const std::string& data)
+{
+    const std::vector<char> compressed = Zlib::Compress(data.data(), data.size(), ZlibQuality);
+    return std::string(compressed.begin(), compressed.end());
+}
+
+std::string TileProtocol::Decompress(const std::string& data)
+{
+    const std::vector<char> decompressed = Zlib::Decompress(data.data(), data.size());
+    return std::string(decompressed.begin(), decompressed.end());
+}
+
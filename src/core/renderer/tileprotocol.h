@@ -0,0 +1,67 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "core/film/filmcheckpoint.h"
+#include "system/network/socket.h"
+
+// Messages exchanged between a TileCoordinator and its TileWorkers. Each message is a header
+// with its type and payload size followed by the payload. Tiles travel as their serialized
+// buffers, see FilmTile::Write, deflated with zlib since most of a tile's bytes are weights and
+// unused channels that compress well.
+enum class TileMessageType : uint32_t
+{
+    Hello,  // Coordinator to worker, the film header of the frame, see FilmCheckpoint::GetHeader, and the scene id
+    Ready,  // Worker to coordinator, the worker matches the hello and takes tiles
+    Job,    // Coordinator to worker, the index of a tile to render with every sample per pixel
+    Result, // Worker to coordinator, the tile index, the number of rays traced and the tile
+    Finish  // Coordinator to worker, every tile of the frame has been rendered
+};
+
+struct TileMessage
+{
+    TileMessageType m_Type;
+    std::string m_Payload;
+};
+
+namespace TileProtocol
+{
+    void Send(Socket& socket, TileMessageType type, const std::string& payload = {});
+
+    // Returns false if the peer disconnected between two messages
+    bool Receive(Socket& socket, TileMessage& message);
+
+    std::string WriteHello(const Film& film, int samplesPerPixel, const std::string& sceneId);
+    bool IsMatchingHello(const std::string& payload, const Film& film, int samplesPerPixel, const std::string& sceneId);
+
+    std::string WriteJob(int tileIndex);
+    int ReadJob(const std::string& payload);
+
+    std::string WriteResult(int tileIndex, uint64_t numRays, const FilmTile& tile);
+
+    // Reads the result into tile and returns the number of rays traced for it. Throws if the
+    // result is for another tile or does not match the tile's layout.
+    uint64_t ReadResult(const std::string& payload, int tileIndex, FilmTile& tile);
+
+    std::string Compress(const std::string& data);
+    std::string Decompress(const std::string& data);
+}
+
@@ -0,0 +1,124 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <thread>
+#include "tileworker.h"
+#include "tileprotocol.h"
+
+TileWorker::TileWorker(Camera& camera, const Integrator& integrator, const Sampler& sampler)
+    : m_Camera(camera)
+    , m_Integrator(integrator)
+    , m_Sampler(sampler)
+    , m_NumThreads(std::max(1u, std::thread::hardware_concurrency()))
+    , m_NumTilesRendered(0)
+    , m_NumRays(0)
+{
+}
+
+void TileWorker::SetNumThreads(int numThreads)
+{
+    if (numThreads < 1)
+        throw std::invalid_argument("Tile worker needs at least one thread");
+
+    m_NumThreads = numThreads;
+}
+
+void TileWorker::SetSceneId(const std::string& sceneId)
+{
+    m_SceneId = sceneId;
+}
+
+void TileWorker::Run(const std::string& address, double connectTimeout)
+{
+    if (m_Camera.GetFilm().IsStreaming())
+        throw std::runtime_error("Tile workers need a film that keeps its tiles in memory");
+
+    m_Camera.UpdateCachedTransforms();
+    m_NumTilesRendered = 0;
+    m_NumRays = 0;
+    m_Error = nullptr;
+
+    {
+        std::vector<std::thread> threads;
+
+        for (int i = 0; i < m_NumThreads; ++i)
+            threads.emplace_back(&TileWorker::ServeCoordinator, this, address, connectTimeout);
+
+        for (std::thread& thread : threads)
+            thread.join();
+    }
+
+    if (m_Error)
+        std::rethrow_exception(m_Error);
+}
+
+void TileWorker::ServeCoordinator(const std::string& address, double connectTimeout)
+{
+    try
+    {
+        const Film& film = m_Camera.GetFilm();
+        const int samplesPerPixel = m_Sampler.GetSamplesPerPixel();
+        Socket socket = Socket::Connect(address, connectTimeout);
+
+        TileMessage message;
+        if (!TileProtocol::Receive(socket, message) || message.m_Type != TileMessageType::Hello)
+            throw std::runtime_error("Tile coordinator did not introduce the frame");
+
+        if (!TileProtocol::IsMatchingHello(message.m_Payload, film, samplesPerPixel, m_SceneId))
+            throw std::runtime_error("Tile coordinator is rendering another scene or a film with other settings");
+
+        TileProtocol::Send(socket, TileMessageType::Ready);
+
+        while (true)
+        {
+            if (!TileProtocol::Receive(socket, message))
+                throw std::runtime_error("Tile coordinator disconnected");
+
+            if (message.m_Type == TileMessageType::Finish)
+                return;
+
+            if (message.m_Type != TileMessageType::Job)
+                throw std::runtime_error("Received an unexpected tile message");
+
+            const int tileIndex = TileProtocol::ReadJob(message.m_Payload);
+
+            if (tileIndex < 0 || tileIndex >= film.GetNumTiles())
+                throw std::runtime_error("Tile coordinator sent an invalid tile");
+
+            FilmTile tile = film.GetTile(tileIndex);
+            std::unique_ptr<Sampler> sampler = m_Sampler.Clone();
+            uint64_t numTileRays = 0;
+
+            m_Integrator.IntegrateTile(m_Camera, tile, *sampler, 0, samplesPerPixel, numTileRays);
+            TileProtocol::Send(socket, TileMessageType::Result, TileProtocol::WriteResult(tileIndex, numTileRays, tile));
+
+            ++m_NumTilesRendered;
+            m_NumRays += numTileRays;
+        }
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(m_ErrorMutex);
+
+        if (!m_Error)
+            m_Error = std::current_exception();
+    }
+}
+
@@ -0,0 +1,71 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "core/camera/camera.h"
+#include "core/integrator/integrator.h"
+#include "system/network/socket.h"
+
+// Renders tiles handed out by a TileCoordinator, see there. The worker needs the same scene,
+// camera and sampler as the coordinator's frame and checks that its film and scene id match
+// before taking any work. Every thread holds its own connection and is a separate worker to the coordinator.
+//
+// Tiles are rendered into copies of the untouched tiles of the worker's film, which is never
+// written to, so a tile that is handed out again renders from scratch.
+class TileWorker
+{
+public:
+    TileWorker(Camera& camera, const Integrator& integrator, const Sampler& sampler);
+    ~TileWorker() = default;
+
+public:
+    inline const std::string& GetSceneId() const { return m_SceneId; }
+    inline int GetNumThreads() const { return m_NumThreads; }
+    inline int GetNumTilesRendered() const { return m_NumTilesRendered; }
+    inline uint64_t GetNumRays() const { return m_NumRays; }
+
+public:
+    void SetNumThreads(int numThreads);
+
+    // Must be the scene id the coordinator was given, see TileCoordinator::SetSceneId
+    void SetSceneId(const std::string& sceneId);
+
+    // Renders tiles until the coordinator reports the frame as finished, retrying the connection
+    // for up to connectTimeout seconds. Rethrows the first error of any thread, which includes
+    // the coordinator disconnecting and a film or scene that does not match the coordinator's.
+    void Run(const std::string& address, double connectTimeout = 0.0);
+
+private:
+    void ServeCoordinator(const std::string& address, double connectTimeout);
+
+private:
+    Camera& m_Camera;
+    const Integrator& m_Integrator;
+    const Sampler& m_Sampler;
+    std::string m_SceneId;
+    int m_NumThreads;
+
+    std::atomic<int> m_NumTilesRendered;
+    std::atomic<uint64_t> m_NumRays;
+    std::mutex m_ErrorMutex;
+    std::exception_ptr m_Error;
+};
+
@@ -0,0 +1,237 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "batchsampling.h"
+
+#ifdef SPC_USE_AVX_2
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    constexpr double TwoPi = 2.0 * SMath::Pi;
+
+    void ValidateBatch(size_t size, std::initializer_list<size_t> sizes)
+    {
+        for (size_t other : sizes)
+            if (other != size)
+                throw std::invalid_argument("Sample batch spans must have the same size");
+    }
+
+    inline void ConcentricSample(double u0, double u1, double& x, double& y)
+    {
+        const double a = 2.0 * u0 - 1.0;
+        const double b = 2.0 * u1 - 1.0;
+        const bool useA = std::abs(a) > std::abs(b);
+
+        // The center maps to itself, guard its division instead of branching on it
+        const double r = useA ? a : b;
+        const double ratio = useA ? b / a : a / (b != 0.0 ? b : 1.0);
+        const double theta = useA ? SMath::PiOver4 * ratio : SMath::PiOver2 - SMath::PiOver4 * ratio;
+
+        double sine, cosine;
+        BatchSampling::FastSinCos(theta, sine, cosine);
+        x = r * cosine;
+        y = r * sine;
+    }
+
+#ifdef SPC_USE_AVX_2
+    constexpr size_t LaneWidth = 4;
+
+    inline void FastSinCos4(__m256d angle, __m256d& sine, __m256d& cosine)
+    {
+        const __m256d quadrant = _mm256_round_pd(_mm256_mul_pd(angle, _mm256_set1_pd(0.63661977236758134308)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        __m256d r = _mm256_sub_pd(angle, _mm256_mul_pd(quadrant, _mm256_set1_pd(1.5707963267948966)));
+        r = _mm256_sub_pd(r, _mm256_mul_pd(quadrant, _mm256_set1_pd(6.123233995736766e-17)));
+        const __m256d r2 = _mm256_mul_pd(r, r);
+
+        __m256d s = _mm256_set1_pd(-1.0 / 39916800);
+        s = _mm256_add_pd(_mm256_mul_pd(s, r2), _mm256_set1_pd(1.0 / 362880));
+        s = _mm256_add_pd(_mm256_mul_pd(s, r2), _mm256_set1_pd(-1.0 / 5040));
+        s = _mm256_add_pd(_mm256_mul_pd(s, r2), _mm256_set1_pd(1.0 / 120));
+        s = _mm256_add_pd(_mm256_mul_pd(s, r2), _mm256_set1_pd(-1.0 / 6));
+        s = _mm256_add_pd(r, _mm256_mul_pd(_mm256_mul_pd(s, r2), r));
+
+        __m256d c = _mm256_set1_pd(1.0 / 479001600);
+        c = _mm256_add_pd(_mm256_mul_pd(c, r2), _mm256_set1_pd(-1.0 / 3628800));
+        c = _mm256_add_pd(_mm256_mul_pd(c, r2), _mm256_set1_pd(1.0 / 40320));
+        c = _mm256_add_pd(_mm256_mul_pd(c, r2), _mm256_set1_pd(-1.0 / 720));
+        c = _mm256_add_pd(_mm256_mul_pd(c, r2), _mm256_set1_pd(1.0 / 24));
+        c = _mm256_add_pd(_mm256_mul_pd(c, r2), _mm256_set1_pd(-1.0 / 2));
+        c = _mm256_add_pd(_mm256_mul_pd(c, r2), _mm256_set1_pd(1.0));
+
+        // Odd quadrants swap sine and cosine, the second bit of the quadrant moves into the sign bit
+        const __m256i q = _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(quadrant));
+        const __m256d swap = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(q, _mm256_set1_epi64x(1)), _mm256_set1_epi64x(1)));
+        const __m256d sineSign = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_and_si256(q, _mm256_set1_epi64x(2)), 62));
+        const __m256d cosineSign = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_and_si256(_mm256_add_epi64(q, _mm256_set1_epi64x(1)), _mm256_set1_epi64x(2)), 62));
+
+        sine = _mm256_xor_pd(_mm256_blendv_pd(s, c, swap), sineSign);
+        cosine = _mm256_xor_pd(_mm256_blendv_pd(c, s, swap), cosineSign);
+    }
+
+    inline __m256d SafeSqrt4(__m256d value)
+    {
+        return _mm256_sqrt_pd(_mm256_max_pd(value, _mm256_setzero_pd()));
+    }
+
+    inline void ConcentricSample4(__m256d u0, __m256d u1, __m256d& x, __m256d& y)
+    {
+        const __m256d one = _mm256_set1_pd(1.0);
+        const __m256d signMask = _mm256_set1_pd(-0.0);
+        const __m256d a = _mm256_sub_pd(_mm256_add_pd(u0, u0), one);
+        const __m256d b = _mm256_sub_pd(_mm256_add_pd(u1, u1), one);
+        const __m256d useA = _mm256_cmp_pd(_mm256_andnot_pd(signMask, a), _mm256_andnot_pd(signMask, b), _CMP_GT_OQ);
+
+        const __m256d safeB = _mm256_blendv_pd(b, one, _mm256_cmp_pd(b, _mm256_setzero_pd(), _CMP_EQ_OQ));
+        const __m256d r = _mm256_blendv_pd(b, a, useA);
+        const __m256d ratio = _mm256_blendv_pd(_mm256_div_pd(a, safeB), _mm256_div_pd(b, a), useA);
+        const __m256d angle = _mm256_mul_pd(ratio, _mm256_set1_pd(SMath::PiOver4));
+        const __m256d theta = _mm256_blendv_pd(_mm256_sub_pd(_mm256_set1_pd(SMath::PiOver2), angle), angle, useA);
+
+        __m256d sine, cosine;
+        FastSinCos4(theta, sine, cosine);
+        x = _mm256_mul_pd(r, cosine);
+        y = _mm256_mul_pd(r, sine);
+    }
+#endif
+}
+
+void BatchSampling::FastSinCos(std::span<const double> angles, std::span<double> sines, std::span<double> cosines)
+{
+    ValidateBatch(angles.size(), { sines.size(), cosines.size() });
+    size_t i = 0;
+
+#ifdef SPC_USE_AVX_2
+    for (; i + LaneWidth <= angles.size(); i += LaneWidth)
+    {
+        __m256d sine, cosine;
+        FastSinCos4(_mm256_loadu_pd(&angles[i]), sine, cosine);
+        _mm256_storeu_pd(&sines[i], sine);
+        _mm256_storeu_pd(&cosines[i], cosine);
+    }
+#endif
+
+    for (; i < angles.size(); ++i)
+        FastSinCos(angles[i], sines[i], cosines[i]);
+}
+
+void BatchSampling::UniformSampleHemisphere(std::span<const double> u0, std::span<const double> u1, std::span<double> x, std::span<double> y, std::span<double> z)
+{
+    ValidateBatch(u0.size(), { u1.size(), x.size(), y.size(), z.size() });
+    size_t i = 0;
+
+#ifdef SPC_USE_AVX_2
+    for (; i + LaneWidth <= u0.size(); i += LaneWidth)
+    {
+        const __m256d cosTheta = _mm256_loadu_pd(&u0[i]);
+        const __m256d r = SafeSqrt4(_mm256_sub_pd(_mm256_set1_pd(1.0), _mm256_mul_pd(cosTheta, cosTheta)));
+        __m256d sine, cosine;
+        FastSinCos4(_mm256_mul_pd(_mm256_loadu_pd(&u1[i]), _mm256_set1_pd(TwoPi)), sine, cosine);
+        _mm256_storeu_pd(&x[i], _mm256_mul_pd(r, cosine));
+        _mm256_storeu_pd(&y[i], cosTheta);
+        _mm256_storeu_pd(&z[i], _mm256_mul_pd(r, sine));
+    }
+#endif
+
+    for (; i < u0.size(); ++i)
+    {
+        const double r = std::sqrt(std::max(0.0, 1.0 - u0[i] * u0[i]));
+        double sine, cosine;
+        FastSinCos(TwoPi * u1[i], sine, cosine);
+        x[i] = r * cosine;
+        y[i] = u0[i];
+        z[i] = r * sine;
+    }
+}
+
+void BatchSampling::UniformSampleSphere(std::span<const double> u0, std::span<const double> u1, std::span<double> x, std::span<double> y, std::span<double> z)
+{
+    ValidateBatch(u0.size(), { u1.size(), x.size(), y.size(), z.size() });
+    size_t i = 0;
+
+#ifdef SPC_USE_AVX_2
+    for (; i + LaneWidth <= u0.size(); i += LaneWidth)
+    {
+        const __m256d cosTheta = _mm256_sub_pd(_mm256_set1_pd(1.0), _mm256_mul_pd(_mm256_loadu_pd(&u0[i]), _mm256_set1_pd(2.0)));
+        const __m256d r = SafeSqrt4(_mm256_sub_pd(_mm256_set1_pd(1.0), _mm256_mul_pd(cosTheta, cosTheta)));
+        __m256d sine, cosine;
+        FastSinCos4(_mm256_mul_pd(_mm256_loadu_pd(&u1[i]), _mm256_set1_pd(TwoPi)), sine, cosine);
+        _mm256_storeu_pd(&x[i], _mm256_mul_pd(r, cosine));
+        _mm256_storeu_pd(&y[i], _mm256_mul_pd(r, sine));
+        _mm256_storeu_pd(&z[i], cosTheta);
+    }
+#endif
+
+    for (; i < u0.size(); ++i)
+    {
+        const double cosTheta = 1.0 - 2.0 * u0[i];
+        const double r = std::sqrt(std::max(0.0, 1.0 - cosTheta * cosTheta));
+        double sine, cosine;
+        FastSinCos(TwoPi * u1[i], sine, cosine);
+        x[i] = r * cosine;
+        y[i] = r * sine;
+        z[i] = cosTheta;
+    }
+}
+
+void BatchSampling::CosineSampleHemisphere(std::span<const double> u0, std::span<const double> u1, std::span<double> x, std::span<double> y, std::span<double> z)
+{
+    ValidateBatch(u0.size(), { u1.size(), x.size(), y.size(), z.size() });
+    size_t i = 0;
+
+#ifdef SPC_USE_AVX_2
+    for (; i + LaneWidth <= u0.size(); i += LaneWidth)
+    {
+        __m256d diskX, diskY;
+        ConcentricSample4(_mm256_loadu_pd(&u0[i]), _mm256_loadu_pd(&u1[i]), diskX, diskY);
+        const __m256d radius2 = _mm256_add_pd(_mm256_mul_pd(diskX, diskX), _mm256_mul_pd(diskY, diskY));
+        _mm256_storeu_pd(&x[i], diskX);
+        _mm256_storeu_pd(&y[i], diskY);
+        _mm256_storeu_pd(&z[i], SafeSqrt4(_mm256_sub_pd(_mm256_set1_pd(1.0), radius2)));
+    }
+#endif
+
+    for (; i < u0.size(); ++i)
+    {
+        ConcentricSample(u0[i], u1[i], x[i], y[i]);
+        z[i] = std::sqrt(std::max(0.0, 1.0 - x[i] * x[i] - y[i] * y[i]));
+    }
+}
+
+void BatchSampling::ConcentricSampleDisk(std::span<const double> u0, std::span<const double> u1, std::span<double> x, std::span<double> y)
+{
+    ValidateBatch(u0.size(), { u1.size(), x.size(), y.size() });
+    size_t i = 0;
+
+#ifdef SPC_USE_AVX_2
+    for (; i + LaneWidth <= u0.size(); i += LaneWidth)
+    {
+        __m256d diskX, diskY;
+        ConcentricSample4(_mm256_loadu_pd(&u0[i]), _mm256_loadu_pd(&u1[i]), diskX, diskY);
+        _mm256_storeu_pd(&x[i], diskX);
+        _mm256_storeu_pd(&y[i], diskY);
+    }
+#endif
+
+    for (; i < u0.size(); ++i)
+        ConcentricSample(u0[i], u1[i], x[i], y[i]);
+}
+
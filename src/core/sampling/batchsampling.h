@@ -0,0 +1,60 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+// Batched counterparts of the warping functions in sampling.h for wavefront style integrators
+// that generate many secondary rays at once. Inputs and outputs are structure-of-arrays spans of
+// equal size. The functions are branch free and replace sin and cos with a polynomial
+// approximation; with SPC_USE_AVX_2 they process four samples per instruction.
+namespace BatchSampling
+{
+    // Polynomial sine and cosine, accurate to about 1e-12 for arguments within a few turns of zero
+    inline void FastSinCos(double angle, double& sine, double& cosine)
+    {
+        constexpr double TwoOverPi = 0.63661977236758134308;
+        constexpr double PiOver2Hi = 1.5707963267948966;
+        constexpr double PiOver2Lo = 6.123233995736766e-17;
+
+        // Reduce to [-pi/4, pi/4] around the nearest multiple of pi/2
+        const double quadrant = std::nearbyint(angle * TwoOverPi);
+        const double r = (angle - quadrant * PiOver2Hi) - quadrant * PiOver2Lo;
+        const double r2 = r * r;
+
+        const double s = r + r * r2 * (-1.0 / 6 + r2 * (1.0 / 120 + r2 * (-1.0 / 5040 + r2 * (1.0 / 362880 + r2 * (-1.0 / 39916800)))));
+        const double c = 1.0 + r2 * (-1.0 / 2 + r2 * (1.0 / 24 + r2 * (-1.0 / 720 + r2 * (1.0 / 40320 + r2 * (-1.0 / 3628800 + r2 * (1.0 / 479001600))))));
+
+        const int q = (int)(int64_t)quadrant & 3;
+        sine = (q & 1) ? c : s;
+        cosine = (q & 1) ? s : c;
+        sine = (q & 2) ? -sine : sine;
+        cosine = ((q + 1) & 2) ? -cosine : cosine;
+    }
+
+    void FastSinCos(std::span<const double> angles, std::span<double> sines, std::span<double> cosines);
+
+    void UniformSampleHemisphere(std::span<const double> u0, std::span<const double> u1, std::span<double> x, std::span<double> y, std::span<double> z);
+    void UniformSampleSphere(std::span<const double> u0, std::span<const double> u1, std::span<double> x, std::span<double> y, std::span<double> z);
+    void CosineSampleHemisphere(std::span<const double> u0, std::span<const double> u1, std::span<double> x, std::span<double> y, std::span<double> z);
+
+    // Concentric mapping, also the bounded replacement for rejection sampling the disk
+    void ConcentricSampleDisk(std::span<const double> u0, std::span<const double> u1, std::span<double> x, std::span<double> y);
+}
+
@@ -0,0 +1,57 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "haltonsampler.h"
+#include "lowdiscrepancy.h"
+
+HaltonSampler::HaltonSampler(int samplesPerPixel, uint64_t seed)
+    : Sampler(samplesPerPixel, seed)
+{
+}
+
+double HaltonSampler::Get1D()
+{
+    return SampleDimension(m_Dimension++);
+}
+
+Point2 HaltonSampler::Get2D()
+{
+    const double x = SampleDimension(m_Dimension++);
+    const double y = SampleDimension(m_Dimension++);
+    return { x, y };
+}
+
+std::unique_ptr<Sampler> HaltonSampler::Clone() const
+{
+    return std::make_unique<HaltonSampler>(*this);
+}
+
+double HaltonSampler::SampleDimension(int dimension) const
+{
+    const uint64_t hash = LowDiscrepancy::Hash(m_Pixel.x, m_Pixel.y, dimension, m_Seed);
+
+    if (dimension >= LowDiscrepancy::NumPrimes)
+        return LowDiscrepancy::ToUnitInterval((uint32_t)LowDiscrepancy::Hash(hash, m_SampleIndex));
+
+    // The shift also moves the first point of the sequence away from the origin, where it lies in every base
+    const double value = LowDiscrepancy::RadicalInverse(dimension, m_SampleIndex) + LowDiscrepancy::ToUnitInterval((uint32_t)hash);
+    return value >= 1.0 ? value - 1.0 : value;
+}
+
@@ -0,0 +1,43 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "sampler.h"
+
+// Samples the Halton sequence, whose dimensions are radical inverses in successive prime bases.
+// Every pixel walks the same sequence under its own random toroidal shift per dimension
+// (Cranley-Patterson rotation). Dimensions past the prime table fall back to random values.
+class HaltonSampler : public Sampler
+{
+public:
+    HaltonSampler(int samplesPerPixel, uint64_t seed = 0);
+    ~HaltonSampler() override = default;
+
+public:
+    double Get1D() override;
+    Point2 Get2D() override;
+
+    std::unique_ptr<Sampler> Clone() const override;
+
+private:
+    double SampleDimension(int dimension) const;
+};
+
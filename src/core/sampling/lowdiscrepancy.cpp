@@ -0,0 +1,86 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "lowdiscrepancy.h"
+
+const int LowDiscrepancy::Primes[LowDiscrepancy::NumPrimes] =
+{
+    2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53,
+    59, 61, 67, 71, 73, 79, 83, 89, 97, 101, 103, 107, 109, 113, 127, 131,
+    137, 139, 149, 151, 157, 163, 167, 173, 179, 181, 191, 193, 197, 199, 211, 223,
+    227, 229, 233, 239, 241, 251, 257, 263, 269, 271, 277, 281, 283, 293, 307, 311
+};
+
+uint32_t LowDiscrepancy::PermutationElement(uint32_t index, uint32_t length, uint32_t seed)
+{
+    // Bijective hash on the next power of two, cycle walking until the result is within length
+    uint32_t mask = length - 1;
+    mask |= mask >> 1;
+    mask |= mask >> 2;
+    mask |= mask >> 4;
+    mask |= mask >> 8;
+    mask |= mask >> 16;
+
+    do
+    {
+        index ^= seed;
+        index *= 0xe170893d;
+        index ^= seed >> 16;
+        index ^= (index & mask) >> 4;
+        index ^= seed >> 8;
+        index *= 0x0929eb3f;
+        index ^= seed >> 23;
+        index ^= (index & mask) >> 1;
+        index *= 1 | seed >> 27;
+        index *= 0x6935fa69;
+        index ^= (index & mask) >> 11;
+        index *= 0x74dcb303;
+        index ^= (index & mask) >> 2;
+        index *= 0x9e501cc3;
+        index ^= (index & mask) >> 2;
+        index *= 0xc860a3df;
+        index &= mask;
+        index ^= index >> 5;
+    } while (index >= length);
+
+    return (index + seed) % length;
+}
+
+double LowDiscrepancy::RadicalInverse(int baseIndex, uint64_t index)
+{
+    if (baseIndex < 0 || baseIndex >= NumPrimes)
+        throw std::invalid_argument("Radical inverse base index is out of range");
+
+    const uint64_t base = Primes[baseIndex];
+    const double invBase = 1.0 / base;
+    uint64_t reversedDigits = 0;
+    double invBaseN = 1.0;
+
+    while (index != 0)
+    {
+        const uint64_t next = index / base;
+        reversedDigits = reversedDigits * base + (index - next * base);
+        invBaseN *= invBase;
+        index = next;
+    }
+
+    return std::min(reversedDigits * invBaseN, 1.0 - 0x1p-53);
+}
+
@@ -0,0 +1,87 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "rng.h"
+
+// Building blocks for low discrepancy samplers. Values are 32 bit fixed point fractions, i.e.
+// a value v stands for v / 2^32.
+namespace LowDiscrepancy
+{
+    constexpr int NumPrimes = 64;
+    extern const int Primes[NumPrimes];
+
+    inline uint32_t ReverseBits32(uint32_t value)
+    {
+        value = (value << 16) | (value >> 16);
+        value = ((value & 0x00ff00ff) << 8) | ((value & 0xff00ff00) >> 8);
+        value = ((value & 0x0f0f0f0f) << 4) | ((value & 0xf0f0f0f0) >> 4);
+        value = ((value & 0x33333333) << 2) | ((value & 0xcccccccc) >> 2);
+        value = ((value & 0x55555555) << 1) | ((value & 0xaaaaaaaa) >> 1);
+        return value;
+    }
+
+    inline double ToUnitInterval(uint32_t value)
+    {
+        return value * 0x1p-32;
+    }
+
+    // Combines values into a well distributed seed
+    inline uint64_t Hash(uint64_t a, uint64_t b, uint64_t c = 0, uint64_t d = 0)
+    {
+        return Rng::MixBits(a ^ Rng::MixBits(b ^ Rng::MixBits(c ^ Rng::MixBits(d))));
+    }
+
+    // The first two dimensions of the Sobol sequence, which are also the (0, 2) sequence
+    inline uint32_t SobolSample0(uint32_t index) { return ReverseBits32(index); }
+
+    inline uint32_t SobolSample1(uint32_t index)
+    {
+        uint32_t value = 0;
+
+        for (uint32_t direction = 1u << 31; index != 0; index >>= 1, direction ^= direction >> 1)
+            if (index & 1)
+                value ^= direction;
+
+        return value;
+    }
+
+    // Nested uniform scrambling (Owen 1995) with the hash based permutation of Laine and Karras.
+    // Scrambled points keep their stratification while being decorrelated across seeds.
+    inline uint32_t OwenScramble(uint32_t value, uint32_t seed)
+    {
+        value = ReverseBits32(value);
+        value ^= value * 0x3d20adea;
+        value += seed;
+        value *= (seed >> 16) | 1;
+        value ^= value * 0x05526c56;
+        value ^= value * 0x53a22864;
+        return ReverseBits32(value);
+    }
+
+    // Element index of a pseudo random permutation of [0, length), without storing the permutation
+    // (Kensler 2013). Every seed gives a different permutation.
+    uint32_t PermutationElement(uint32_t index, uint32_t length, uint32_t seed);
+
+    // Van der Corput sequence in the given base, with the digits of index mirrored around the radix point
+    double RadicalInverse(int baseIndex, uint64_t index);
+}
+
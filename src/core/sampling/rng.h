@@ -0,0 +1,111 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+// PCG32 random number generator (O'Neill 2014). It is small enough to give every render thread
+// its own instance, and seeding it per pixel and sample makes renders reproducible regardless of
+// how work is scheduled across threads.
+class Rng
+{
+public:
+    Rng() { SetSequence(DefaultSequence); }
+    Rng(uint64_t sequenceIndex, uint64_t seed = 0) { SetSequence(sequenceIndex, seed); }
+    ~Rng() = default;
+
+public:
+    static constexpr uint64_t DefaultState = 0x853c49e6748fea9bULL;
+    static constexpr uint64_t DefaultSequence = 0xda3e39cb94b95bdbULL;
+    static constexpr uint64_t Multiplier = 0x5851f42d4c957f2dULL;
+
+public:
+    // Each sequence index selects an independent stream
+    inline void SetSequence(uint64_t sequenceIndex, uint64_t seed = MixBits(DefaultState))
+    {
+        m_State = 0;
+        m_Increment = (sequenceIndex << 1) | 1;
+        UniformUInt32();
+        m_State += seed;
+        UniformUInt32();
+    }
+
+    // Starts the stream of a single pixel sample, consecutive samples of a pixel stay on one stream
+    inline void SetPixelSample(const Point2i& pixel, int sampleIndex, uint64_t seed = 0)
+    {
+        SetSequence(MixBits(((uint64_t)(uint32_t)pixel.x << 32) ^ (uint32_t)pixel.y), MixBits(seed));
+        Advance((int64_t)sampleIndex * DimensionsPerSample);
+    }
+
+    inline uint32_t UniformUInt32()
+    {
+        const uint64_t oldState = m_State;
+        m_State = oldState * Multiplier + m_Increment;
+        const uint32_t xorShifted = (uint32_t)(((oldState >> 18) ^ oldState) >> 27);
+        const uint32_t rotation = (uint32_t)(oldState >> 59);
+        return (xorShifted >> rotation) | (xorShifted << ((~rotation + 1) & 31));
+    }
+
+    // Uniform in [0, 1)
+    inline double UniformDouble() { return UniformUInt32() * 0x1p-32; }
+    inline Point2 UniformPoint2() { return { UniformDouble(), UniformDouble() }; }
+
+    // Skips delta values in logarithmic time, negative deltas step backwards
+    inline void Advance(int64_t delta)
+    {
+        uint64_t currentMultiplier = Multiplier;
+        uint64_t currentIncrement = m_Increment;
+        uint64_t accumulatedMultiplier = 1;
+        uint64_t accumulatedIncrement = 0;
+
+        for (uint64_t remaining = (uint64_t)delta; remaining > 0; remaining >>= 1)
+        {
+            if (remaining & 1)
+            {
+                accumulatedMultiplier *= currentMultiplier;
+                accumulatedIncrement = accumulatedIncrement * currentMultiplier + currentIncrement;
+            }
+
+            currentIncrement = (currentMultiplier + 1) * currentIncrement;
+            currentMultiplier *= currentMultiplier;
+        }
+
+        m_State = accumulatedMultiplier * m_State + accumulatedIncrement;
+    }
+
+    // Finalizer of SplitMix64, spreads structured inputs such as pixel coordinates over all bits
+    static inline constexpr uint64_t MixBits(uint64_t value)
+    {
+        value ^= value >> 31;
+        value *= 0x7fb5d329728ea185ULL;
+        value ^= value >> 27;
+        value *= 0x81dadef4bc2dd44dULL;
+        value ^= value >> 33;
+        return value;
+    }
+
+private:
+    // Values reserved for one sample before the next sample of the same pixel begins
+    static constexpr int64_t DimensionsPerSample = 1 << 16;
+
+private:
+    uint64_t m_State;
+    uint64_t m_Increment;
+};
+
@@ -0,0 +1,40 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sampler.h"
+
+Sampler::Sampler(int samplesPerPixel, uint64_t seed)
+    : m_SamplesPerPixel(samplesPerPixel)
+    , m_Seed(seed)
+    , m_Pixel(0, 0)
+    , m_SampleIndex(0)
+    , m_Dimension(0)
+{
+    if (samplesPerPixel <= 0)
+        throw std::invalid_argument("Sampler needs at least one sample per pixel");
+}
+
+void Sampler::StartPixelSample(const Point2i& pixel, int sampleIndex, int dimension)
+{
+    m_Pixel = pixel;
+    m_SampleIndex = sampleIndex;
+    m_Dimension = dimension;
+}
+
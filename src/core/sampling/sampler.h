@@ -0,0 +1,59 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "rng.h"
+
+// Generates the sample values of a render, indexed by pixel, sample and dimension. Each render
+// thread works on its own clone, and the values only depend on those indices and the seed, so
+// images are reproducible. Dimensions are consumed in order by Get1D, Get2D and GetPixel2D
+// after StartPixelSample.
+class Sampler
+{
+public:
+    Sampler(int samplesPerPixel, uint64_t seed = 0);
+    virtual ~Sampler() = default;
+
+public:
+    inline int GetSamplesPerPixel() const { return m_SamplesPerPixel; }
+    inline uint64_t GetSeed() const { return m_Seed; }
+    inline int GetDimension() const { return m_Dimension; }
+
+public:
+    virtual void StartPixelSample(const Point2i& pixel, int sampleIndex, int dimension = 0);
+
+    virtual double Get1D() = 0;
+    virtual Point2 Get2D() = 0;
+
+    // Sample position within the pixel, samplers may give it special treatment
+    virtual Point2 GetPixel2D() { return Get2D(); }
+
+    virtual std::unique_ptr<Sampler> Clone() const = 0;
+
+protected:
+    const int m_SamplesPerPixel;
+    const uint64_t m_Seed;
+
+    Point2i m_Pixel;
+    int m_SampleIndex;
+    int m_Dimension;
+};
+
@@ -20,13 +20,17 @@
 
 #pragma once
 
+#include "rng.h"
+
+// Warping functions from uniform samples in [0, 1)^2 to other domains. They are stateless, so
+// callers decide where samples come from, e.g. a per-thread Rng or a low discrepancy sequence.
 namespace Sampling
 {
-    inline Point3 UniformSampleHemisphere()
+    inline Point3 UniformSampleHemisphere(const Point2& u)
     {
-        double y = SMath::Random::UniformFloat();
+        double y = u.x;
         double r = std::sqrt(std::max(0.0, 1.0 - y * y));
-        double phi = 2 * SMath::Pi * SMath::Random::UniformFloat();
+        double phi = 2 * SMath::Pi * u.y;
         return Point3(r * cos(phi), y, r * sin(phi));
     }
 
@@ -34,11 +38,11 @@ namespace Sampling
         return SMath::Inv2Pi;
     }
 
-    inline Point3 UniformSampleSphere()
+    inline Point3 UniformSampleSphere(const Point2& u)
     {
-        double z = 1 - 2 * SMath::Random::UniformFloat();
+        double z = 1 - 2 * u.x;
         double r = std::sqrt(std::max(0.0, 1.0 - z * z));
-        double phi = 2 * SMath::Pi * SMath::Random::UniformFloat();
+        double phi = 2 * SMath::Pi * u.y;
         return Point3(r * cos(phi), r * sin(phi), z);
     }
 
@@ -47,19 +51,20 @@ namespace Sampling
         return SMath::Inv4Pi;
     }
 
-    inline Point2 RejectionSampleDisk()
+    // Needs an unbounded number of samples, so it draws them from rng
+    inline Point2 RejectionSampleDisk(Rng& rng)
     {
         Point2 p;
         do {
-            p.x = 1 - 2 * SMath::Random::UniformFloat();
-            p.y = 1 - 2 * SMath::Random::UniformFloat();
+            p.x = 1 - 2 * rng.UniformDouble();
+            p.y = 1 - 2 * rng.UniformDouble();
         } while (p.x * p.x + p.y * p.y > 1);
         return p;
     }
 
-    inline Point2 ConcentricSampleDisk()
+    inline Point2 ConcentricSampleDisk(const Point2& u)
     {
-        Point2 uOffset = Point2(SMath::Random::UniformFloat() * 2.0 - 1.0, SMath::Random::UniformFloat() * 2.0 - 1.0);
+        Point2 uOffset = Point2(u.x * 2.0 - 1.0, u.y * 2.0 - 1.0);
 
         if (uOffset.x == 0 && uOffset.y == 0)
             return {};
@@ -80,9 +85,9 @@ namespace Sampling
         return Point2(cos(theta) * r, sin(theta) * r);
     }
 
-    inline Point3 CosineSampleHemisphere()
+    inline Point3 CosineSampleHemisphere(const Point2& u)
     {
-        Point2 d = ConcentricSampleDisk();
+        Point2 d = ConcentricSampleDisk(u);
         double z = std::sqrt(std::max(0.0, 1.0 - d.x * d.x - d.y * d.y));
         return Point3(d.x, d.y, z);
     }
@@ -92,4 +97,3 @@ namespace Sampling
         return cosTheta * SMath::InvPi;
     }
 }
-
@@ -0,0 +1,65 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sobolsampler.h"
+#include "lowdiscrepancy.h"
+
+SobolSampler::SobolSampler(int samplesPerPixel, uint64_t seed)
+    : Sampler(samplesPerPixel, seed)
+{
+    if ((samplesPerPixel & (samplesPerPixel - 1)) != 0)
+        throw std::invalid_argument("Sobol sampler needs a power of two samples per pixel");
+}
+
+double SobolSampler::Get1D()
+{
+    const uint64_t hash = LowDiscrepancy::Hash(m_Pixel.x, m_Pixel.y, m_Dimension++, m_Seed);
+    const uint32_t index = GetShuffledIndex(hash);
+    return LowDiscrepancy::ToUnitInterval(LowDiscrepancy::OwenScramble(LowDiscrepancy::SobolSample0(index), (uint32_t)(hash >> 32)));
+}
+
+Point2 SobolSampler::Get2D()
+{
+    const uint64_t hash = LowDiscrepancy::Hash(m_Pixel.x, m_Pixel.y, m_Dimension, m_Seed);
+    const uint32_t index = GetShuffledIndex(hash);
+    m_Dimension += 2;
+
+    // Both dimensions share the sample order but need independent scrambles
+    const uint64_t scrambleSeed = Rng::MixBits(hash);
+    return
+    {
+        LowDiscrepancy::ToUnitInterval(LowDiscrepancy::OwenScramble(LowDiscrepancy::SobolSample0(index), (uint32_t)scrambleSeed)),
+        LowDiscrepancy::ToUnitInterval(LowDiscrepancy::OwenScramble(LowDiscrepancy::SobolSample1(index), (uint32_t)(scrambleSeed >> 32)))
+    };
+}
+
+std::unique_ptr<Sampler> SobolSampler::Clone() const
+{
+    return std::make_unique<SobolSampler>(*this);
+}
+
+uint32_t SobolSampler::GetShuffledIndex(uint64_t hash) const
+{
+    // Samples past the pixel's sample count continue in the next block of the sequence
+    const uint32_t block = m_SampleIndex / m_SamplesPerPixel;
+    const uint32_t offset = LowDiscrepancy::PermutationElement(m_SampleIndex % m_SamplesPerPixel, m_SamplesPerPixel, (uint32_t)hash);
+    return block * m_SamplesPerPixel + offset;
+}
+
@@ -0,0 +1,44 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "sampler.h"
+
+// Owen scrambled Sobol samples. Every 1D and 2D request draws from the first one or two Sobol
+// dimensions, which form a (0, 2) sequence, under a scramble and a sample order that are unique
+// to the pixel and dimension. This keeps the stratification of the full sequence in every pair
+// of dimensions without direction number tables. Sample counts must be powers of two.
+class SobolSampler : public Sampler
+{
+public:
+    SobolSampler(int samplesPerPixel, uint64_t seed = 0);
+    ~SobolSampler() override = default;
+
+public:
+    double Get1D() override;
+    Point2 Get2D() override;
+
+    std::unique_ptr<Sampler> Clone() const override;
+
+private:
+    uint32_t GetShuffledIndex(uint64_t hash) const;
+};
+
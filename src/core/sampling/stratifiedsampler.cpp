@@ -0,0 +1,72 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stratifiedsampler.h"
+#include "lowdiscrepancy.h"
+
+StratifiedSampler::StratifiedSampler(int samplesX, int samplesY, bool jitter, uint64_t seed)
+    : Sampler(std::max(samplesX, 0) * std::max(samplesY, 0), seed)
+    , m_SamplesX(samplesX)
+    , m_SamplesY(samplesY)
+    , m_Jitter(jitter)
+{
+}
+
+void StratifiedSampler::StartPixelSample(const Point2i& pixel, int sampleIndex, int dimension)
+{
+    Sampler::StartPixelSample(pixel, sampleIndex, dimension);
+    m_Rng.SetPixelSample(pixel, sampleIndex, m_Seed);
+    m_Rng.Advance(dimension);
+}
+
+double StratifiedSampler::Get1D()
+{
+    const uint32_t stratum = GetStratum(m_SamplesPerPixel);
+    return (stratum + GetOffset()) / m_SamplesPerPixel;
+}
+
+Point2 StratifiedSampler::Get2D()
+{
+    const uint32_t stratum = GetStratum(m_SamplesPerPixel);
+    const int x = stratum % m_SamplesX;
+    const int y = stratum / m_SamplesX;
+    const double dx = GetOffset();
+    const double dy = GetOffset();
+    ++m_Dimension;
+    return { (x + dx) / m_SamplesX, (y + dy) / m_SamplesY };
+}
+
+std::unique_ptr<Sampler> StratifiedSampler::Clone() const
+{
+    return std::make_unique<StratifiedSampler>(*this);
+}
+
+uint32_t StratifiedSampler::GetStratum(int numStrata)
+{
+    const uint64_t hash = LowDiscrepancy::Hash(m_Pixel.x, m_Pixel.y, m_Dimension, m_Seed);
+    ++m_Dimension;
+    return LowDiscrepancy::PermutationElement(m_SampleIndex % numStrata, numStrata, (uint32_t)hash);
+}
+
+double StratifiedSampler::GetOffset()
+{
+    return m_Jitter ? m_Rng.UniformDouble() : 0.5;
+}
+
@@ -0,0 +1,57 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "sampler.h"
+
+// Splits every dimension into one stratum per sample and jitters samples within their stratum.
+// Strata are visited in a different random order for every pixel and dimension, so dimensions
+// are not correlated with each other.
+class StratifiedSampler : public Sampler
+{
+public:
+    StratifiedSampler(int samplesX, int samplesY, bool jitter = true, uint64_t seed = 0);
+    ~StratifiedSampler() override = default;
+
+public:
+    inline int GetSamplesX() const { return m_SamplesX; }
+    inline int GetSamplesY() const { return m_SamplesY; }
+    inline bool IsJittered() const { return m_Jitter; }
+
+public:
+    void StartPixelSample(const Point2i& pixel, int sampleIndex, int dimension = 0) override;
+
+    double Get1D() override;
+    Point2 Get2D() override;
+
+    std::unique_ptr<Sampler> Clone() const override;
+
+private:
+    uint32_t GetStratum(int numStrata);
+    double GetOffset();
+
+private:
+    const int m_SamplesX;
+    const int m_SamplesY;
+    const bool m_Jitter;
+    Rng m_Rng;
+};
+
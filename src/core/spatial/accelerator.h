@@ -21,6 +21,7 @@
 #pragma once
 
 class Geometry;
+struct SurfaceInteraction;
 
 class Accelerator
 {
@@ -29,6 +30,11 @@ public:
     virtual ~Accelerator() = default;
 
 public:
-    virtual void Build(const std::vector<Geometry>& primitives) const = 0;
-    virtual void Intersect(const Ray& ray) const = 0;
+    // Geometries must outlive the accelerator
+    virtual void Build(const std::vector<const Geometry*>& geometries) = 0;
+
+    // Rays are in world space and intersected with animated geometry at the given shutter time.
+    // The first variant only tests for occlusion, the second finds the closest hit.
+    virtual bool Intersect(const Ray& ray, double time) const = 0;
+    virtual bool Intersect(const Ray& ray, double time, double* tHit, SurfaceInteraction* surface) const = 0;
 };
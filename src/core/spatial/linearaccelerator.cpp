@@ -0,0 +1,96 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "linearaccelerator.h"
+#include "core/geometry/geometry.h"
+#include "core/geometry/primitives/primitive.h"
+
+void LinearAccelerator::Build(const std::vector<const Geometry*>& geometries)
+{
+    m_Instances.clear();
+    m_NumPrimitives = 0;
+
+    for (const Geometry* geometry : geometries)
+    {
+        if (geometry == nullptr)
+            throw std::invalid_argument("Accelerators cannot be built from null geometry");
+
+        Instance instance;
+        instance.m_Geometry = geometry;
+        instance.m_IsTransformed = geometry->IsAnimated() || !geometry->GetTransform().IsIdentity();
+        geometry->GetPrimitives(instance.m_Primitives);
+
+        m_NumPrimitives += instance.m_Primitives.size();
+        m_Instances.push_back(std::move(instance));
+    }
+}
+
+bool LinearAccelerator::Intersect(const Ray& ray, double time) const
+{
+    for (const Instance& instance : m_Instances)
+    {
+        const Ray localRay = instance.m_IsTransformed ? instance.m_Geometry->ToObjectSpace(ray, time) : ray;
+
+        for (const Primitive* primitive : instance.m_Primitives)
+            if (primitive->Intersect(localRay))
+                return true;
+    }
+
+    return false;
+}
+
+bool LinearAccelerator::Intersect(const Ray& ray, double time, double* tHit, SurfaceInteraction* surface) const
+{
+    const Instance* hitInstance = nullptr;
+    double closestHit = ray.m_TMax;
+
+    for (const Instance& instance : m_Instances)
+    {
+        Ray localRay = instance.m_IsTransformed ? instance.m_Geometry->ToObjectSpace(ray, time) : ray;
+
+        for (const Primitive* primitive : instance.m_Primitives)
+        {
+            // Object space rays keep world space hit distances, so the closest hit so far
+            // culls primitives of every geometry
+            localRay.m_TMax = closestHit;
+
+            if (primitive->Intersect(localRay, tHit, surface))
+            {
+                closestHit = *tHit;
+                hitInstance = &instance;
+            }
+        }
+    }
+
+    if (hitInstance == nullptr)
+        return false;
+
+    *tHit = closestHit;
+
+    if (hitInstance->m_IsTransformed)
+    {
+        surface->m_Point = ray(closestHit);
+        surface->m_Normal = hitInstance->m_Geometry->NormalToWorldSpace(surface->m_Normal, time);
+        surface->m_Wo = -ray.m_Direction;
+    }
+
+    return true;
+}
+
@@ -0,0 +1,57 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "accelerator.h"
+
+class Primitive;
+
+// Tests every primitive of every geometry in turn. Only suitable for small scenes, but it
+// needs no build step and serves as the reference that faster accelerators are tested against.
+class LinearAccelerator : public Accelerator
+{
+public:
+    LinearAccelerator() = default;
+    ~LinearAccelerator() override = default;
+
+public:
+    inline size_t GetNumPrimitives() const { return m_NumPrimitives; }
+
+public:
+    void Build(const std::vector<const Geometry*>& geometries) override;
+    bool Intersect(const Ray& ray, double time) const override;
+    bool Intersect(const Ray& ray, double time, double* tHit, SurfaceInteraction* surface) const override;
+
+private:
+    struct Instance
+    {
+        const Geometry* m_Geometry;
+        std::vector<const Primitive*> m_Primitives;
+
+        // Rays are only moved into object space for geometries that are not already in world space
+        bool m_IsTransformed;
+    };
+
+private:
+    std::vector<Instance> m_Instances;
+    size_t m_NumPrimitives = 0;
+};
+
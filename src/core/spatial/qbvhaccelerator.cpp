@@ -19,13 +19,371 @@
 */
 
 #include "qbvhaccelerator.h"
+#include <limits>
+#include "core/geometry/geometry.h"
+#include "core/geometry/primitives/primitive.h"
 
-void QBvhAccelerator::Build(const std::vector<Geometry>& primitives) const
+namespace
 {
+    // Every level pops one entry and pushes at most four, median splits keep trees shallow
+    // enough for this to hold any number of items that fits into 32 bits
+    constexpr int MaxStackSize = 64;
 
+    // Pads the far side of box tests so that rounding never misses flat or touching boxes
+    constexpr double FarScale = 1.0 + 4.0 * std::numeric_limits<double>::epsilon();
+
+    struct StackEntry
+    {
+        uint32_t m_Index;
+        uint32_t m_Count;
+        double m_TEntry;
+    };
+
+    BoundingBox GetEmptyBounds()
+    {
+        BoundingBox bounds;
+        bounds.m_Min = Point3(std::numeric_limits<double>::infinity());
+        bounds.m_Max = Point3(-std::numeric_limits<double>::infinity());
+        return bounds;
+    }
+
+    void Extend(BoundingBox& bounds, const BoundingBox& other)
+    {
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            bounds.m_Min[axis] = std::min(bounds.m_Min[axis], other.m_Min[axis]);
+            bounds.m_Max[axis] = std::max(bounds.m_Max[axis], other.m_Max[axis]);
+        }
+    }
+}
+
+QBvhAccelerator::RayBoxTest::RayBoxTest(const Ray& ray)
+    : m_Origin(ray.m_Origin)
+{
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        m_InvDirection[axis] = 1.0 / ray.m_Direction[axis];
+        m_IsNegative[axis] = m_InvDirection[axis] < 0.0;
+    }
+}
+
+void QBvhAccelerator::Build(const std::vector<const Geometry*>& geometries)
+{
+    m_Nodes.clear();
+    m_Primitives.clear();
+    m_Instances.clear();
+
+    std::vector<BuildItem> instanceItems;
+    std::vector<Instance> instances;
+    std::vector<const Primitive*> primitives;
+    std::vector<BuildItem> items;
+
+    for (const Geometry* geometry : geometries)
+    {
+        if (geometry == nullptr)
+            throw std::invalid_argument("Accelerators cannot be built from null geometry");
+
+        primitives.clear();
+        geometry->GetPrimitives(primitives);
+
+        // Geometries without primitives can never be hit
+        if (primitives.empty())
+            continue;
+
+        items.clear();
+        BoundingBox objectBounds = GetEmptyBounds();
+
+        for (size_t i = 0; i < primitives.size(); ++i)
+        {
+            const BoundingBox bounds = primitives[i]->GetExtents();
+            items.push_back({ bounds, bounds.m_Min + (bounds.m_Max - bounds.m_Min) * 0.5, (uint32_t)i });
+            Extend(objectBounds, bounds);
+        }
+
+        Instance instance;
+        instance.m_Geometry = geometry;
+        instance.m_IsTransformed = geometry->IsAnimated() || !geometry->GetTransform().IsIdentity();
+        instance.m_Root = BuildTree(items, (uint32_t)m_Primitives.size());
+
+        for (const BuildItem& item : items)
+            m_Primitives.push_back(primitives[item.m_Index]);
+
+        // Transformed geometry is bounded in world space over its whole animation
+        const BoundingBox worldBounds = instance.m_IsTransformed ? geometry->GetAnimatedTransform().GetMotionBounds(objectBounds) : objectBounds;
+        instanceItems.push_back({ worldBounds, worldBounds.m_Min + (worldBounds.m_Max - worldBounds.m_Min) * 0.5, (uint32_t)instances.size() });
+        instances.push_back(instance);
+    }
+
+    m_Root = BuildTree(instanceItems, 0);
+
+    for (const BuildItem& item : instanceItems)
+        m_Instances.push_back(instances[item.m_Index]);
+}
+
+bool QBvhAccelerator::Intersect(const Ray& ray, double time) const
+{
+    if (m_Nodes.empty())
+        return false;
+
+    return TraverseTree(m_Root, ray, ray.m_TMax, [&](uint32_t first, uint32_t count)
+    {
+        for (uint32_t i = first; i < first + count; ++i)
+            if (IntersectInstance(m_Instances[i], ray, time))
+                return true;
+
+        return false;
+    });
+}
+
+bool QBvhAccelerator::Intersect(const Ray& ray, double time, double* tHit, SurfaceInteraction* surface) const
+{
+    if (m_Nodes.empty())
+        return false;
+
+    const Instance* hitInstance = nullptr;
+    double closestHit = ray.m_TMax;
+
+    TraverseTree(m_Root, ray, closestHit, [&](uint32_t first, uint32_t count)
+    {
+        for (uint32_t i = first; i < first + count; ++i)
+            if (IntersectInstance(m_Instances[i], ray, time, closestHit, surface))
+                hitInstance = &m_Instances[i];
+
+        return false;
+    });
+
+    if (hitInstance == nullptr)
+        return false;
+
+    *tHit = closestHit;
+
+    if (hitInstance->m_IsTransformed)
+    {
+        surface->m_Point = ray(closestHit);
+        surface->m_Normal = hitInstance->m_Geometry->NormalToWorldSpace(surface->m_Normal, time);
+        surface->m_Wo = -ray.m_Direction;
+    }
+
+    return true;
+}
+
+uint32_t QBvhAccelerator::BuildTree(std::vector<BuildItem>& items, uint32_t firstItem)
+{
+    if (!items.empty())
+        return BuildNode(items, 0, items.size(), firstItem);
+
+    // Empty trees are a single node without children
+    m_Nodes.emplace_back();
+    Node& node = m_Nodes.back();
+
+    for (int child = 0; child < 4; ++child)
+    {
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            node.m_Min[axis][child] = std::numeric_limits<double>::infinity();
+            node.m_Max[axis][child] = -std::numeric_limits<double>::infinity();
+        }
+
+        node.m_Children[child] = 0;
+        node.m_Counts[child] = 0;
+    }
+
+    return (uint32_t)(m_Nodes.size() - 1);
+}
+
+uint32_t QBvhAccelerator::BuildNode(std::vector<BuildItem>& items, size_t begin, size_t end, uint32_t firstItem)
+{
+    // The node is filled in once its children are built, which may grow m_Nodes
+    const uint32_t index = (uint32_t)m_Nodes.size();
+    m_Nodes.emplace_back();
+
+    // Split in half and split both halves again, small ranges become a single leaf
+    size_t parts[5] = { begin, end, end, end, end };
+    int numParts = 1;
+
+    if (end - begin > MaxLeafSize)
+    {
+        const size_t middle = SplitItems(items, begin, end);
+        parts[1] = SplitItems(items, begin, middle);
+        parts[2] = middle;
+        parts[3] = SplitItems(items, middle, end);
+        numParts = 4;
+    }
+
+    Node node;
+
+    for (int child = 0; child < 4; ++child)
+    {
+        BoundingBox bounds = GetEmptyBounds();
+        node.m_Children[child] = 0;
+        node.m_Counts[child] = 0;
+
+        if (child < numParts)
+        {
+            const size_t partBegin = parts[child];
+            const size_t partEnd = parts[child + 1];
+
+            for (size_t i = partBegin; i < partEnd; ++i)
+                Extend(bounds, items[i].m_Bounds);
+
+            if (partEnd - partBegin <= MaxLeafSize)
+            {
+                node.m_Children[child] = firstItem + (uint32_t)partBegin;
+                node.m_Counts[child] = (uint32_t)(partEnd - partBegin);
+            }
+            else
+            {
+                node.m_Children[child] = BuildNode(items, partBegin, partEnd, firstItem);
+            }
+        }
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            node.m_Min[axis][child] = bounds.m_Min[axis];
+            node.m_Max[axis][child] = bounds.m_Max[axis];
+        }
+    }
+
+    m_Nodes[index] = node;
+    return index;
+}
+
+size_t QBvhAccelerator::SplitItems(std::vector<BuildItem>& items, size_t begin, size_t end)
+{
+    BoundingBox centroidBounds = GetEmptyBounds();
+
+    for (size_t i = begin; i < end; ++i)
+        Extend(centroidBounds, { items[i].m_Centroid, items[i].m_Centroid });
+
+    const Vector3 extent = centroidBounds.m_Max - centroidBounds.m_Min;
+    const int axis = (extent.x > extent.y && extent.x > extent.z) ? 0 : (extent.y > extent.z ? 1 : 2);
+    const size_t middle = begin + (end - begin) / 2;
+
+    std::nth_element(items.begin() + begin, items.begin() + middle, items.begin() + end, [axis](const BuildItem& a, const BuildItem& b)
+    {
+        return a.m_Centroid[axis] < b.m_Centroid[axis];
+    });
+
+    return middle;
+}
+
+int QBvhAccelerator::IntersectChildren(const Node& node, const RayBoxTest& test, double tMax, double tEntry[4])
+{
+    int mask = 0;
+
+    for (int child = 0; child < 4; ++child)
+    {
+        double tNear = 0.0;
+        double tFar = tMax;
+
+        // Slabs are entered on the side facing the ray. Empty children have their minimum above
+        // their maximum, so they are never entered before they are left.
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            const double slabNear = test.m_IsNegative[axis] ? node.m_Max[axis][child] : node.m_Min[axis][child];
+            const double slabFar = test.m_IsNegative[axis] ? node.m_Min[axis][child] : node.m_Max[axis][child];
+            tNear = std::max(tNear, (slabNear - test.m_Origin[axis]) * test.m_InvDirection[axis]);
+            tFar = std::min(tFar, (slabFar - test.m_Origin[axis]) * test.m_InvDirection[axis] * FarScale);
+        }
+
+        tEntry[child] = tNear;
+
+        if (tNear <= tFar)
+            mask |= 1 << child;
+    }
+
+    return mask;
 }
 
-void QBvhAccelerator::Intersect(const Ray& ray) const
+template <typename Function>
+bool QBvhAccelerator::TraverseTree(uint32_t root, const Ray& ray, const double& tMax, Function&& visitLeaf) const
 {
+    const RayBoxTest test(ray);
+    StackEntry stack[MaxStackSize];
+    int stackSize = 0;
+    stack[stackSize++] = { root, 0, 0.0 };
 
+    while (stackSize > 0)
+    {
+        const StackEntry entry = stack[--stackSize];
+
+        // Hits found since the entry was pushed may have moved tMax in front of it
+        if (entry.m_TEntry > tMax)
+            continue;
+
+        if (entry.m_Count > 0)
+        {
+            if (visitLeaf(entry.m_Index, entry.m_Count))
+                return true;
+
+            continue;
+        }
+
+        const Node& node = m_Nodes[entry.m_Index];
+        double tEntry[4];
+        const int mask = IntersectChildren(node, test, tMax, tEntry);
+
+        // Sorted farthest first so that the closest child is popped next
+        int order[4];
+        int numHits = 0;
+
+        for (int child = 0; child < 4; ++child)
+        {
+            if ((mask & (1 << child)) == 0)
+                continue;
+
+            int i = numHits++;
+            for (; i > 0 && tEntry[order[i - 1]] < tEntry[child]; --i)
+                order[i] = order[i - 1];
+
+            order[i] = child;
+        }
+
+        for (int i = 0; i < numHits; ++i)
+            stack[stackSize++] = { node.m_Children[order[i]], node.m_Counts[order[i]], tEntry[order[i]] };
+    }
+
+    return false;
 }
+
+bool QBvhAccelerator::IntersectInstance(const Instance& instance, const Ray& ray, double time) const
+{
+    const Ray localRay = instance.m_IsTransformed ? instance.m_Geometry->ToObjectSpace(ray, time) : ray;
+
+    return TraverseTree(instance.m_Root, localRay, localRay.m_TMax, [&](uint32_t first, uint32_t count)
+    {
+        for (uint32_t i = first; i < first + count; ++i)
+            if (m_Primitives[i]->Intersect(localRay))
+                return true;
+
+        return false;
+    });
+}
+
+bool QBvhAccelerator::IntersectInstance(const Instance& instance, const Ray& ray, double time, double& closestHit, SurfaceInteraction* surface) const
+{
+    // Object space rays keep world space hit distances, so the closest hit so far culls nodes
+    // and primitives of every geometry
+    Ray localRay = instance.m_IsTransformed ? instance.m_Geometry->ToObjectSpace(ray, time) : ray;
+    bool isHit = false;
+
+    TraverseTree(instance.m_Root, localRay, closestHit, [&](uint32_t first, uint32_t count)
+    {
+        for (uint32_t i = first; i < first + count; ++i)
+        {
+            double tHit;
+            localRay.m_TMax = closestHit;
+
+            if (m_Primitives[i]->Intersect(localRay, &tHit, surface))
+            {
+                closestHit = tHit;
+                isHit = true;
+            }
+        }
+
+        return false;
+    });
+
+    return isHit;
+}
+
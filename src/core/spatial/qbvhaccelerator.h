@@ -22,6 +22,13 @@
 
 #include "accelerator.h"
 
+class Primitive;
+
+// Two-level bounding volume hierarchy with four children per node. Every geometry gets a tree
+// over its primitives in object space and the geometries themselves are held in a top-level
+// tree in world space. Rays are moved into a geometry's object space at their shutter time
+// before its tree is traversed, so moving geometry is intersected at the ray's time without
+// rebuilding, and its top-level bounds cover its whole animation.
 class QBvhAccelerator : public Accelerator
 {
 public:
@@ -29,21 +36,77 @@ public:
     ~QBvhAccelerator() override = default;
 
 public:
-    struct SimdQBvhNode
+    inline size_t GetNumPrimitives() const { return m_Primitives.size(); }
+    inline size_t GetNumNodes() const { return m_Nodes.size(); }
+
+public:
+    void Build(const std::vector<const Geometry*>& geometries) override;
+    bool Intersect(const Ray& ray, double time) const override;
+    bool Intersect(const Ray& ray, double time, double* tHit, SurfaceInteraction* surface) const override;
+
+protected:
+    static constexpr uint32_t MaxLeafSize = 4;
+
+    // The bounds of all four children are stored per axis so that they are tested together.
+    // Children with a count are leaves that hold that many items starting at their index,
+    // the others are inner nodes. Unused children have empty bounds that no ray can hit.
+    struct Node
     {
-        BoundingBox m_ChildBoundingBoxes;
-        uint32_t m_ChildIndices[4];
-        uint32_t m_Axis0, m_Axis1, m_Axis2;
+        double m_Min[3][4];
+        double m_Max[3][4];
+        uint32_t m_Children[4];
+        uint32_t m_Counts[4];
     };
 
-public:
-    void Build(const std::vector<Geometry>& primitives) const override;
-    void Intersect(const Ray& ray) const override;
+    struct Instance
+    {
+        const Geometry* m_Geometry;
+        uint32_t m_Root;
+        bool m_IsTransformed;
+    };
+
+    struct BuildItem
+    {
+        BoundingBox m_Bounds;
+        Point3 m_Centroid;
+        uint32_t m_Index;
+    };
+
+    // Ray data that is shared by the four box tests of every node
+    struct RayBoxTest
+    {
+        RayBoxTest(const Ray& ray);
+
+        Point3 m_Origin;
+        Vector3 m_InvDirection;
+        bool m_IsNegative[3];
+    };
 
 protected:
-    static constexpr uint32_t MaxTreeDepth = 8;
-    static constexpr uint32_t MaxNumNodes = 65536; // 4^MaxTreeDepth
+    // Builds a tree over items and returns its root node. The items are reordered so that the
+    // items of every leaf are consecutive, leaves index them starting at firstItem.
+    uint32_t BuildTree(std::vector<BuildItem>& items, uint32_t firstItem);
+    uint32_t BuildNode(std::vector<BuildItem>& items, size_t begin, size_t end, uint32_t firstItem);
 
-    SimdQBvhNode m_RootNode[MaxNumNodes];
+    // Splits a range of items at the median of their centroids along the longest axis
+    static size_t SplitItems(std::vector<BuildItem>& items, size_t begin, size_t end);
+
+    // Writes the distance at which the ray enters each child to tEntry and returns a mask of
+    // the children it hits before tMax
+    static int IntersectChildren(const Node& node, const RayBoxTest& test, double tMax, double tEntry[4]);
+
+    // Visits the leaves the ray passes through before tMax, closest first. Visiting a leaf may
+    // move tMax closer, returning true from it ends the traversal.
+    template <typename Function>
+    bool TraverseTree(uint32_t root, const Ray& ray, const double& tMax, Function&& visitLeaf) const;
+
+    bool IntersectInstance(const Instance& instance, const Ray& ray, double time) const;
+    bool IntersectInstance(const Instance& instance, const Ray& ray, double time, double& closestHit, SurfaceInteraction* surface) const;
+
+protected:
+    std::vector<Node> m_Nodes;
+    std::vector<const Primitive*> m_Primitives;
+    std::vector<Instance> m_Instances;
+    uint32_t m_Root = 0;
 };
 
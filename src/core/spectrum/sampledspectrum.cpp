@@ -64,15 +64,6 @@ SampledSpectrum SampledSpectrum::FromSortedRawSamples(const double* lambda, cons
     return sampleArray;
 }
 
-RgbCoefficients SampledSpectrum::XyzToRgb(const XyzCoefficients& xyz)
-{
-    RgbCoefficients rgb;
-    rgb[0] = 3.240479 * xyz[0] - 1.537150 * xyz[1] - 0.498535 * xyz[2];
-    rgb[1] =-0.969256 * xyz[0] + 1.875991 * xyz[1] + 0.041556 * xyz[2];
-    rgb[2] = 0.055648 * xyz[0] - 0.204043 * xyz[1] + 1.057311 * xyz[2];
-    return rgb;
-}
-
 XyzCoefficients SampledSpectrum::RgbToXyz(const RgbCoefficients& rgb)
 {
     XyzCoefficients xyz;
@@ -37,9 +37,18 @@ public:
 
 public:
     static SampledSpectrum FromSortedRawSamples(const double* lambda, const double* power, int numSamples);
-    static RgbCoefficients XyzToRgb(const XyzCoefficients& xyz);
     static XyzCoefficients RgbToXyz(const RgbCoefficients& rgb);
 
+    // Inlined so that exporters can convert whole scanlines in vectorized loops
+    static inline RgbCoefficients XyzToRgb(const XyzCoefficients& xyz)
+    {
+        RgbCoefficients rgb;
+        rgb[0] = 3.240479 * xyz[0] - 1.537150 * xyz[1] - 0.498535 * xyz[2];
+        rgb[1] =-0.969256 * xyz[0] + 1.875991 * xyz[1] + 0.041556 * xyz[2];
+        rgb[2] = 0.055648 * xyz[0] - 0.204043 * xyz[1] + 1.057311 * xyz[2];
+        return rgb;
+    }
+
 public:
     XyzCoefficients ToXyz() const;
     RgbCoefficients ToRgb() const;
@@ -0,0 +1,79 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "exporter.h"
+#include "core/spectrum/sampledspectrum.h"
+#include "system/threading/threadpool.h"
+
+Exporter::Exporter()
+    : m_NumThreads(std::max(1u, std::thread::hardware_concurrency()))
+{
+}
+
+void Exporter::ExtractTiles(const Film& film, const std::function<void(const FilmTile&)>& extractTile) const
+{
+    RunParallel(film.GetNumTiles(), [&film, &extractTile](int tileIndex) { extractTile(film.GetTile(tileIndex)); });
+}
+
+void Exporter::RunParallel(int numTasks, const std::function<void(int)>& task) const
+{
+    // The pool joins once every task has run
+    ThreadPool threadPool(m_NumThreads);
+
+    for (int i = 0; i < numTasks; ++i)
+        threadPool.ScheduleTask(0, task, i);
+}
+
+void Exporter::ReadScanline(const Film& film, const FilmTile& tile, int tileSpaceY, PixelBuffer& scanline)
+{
+    if (tile.IsResident())
+    {
+        tile.ReadScanline(tileSpaceY, scanline);
+        return;
+    }
+
+    const int width = tile.GetSize().x;
+    std::vector<float> xyz(3 * (size_t)width);
+    film.GetStream().ReadScanline({ tile.GetPosition().x, tile.GetPosition().y + tileSpaceY }, width, xyz.data());
+
+    // Streamed pixels are already resolved, so they carry a unit weight
+    for (int x = 0; x < width; ++x)
+    {
+        scanline.GetPlane(PixelBuffer::X)[x] = (FilmChannel)xyz[3 * x + 0];
+        scanline.GetPlane(PixelBuffer::Y)[x] = (FilmChannel)xyz[3 * x + 1];
+        scanline.GetPlane(PixelBuffer::Z)[x] = (FilmChannel)xyz[3 * x + 2];
+        scanline.GetPlane(PixelBuffer::Weight)[x] = 1;
+    }
+}
+
+void Exporter::ResolveScanline(const PixelBuffer& scanline, int width, RgbCoefficients* rgb)
+{
+    const FilmChannel* xs = scanline.GetPlane(PixelBuffer::X);
+    const FilmChannel* ys = scanline.GetPlane(PixelBuffer::Y);
+    const FilmChannel* zs = scanline.GetPlane(PixelBuffer::Z);
+    const FilmChannel* weights = scanline.GetPlane(PixelBuffer::Weight);
+
+    for (int x = 0; x < width; ++x)
+    {
+        const double invWeight = weights[x] > 0 ? 1.0 / weights[x] : 0.0;
+        rgb[x] = SampledSpectrum::XyzToRgb({ xs[x] * invWeight, ys[x] * invWeight, zs[x] * invWeight });
+    }
+}
+
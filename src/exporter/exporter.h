@@ -20,14 +20,37 @@
 
 #pragma once
 
+#include <functional>
 #include "core/film/film.h"
 
 class Exporter
 {
 public:
-    Exporter() = default;
+    Exporter();
     ~Exporter() = default;
 
+public:
+    inline void SetNumThreads(int numThreads) { m_NumThreads = std::max(1, numThreads); }
+    inline int GetNumThreads() const { return m_NumThreads; }
+
 public:
     virtual void Export(const Film& film) const = 0;
+
+protected:
+    // Calls extractTile for every tile of the film on a thread pool and returns once all tiles
+    // are done. Tiles cover disjoint parts of the image, so they can write to a shared buffer.
+    void ExtractTiles(const Film& film, const std::function<void(const FilmTile&)>& extractTile) const;
+
+    // Calls task for every index in [0, numTasks) on a thread pool and returns once all are done
+    void RunParallel(int numTasks, const std::function<void(int)>& task) const;
+
+    // Reads a tile scanline like FilmTile::ReadScanline. Tiles that streaming films have already
+    // written out and dropped from memory are read back from the film stream instead.
+    static void ReadScanline(const Film& film, const FilmTile& tile, int tileSpaceY, PixelBuffer& scanline);
+
+    // Resolves a scanline read with ReadScanline into linear RGB. Pixels without samples are black.
+    static void ResolveScanline(const PixelBuffer& scanline, int width, RgbCoefficients* rgb);
+
+private:
+    int m_NumThreads;
 };
@@ -0,0 +1,441 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "hdrexporter.h"
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include "system/compression/zlib.h"
+
+const std::string OutputFileName = "Spectre_Output";
+const int NumColorChannels = 3;
+
+// Radiance run length encoding is only defined for these widths, others are written flat
+const int RadianceMinRleWidth = 8;
+const int RadianceMaxRleWidth = 0x7fff;
+const int RadianceMinRun = 4;
+const int RadianceMaxRun = 127;
+const int RadianceMaxLiteral = 128;
+
+const int ExrScanlinesPerBlock = 16;
+const int ExrCompressionZip = 3;
+const int ExrPixelTypeFloat = 2;
+const int ExrZlibQuality = 8;
+
+namespace
+{
+    template <typename T>
+    void Append(std::vector<char>& out, T value)
+    {
+        // Every format written here is little endian
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    void Append(std::vector<char>& out, const std::string& text)
+    {
+        out.insert(out.end(), text.begin(), text.end());
+    }
+
+    void AppendExrAttribute(std::vector<char>& out, const std::string& name, const std::string& type, const std::vector<char>& value)
+    {
+        Append(out, name);
+        out.push_back('\0');
+        Append(out, type);
+        out.push_back('\0');
+        Append(out, (int32_t)value.size());
+        out.insert(out.end(), value.begin(), value.end());
+    }
+}
+
+HdrExporter::HdrExporter(HdrFormat format)
+    : m_OutputFileName(OutputFileName)
+    , m_Format(format)
+{
+}
+
+std::string HdrExporter::GetFileExtension() const
+{
+    switch (m_Format)
+    {
+    case HdrFormat::Pfm:
+        return ".pfm";
+    case HdrFormat::Radiance:
+        return ".hdr";
+    default:
+        return ".exr";
+    }
+}
+
+void HdrExporter::Export(const Film& film) const
+{
+    std::lock_guard<std::mutex> lock(m_ExportMutex);
+
+    const int width = film.GetResolution().GetWidth();
+    const int height = film.GetResolution().GetHeight();
+    const std::vector<float> rgb = ExtractPixelData(film);
+
+    std::vector<AovType> aovTypes;
+    std::vector<std::vector<float>> aovs;
+
+    for (int i = 0; i < Aov::NumAovTypes; ++i)
+    {
+        if (film.HasAov((AovType)i))
+        {
+            aovTypes.push_back((AovType)i);
+            aovs.push_back(ExtractAovData(film, (AovType)i));
+        }
+    }
+
+    if (m_Format == HdrFormat::Exr)
+    {
+        std::vector<ExrChannel> channels =
+        {
+            { "R", rgb.data(), NumColorChannels },
+            { "G", rgb.data() + 1, NumColorChannels },
+            { "B", rgb.data() + 2, NumColorChannels }
+        };
+
+        for (size_t i = 0; i < aovTypes.size(); ++i)
+        {
+            const std::vector<std::string> names = GetAovChannelNames(aovTypes[i]);
+
+            for (size_t c = 0; c < names.size(); ++c)
+                channels.push_back({ names[c], aovs[i].data() + c, (int)names.size() });
+        }
+
+        WriteFile(m_OutputFileName + GetFileExtension(), EncodeExr(channels, width, height));
+        return;
+    }
+
+    if (m_Format == HdrFormat::Pfm)
+        WriteFile(m_OutputFileName + GetFileExtension(), EncodePfm(rgb, NumColorChannels, width, height));
+    else
+        WriteFile(m_OutputFileName + GetFileExtension(), EncodeRadiance(rgb, width, height));
+
+    for (size_t i = 0; i < aovTypes.size(); ++i)
+        WriteFile(m_OutputFileName + "." + Aov::GetName(aovTypes[i]) + ".pfm", EncodePfm(aovs[i], Aov::GetNumComponents(aovTypes[i]), width, height));
+}
+
+std::vector<float> HdrExporter::ExtractPixelData(const Film& film) const
+{
+    std::vector<float> data(film.GetNumPixels() * NumColorChannels);
+
+    ExtractTiles(film, [this, &film, &data](const FilmTile& tile)
+    {
+        ExtractTile(film, tile, data.data());
+    });
+
+    return data;
+}
+
+void HdrExporter::ExtractTile(const Film& film, const FilmTile& tile, float* data) const
+{
+    const int filmWidth = film.GetResolution().GetWidth();
+    const Point2i position = tile.GetPosition();
+    const Vector2i size = tile.GetSize();
+
+    PixelBuffer scanline(size.x);
+    std::vector<RgbCoefficients> rgb(size.x);
+
+    for (int y = 0; y < size.y; ++y)
+    {
+        ReadScanline(film, tile, y, scanline);
+        ResolveScanline(scanline, size.x, rgb.data());
+
+        float* row = data + NumColorChannels * ((position.y + y) * (size_t)filmWidth + position.x);
+
+        for (int x = 0; x < size.x; ++x)
+        {
+            row[NumColorChannels * x + 0] = (float)rgb[x][0];
+            row[NumColorChannels * x + 1] = (float)rgb[x][1];
+            row[NumColorChannels * x + 2] = (float)rgb[x][2];
+        }
+    }
+}
+
+std::vector<float> HdrExporter::ExtractAovData(const Film& film, AovType type) const
+{
+    const int numComponents = Aov::GetNumComponents(type);
+    const int filmWidth = film.GetResolution().GetWidth();
+    std::vector<float> data(film.GetNumPixels() * numComponents);
+
+    // Streaming films do not support AOVs, so every tile of a film that has them is resident
+    ExtractTiles(film, [&data, type, numComponents, filmWidth](const FilmTile& tile)
+    {
+        const Point2i position = tile.GetPosition();
+
+        for (int y = 0; y < tile.GetSize().y; ++y)
+            tile.ResolveAovScanline(y, type, data.data() + numComponents * ((position.y + y) * (size_t)filmWidth + position.x));
+    });
+
+    return data;
+}
+
+std::vector<std::string> HdrExporter::GetAovChannelNames(AovType type)
+{
+    const std::string name = Aov::GetName(type);
+
+    switch (type)
+    {
+    case AovType::Normal:
+        return { name + ".X", name + ".Y", name + ".Z" };
+    case AovType::Albedo:
+        return { name + ".R", name + ".G", name + ".B" };
+    default:
+        return { name };
+    }
+}
+
+std::vector<char> HdrExporter::EncodePfm(const std::vector<float>& data, int numComponents, int width, int height) const
+{
+    // A negative scale marks little endian data, scanlines are stored bottom to top
+    std::vector<char> out;
+    Append(out, (numComponents == 1 ? "Pf\n" : "PF\n") + std::to_string(width) + " " + std::to_string(height) + "\n-1.0\n");
+
+    const size_t rowSize = (size_t)width * numComponents * sizeof(float);
+    const size_t headerSize = out.size();
+    out.resize(headerSize + rowSize * height);
+
+    for (int y = 0; y < height; ++y)
+        std::memcpy(out.data() + headerSize + rowSize * (height - 1 - y), data.data() + (size_t)width * numComponents * y, rowSize);
+
+    return out;
+}
+
+std::vector<char> HdrExporter::EncodeRadiance(const std::vector<float>& rgb, int width, int height) const
+{
+    std::vector<char> out;
+    Append(out, "#?RADIANCE\nFORMAT=32-bit_rle_rgbe\n\n-Y " + std::to_string(height) + " +X " + std::to_string(width) + "\n");
+
+    std::vector<std::vector<char>> scanlines(height);
+
+    RunParallel(height, [&rgb, &scanlines, width](int y)
+    {
+        EncodeRadianceScanline(rgb.data() + (size_t)width * NumColorChannels * y, width, scanlines[y]);
+    });
+
+    for (const std::vector<char>& scanline : scanlines)
+        out.insert(out.end(), scanline.begin(), scanline.end());
+
+    return out;
+}
+
+std::vector<char> HdrExporter::EncodeExr(std::vector<ExrChannel> channels, int width, int height) const
+{
+    // Channels are stored in alphabetical order
+    std::sort(channels.begin(), channels.end(), [](const ExrChannel& a, const ExrChannel& b) { return a.m_Name < b.m_Name; });
+
+    std::vector<char> out;
+    Append(out, (int32_t)20000630);
+    Append(out, (int32_t)2);
+
+    std::vector<char> channelList;
+    for (const ExrChannel& channel : channels)
+    {
+        Append(channelList, channel.m_Name);
+        channelList.push_back('\0');
+        Append(channelList, (int32_t)ExrPixelTypeFloat);
+        Append(channelList, (int32_t)0);
+        Append(channelList, (int32_t)1);
+        Append(channelList, (int32_t)1);
+    }
+    channelList.push_back('\0');
+
+    std::vector<char> window;
+    for (int32_t value : { 0, 0, width - 1, height - 1 })
+        Append(window, value);
+
+    std::vector<char> compression, lineOrder, aspectRatio, windowCenter, windowWidth;
+    compression.push_back((char)ExrCompressionZip);
+    lineOrder.push_back(0);
+    Append(aspectRatio, 1.0f);
+    Append(windowCenter, 0.0f);
+    Append(windowCenter, 0.0f);
+    Append(windowWidth, 1.0f);
+
+    AppendExrAttribute(out, "channels", "chlist", channelList);
+    AppendExrAttribute(out, "compression", "compression", compression);
+    AppendExrAttribute(out, "dataWindow", "box2i", window);
+    AppendExrAttribute(out, "displayWindow", "box2i", window);
+    AppendExrAttribute(out, "lineOrder", "lineOrder", lineOrder);
+    AppendExrAttribute(out, "pixelAspectRatio", "float", aspectRatio);
+    AppendExrAttribute(out, "screenWindowCenter", "v2f", windowCenter);
+    AppendExrAttribute(out, "screenWindowWidth", "float", windowWidth);
+    out.push_back('\0');
+
+    const int numBlocks = (height + ExrScanlinesPerBlock - 1) / ExrScanlinesPerBlock;
+    std::vector<std::vector<char>> blocks(numBlocks);
+
+    RunParallel(numBlocks, [&channels, &blocks, width, height](int block)
+    {
+        const int y = block * ExrScanlinesPerBlock;
+        blocks[block] = EncodeExrBlock(channels, width, y, std::min(ExrScanlinesPerBlock, height - y));
+    });
+
+    // The offset table points at each chunk, chunks follow right after it
+    uint64_t offset = out.size() + numBlocks * sizeof(uint64_t);
+    for (const std::vector<char>& block : blocks)
+    {
+        Append(out, offset);
+        offset += 2 * sizeof(int32_t) + block.size();
+    }
+
+    for (int i = 0; i < numBlocks; ++i)
+    {
+        Append(out, (int32_t)(i * ExrScanlinesPerBlock));
+        Append(out, (int32_t)blocks[i].size());
+        out.insert(out.end(), blocks[i].begin(), blocks[i].end());
+    }
+
+    return out;
+}
+
+void HdrExporter::EncodeRgbe(const float* rgb, unsigned char* rgbe)
+{
+    const float r = std::max(rgb[0], 0.0f);
+    const float g = std::max(rgb[1], 0.0f);
+    const float b = std::max(rgb[2], 0.0f);
+    const float maxComponent = std::max({ r, g, b });
+
+    if (maxComponent < 1e-32f)
+    {
+        std::fill_n(rgbe, 4, 0);
+        return;
+    }
+
+    int exponent;
+    const float scale = std::frexp(maxComponent, &exponent) * 256.0f / maxComponent;
+
+    rgbe[0] = (unsigned char)(r * scale);
+    rgbe[1] = (unsigned char)(g * scale);
+    rgbe[2] = (unsigned char)(b * scale);
+    rgbe[3] = (unsigned char)(exponent + 128);
+}
+
+void HdrExporter::EncodeRadianceScanline(const float* rgb, int width, std::vector<char>& out)
+{
+    std::vector<unsigned char> rgbe(width * 4);
+
+    for (int x = 0; x < width; ++x)
+        EncodeRgbe(rgb + NumColorChannels * x, &rgbe[x * 4]);
+
+    if (width < RadianceMinRleWidth || width > RadianceMaxRleWidth)
+    {
+        out.insert(out.end(), rgbe.begin(), rgbe.end());
+        return;
+    }
+
+    out.push_back(2);
+    out.push_back(2);
+    out.push_back((char)(width >> 8));
+    out.push_back((char)(width & 0xff));
+
+    // Each component is encoded separately as a mix of literal spans and runs of a repeated byte
+    std::vector<unsigned char> component(width);
+
+    for (int c = 0; c < 4; ++c)
+    {
+        for (int x = 0; x < width; ++x)
+            component[x] = rgbe[x * 4 + c];
+
+        int x = 0;
+        while (x < width)
+        {
+            int runStart = x;
+            int runLength = 0;
+
+            while (runStart < width)
+            {
+                runLength = 1;
+                while (runStart + runLength < width && runLength < RadianceMaxRun && component[runStart + runLength] == component[runStart])
+                    ++runLength;
+
+                if (runLength >= RadianceMinRun)
+                    break;
+
+                runStart += runLength;
+            }
+
+            while (x < runStart)
+            {
+                const int literalLength = std::min(RadianceMaxLiteral, runStart - x);
+                out.push_back((char)literalLength);
+                out.insert(out.end(), component.begin() + x, component.begin() + x + literalLength);
+                x += literalLength;
+            }
+
+            if (runStart < width)
+            {
+                out.push_back((char)(128 + runLength));
+                out.push_back((char)component[runStart]);
+                x += runLength;
+            }
+        }
+    }
+}
+
+std::vector<char> HdrExporter::EncodeExrBlock(const std::vector<ExrChannel>& channels, int width, int firstScanline, int numScanlines)
+{
+    // Scanlines are stored channel by channel
+    std::vector<float> planar((size_t)width * channels.size() * numScanlines);
+    float* dst = planar.data();
+
+    for (int y = firstScanline; y < firstScanline + numScanlines; ++y)
+    {
+        for (const ExrChannel& channel : channels)
+        {
+            const float* row = channel.m_Data + (size_t)width * channel.m_Stride * y;
+
+            for (int x = 0; x < width; ++x)
+                *dst++ = row[channel.m_Stride * x];
+        }
+    }
+
+    const unsigned char* raw = reinterpret_cast<const unsigned char*>(planar.data());
+    const int rawSize = (int)(planar.size() * sizeof(float));
+
+    // Split even and odd bytes and delta encode them, which is how EXR readers expect ZIP blocks
+    std::vector<unsigned char> predicted(rawSize);
+    const int half = (rawSize + 1) / 2;
+
+    for (int i = 0; i < rawSize; ++i)
+        predicted[(i & 1) ? half + i / 2 : i / 2] = raw[i];
+
+    for (int i = rawSize - 1; i > 0; --i)
+        predicted[i] = (unsigned char)(predicted[i] - predicted[i - 1] + 128);
+
+    std::vector<char> block = Zlib::Compress(predicted.data(), rawSize, ExrZlibQuality);
+
+    // Blocks that do not shrink are stored raw, readers tell them apart by their size
+    if ((int)block.size() >= rawSize)
+        block.assign(raw, raw + rawSize);
+
+    return block;
+}
+
+void HdrExporter::WriteFile(const std::string& path, const std::vector<char>& file)
+{
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+
+    if (!stream.write(file.data(), file.size()))
+        throw std::runtime_error("Failed to write " + path);
+}
+
@@ -0,0 +1,93 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "exporter.h"
+
+enum class HdrFormat
+{
+    Pfm,
+    Radiance,
+    Exr
+};
+
+// Writes the resolved film as linear, untonemapped RGB. Radiance scanlines and EXR blocks are
+// compressed independently of each other, so they are encoded in parallel. AOVs enabled on the
+// film become extra channels of EXR files, other formats write one PFM file per AOV next to the image.
+class HdrExporter : public Exporter
+{
+public:
+    HdrExporter(HdrFormat format = HdrFormat::Exr);
+    ~HdrExporter() = default;
+
+public:
+    inline void SetOutputName(const std::string& name) { m_OutputFileName = name; }
+    inline std::string GetOutputName() const { return m_OutputFileName; }
+    inline void SetFormat(HdrFormat format) { m_Format = format; }
+    inline HdrFormat GetFormat() const { return m_Format; }
+
+    std::string GetFileExtension() const;
+
+public:
+    void Export(const Film& film) const override;
+
+private:
+    // A float image channel stored with a stride of several channels per pixel
+    struct ExrChannel
+    {
+        std::string m_Name;
+        const float* m_Data;
+        int m_Stride;
+    };
+
+private:
+    friend class HdrExporterTest_ExtractsLinearRgb_Test;
+    friend class HdrExporterTest_ExtractsAovs_Test;
+    friend class HdrExporterTest_ExrBlocksRoundTrip_Test;
+    friend class HdrExporterTest_EncodesRgbe_Test;
+    friend class HdrExporterTest_RunLengthEncodesScanlines_Test;
+    friend class HdrExporterTest_ExportsRadiance_Test;
+    friend class HdrExporterTest_ExportsPfm_Test;
+
+    // Returns linear RGB triplets, top scanline first
+    std::vector<float> ExtractPixelData(const Film& film) const;
+    void ExtractTile(const Film& film, const FilmTile& tile, float* data) const;
+
+    // Returns the resolved components of an AOV per pixel, top scanline first
+    std::vector<float> ExtractAovData(const Film& film, AovType type) const;
+    static std::vector<std::string> GetAovChannelNames(AovType type);
+
+    std::vector<char> EncodePfm(const std::vector<float>& data, int numComponents, int width, int height) const;
+    std::vector<char> EncodeRadiance(const std::vector<float>& rgb, int width, int height) const;
+    std::vector<char> EncodeExr(std::vector<ExrChannel> channels, int width, int height) const;
+
+    static void EncodeRgbe(const float* rgb, unsigned char* rgbe);
+    static void EncodeRadianceScanline(const float* rgb, int width, std::vector<char>& out);
+    static std::vector<char> EncodeExrBlock(const std::vector<ExrChannel>& channels, int width, int firstScanline, int numScanlines);
+
+    static void WriteFile(const std::string& path, const std::vector<char>& file);
+
+private:
+    std::string m_OutputFileName;
+    HdrFormat m_Format;
+    mutable std::mutex m_ExportMutex;
+};
+
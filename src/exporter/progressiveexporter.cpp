@@ -0,0 +1,129 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "progressiveexporter.h"
+
+ProgressiveExporter::ProgressiveExporter(std::shared_ptr<Exporter> exporter, std::chrono::milliseconds interval)
+    : m_Exporter(exporter)
+    , m_Interval(interval)
+    , m_Film(nullptr)
+    , m_ShouldStop(false)
+    , m_ExportRequested(false)
+    , m_NumExports(0)
+{
+    if (m_Exporter == nullptr)
+        throw std::invalid_argument("Progressive export requires an exporter");
+
+    if (m_Interval.count() <= 0)
+        throw std::invalid_argument("Progressive export interval must be positive");
+}
+
+ProgressiveExporter::~ProgressiveExporter()
+{
+    if (!IsRunning())
+        return;
+
+    try
+    {
+        Stop();
+    }
+    catch (...)
+    {
+        // Export errors can only be reported through Stop
+    }
+}
+
+void ProgressiveExporter::Start(Film& film)
+{
+    if (IsRunning())
+        throw std::runtime_error("Progressive export is already running");
+
+    m_ShouldStop = false;
+    m_ExportRequested = false;
+    m_Error = nullptr;
+    m_Film = &film;
+    m_Film->EnableSnapshots();
+    m_Thread = std::thread(&ProgressiveExporter::Run, this, std::cref(film));
+}
+
+void ProgressiveExporter::Stop()
+{
+    if (!IsRunning())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_ShouldStop = true;
+    }
+
+    m_Condition.notify_one();
+    m_Thread.join();
+    m_Film->DisableSnapshots();
+
+    if (m_Error != nullptr)
+        std::rethrow_exception(m_Error);
+}
+
+void ProgressiveExporter::RequestExport()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_ExportRequested = true;
+    }
+
+    m_Condition.notify_one();
+}
+
+void ProgressiveExporter::Run(const Film& film)
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    bool isFinalExport = false;
+
+    // The last snapshot is exported after the stop request so that it holds everything published
+    while (!isFinalExport)
+    {
+        m_Condition.wait_for(lock, m_Interval, [this]() { return m_ShouldStop || m_ExportRequested; });
+        m_ExportRequested = false;
+        isFinalExport = m_ShouldStop;
+
+        // Exporting can take a while, requests made in the meantime are picked up afterwards
+        lock.unlock();
+        ExportSnapshot(film);
+        lock.lock();
+    }
+}
+
+void ProgressiveExporter::ExportSnapshot(const Film& film)
+{
+    if (m_Error != nullptr)
+        return;
+
+    try
+    {
+        m_Exporter->Export(*film.CreateSnapshot());
+        ++m_NumExports;
+    }
+    catch (...)
+    {
+        m_Error = std::current_exception();
+    }
+}
+
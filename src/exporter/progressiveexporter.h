@@ -0,0 +1,70 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <thread>
+#include "exporter.h"
+
+// Exports snapshots of a film from a background thread at a fixed interval while it is being
+// rendered. Snapshots only contain tiles published with Film::PublishTile, so render threads
+// never wait for an export to finish. Snapshots of the film are enabled while the exporter runs.
+class ProgressiveExporter
+{
+public:
+    ProgressiveExporter(std::shared_ptr<Exporter> exporter, std::chrono::milliseconds interval = std::chrono::seconds(10));
+    ~ProgressiveExporter();
+
+public:
+    inline std::chrono::milliseconds GetInterval() const { return m_Interval; }
+    inline int GetNumExports() const { return m_NumExports; }
+    inline bool IsRunning() const { return m_Thread.joinable(); }
+
+public:
+    void Start(Film& film);
+
+    // Writes a final snapshot, joins the background thread, disables snapshots of the film again
+    // and rethrows the first export error
+    void Stop();
+
+    // Wakes the background thread to export a snapshot right away
+    void RequestExport();
+
+private:
+    void Run(const Film& film);
+    void ExportSnapshot(const Film& film);
+
+private:
+    std::shared_ptr<Exporter> m_Exporter;
+    std::chrono::milliseconds m_Interval;
+
+    Film* m_Film;
+    std::thread m_Thread;
+    std::mutex m_Mutex;
+    std::condition_variable m_Condition;
+    bool m_ShouldStop;
+    bool m_ExportRequested;
+
+    std::atomic<int> m_NumExports;
+    std::exception_ptr m_Error;
+};
+
@@ -20,10 +20,9 @@
 
 #include "stbexporter.h"
 #include <vector>
-#include "core/spectrum/sampledspectrum.h"
 #include "core/film/tonemapper/tonemapper.h"
 
-#define STB_IMAGE_WRITE_IMPLEMENTATION
+// The implementation is compiled in system/compression/zlib.cpp
 #include "stb/stb_image_write.h"
 
 const std::string OutputFileName = "Spectre_Output";
@@ -48,52 +47,47 @@ void StbExporter::Export(const Film& film) const
         NumColorChannels * film.GetResolution().GetWidth());
 }
 
-RgbCoefficients uncharted2_tonemap_partial(RgbCoefficients x)
+std::vector<char> StbExporter::ExtractPixelData(const Film& film) const
 {
-    float A = 0.15f;
-    float B = 0.50f;
-    float C = 0.10f;
-    float D = 0.20f;
-    float E = 0.02f;
-    float F = 0.30f;
-    return ((x * (x * A + C * B) + D * E) / (x * (x * A + B) + D * F)) - E / F;
-}
+    std::vector<char> data(GetBufferSize(film));
 
-RgbCoefficients uncharted2_filmic(RgbCoefficients v)
-{
-    float exposure_bias = 2.0f;
-    RgbCoefficients curr = uncharted2_tonemap_partial(v * exposure_bias);
+    ExtractTiles(film, [this, &film, &data](const FilmTile& tile)
+    {
+        ExtractTile(film, tile, data.data());
+    });
 
-    RgbCoefficients W = RgbCoefficients(11.2f);
-    RgbCoefficients white_scale = RgbCoefficients(1.0f) / uncharted2_tonemap_partial(W);
-    return curr * white_scale;
+    return data;
 }
 
-std::vector<char> StbExporter::ExtractPixelData(const Film& film) const
+void StbExporter::ExtractTile(const Film& film, const FilmTile& tile, char* data) const
 {
-    std::vector<char> data(GetBufferSize(film));
-    Resolution resolution = film.GetResolution();
-    int iterator = 0;
-    for (int y = 0; y < resolution.GetHeight(); ++y)
+    const int filmWidth = film.GetResolution().GetWidth();
+    const Point2i position = tile.GetPosition();
+    const Vector2i size = tile.GetSize();
+
+    PixelBuffer scanline(size.x);
+    std::vector<RgbCoefficients> rgb(size.x);
+
+    for (int y = 0; y < size.y; ++y)
     {
-        for (int x = 0; x < resolution.GetWidth(); ++x)
-        {
-            Pixel p = const_cast<Film&>(film).GetTile({ x, y }).GetFilmSpacePixel({ x, y });
-            RgbCoefficients rgb = SampledSpectrum::XyzToRgb(p.m_Xyz / p.m_TotalSplat);
+        ReadScanline(film, tile, y, scanline);
+        ResolveScanline(scanline, size.x, rgb.data());
+
+        if (m_Tonemapper != nullptr)
+            m_Tonemapper->ApplyTonemap(rgb, rgb);
 
-            if (m_Tonemapper != nullptr)
-                rgb = m_Tonemapper->ApplyTonemap(rgb);
+        char* row = data + NumColorChannels * ((position.y + y) * (size_t)filmWidth + position.x);
 
-            data[iterator++] = (char)(std::clamp(rgb[0] * 255.0, 0.0, 255.0));
-            data[iterator++] = (char)(std::clamp(rgb[1] * 255.0, 0.0, 255.0));
-            data[iterator++] = (char)(std::clamp(rgb[2] * 255.0, 0.0, 255.0));
+        for (int x = 0; x < size.x; ++x)
+        {
+            row[NumColorChannels * x + 0] = (char)std::clamp(rgb[x][0] * 255.0, 0.0, 255.0);
+            row[NumColorChannels * x + 1] = (char)std::clamp(rgb[x][1] * 255.0, 0.0, 255.0);
+            row[NumColorChannels * x + 2] = (char)std::clamp(rgb[x][2] * 255.0, 0.0, 255.0);
         }
     }
-
-    return data;
 }
 
-int StbExporter::GetBufferSize(const Film& film) const
+size_t StbExporter::GetBufferSize(const Film& film) const
 {
     return film.GetNumPixels() * NumColorChannels;
 }
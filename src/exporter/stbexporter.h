@@ -38,8 +38,11 @@ public:
     void Export(const Film& film) const override;
 
 private:
+    friend class StbExporterTest_ExtractsTilesInParallel_Test;
+
     std::vector<char> ExtractPixelData(const Film& film) const;
-    int GetBufferSize(const Film& film) const;
+    void ExtractTile(const Film& film, const FilmTile& tile, char* data) const;
+    size_t GetBufferSize(const Film& film) const;
 
 private:
     std::string m_OutputFileName;
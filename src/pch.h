@@ -22,8 +22,10 @@
 
 #include <algorithm>
 #include <assert.h>
+#include <atomic>
 #include <memory>
 #include <mutex>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <stdexcept>
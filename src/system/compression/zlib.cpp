@@ -0,0 +1,68 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "zlib.h"
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb/stb_image.h"
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb/stb_image_write.h"
+
+namespace
+{
+    int CheckedSize(size_t size)
+    {
+        if (size > (size_t)std::numeric_limits<int>::max())
+            throw std::invalid_argument("Data is too large for a zlib stream");
+
+        return (int)size;
+    }
+}
+
+std::vector<char> Zlib::Compress(const void* data, size_t size, int quality)
+{
+    int compressedSize = 0;
+    unsigned char* compressed = stbi_zlib_compress(static_cast<unsigned char*>(const_cast<void*>(data)), CheckedSize(size), &compressedSize, quality);
+
+    if (compressed == nullptr)
+        throw std::runtime_error("Failed to compress data");
+
+    std::vector<char> result(compressed, compressed + compressedSize);
+    free(compressed);
+    return result;
+}
+
+std::vector<char> Zlib::Decompress(const void* data, size_t size)
+{
+    int decompressedSize = 0;
+    char* decompressed = stbi_zlib_decode_malloc(static_cast<const char*>(data), CheckedSize(size), &decompressedSize);
+
+    if (decompressed == nullptr)
+        throw std::runtime_error("Failed to decompress data");
+
+    std::vector<char> result(decompressed, decompressed + decompressedSize);
+    free(decompressed);
+    return result;
+}
+
@@ -0,0 +1,36 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Zlib streams as used by the EXR exporter and the tile protocol. This module owns the stb_image
+// and stb_image_write implementations, since stb only exposes its zlib encoder to the translation
+// unit that compiles stb_image_write; everywhere else includes the plain stb headers.
+namespace Zlib
+{
+    // Quality trades speed for size, stb uses 8 for PNGs. Throws if the data cannot be compressed.
+    std::vector<char> Compress(const void* data, size_t size, int quality);
+
+    // Throws if the data is not a valid zlib stream
+    std::vector<char> Decompress(const void* data, size_t size);
+}
+
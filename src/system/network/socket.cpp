@@ -0,0 +1,446 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <system_error>
+#include <thread>
+#include "socket.h"
+
+#if defined(SPC_PLATFORM_WIN)
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <afunix.h>
+#else
+#include <cerrno>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+const std::string UnixAddressPrefix = "unix:";
+const int ConnectRetryMilliseconds = 50;
+
+#if defined(SPC_PLATFORM_WIN)
+const int SendFlags = 0;
+#elif defined(MSG_NOSIGNAL)
+const int SendFlags = MSG_NOSIGNAL;
+#else
+const int SendFlags = 0;
+#endif
+
+namespace
+{
+    // The few calls that differ between Winsock and POSIX sockets
+#if defined(SPC_PLATFORM_WIN)
+    typedef int AddressLength;
+
+    // Winsock has to be started once per process before any socket is created
+    struct WinsockSession
+    {
+        WinsockSession()
+        {
+            WSADATA data;
+            if (WSAStartup(MAKEWORD(2, 2), &data) != 0)
+                throw std::runtime_error("Failed to start Winsock");
+        }
+
+        ~WinsockSession() { WSACleanup(); }
+    };
+
+    void StartSockets() { static WinsockSession session; }
+    int GetLastSocketError() { return WSAGetLastError(); }
+    void SetLastSocketError(int error) { WSASetLastError(error); }
+    void CloseSocketHandle(uintptr_t handle) { closesocket((SOCKET)handle); }
+    int PollHandles(pollfd* requests, int numRequests, int timeoutMilliseconds) { return WSAPoll(requests, numRequests, timeoutMilliseconds); }
+
+    bool IsInterrupted(int error) { return error == WSAEINTR; }
+    bool IsTimedOut(int error) { return error == WSAETIMEDOUT || error == WSAEWOULDBLOCK; }
+    bool IsNobodyListening(int error) { return error == WSAECONNREFUSED; }
+#else
+    typedef socklen_t AddressLength;
+
+    void StartSockets() {}
+    int GetLastSocketError() { return errno; }
+    void SetLastSocketError(int error) { errno = error; }
+    void CloseSocketHandle(int handle) { close(handle); }
+    int PollHandles(pollfd* requests, int numRequests, int timeoutMilliseconds) { return poll(requests, numRequests, timeoutMilliseconds); }
+
+    bool IsInterrupted(int error) { return error == EINTR; }
+    bool IsTimedOut(int error) { return error == EAGAIN || error == EWOULDBLOCK; }
+    bool IsNobodyListening(int error) { return error == ECONNREFUSED || error == ENOENT; }
+#endif
+
+    std::runtime_error SocketError(const std::string& message)
+    {
+        return std::runtime_error(message + ": " + std::system_category().message(GetLastSocketError()));
+    }
+
+    bool IsUnixAddress(const std::string& address)
+    {
+        return address.compare(0, UnixAddressPrefix.size(), UnixAddressPrefix) == 0;
+    }
+
+    sockaddr_un GetUnixAddress(const std::string& address)
+    {
+        const std::string path = address.substr(UnixAddressPrefix.size());
+        sockaddr_un unixAddress = {};
+
+        if (path.empty() || path.size() >= sizeof(unixAddress.sun_path))
+            throw std::invalid_argument("Invalid Unix socket path " + path);
+
+        unixAddress.sun_family = AF_UNIX;
+        std::memcpy(unixAddress.sun_path, path.c_str(), path.size() + 1);
+        return unixAddress;
+    }
+
+    std::unique_ptr<addrinfo, void (*)(addrinfo*)> ResolveTcpAddress(const std::string& address, bool isPassive)
+    {
+        const size_t separator = address.rfind(':');
+
+        if (separator == std::string::npos || separator + 1 == address.size())
+            throw std::invalid_argument("Socket address " + address + " is neither unix:<path> nor <host>:<port>");
+
+        const std::string host = address.substr(0, separator);
+        const std::string port = address.substr(separator + 1);
+
+        addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = isPassive ? AI_PASSIVE : 0;
+
+        addrinfo* result = nullptr;
+        const int status = getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &result);
+
+        if (status != 0)
+            throw std::runtime_error("Failed to resolve " + address + ": " + gai_strerror(status));
+
+        return { result, freeaddrinfo };
+    }
+}
+
+Socket::Socket()
+    : m_Handle(InvalidHandle)
+{
+}
+
+Socket::Socket(Handle handle)
+    : m_Handle(handle)
+{
+}
+
+Socket::Socket(Socket&& other) noexcept
+    : m_Handle(other.m_Handle)
+    , m_UnixPath(std::move(other.m_UnixPath))
+{
+    other.m_Handle = InvalidHandle;
+    other.m_UnixPath.clear();
+}
+
+Socket::~Socket()
+{
+    Close();
+}
+
+Socket& Socket::operator=(Socket&& other) noexcept
+{
+    if (this != &other)
+    {
+        Close();
+        m_Handle = other.m_Handle;
+        m_UnixPath = std::move(other.m_UnixPath);
+        other.m_Handle = InvalidHandle;
+        other.m_UnixPath.clear();
+    }
+
+    return *this;
+}
+
+Socket Socket::Create(int family)
+{
+    StartSockets();
+    Socket socket((Handle)::socket(family, SOCK_STREAM, 0));
+
+    if (!socket.IsOpen())
+        throw SocketError("Failed to create socket");
+
+#ifdef SO_NOSIGPIPE
+    // Platforms without MSG_NOSIGNAL report writes to closed connections this way
+    const int noSigPipe = 1;
+    setsockopt(socket.m_Handle, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+
+    // Tile messages are written whole, so there is nothing to gain from delaying them
+    if (family != AF_UNIX)
+    {
+        const int noDelay = 1;
+        setsockopt(socket.m_Handle, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+    }
+
+    return socket;
+}
+
+Socket Socket::TryConnect(const std::string& address)
+{
+    if (IsUnixAddress(address))
+    {
+        const sockaddr_un unixAddress = GetUnixAddress(address);
+        Socket socket = Create(AF_UNIX);
+
+        if (connect(socket.m_Handle, reinterpret_cast<const sockaddr*>(&unixAddress), sizeof(unixAddress)) == 0)
+            return socket;
+
+        return Socket();
+    }
+
+    const auto addresses = ResolveTcpAddress(address, false);
+
+    for (const addrinfo* info = addresses.get(); info != nullptr; info = info->ai_next)
+    {
+        Socket socket = Create(info->ai_family);
+
+        if (connect(socket.m_Handle, info->ai_addr, (AddressLength)info->ai_addrlen) == 0)
+            return socket;
+    }
+
+    return Socket();
+}
+
+Socket Socket::Listen(const std::string& address, int backlog)
+{
+    Socket listener;
+
+    if (IsUnixAddress(address))
+    {
+        const sockaddr_un unixAddress = GetUnixAddress(address);
+        listener = Create(AF_UNIX);
+        std::remove(unixAddress.sun_path);
+
+        if (bind(listener.m_Handle, reinterpret_cast<const sockaddr*>(&unixAddress), sizeof(unixAddress)) != 0)
+            throw SocketError("Failed to bind " + address);
+
+        listener.m_UnixPath = unixAddress.sun_path;
+    }
+    else
+    {
+        const auto addresses = ResolveTcpAddress(address, true);
+
+        for (const addrinfo* info = addresses.get(); info != nullptr && !listener.IsOpen(); info = info->ai_next)
+        {
+            Socket candidate = Create(info->ai_family);
+            const int reuseAddress = 1;
+            setsockopt(candidate.m_Handle, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuseAddress), sizeof(reuseAddress));
+
+            if (bind(candidate.m_Handle, info->ai_addr, (AddressLength)info->ai_addrlen) == 0)
+                listener = std::move(candidate);
+        }
+
+        if (!listener.IsOpen())
+            throw SocketError("Failed to bind " + address);
+    }
+
+    if (listen(listener.m_Handle, backlog) != 0)
+        throw SocketError("Failed to listen on " + address);
+
+    return listener;
+}
+
+Socket Socket::Connect(const std::string& address, double timeoutSeconds)
+{
+    const auto startTime = std::chrono::steady_clock::now();
+
+    while (true)
+    {
+        Socket socket = TryConnect(address);
+
+        if (socket.IsOpen())
+            return socket;
+
+        // Nobody is listening yet
+        const bool isRetryable = IsNobodyListening(GetLastSocketError());
+        const double elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+        if (!isRetryable || elapsedSeconds >= timeoutSeconds)
+            throw SocketError("Failed to connect to " + address);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(ConnectRetryMilliseconds));
+    }
+}
+
+Socket Socket::Accept()
+{
+    if (!IsOpen())
+        throw std::runtime_error("Socket is not open");
+
+    while (true)
+    {
+        Socket socket((Handle)accept(m_Handle, nullptr, nullptr));
+
+        if (socket.IsOpen())
+            return socket;
+
+        if (!IsInterrupted(GetLastSocketError()))
+            throw SocketError("Failed to accept connection");
+    }
+}
+
+bool Socket::WaitReadable(int timeoutMilliseconds) const
+{
+    if (!IsOpen())
+        throw std::runtime_error("Socket is not open");
+
+    pollfd request = {};
+    request.fd = m_Handle;
+    request.events = POLLIN;
+
+    const int result = PollHandles(&request, 1, timeoutMilliseconds);
+
+    if (result < 0 && !IsInterrupted(GetLastSocketError()))
+        throw SocketError("Failed to poll socket");
+
+    return result > 0;
+}
+
+void Socket::SetReceiveTimeout(double seconds)
+{
+    if (seconds < 0.0)
+        throw std::invalid_argument("Socket timeout cannot be negative");
+
+#if defined(SPC_PLATFORM_WIN)
+    const DWORD timeout = (DWORD)std::ceil(seconds * 1e3);
+#else
+    timeval timeout = {};
+    timeout.tv_sec = (time_t)seconds;
+    timeout.tv_usec = (suseconds_t)((seconds - (double)timeout.tv_sec) * 1e6);
+#endif
+
+    if (setsockopt(m_Handle, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout)) != 0)
+        throw SocketError("Failed to set socket timeout");
+}
+
+void Socket::Send(const void* data, size_t size)
+{
+    if (!IsOpen())
+        throw std::runtime_error("Socket is not open");
+
+    const char* bytes = static_cast<const char*>(data);
+
+    while (size > 0)
+    {
+        // Winsock takes int sizes, so large messages go out in several calls
+        const int numToSend = (int)std::min<size_t>(size, std::numeric_limits<int>::max());
+        const int64_t numSent = send(m_Handle, bytes, numToSend, SendFlags);
+
+        if (numSent < 0)
+        {
+            if (IsInterrupted(GetLastSocketError()))
+                continue;
+
+            throw SocketError("Failed to send");
+        }
+
+        bytes += numSent;
+        size -= (size_t)numSent;
+    }
+}
+
+bool Socket::Receive(void* data, size_t size)
+{
+    if (!IsOpen())
+        throw std::runtime_error("Socket is not open");
+
+    char* bytes = static_cast<char*>(data);
+    size_t numReceived = 0;
+
+    while (numReceived < size)
+    {
+        const int numToReceive = (int)std::min<size_t>(size - numReceived, std::numeric_limits<int>::max());
+        const int64_t result = recv(m_Handle, bytes + numReceived, numToReceive, 0);
+
+        if (result == 0)
+        {
+            if (numReceived == 0)
+                return false;
+
+            throw std::runtime_error("Connection closed part way through a message");
+        }
+
+        if (result < 0)
+        {
+            const int error = GetLastSocketError();
+
+            if (IsInterrupted(error))
+                continue;
+
+            if (IsTimedOut(error))
+                throw std::runtime_error("Timed out receiving from socket");
+
+            throw SocketError("Failed to receive");
+        }
+
+        numReceived += (size_t)result;
+    }
+
+    return true;
+}
+
+int Socket::GetPort() const
+{
+    sockaddr_storage address = {};
+    AddressLength length = sizeof(address);
+
+    if (!IsOpen() || getsockname(m_Handle, reinterpret_cast<sockaddr*>(&address), &length) != 0)
+        throw std::runtime_error("Failed to get socket address");
+
+    if (address.ss_family == AF_INET)
+        return ntohs(reinterpret_cast<const sockaddr_in*>(&address)->sin_port);
+
+    if (address.ss_family == AF_INET6)
+        return ntohs(reinterpret_cast<const sockaddr_in6*>(&address)->sin6_port);
+
+    throw std::runtime_error("Socket is not a TCP socket");
+}
+
+void Socket::Close()
+{
+    if (!IsOpen())
+        return;
+
+    // Keep the error of a failed call for whoever reports it
+    const int error = GetLastSocketError();
+    CloseSocketHandle(m_Handle);
+    SetLastSocketError(error);
+    m_Handle = InvalidHandle;
+
+    if (!m_UnixPath.empty())
+    {
+        std::remove(m_UnixPath.c_str());
+        m_UnixPath.clear();
+    }
+}
+
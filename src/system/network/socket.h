@@ -0,0 +1,90 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+// Blocking stream socket for connecting render processes. Addresses are either "unix:<path>"
+// for a Unix domain socket, which is the simplest way to run several processes on one machine,
+// or "<host>:<port>" for TCP. Errors throw std::runtime_error, a peer that disconnects cleanly
+// is reported by Receive instead. Windows supports Unix domain sockets from Windows 10 1803 on.
+class Socket
+{
+public:
+    Socket();
+    Socket(Socket&& other) noexcept;
+    Socket(const Socket& other) = delete;
+    ~Socket();
+
+    Socket& operator=(Socket&& other) noexcept;
+    Socket& operator=(const Socket& other) = delete;
+
+public:
+    inline bool IsOpen() const { return m_Handle != InvalidHandle; }
+
+public:
+    // Listening on TCP port 0 picks a free port, see GetPort. A stale Unix socket file left
+    // behind by a previous process is replaced.
+    static Socket Listen(const std::string& address, int backlog = 16);
+
+    // Retries refused connections until the timeout has passed, so that workers can be
+    // started before the process they connect to
+    static Socket Connect(const std::string& address, double timeoutSeconds = 0.0);
+
+    Socket Accept();
+
+    // Waits until data or a connection is ready to be received, returns false on timeout
+    bool WaitReadable(int timeoutMilliseconds) const;
+
+    // Receives fail with an error once they have waited for longer than the timeout, zero waits forever
+    void SetReceiveTimeout(double seconds);
+
+    void Send(const void* data, size_t size);
+
+    // Returns false if the peer closed the connection before the first byte, throws if it was
+    // closed part way through
+    bool Receive(void* data, size_t size);
+
+    // The local port of a TCP socket
+    int GetPort() const;
+
+    void Close();
+
+private:
+    // A SOCKET on Windows and a file descriptor elsewhere
+#if defined(SPC_PLATFORM_WIN)
+    typedef uintptr_t Handle;
+#else
+    typedef int Handle;
+#endif
+
+    static constexpr Handle InvalidHandle = (Handle)-1;
+
+    explicit Socket(Handle handle);
+
+    static Socket Create(int family);
+
+    // Returns a closed socket and leaves the error of the last attempt set if no connection was made
+    static Socket TryConnect(const std::string& address);
+
+private:
+    Handle m_Handle;
+    std::string m_UnixPath;
+};
+
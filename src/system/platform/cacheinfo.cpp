@@ -0,0 +1,61 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "cacheinfo.h"
+
+#if defined(SPC_PLATFORM_WIN)
+#include <windows.h>
+#elif defined(SPC_PLATFORM_MAC)
+#include <sys/sysctl.h>
+#else
+#include <unistd.h>
+#endif
+
+constexpr size_t DefaultL2CacheSize = 256 * 1024;
+
+size_t CacheInfo::GetL2CacheSize()
+{
+#if defined(SPC_PLATFORM_WIN)
+    DWORD bufferSize = 0;
+    GetLogicalProcessorInformation(nullptr, &bufferSize);
+    std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> info(bufferSize / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+
+    if (GetLogicalProcessorInformation(info.data(), &bufferSize))
+    {
+        for (const SYSTEM_LOGICAL_PROCESSOR_INFORMATION& processor : info)
+            if (processor.Relationship == RelationCache && processor.Cache.Level == 2)
+                return processor.Cache.Size;
+    }
+#elif defined(SPC_PLATFORM_MAC)
+    size_t cacheSize = 0;
+    size_t length = sizeof(cacheSize);
+
+    if (sysctlbyname("hw.l2cachesize", &cacheSize, &length, nullptr, 0) == 0 && cacheSize > 0)
+        return cacheSize;
+#elif defined(_SC_LEVEL2_CACHE_SIZE)
+    long cacheSize = sysconf(_SC_LEVEL2_CACHE_SIZE);
+
+    if (cacheSize > 0)
+        return (size_t)cacheSize;
+#endif
+
+    return DefaultL2CacheSize;
+}
+
@@ -0,0 +1,53 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "memoryinfo.h"
+
+#if defined(SPC_PLATFORM_WIN)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+size_t MemoryInfo::GetPeakResidentSetSize()
+{
+#if defined(SPC_PLATFORM_WIN)
+    PROCESS_MEMORY_COUNTERS counters = {};
+
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.PeakWorkingSetSize;
+#else
+    rusage usage = {};
+
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+#if defined(SPC_PLATFORM_MAC)
+        return (size_t)usage.ru_maxrss;
+#else
+        // Linux reports kilobytes
+        return (size_t)usage.ru_maxrss * 1024;
+#endif
+    }
+#endif
+
+    return 0;
+}
+
@@ -0,0 +1,96 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <chrono>
+#include "debugscene.h"
+#include "core/sampling/rng.h"
+
+const uint64_t FieldSeed = 0x5eed;
+const int NumFieldQuads = 24;
+
+DebugScene::DebugScene(const std::string& name, bool isQuickRender)
+    : m_Name(name)
+    , m_Integrator(m_Accelerator)
+    , m_Sampler(isQuickRender ? 4 : 64)
+    , m_Camera(60)
+    , m_AcceleratorBuildSeconds(0.0)
+{
+    const std::vector<std::string>& names = GetSceneNames();
+
+    if (std::find(names.begin(), names.end(), name) == names.end())
+        throw std::invalid_argument("Unknown debug scene " + name);
+
+    // A wall with a few smaller quads in front of it that shadow parts of it
+    AddQuad({ 0, 0, 6 }, 10.0);
+    AddQuad({ -1, -1, 5 }, 0.5);
+    AddQuad({ 1, -1, 5.5 }, 0.75);
+    AddQuad({ -1, 1, 4.5 }, 0.5);
+    AddQuad({ 1, 1, 5.8 }, 0.25);
+
+    if (name == "field")
+    {
+        Rng rng(0, FieldSeed);
+
+        for (int i = 0; i < NumFieldQuads; ++i)
+        {
+            const Point3 center(rng.UniformDouble() * 6.0 - 3.0, rng.UniformDouble() * 4.0 - 2.0, 3.0 + rng.UniformDouble() * 2.5);
+            AddQuad(center, 0.1 + rng.UniformDouble() * 0.3);
+        }
+    }
+
+    std::vector<const Geometry*> geometries;
+    for (const std::unique_ptr<TriangleMesh>& mesh : m_Meshes)
+        geometries.push_back(mesh.get());
+
+    const auto startTime = std::chrono::steady_clock::now();
+    m_Accelerator.Build(geometries);
+    m_AcceleratorBuildSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    m_Integrator.SetAlbedo(0.8);
+    m_Integrator.SetSun({ 0.3, 0.5, -1 }, XyzCoefficients(2.0));
+
+    Resolution resolution;
+    resolution.SetWidth(isQuickRender ? 480 : 1280);
+    resolution.SetHeight(isQuickRender ? 270 : 720);
+    m_Camera.GetFilm().SetResolution(resolution);
+    m_Camera.GetFilm().SetTileSize(32);
+}
+
+const std::vector<std::string>& DebugScene::GetSceneNames()
+{
+    static const std::vector<std::string> names = { "wall", "field" };
+    return names;
+}
+
+void DebugScene::AddQuad(const Point3& center, double halfSize)
+{
+    TriangleMesh& mesh = *m_Meshes.emplace_back(std::make_unique<TriangleMesh>());
+
+    TriangleMesh::Vertex vertices[4];
+    vertices[0] = { .m_Position = center + Vector3(-halfSize, -halfSize, 0), .m_Normal = { 0, 0, -1 } };
+    vertices[1] = { .m_Position = center + Vector3(halfSize, -halfSize, 0), .m_Normal = { 0, 0, -1 } };
+    vertices[2] = { .m_Position = center + Vector3(halfSize, halfSize, 0), .m_Normal = { 0, 0, -1 } };
+    vertices[3] = { .m_Position = center + Vector3(-halfSize, halfSize, 0), .m_Normal = { 0, 0, -1 } };
+    mesh.SetVertices(vertices, 4);
+
+    TrianglePrimitive faces[2] = { { &mesh, 0, 1, 2 }, { &mesh, 0, 2, 3 } };
+    mesh.SetFaces(faces, 2);
+}
+
@@ -0,0 +1,65 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "core/camera/perspectivecamera.h"
+#include "core/geometry/trianglemesh.h"
+#include "core/integrator/wavefrontintegrator.h"
+#include "core/sampling/independentsampler.h"
+#include "core/spatial/qbvhaccelerator.h"
+
+// Scenes defined in code, rendered until scene files can be loaded. Scenes are built the same
+// way in every process, which distributed renders rely on to have workers render the
+// coordinator's frame and benchmarks rely on to compare runs. Procedural geometry is placed with
+// a fixed seed.
+class DebugScene
+{
+public:
+    DebugScene(const std::string& name, bool isQuickRender);
+    ~DebugScene() = default;
+
+public:
+    inline const std::string& GetName() const { return m_Name; }
+    inline Camera& GetCamera() { return m_Camera; }
+    inline const Integrator& GetIntegrator() const { return m_Integrator; }
+    inline const Sampler& GetSampler() const { return m_Sampler; }
+
+    // Time it took to build the scene's QBVH
+    inline double GetAcceleratorBuildSeconds() const { return m_AcceleratorBuildSeconds; }
+
+public:
+    // "wall" is a wall with a few quads in front of it, "field" adds a field of randomly
+    // placed quads that cast overlapping shadows
+    static const std::vector<std::string>& GetSceneNames();
+
+private:
+    void AddQuad(const Point3& center, double halfSize);
+
+private:
+    const std::string m_Name;
+    std::vector<std::unique_ptr<TriangleMesh>> m_Meshes;
+    QBvhAccelerator m_Accelerator;
+    WavefrontIntegrator m_Integrator;
+    IndependentSampler m_Sampler;
+    PerspectiveCamera m_Camera;
+    double m_AcceleratorBuildSeconds;
+};
+
@@ -17,7 +17,36 @@
 */
 
 #include <iostream>
+#include <cmath>
 #include <cstring>
+#include <sstream>
+#include "core/renderer/tilecoordinator.h"
+#include "core/renderer/tileworker.h"
+#include "exporter/stbexporter.h"
+#include "system/platform/memoryinfo.h"
+#include "debugscene.h"
+
+struct Options
+{
+    int numThreads = 0;
+    std::string outputFile;
+    bool stampFile = false;
+    bool quickRender = false;
+    bool quiet = false;
+    bool debug = false;
+    std::string sceneName = "wall";
+    std::string benchScene;
+    int benchIterations = 3;
+    std::string coordinatorAddress;
+    std::string workerAddress;
+    double tileTimeout = 0.0;
+};
+
+const std::string DefaultOutputName = "Spectre_Output";
+const std::string OutputExtension = ".png";
+
+// Workers may be started before the coordinator is up
+const double WorkerConnectTimeout = 30.0;
 
 void PrintTitle()
 {
@@ -40,6 +69,15 @@ void PrintUsage(const char* msg = nullptr)
     cout << "   -s, --stamp             Stamp output filename with metadata" << endl;
     cout << "   -q, --quick             Reduce output quality for quick render" << endl;
     cout << "   -d, --debug             Render debug scene defined in code. To be deprecated." << endl;
+    cout << "   --scene <name>          Debug scene to render, wall (default) or field" << endl;
+    cout << "Benchmark Options: " << endl;
+    cout << "   --bench <name>          Render a debug scene repeatedly and print its performance as JSON" << endl;
+    cout << "   --benchiterations <n>   Number of renders to benchmark, 3 by default" << endl;
+    cout << "Distributed Rendering Options: " << endl;
+    cout << "   --coordinator <address> Hand out the tiles of the frame to workers connecting to <address>" << endl;
+    cout << "   --worker <address>      Render tiles for the coordinator at <address>" << endl;
+    cout << "   --tiletimeout <seconds> Reassign tiles that workers have not returned in time" << endl;
+    cout << "   Addresses are unix:<path> for local processes or <host>:<port> for TCP." << endl;
     cout << "Logging Options: " << endl;
     cout << "   --quiet                 Suppress all non-error messages" << endl;
     cout << "For documentations, please refer to <url>" << endl;
@@ -47,33 +85,243 @@ void PrintUsage(const char* msg = nullptr)
     SPC_WIN32_ONLY(system("PAUSE"));
 }
 
+std::string GetOutputName(const Options& options, const Film& film, int samplesPerPixel, double seconds)
+{
+    std::string name = options.outputFile.empty() ? DefaultOutputName : options.outputFile;
+
+    // The exporter adds the extension
+    if (name.size() > OutputExtension.size() && name.compare(name.size() - OutputExtension.size(), OutputExtension.size(), OutputExtension) == 0)
+        name.resize(name.size() - OutputExtension.size());
+
+    if (options.stampFile)
+    {
+        std::ostringstream stamp;
+        stamp << "_" << film.GetResolution().GetWidth() << "x" << film.GetResolution().GetHeight();
+        stamp << "_" << samplesPerPixel << "spp_" << (int)std::ceil(seconds) << "s";
+        name += stamp.str();
+    }
+
+    return name;
+}
+
+void Export(DebugScene& scene, const Options& options, double seconds)
+{
+    const Film& film = scene.GetCamera().GetFilm();
+
+    StbExporter exporter;
+    exporter.SetOutputName(GetOutputName(options, film, scene.GetSampler().GetSamplesPerPixel(), seconds));
+
+    if (options.numThreads > 0)
+        exporter.SetNumThreads(options.numThreads);
+
+    exporter.Export(film);
+
+    if (!options.quiet)
+        std::cout << "Wrote " << exporter.GetOutputName() << OutputExtension << std::endl;
+}
+
+void RunLocal(DebugScene& scene, const Options& options)
+{
+    using namespace std;
+    Renderer renderer(scene.GetCamera(), scene.GetIntegrator(), scene.GetSampler());
+
+    if (options.numThreads > 0)
+        renderer.SetNumThreads(options.numThreads);
+
+    const RenderStatistics& statistics = renderer.Render();
+
+    if (!options.quiet)
+        cout << "Rendered " << scene.GetName() << " in " << statistics.m_Seconds << "s on " << renderer.GetNumThreads() << " threads, " << statistics.GetMraysPerSecond() << " Mrays/s" << endl;
+
+    Export(scene, options, statistics.m_Seconds);
+}
+
+// Coordinator and workers compare this before any tile is handed out
+std::string GetSceneId(const DebugScene& scene, const Options& options)
+{
+    return options.quickRender ? scene.GetName() + ":quick" : scene.GetName();
+}
+
+void RunCoordinator(DebugScene& scene, const Options& options)
+{
+    using namespace std;
+    Film& film = scene.GetCamera().GetFilm();
+    TileCoordinator coordinator(film, scene.GetSampler().GetSamplesPerPixel());
+    coordinator.SetSceneId(GetSceneId(scene, options));
+    coordinator.SetTileTimeout(options.tileTimeout);
+    coordinator.Listen(options.coordinatorAddress);
+
+    if (!options.quiet)
+        cout << "Waiting for workers on " << options.coordinatorAddress << endl;
+
+    const RenderStatistics& statistics = coordinator.Run();
+
+    if (!options.quiet)
+    {
+        cout << "Rendered " << film.GetNumTiles() << " tiles on " << coordinator.GetNumWorkers() << " workers in " << statistics.m_Seconds << "s";
+        cout << ", " << coordinator.GetNumReassignedTiles() << " tiles reassigned" << endl;
+    }
+
+    Export(scene, options, statistics.m_Seconds);
+}
+
+void RunWorker(DebugScene& scene, const Options& options)
+{
+    using namespace std;
+    TileWorker worker(scene.GetCamera(), scene.GetIntegrator(), scene.GetSampler());
+    worker.SetSceneId(GetSceneId(scene, options));
+
+    if (options.numThreads > 0)
+        worker.SetNumThreads(options.numThreads);
+
+    worker.Run(options.workerAddress, WorkerConnectTimeout);
+
+    if (!options.quiet)
+        cout << "Rendered " << worker.GetNumTilesRendered() << " tiles" << endl;
+}
+
+// Prints a single JSON object so that results can be collected by scripts. Every iteration
+// builds and renders the scene from scratch, rates are over all iterations together.
+void RunBenchmark(const Options& options)
+{
+    using namespace std;
+    double buildSeconds = 0.0;
+    double renderSeconds = 0.0;
+    uint64_t numCameraRays = 0;
+    uint64_t numRays = 0;
+    int numThreads = 0;
+    int samplesPerPixel = 0;
+    Resolution resolution;
+
+    for (int i = 0; i < options.benchIterations; ++i)
+    {
+        DebugScene scene(options.benchScene, options.quickRender);
+        Renderer renderer(scene.GetCamera(), scene.GetIntegrator(), scene.GetSampler());
+
+        if (options.numThreads > 0)
+            renderer.SetNumThreads(options.numThreads);
+
+        const RenderStatistics& statistics = renderer.Render();
+        buildSeconds += scene.GetAcceleratorBuildSeconds();
+        renderSeconds += statistics.m_Seconds;
+        numCameraRays += statistics.m_NumCameraRays;
+        numRays += statistics.m_NumRays;
+        numThreads = renderer.GetNumThreads();
+        samplesPerPixel = scene.GetSampler().GetSamplesPerPixel();
+        resolution = scene.GetCamera().GetFilm().GetResolution();
+    }
+
+    // Renders too fast for the timer report no rates rather than inf, which is not valid JSON
+    const double primaryRaysPerSecond = renderSeconds > 0.0 ? numCameraRays / renderSeconds : 0.0;
+    const double raysPerSecond = renderSeconds > 0.0 ? numRays / renderSeconds : 0.0;
+
+    cout << "{\"scene\": \"" << options.benchScene << "\"";
+    cout << ", \"iterations\": " << options.benchIterations;
+    cout << ", \"threads\": " << numThreads;
+    cout << ", \"width\": " << resolution.GetWidth();
+    cout << ", \"height\": " << resolution.GetHeight();
+    cout << ", \"samples_per_pixel\": " << samplesPerPixel;
+    cout << ", \"accelerator_build_seconds\": " << buildSeconds / options.benchIterations;
+    cout << ", \"render_seconds\": " << renderSeconds / options.benchIterations;
+    cout << ", \"primary_rays_per_second\": " << primaryRaysPerSecond;
+    cout << ", \"rays_per_second\": " << raysPerSecond;
+    cout << ", \"peak_rss_bytes\": " << MemoryInfo::GetPeakResidentSetSize();
+    cout << "}" << endl;
+}
+
 int main(int argc, char* argv[])
 {
-    PrintTitle();
+    Options options;
+    std::vector<std::string> filenames;
 
     for (int i = 1; i < argc; ++i)
     {
+        const bool hasValue = i + 1 < argc;
+
         if (!strcmp(argv[i], "--help") || !strcmp(argv[i], "-h"))
         {
+            PrintTitle();
             PrintUsage();
             return -1;
         }
-        //else if (!strcmp(argv[i], "--numthreads") || !strcmp(argv[i], "-t"))
-        //    options.numThreads = exrMax(options.numThreads, exrU32(atoi(argv[++i])));
-        //else if (!strcmp(argv[i], "--out") || !strcmp(argv[i], "-o"))
-        //    options.outputFile = argv[++i];
-        //else if (!strcmp(argv[i], "--stamp") || !strcmp(argv[i], "-s"))
-        //    options.stampFile = true;
-        //else if (!strcmp(argv[i], "--quick") || !strcmp(argv[i], "-q"))
-        //    options.quickRender = true;
-        //else if (!strcmp(argv[i], "--quiet"))
-        //    options.quiet = true;
-        //else if (!strcmp(argv[i], "--debug") || !strcmp(argv[i], "-d"))
-        //    options.debug = true;
-        //else
-        //    filenames.push_back(argv[i]);
+        else if ((!strcmp(argv[i], "--numthreads") || !strcmp(argv[i], "-t")) && hasValue)
+            options.numThreads = std::max(options.numThreads, atoi(argv[++i]));
+        else if ((!strcmp(argv[i], "--out") || !strcmp(argv[i], "-o")) && hasValue)
+            options.outputFile = argv[++i];
+        else if (!strcmp(argv[i], "--stamp") || !strcmp(argv[i], "-s"))
+            options.stampFile = true;
+        else if (!strcmp(argv[i], "--quick") || !strcmp(argv[i], "-q"))
+            options.quickRender = true;
+        else if (!strcmp(argv[i], "--quiet"))
+            options.quiet = true;
+        else if (!strcmp(argv[i], "--debug") || !strcmp(argv[i], "-d"))
+            options.debug = true;
+        else if (!strcmp(argv[i], "--scene") && hasValue)
+            options.sceneName = argv[++i];
+        else if (!strcmp(argv[i], "--bench") && hasValue)
+            options.benchScene = argv[++i];
+        else if (!strcmp(argv[i], "--benchiterations") && hasValue)
+            options.benchIterations = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--coordinator") && hasValue)
+            options.coordinatorAddress = argv[++i];
+        else if (!strcmp(argv[i], "--worker") && hasValue)
+            options.workerAddress = argv[++i];
+        else if (!strcmp(argv[i], "--tiletimeout") && hasValue)
+            options.tileTimeout = atof(argv[++i]);
+        else if (argv[i][0] == '-')
+        {
+            PrintUsage((std::string("unknown or incomplete option ") + argv[i]).c_str());
+            return -1;
+        }
+        else
+            filenames.push_back(argv[i]);
+    }
+
+    if (!options.coordinatorAddress.empty() && !options.workerAddress.empty())
+    {
+        PrintUsage("a process is either a coordinator or a worker");
+        return -1;
+    }
+
+    if (!filenames.empty() && !options.debug)
+    {
+        PrintUsage("loading scene files is not supported yet, use --debug to render a debug scene");
+        return -1;
+    }
+
+    if (options.benchIterations < 1)
+    {
+        PrintUsage("--benchiterations needs at least one iteration");
+        return -1;
     }
 
+    // Benchmarks only print their results
+    if (!options.quiet && options.benchScene.empty())
+        PrintTitle();
+
+    try
+    {
+        if (!options.benchScene.empty())
+        {
+            RunBenchmark(options);
+            return 0;
+        }
+
+        // Coordinator and workers must agree on the scene, including --quick
+        DebugScene scene(options.sceneName, options.quickRender);
+
+        if (!options.coordinatorAddress.empty())
+            RunCoordinator(scene, options);
+        else if (!options.workerAddress.empty())
+            RunWorker(scene, options);
+        else
+            RunLocal(scene, options);
+    }
+    catch (const std::exception& e)
+    {
+        fprintf(stderr, "spectre: %s\n", e.what());
+        return 1;
+    }
 
     return 0;
-}
\ No newline at end of file
+}
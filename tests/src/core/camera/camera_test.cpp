@@ -19,6 +19,7 @@
 #include "gtest.h"
 #include "core/camera/camera.h"
 #include "core/film/standardresolution.h"
+#include "core/sampling/stratifiedsampler.h"
 
 class CameraImplStub : public Camera
 {
@@ -33,8 +34,7 @@ TEST(CameraTest, CanBeCreated)
 TEST(CameraTest, CanGetTransform)
 {
     CameraImplStub camera;
-    Matrix4x4& transform = camera.GetTransform();
-    transform = Transform::GetTranslationMatrix({ 1, 2, 3 });
+    camera.SetTransform(Transform::GetTranslationMatrix({ 1, 2, 3 }));
     EXPECT_EQ(camera.GetTransform(), Matrix4x4(1, 0, 0, 1, 0, 1, 0, 2, 0, 0, 1, 3, 0, 0, 0, 1));
 }
 
@@ -51,29 +51,28 @@ TEST(CameraTest, CanGetFilm)
 TEST(CameraTest, CanTransformCameraVectorToWorldSpace)
 {
     CameraImplStub camera;
-    Matrix4x4& transform = camera.GetTransform();
 
     Vector3 cameraSpaceForward(0, 0, 1);
     Vector3 cameraSpaceUp(0, 1, 0);
     Vector3 cameraSpaceRight(1, 0, 0);
 
     // Camera at origin
-    transform = Transform::GetTranslationMatrix({ 0.0 });
+    camera.SetTransform(Transform::GetTranslationMatrix({ 0.0 }));
     EXPECT_EQ(camera.ToWorldSpace(cameraSpaceForward), cameraSpaceForward);
     EXPECT_EQ(camera.ToWorldSpace(cameraSpaceUp), cameraSpaceUp);
     EXPECT_EQ(camera.ToWorldSpace(cameraSpaceRight), cameraSpaceRight);
 
-    transform = Transform::GetTranslationMatrix({ 1, -2.30, 5.234 });
+    camera.SetTransform(Transform::GetTranslationMatrix({ 1, -2.30, 5.234 }));
     EXPECT_EQ(camera.ToWorldSpace(cameraSpaceForward), cameraSpaceForward);
     EXPECT_EQ(camera.ToWorldSpace(cameraSpaceUp), cameraSpaceUp);
     EXPECT_EQ(camera.ToWorldSpace(cameraSpaceRight), cameraSpaceRight);
 
-    transform = Transform::GetScaleMatrix({ 2.0, 2.0, -2.0 });
+    camera.SetTransform(Transform::GetScaleMatrix({ 2.0, 2.0, -2.0 }));
     EXPECT_EQ(camera.ToWorldSpace(cameraSpaceForward), Vector3(0, 0, -2));
     EXPECT_EQ(camera.ToWorldSpace(cameraSpaceUp), Vector3(0, 2, 0));
     EXPECT_EQ(camera.ToWorldSpace(cameraSpaceRight), Vector3(2, 0, 0));
 
-    transform = Transform::GetRotationMatrix({ SMath::DegToRad(90.0), 0, 0 });
+    camera.SetTransform(Transform::GetRotationMatrix({ SMath::DegToRad(90.0), 0, 0 }));
     EXPECT_EQ(camera.ToWorldSpace(cameraSpaceForward),-cameraSpaceUp);
     EXPECT_EQ(camera.ToWorldSpace(cameraSpaceUp), cameraSpaceForward);
     EXPECT_EQ(camera.ToWorldSpace(cameraSpaceRight), cameraSpaceRight);
@@ -82,7 +81,6 @@ TEST(CameraTest, CanTransformCameraVectorToWorldSpace)
 TEST(CameraTest, CanTransformCameraPointToWorldSpace)
 {
     CameraImplStub camera;
-    Matrix4x4& transform = camera.GetTransform();
 
     Point3 cameraSpaceForward(0, 0, 1);
     Point3 cameraSpaceUp(0, 1, 0);
@@ -94,17 +92,17 @@ TEST(CameraTest, CanTransformCameraPointToWorldSpace)
     EXPECT_EQ(camera.ToWorldSpace(cameraSpaceRight), cameraSpaceRight);
 
     Vector3 translation(1, -2.30, 5.234);
-    transform = Transform::GetTranslationMatrix(translation);
+    camera.SetTransform(Transform::GetTranslationMatrix(translation));
     EXPECT_EQ(camera.ToWorldSpace(cameraSpaceForward), cameraSpaceForward + translation);
     EXPECT_EQ(camera.ToWorldSpace(cameraSpaceUp), cameraSpaceUp + translation);
     EXPECT_EQ(camera.ToWorldSpace(cameraSpaceRight), cameraSpaceRight + translation);
 
-    transform = Transform::GetScaleMatrix({ 2.0, 2.0, -2.0 });
+    camera.SetTransform(Transform::GetScaleMatrix({ 2.0, 2.0, -2.0 }));
     EXPECT_EQ(camera.ToWorldSpace(cameraSpaceForward), Point3(0, 0, -2));
     EXPECT_EQ(camera.ToWorldSpace(cameraSpaceUp), Point3(0, 2, 0));
     EXPECT_EQ(camera.ToWorldSpace(cameraSpaceRight), Point3(2, 0, 0));
 
-    transform = Transform::GetRotationMatrix({ SMath::DegToRad(90.0), 0, 0 });
+    camera.SetTransform(Transform::GetRotationMatrix({ SMath::DegToRad(90.0), 0, 0 }));
     EXPECT_EQ(camera.ToWorldSpace(cameraSpaceForward), -cameraSpaceUp);
     EXPECT_EQ(camera.ToWorldSpace(cameraSpaceUp), cameraSpaceForward);
     EXPECT_EQ(camera.ToWorldSpace(cameraSpaceRight), cameraSpaceRight);
@@ -113,7 +111,6 @@ TEST(CameraTest, CanTransformCameraPointToWorldSpace)
 TEST(CameraTest, CanTranformFilmPointToCameraSpace)
 {
     CameraImplStub camera;
-    Matrix4x4& transform = camera.GetTransform();
     Resolution resolution = camera.GetFilm().GetResolution();
 
     Point2i filmPointA(0, 0);
@@ -134,7 +131,6 @@ TEST(CameraTest, CanTranformFilmPointToCameraSpace)
 TEST(CameraTest, CanTransformWorldVectorToCameraSpace)
 {
     CameraImplStub camera;
-    Matrix4x4& transform = camera.GetTransform();
 
     Vector3 worldSpaceForward(0, 0, 1);
     Vector3 worldSpaceUp(0, 1, 0);
@@ -146,17 +142,17 @@ TEST(CameraTest, CanTransformWorldVectorToCameraSpace)
     EXPECT_EQ(camera.ToCameraSpace(worldSpaceRight), worldSpaceRight);
 
     Vector3 translation(1, -2.30, 5.234);
-    transform = Transform::GetTranslationMatrix(translation);
+    camera.SetTransform(Transform::GetTranslationMatrix(translation));
     EXPECT_EQ(camera.ToCameraSpace(worldSpaceForward), worldSpaceForward);
     EXPECT_EQ(camera.ToCameraSpace(worldSpaceUp), worldSpaceUp);
     EXPECT_EQ(camera.ToCameraSpace(worldSpaceRight), worldSpaceRight);
 
-    transform = Transform::GetTranslationMatrix(translation) * Transform::GetScaleMatrix({ 2.0, 2.0, -2.0 });
+    camera.SetTransform(Transform::GetTranslationMatrix(translation) * Transform::GetScaleMatrix({ 2.0, 2.0, -2.0 }));
     EXPECT_EQ(camera.ToCameraSpace(worldSpaceForward), Vector3(0, 0, -.5));
     EXPECT_EQ(camera.ToCameraSpace(worldSpaceUp), Vector3(0, 0.5, 0));
     EXPECT_EQ(camera.ToCameraSpace(worldSpaceRight), Vector3(0.5, 0, 0));
 
-    transform = Transform::GetTranslationMatrix(translation) * Transform::GetRotationMatrix({ SMath::DegToRad(90.0), 0, 0 });
+    camera.SetTransform(Transform::GetTranslationMatrix(translation) * Transform::GetRotationMatrix({ SMath::DegToRad(90.0), 0, 0 }));
     EXPECT_EQ(camera.ToCameraSpace(worldSpaceForward), worldSpaceUp);
     EXPECT_EQ(camera.ToCameraSpace(worldSpaceUp), -worldSpaceForward);
     EXPECT_EQ(camera.ToCameraSpace(worldSpaceRight), worldSpaceRight);
@@ -165,7 +161,6 @@ TEST(CameraTest, CanTransformWorldVectorToCameraSpace)
 TEST(CameraTest, CanTransformWorldPointToCameraSpace)
 {
     CameraImplStub camera;
-    Matrix4x4& transform = camera.GetTransform();
 
     Point3 cameraSpaceForward(0, 0, 1);
     Point3 cameraSpaceUp(0, 1, 0);
@@ -177,9 +172,71 @@ TEST(CameraTest, CanTransformWorldPointToCameraSpace)
     EXPECT_EQ(camera.ToCameraSpace(cameraSpaceRight), cameraSpaceRight);
 
     Vector3 translation(1, -2.30, 5.234);
-    transform = Transform::GetTranslationMatrix(translation);
+    camera.SetTransform(Transform::GetTranslationMatrix(translation));
     EXPECT_EQ(camera.ToCameraSpace(cameraSpaceForward), cameraSpaceForward - translation);
     EXPECT_EQ(camera.ToCameraSpace(cameraSpaceUp), cameraSpaceUp - translation);
     EXPECT_EQ(camera.ToCameraSpace(cameraSpaceRight), cameraSpaceRight - translation);
 }
 
+TEST(CameraTest, CameraSamplesAreDeterministicAndWithinPixel)
+{
+    for (int i = 0; i < 64; ++i)
+    {
+        const CameraSample sample = Camera::GetCameraSample({ i, 2 * i }, i);
+        EXPECT_EQ(sample.m_FilmOffset, Camera::GetCameraSample({ i, 2 * i }, i).m_FilmOffset);
+        EXPECT_GE(sample.m_FilmOffset.x, 0.0);
+        EXPECT_LT(sample.m_FilmOffset.x, 1.0);
+        EXPECT_GE(sample.m_FilmOffset.y, 0.0);
+        EXPECT_LT(sample.m_FilmOffset.y, 1.0);
+        EXPECT_GE(sample.m_Time, 0.0);
+        EXPECT_LT(sample.m_Time, 1.0);
+    }
+
+    EXPECT_FALSE(Camera::GetCameraSample({ 3, 4 }, 0).m_FilmOffset == Camera::GetCameraSample({ 3, 4 }, 1).m_FilmOffset);
+}
+
+TEST(CameraTest, CanSetShutter)
+{
+    CameraImplStub camera;
+    EXPECT_DOUBLE_EQ(camera.GetShutterOpen(), 0.0);
+    EXPECT_DOUBLE_EQ(camera.GetShutterClose(), 1.0);
+
+    camera.SetShutter(0.25, 0.75);
+    EXPECT_DOUBLE_EQ(camera.GetShutterTime(0.0), 0.25);
+    EXPECT_DOUBLE_EQ(camera.GetShutterTime(0.5), 0.5);
+    EXPECT_THROW(camera.SetShutter(1.0, 0.5), std::invalid_argument);
+
+    camera.GetFilm().SetTileSize(8);
+    RayBatch rays;
+    camera.GenerateRays(camera.GetFilm().GetTile(0), 0, rays);
+
+    for (size_t i = 0; i < rays.GetSize(); ++i)
+    {
+        EXPECT_GE(rays.GetTime(i), 0.25);
+        EXPECT_LE(rays.GetTime(i), 0.75);
+    }
+}
+
+TEST(CameraTest, CanGenerateRaysFromSampler)
+{
+    CameraImplStub camera;
+    camera.GetFilm().SetTileSize(8);
+    StratifiedSampler sampler(2, 2);
+
+    const FilmTile& tile = camera.GetFilm().GetTile(0);
+    RayBatch rays;
+    camera.GenerateRays(tile, 3, sampler, rays);
+    ASSERT_EQ(rays.GetSize(), 64);
+
+    for (size_t i = 0; i < rays.GetSize(); ++i)
+    {
+        const Point2i pixel = rays.GetPixel(i);
+        sampler.StartPixelSample(pixel, 3);
+        const Point2 u = sampler.GetPixel2D();
+        const Point2 lens = sampler.Get2D();
+        EXPECT_EQ(rays.GetFilmPosition(i), Point2(pixel.x + u.x, pixel.y + u.y));
+        EXPECT_EQ(rays.GetLensSample(i), lens);
+        EXPECT_DOUBLE_EQ(rays.GetTime(i), camera.GetShutterTime(sampler.Get1D()));
+    }
+}
+
@@ -60,8 +60,7 @@ TEST(OrthographicCameraTest, CanGenerateRay)
     EXPECT_FALSE(bottomRightRay.m_Origin == Point3(0, 0, 0));
     EXPECT_FALSE(topLeftCornerRay.m_Origin == Point3(0, 0, 0));
 
-    Matrix4x4& transform = camera.GetTransform();
-    transform = Transform::GetTranslationMatrix({ 1, 0, 0 });
+    camera.SetTransform(Transform::GetTranslationMatrix({ 1, 0, 0 }));
 
     topLeftCornerRay = camera.GenerateRay({ 0, 0 });
     centerRay = camera.GenerateRay({
@@ -78,7 +77,7 @@ TEST(OrthographicCameraTest, CanGenerateRay)
     EXPECT_FALSE(bottomRightRay.m_Origin == Point3(1, 0, 0));
     EXPECT_FALSE(topLeftCornerRay.m_Origin == Point3(1, 0, 0));
 
-    transform = transform * Transform::GetRotationMatrix({ 0, SMath::DegToRad(90.0), 0 });
+    camera.SetTransform(camera.GetTransform() * Transform::GetRotationMatrix({ 0, SMath::DegToRad(90.0), 0 }));
     topLeftCornerRay = camera.GenerateRay({ 0, 0 });
     centerRay = camera.GenerateRay({
         camera.GetFilm().GetResolution().GetWidth() / 2,
@@ -111,4 +110,23 @@ TEST(OrthographicCameraTest, GeneratedRayIsNormalized)
     EXPECT_EQ(bottomRightRay.m_Direction, bottomRightRay.m_Direction.Normalized());
 }
 
+TEST(OrthographicCameraTest, GenerateRaysMatchesGenerateRay)
+{
+    OrthographicCamera camera(2.0);
+    camera.SetTransform(Transform::GetTranslationMatrix({ 1, -2, 3 }) * Transform::GetRotationMatrix({ 0.3, -0.7, 0.1 }));
+    camera.GetFilm().SetTileSize(16);
+
+    const FilmTile& tile = camera.GetFilm().GetTile(2);
+    RayBatch rays;
+    camera.GenerateRays(tile, 1, rays);
+    ASSERT_EQ(rays.GetSize(), (size_t)tile.GetSize().x * tile.GetSize().y);
+
+    for (size_t i = 0; i < rays.GetSize(); ++i)
+    {
+        const Point2i pixel = rays.GetPixel(i);
+        const Ray expected = camera.GenerateRay(pixel, Camera::GetCameraSample(pixel, 1).m_FilmOffset);
+        EXPECT_EQ(rays.GetRay(i).m_Origin, expected.m_Origin);
+        EXPECT_EQ(rays.GetRay(i).m_Direction, expected.m_Direction);
+    }
+}
 
@@ -60,8 +60,7 @@ TEST(PerspectiveCameraTest, CanGenerateRay)
     EXPECT_EQ(bottomRightRay.m_Origin, Point3(0, 0, 0));
     EXPECT_EQ(topLeftCornerRay.m_Origin, Point3(0, 0, 0));
 
-    Matrix4x4& transform = camera.GetTransform();
-    transform = Transform::GetTranslationMatrix({ 1, 0, 0 });
+    camera.SetTransform(Transform::GetTranslationMatrix({ 1, 0, 0 }));
     topLeftCornerRay = camera.GenerateRay({ 0, 0 });
     centerRay = camera.GenerateRay({
         camera.GetFilm().GetResolution().GetWidth() / 2,
@@ -77,7 +76,7 @@ TEST(PerspectiveCameraTest, CanGenerateRay)
     EXPECT_EQ(bottomRightRay.m_Origin, Point3(1, 0, 0));
     EXPECT_EQ(topLeftCornerRay.m_Origin, Point3(1, 0, 0));
 
-    transform = transform * Transform::GetRotationMatrix({ 0, SMath::DegToRad(90.0), 0 });
+    camera.SetTransform(camera.GetTransform() * Transform::GetRotationMatrix({ 0, SMath::DegToRad(90.0), 0 }));
     topLeftCornerRay = camera.GenerateRay({ 0, 0 });
     centerRay = camera.GenerateRay({
         camera.GetFilm().GetResolution().GetWidth() / 2,
@@ -111,3 +110,124 @@ TEST(PerspectiveCameraTest, GeneratedRayIsNormalized)
 }
 
 
+
+TEST(PerspectiveCameraTest, GenerateRaysMatchesGenerateRay)
+{
+    PerspectiveCamera camera(60);
+    camera.SetTransform(Transform::GetTranslationMatrix({ 1, -2, 3 }) * Transform::GetRotationMatrix({ 0.3, -0.7, 0.1 }));
+    camera.GetFilm().SetTileSize(16);
+
+    const FilmTile& tile = camera.GetFilm().GetTile(3);
+    RayBatch rays;
+    camera.GenerateRays(tile, 5, rays);
+    ASSERT_EQ(rays.GetSize(), (size_t)tile.GetSize().x * tile.GetSize().y);
+
+    for (size_t i = 0; i < rays.GetSize(); ++i)
+    {
+        const Point2i pixel = rays.GetPixel(i);
+        const Vector2 offset = Camera::GetCameraSample(pixel, 5).m_FilmOffset;
+        const Ray expected = camera.GenerateRay(pixel, offset);
+        const Ray ray = rays.GetRay(i);
+
+        EXPECT_EQ(pixel, tile.TileToFilmSpace({ (int)i % tile.GetSize().x, (int)i / tile.GetSize().x }));
+        EXPECT_EQ(rays.GetFilmPosition(i), Point2(pixel.x + offset.x, pixel.y + offset.y));
+        EXPECT_EQ(ray.m_Origin, expected.m_Origin);
+        EXPECT_EQ(ray.m_Direction, expected.m_Direction);
+        EXPECT_EQ(ray.m_Direction, ray.m_Direction.Normalized());
+    }
+}
+
+TEST(PerspectiveCameraTest, CachedTransformsFollowChanges)
+{
+    PerspectiveCamera camera;
+    const Point2i pixel(10, 20);
+    const Ray before = camera.GenerateRay(pixel);
+
+    camera.SetHorizontalFov(30);
+    const Ray narrow = camera.GenerateRay(pixel);
+    EXPECT_FALSE(narrow.m_Direction == before.m_Direction);
+    EXPECT_EQ(narrow.m_Direction, PerspectiveCamera(30).GenerateRay(pixel).m_Direction);
+
+    Resolution resolution;
+    resolution.SetWidth(320);
+    resolution.SetHeight(240);
+    camera.GetFilm().SetResolution(resolution);
+
+    // Resizing the film invalidates the cache until it is updated explicitly
+    EXPECT_FALSE(camera.HasValidCachedTransforms());
+    EXPECT_THROW(camera.GenerateRay(pixel), std::runtime_error);
+    camera.UpdateCachedTransforms();
+    EXPECT_TRUE(camera.HasValidCachedTransforms());
+
+    PerspectiveCamera reference(30);
+    reference.GetFilm().SetResolution(resolution);
+    reference.UpdateCachedTransforms();
+    EXPECT_EQ(camera.GenerateRay(pixel).m_Direction, reference.GenerateRay(pixel).m_Direction);
+    EXPECT_FALSE(camera.GenerateRay(pixel).m_Direction == narrow.m_Direction);
+}
+
+TEST(PerspectiveCameraTest, CanSetLens)
+{
+    PerspectiveCamera camera;
+    EXPECT_DOUBLE_EQ(camera.GetApertureRadius(), 0.0);
+
+    camera.SetApertureRadius(0.1);
+    camera.SetFocusDistance(5.0);
+    EXPECT_DOUBLE_EQ(camera.GetApertureRadius(), 0.1);
+    EXPECT_DOUBLE_EQ(camera.GetFocusDistance(), 5.0);
+
+    EXPECT_THROW(camera.SetApertureRadius(-1.0), std::invalid_argument);
+    EXPECT_THROW(camera.SetFocusDistance(0.0), std::invalid_argument);
+}
+
+TEST(PerspectiveCameraTest, ThinLensRaysConvergeAtFocusDistance)
+{
+    PerspectiveCamera camera;
+    camera.SetTransform(Transform::GetTranslationMatrix({ 1, 2, 3 }));
+    camera.SetApertureRadius(0.5);
+    camera.SetFocusDistance(4.0);
+
+    const Point2i pixel(100, 50);
+    const Ray pinholeRay = camera.GenerateRay(pixel);
+    const Point3 focusPoint = pinholeRay(4.0 / pinholeRay.m_Direction.z);
+
+    for (int i = 0; i < 16; ++i)
+    {
+        CameraSample sample;
+        sample.m_Lens = { (i % 4 + 0.5) / 4.0, (i / 4 + 0.5) / 4.0 };
+        const Ray ray = camera.GenerateRay(pixel, sample);
+
+        EXPECT_NEAR(ray.m_Origin.z, 3.0, 1e-12);
+        EXPECT_LE((ray.m_Origin - Point3(1, 2, 3)).Magnitude(), 0.5 + 1e-12);
+        EXPECT_EQ(ray(4.0 / ray.m_Direction.z), focusPoint);
+    }
+
+    // Rays through the center of the lens are pinhole rays
+    EXPECT_EQ(camera.GenerateRay(pixel, CameraSample()).m_Direction, pinholeRay.m_Direction);
+}
+
+TEST(PerspectiveCameraTest, ThinLensBatchMatchesGenerateRay)
+{
+    PerspectiveCamera camera(50);
+    camera.SetTransform(Transform::GetRotationMatrix({ 0.2, 0.4, 0.0 }));
+    camera.SetApertureRadius(0.25);
+    camera.SetFocusDistance(3.0);
+    camera.GetFilm().SetTileSize(16);
+
+    const FilmTile& tile = camera.GetFilm().GetTile(1);
+    RayBatch rays;
+    camera.GenerateRays(tile, 2, rays);
+
+    for (size_t i = 0; i < rays.GetSize(); ++i)
+    {
+        const Point2i pixel = rays.GetPixel(i);
+        const Ray expected = camera.GenerateRay(pixel, Camera::GetCameraSample(pixel, 2));
+        const Ray ray = rays.GetRay(i);
+
+        for (int c = 0; c < 3; ++c)
+        {
+            EXPECT_NEAR(ray.m_Origin[c], expected.m_Origin[c], 1e-9);
+            EXPECT_NEAR(ray.m_Direction[c], expected.m_Direction[c], 1e-9);
+        }
+    }
+}
@@ -0,0 +1,100 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest.h"
+#include "core/film/aovbuffer.h"
+
+TEST(AovBufferTest, DisabledAovsTakeNoMemory)
+{
+    AovBuffer none(64, Aov::None);
+    EXPECT_FALSE(none.IsAllocated());
+    EXPECT_EQ(none.GetMemoryUsage(), 0);
+
+    // Depth comes with the shared sample count plane
+    AovBuffer depth(64, Aov::Depth);
+    EXPECT_TRUE(depth.IsAllocated());
+    EXPECT_TRUE(depth.Has(AovType::Depth));
+    EXPECT_FALSE(depth.Has(AovType::Normal));
+    EXPECT_EQ(depth.GetMemoryUsage(), 2 * 64 * sizeof(FilmChannel));
+
+    AovBuffer all(64, Aov::All);
+    EXPECT_EQ(all.GetMemoryUsage(), 8 * 64 * sizeof(FilmChannel));
+
+    EXPECT_THROW(AovBuffer(64, 1u << 10), std::invalid_argument);
+}
+
+TEST(AovBufferTest, AveragesSamples)
+{
+    AovBuffer buffer(4, Aov::All);
+    buffer.Add(1, { 2.0, Normal3(0.0, 1.0, 0.0), RgbCoefficients(0.5) });
+    buffer.Add(1, { 4.0, Normal3(0.0, 0.0, 1.0), RgbCoefficients(0.25) });
+
+    float depth, normal[3], albedo[3], sampleCount;
+    buffer.Resolve(AovType::Depth, 1, &depth);
+    buffer.Resolve(AovType::Normal, 1, normal);
+    buffer.Resolve(AovType::Albedo, 1, albedo);
+    buffer.Resolve(AovType::SampleCount, 1, &sampleCount);
+
+    EXPECT_FLOAT_EQ(depth, 3.0f);
+    EXPECT_FLOAT_EQ(normal[0], 0.0f);
+    EXPECT_FLOAT_EQ(normal[1], 0.5f);
+    EXPECT_FLOAT_EQ(normal[2], 0.5f);
+    EXPECT_FLOAT_EQ(albedo[0], 0.375f);
+    EXPECT_FLOAT_EQ(sampleCount, 2.0f);
+
+    // Pixels without samples resolve to zero
+    buffer.Resolve(AovType::Depth, 0, &depth);
+    EXPECT_FLOAT_EQ(depth, 0.0f);
+}
+
+TEST(AovBufferTest, CompileTimeMaskMatchesRuntimeMask)
+{
+    const AovSample sample = { 1.5, Normal3(1.0, 0.0, 0.0), RgbCoefficients(0.75) };
+
+    AovBuffer runtime(1, Aov::Depth | Aov::Albedo);
+    AovBuffer compileTime(1, Aov::Depth | Aov::Albedo);
+    runtime.Add(0, sample);
+    compileTime.Add<Aov::Depth | Aov::Albedo>(0, sample);
+
+    for (AovType type : { AovType::Depth, AovType::Albedo })
+    {
+        float expected[3] = {}, actual[3] = {};
+        runtime.Resolve(type, 0, expected);
+        compileTime.Resolve(type, 0, actual);
+
+        for (int c = 0; c < 3; ++c)
+            EXPECT_FLOAT_EQ(actual[c], expected[c]);
+    }
+
+    EXPECT_EQ(Aov::GetName(AovType::SampleCount), "sampleCount");
+}
+
+TEST(AovBufferTest, DispatchesOnFullMask)
+{
+    AovMask dispatched = Aov::All;
+    Aov::Dispatch(Aov::None, [&dispatched]<AovMask Mask>() { dispatched = Mask; });
+    EXPECT_EQ(dispatched, Aov::None);
+
+    Aov::Dispatch(Aov::Normal | Aov::SampleCount, [&dispatched]<AovMask Mask>() { dispatched = Mask; });
+    EXPECT_EQ(dispatched, Aov::Normal | Aov::SampleCount);
+
+    EXPECT_THROW(Aov::Dispatch(Aov::All + 1, []<AovMask Mask>() {}), std::invalid_argument);
+}
+
@@ -21,6 +21,8 @@
 #include "gtest.h"
 #include "core/film/film.h"
 #include "core/film/standardresolution.h"
+#include "core/film/filter/mitchellfilter.h"
+#include "core/film/filter/gaussianfilter.h"
 
 TEST(FilmTest, CanBeCreated)
 {
@@ -98,3 +100,377 @@ TEST(FilmTest, CanGetTotalTileCount)
     ASSERT_EQ(film.GetNumTiles(), std::ceil(3840 / tileSize) * std::ceil(2160 / tileSize));
 }
 
+TEST(FilmTest, CanReportMemoryUsage)
+{
+    const size_t bytesPerPixel = PixelBuffer::NumChannels * sizeof(FilmChannel);
+    Film film;
+
+    film.SetResolution(Resolution640X360());
+    EXPECT_EQ(film.GetMemoryUsage(), 640 * 360 * bytesPerPixel);
+
+    film.SetResolution(Resolution1920X1080());
+    EXPECT_EQ(film.GetMemoryUsage(), 1920 * 1080 * bytesPerPixel);
+
+    film.SetResolution(Resolution3840X2160());
+    EXPECT_EQ(film.GetMemoryUsage(), 3840 * 2160 * bytesPerPixel);
+
+    film.EnableSplatBuffer();
+    EXPECT_TRUE(film.HasSplatBuffer());
+    EXPECT_EQ(film.GetMemoryUsage(), 2 * 3840 * 2160 * bytesPerPixel);
+
+    film.SetResolution(Resolution1920X1080());
+    EXPECT_EQ(film.GetMemoryUsage(), 2 * 1920 * 1080 * bytesPerPixel);
+}
+
+TEST(FilmTest, HasBoxFilterByDefault)
+{
+    Film film;
+    EXPECT_DOUBLE_EQ(film.GetFilterTable().GetRadius(), 0.5);
+    EXPECT_EQ(film.GetTile(0).GetApron(), 0);
+}
+
+TEST(FilmTest, CanSetFilter)
+{
+    Film film;
+    ASSERT_NO_THROW(film.SetFilter(MitchellFilter()));
+    EXPECT_DOUBLE_EQ(film.GetFilterTable().GetRadius(), 2.0);
+    EXPECT_EQ(film.GetTile(0).GetApron(), 2);
+}
+
+TEST(FilmTest, MergedSamplesAreConservedAcrossTiles)
+{
+    Film film;
+    film.SetFilter(GaussianFilter(1.5));
+
+    // Sample next to the corner shared by four tiles
+    const int tileSize = film.GetTileSize();
+    const Point2 samplePos(tileSize + 0.2, tileSize - 0.1);
+    film.AddSample(samplePos, { 1.0, 1.0, 1.0 });
+    film.MergeTileAprons();
+
+    for (int y = tileSize - 3; y <= tileSize + 1; ++y)
+    {
+        for (int x = tileSize - 2; x <= tileSize + 2; ++x)
+        {
+            Vector2 offset(x + 0.5 - samplePos.x, y + 0.5 - samplePos.y);
+            bool isInSupport = std::abs(offset.x) < 1.5 && std::abs(offset.y) < 1.5;
+            double expectedWeight = isInSupport ? film.GetFilterTable().GetWeight(offset) : 0.0;
+
+            Pixel p = film.GetTile({ x, y }).GetFilmSpacePixel({ x, y });
+            EXPECT_FLOAT_EQ(p.m_TotalSplat, expectedWeight);
+        }
+    }
+
+    // Merging again must not count the apron twice
+    film.MergeTileAprons();
+    Pixel p = film.GetTile({ tileSize, tileSize }).GetFilmSpacePixel({ tileSize, tileSize });
+    EXPECT_FLOAT_EQ(p.m_TotalSplat, film.GetFilterTable().GetWeight({ 0.3, 0.6 }));
+}
+
+TEST(FilmTest, CanSetResolutionAboveUhd)
+{
+    Resolution resolution;
+    resolution.SetWidth(16384);
+    resolution.SetHeight(16384);
+
+    Film film;
+    film.EnableStreaming("FilmTest.spcfilm");
+    ASSERT_NO_THROW(film.SetResolution(resolution));
+    EXPECT_EQ(film.GetNumPixels(), 16384LL * 16384LL);
+    EXPECT_EQ(film.GetMemoryUsage(), 0);
+    EXPECT_NO_THROW(film.GetTile({ 16383, 16383 }));
+    std::remove("FilmTest.spcfilm");
+}
+
+TEST(FilmTest, StreamingThrowsOnNonResidentTiles)
+{
+    Film film;
+    film.EnableStreaming("FilmTest.spcfilm");
+    EXPECT_TRUE(film.IsStreaming());
+    EXPECT_THROW(film.AddSample({ 0.5, 0.5 }, { 1.0, 1.0, 1.0 }), std::runtime_error);
+    EXPECT_THROW(film.EndTile(0), std::runtime_error);
+    EXPECT_THROW(film.EnableSplatBuffer(), std::runtime_error);
+    EXPECT_THROW(film.EnableAovs(Aov::Depth), std::runtime_error);
+    EXPECT_THROW(film.EnableVarianceTracking(), std::runtime_error);
+    EXPECT_THROW(film.MergeTileAprons(), std::runtime_error);
+
+    film.BeginTile(0);
+    EXPECT_NO_THROW(film.AddSample({ 0.5, 0.5 }, { 1.0, 1.0, 1.0 }));
+    EXPECT_THROW(film.BeginTile(0), std::runtime_error);
+    std::remove("FilmTest.spcfilm");
+}
+
+TEST(FilmTest, StreamedFilmMatchesInMemoryFilm)
+{
+    Resolution resolution;
+    resolution.SetWidth(200);
+    resolution.SetHeight(150);
+
+    Film film;
+    film.SetResolution(resolution);
+    film.SetFilter(GaussianFilter(1.5));
+
+    Film streamedFilm;
+    streamedFilm.SetResolution(resolution);
+    streamedFilm.SetFilter(GaussianFilter(1.5));
+    streamedFilm.EnableStreaming("FilmTest.spcfilm");
+
+    const size_t tileMemoryUsage = film.GetTile(0).GetMemoryUsage();
+    size_t peakMemoryUsage = 0;
+
+    // Render tiles in scanline order, spreading samples over each tile and its edges
+    for (int i = 0; i < film.GetNumTiles(); ++i)
+    {
+        FilmTile& tile = streamedFilm.BeginTile(i);
+        Point2i position = tile.GetPosition();
+        Vector2i size = tile.GetSize();
+
+        for (int y = 0; y < size.y; ++y)
+        {
+            for (int x = 0; x < size.x; ++x)
+            {
+                Point2 samplePos(position.x + x + 0.25 + 0.5 * (x % 2), position.y + y + 0.75);
+                XyzCoefficients xyz(x * 0.01, y * 0.02, 0.5);
+                film.AddSample(samplePos, xyz);
+                streamedFilm.AddSample(samplePos, xyz);
+            }
+        }
+
+        peakMemoryUsage = std::max(peakMemoryUsage, streamedFilm.GetMemoryUsage());
+        streamedFilm.EndTile(i);
+    }
+
+    film.MergeTileAprons();
+
+    // Every tile has been written and dropped, and no more than two rows were ever resident
+    EXPECT_EQ(streamedFilm.GetMemoryUsage(), 0);
+    EXPECT_LE(peakMemoryUsage, (size_t)(2 * streamedFilm.GetResolution().GetWidth() / film.GetTileSize() + 2) * tileMemoryUsage);
+    EXPECT_LT(peakMemoryUsage, film.GetMemoryUsage());
+
+    for (int y = 0; y < resolution.GetHeight(); ++y)
+    {
+        for (int x = 0; x < resolution.GetWidth(); ++x)
+        {
+            Pixel p = film.GetTile({ x, y }).GetFilmSpacePixel({ x, y });
+            XyzCoefficients expected = p.m_Xyz / p.m_TotalSplat;
+            XyzCoefficients streamed = streamedFilm.GetStream().ReadPixel({ x, y });
+            EXPECT_FLOAT_EQ(streamed[0], expected[0]);
+            EXPECT_FLOAT_EQ(streamed[1], expected[1]);
+            EXPECT_FLOAT_EQ(streamed[2], expected[2]);
+        }
+    }
+
+    std::remove("FilmTest.spcfilm");
+}
+
+
+TEST(FilmTest, CanSetTileSize)
+{
+    Film film;
+    film.SetResolution(Resolution640X360());
+    ASSERT_NO_THROW(film.SetTileSize(32));
+    EXPECT_EQ(film.GetTileSize(), 32);
+    EXPECT_EQ(film.GetNumTiles(), 20 * 12);
+    EXPECT_EQ(film.GetTile({ 639, 359 }).GetSize(), Vector2i(32, 8));
+
+    EXPECT_THROW(film.SetTileSize(0), std::invalid_argument);
+    EXPECT_THROW(film.SetTileSize(-1), std::invalid_argument);
+}
+
+TEST(FilmTest, CanSetTileOrder)
+{
+    Film film;
+    EXPECT_EQ(film.GetTileOrder(), TileOrder::Scanline);
+    EXPECT_EQ(film.GetTileSchedule(), TileOrdering::GenerateScanline(13, 8));
+
+    film.SetTileOrder(TileOrder::Hilbert);
+    EXPECT_EQ(film.GetTileOrder(), TileOrder::Hilbert);
+    EXPECT_EQ(film.GetTileSchedule(), TileOrdering::GenerateHilbert(13, 8));
+
+    // The order is kept when the tile layout changes
+    film.SetTileSize(32);
+    EXPECT_EQ(film.GetTileSchedule(), TileOrdering::GenerateHilbert(25, 15));
+}
+
+TEST(FilmTest, CanComputeTileSize)
+{
+    // 64x64 tiles of single precision pixels take 64KiB
+    const size_t bytesPerPixel = PixelBuffer::NumChannels * sizeof(FilmChannel);
+    const size_t l2CacheSize = 2 * 64 * 64 * bytesPerPixel;
+    EXPECT_EQ(Film::ComputeTileSize(Resolution1920X1080(), 0, 1, l2CacheSize), 64);
+
+    // Filter aprons count towards the tile footprint
+    EXPECT_EQ(Film::ComputeTileSize(Resolution1920X1080(), 2, 1, l2CacheSize), 32);
+
+    // Small films are split up further so that every thread has enough tiles
+    EXPECT_EQ(Film::ComputeTileSize(Resolution640X360(), 0, 64, l2CacheSize), 16);
+
+    // Tile size never drops below the minimum
+    EXPECT_EQ(Film::ComputeTileSize(Resolution640X360(), 0, 1, 0), 8);
+
+    Film film;
+    ASSERT_NO_THROW(film.AutoTuneTileSize(4));
+    EXPECT_GE(film.GetTileSize(), 8);
+    EXPECT_LE(film.GetTileSize(), 256);
+}
+
+
+TEST(FilmTest, CanSetPixelLayout)
+{
+    Film film;
+    EXPECT_EQ(film.GetPixelLayout(), PixelLayout::RowMajor);
+
+    film.SetPixelLayout(PixelLayout::Morton);
+    EXPECT_EQ(film.GetPixelLayout(), PixelLayout::Morton);
+    EXPECT_EQ(film.GetTile(0).GetLayout(), PixelLayout::Morton);
+
+    film.SetFilter(GaussianFilter(1.5));
+    film.AddSample({ 64.2, 63.9 }, { 1.0, 1.0, 1.0 });
+    film.MergeTileAprons();
+    EXPECT_FLOAT_EQ(film.GetTile({ 64, 64 }).GetFilmSpacePixel({ 64, 64 }).m_TotalSplat, film.GetFilterTable().GetWeight({ 0.3, 0.6 }));
+}
+
+
+TEST(FilmTest, SnapshotsHoldPublishedTiles)
+{
+    Film film;
+    film.SetResolution(Resolution640X360());
+    film.GetTile({ 10, 10 }).SplatPixel({ 10, 10 }, { 1.0, 2.0, 3.0 }, 0.5);
+    film.GetTile({ 100, 10 }).SplatPixel({ 36, 10 }, { 1.0, 2.0, 3.0 }, 0.5);
+    film.EnableSnapshots();
+
+    // Only the published tile shows up
+    const int tileIndex = 0;
+    film.PublishTile(tileIndex);
+    std::unique_ptr<const Film> snapshot = film.CreateSnapshot();
+    ASSERT_EQ(snapshot->GetNumTiles(), film.GetNumTiles());
+    EXPECT_EQ(snapshot->GetResolution(), film.GetResolution());
+    EXPECT_FLOAT_EQ(snapshot->GetTile(tileIndex).GetFilmSpacePixel({ 10, 10 }).m_TotalSplat, 0.5);
+    EXPECT_FLOAT_EQ(snapshot->GetTile({ 100, 10 }).GetFilmSpacePixel({ 100, 10 }).m_TotalSplat, 0.0);
+
+    // Later changes do not touch existing snapshots
+    film.GetTile({ 10, 10 }).SplatPixel({ 10, 10 }, { 1.0, 2.0, 3.0 }, 0.5);
+    film.PublishTile(tileIndex);
+    EXPECT_FLOAT_EQ(snapshot->GetTile(tileIndex).GetFilmSpacePixel({ 10, 10 }).m_TotalSplat, 0.5);
+    EXPECT_FLOAT_EQ(film.CreateSnapshot()->GetTile(tileIndex).GetFilmSpacePixel({ 10, 10 }).m_TotalSplat, 1.0);
+}
+
+TEST(FilmTest, PublishesOnlyWithSnapshotsEnabled)
+{
+    Film film;
+    film.SetResolution(Resolution640X360());
+    film.GetTile(0).SplatPixel({ 10, 10 }, { 1.0, 2.0, 3.0 }, 0.5);
+    EXPECT_FALSE(film.HasSnapshots());
+
+    film.PublishTile(0);
+    EXPECT_THROW(film.CreateSnapshot(), std::runtime_error);
+
+    film.EnableSnapshots();
+    EXPECT_FLOAT_EQ(film.CreateSnapshot()->GetTile(0).GetFilmSpacePixel({ 10, 10 }).m_TotalSplat, 0.0);
+    film.PublishTile(0);
+    std::unique_ptr<const Film> snapshot = film.CreateSnapshot();
+    EXPECT_FLOAT_EQ(snapshot->GetTile(0).GetFilmSpacePixel({ 10, 10 }).m_TotalSplat, 0.5);
+
+    // Disabling drops the published versions, snapshots that hold one keep it
+    film.DisableSnapshots();
+    film.PublishTile(0);
+    EXPECT_THROW(film.CreateSnapshot(), std::runtime_error);
+    EXPECT_FLOAT_EQ(snapshot->GetTile(0).GetFilmSpacePixel({ 10, 10 }).m_TotalSplat, 0.5);
+}
+
+TEST(FilmTest, CountsPublishedTilesInMemoryUsage)
+{
+    Film film;
+    film.SetResolution(Resolution640X360());
+    const size_t memoryUsage = film.GetMemoryUsage();
+    const size_t tileMemoryUsage = film.GetTile(0).GetMemoryUsage();
+
+    // Films without snapshots hold no published copies
+    for (int i = 0; i < film.GetNumTiles(); ++i)
+        film.PublishTile(i);
+
+    EXPECT_EQ(film.GetMemoryUsage(), memoryUsage);
+
+    film.EnableSnapshots();
+    film.PublishTile(0);
+    film.PublishTile(0);
+    EXPECT_EQ(film.GetMemoryUsage(), memoryUsage + tileMemoryUsage);
+
+    film.DisableSnapshots();
+    EXPECT_EQ(film.GetMemoryUsage(), memoryUsage);
+}
+
+TEST(FilmTest, SnapshotsSharePublishedTiles)
+{
+    Film film;
+    film.SetResolution(Resolution640X360());
+    film.EnableSnapshots();
+    film.PublishTile(0);
+
+    // Published tiles are shared rather than copied into every snapshot
+    std::unique_ptr<const Film> first = film.CreateSnapshot();
+    std::unique_ptr<const Film> second = film.CreateSnapshot();
+    EXPECT_EQ(&first->GetTile(0), &second->GetTile(0));
+    EXPECT_NE(&first->GetTile(1), &second->GetTile(1));
+
+    // Republishing leaves older snapshots on the previous version
+    film.PublishTile(0);
+    EXPECT_NE(&film.CreateSnapshot()->GetTile(0), &first->GetTile(0));
+    EXPECT_EQ(&first->GetTile(0), &second->GetTile(0));
+}
+
+TEST(FilmTest, CanEnableAovs)
+{
+    Film film;
+    film.SetResolution(Resolution640X360());
+    const size_t baseMemoryUsage = film.GetMemoryUsage();
+    EXPECT_EQ(film.GetAovMask(), Aov::None);
+    EXPECT_FALSE(film.GetTile(0).HasAovs());
+
+    film.EnableAovs(Aov::Depth | Aov::SampleCount);
+    EXPECT_TRUE(film.HasAov(AovType::Depth));
+    EXPECT_FALSE(film.HasAov(AovType::Albedo));
+    EXPECT_GT(film.GetMemoryUsage(), baseMemoryUsage);
+
+    // AOV samples land in the pixel under them without filtering
+    film.AddSample({ 10.5, 20.5 }, { 1.0, 1.0, 1.0 }, { 5.0, Normal3(0.0, 0.0, 1.0), RgbCoefficients(1.0) });
+    film.AddSample({ 10.2, 20.9 }, { 1.0, 1.0, 1.0 }, { 3.0, Normal3(0.0, 0.0, 1.0), RgbCoefficients(1.0) });
+
+    std::vector<float> depth(film.GetTileSize()), sampleCount(film.GetTileSize());
+    film.GetTile({ 10, 20 }).ResolveAovScanline(20, AovType::Depth, depth.data());
+    film.GetTile({ 10, 20 }).ResolveAovScanline(20, AovType::SampleCount, sampleCount.data());
+    EXPECT_FLOAT_EQ(depth[10], 4.0f);
+    EXPECT_FLOAT_EQ(sampleCount[10], 2.0f);
+    EXPECT_FLOAT_EQ(sampleCount[11], 0.0f);
+    EXPECT_THROW(film.GetTile(0).ResolveAovScanline(0, AovType::Albedo, depth.data()), std::invalid_argument);
+
+    // Snapshots keep the AOVs
+    film.EnableSnapshots();
+    film.PublishTile(0);
+    EXPECT_TRUE(film.CreateSnapshot()->GetTile(1).HasAovs());
+    film.DisableSnapshots();
+
+    film.EnableAovs(Aov::None);
+    EXPECT_EQ(film.GetMemoryUsage(), baseMemoryUsage);
+    EXPECT_THROW(film.GetTile(0).ResolveAovScanline(0, AovType::Depth, depth.data()), std::invalid_argument);
+}
+
+TEST(FilmTest, CanEnableVarianceTracking)
+{
+    Film film;
+    film.SetResolution(Resolution640X360());
+    EXPECT_FALSE(film.IsTrackingVariance());
+
+    film.EnableVarianceTracking();
+    EXPECT_TRUE(film.IsTrackingVariance());
+    EXPECT_TRUE(film.GetTile(0).HasVarianceBuffer());
+
+    // Tiles that are set up again keep tracking variance, as do snapshots
+    film.SetTileSize(32);
+    film.EnableSnapshots();
+    EXPECT_TRUE(film.GetTile(0).HasVarianceBuffer());
+    EXPECT_TRUE(film.CreateSnapshot()->GetTile(0).HasVarianceBuffer());
+
+    EXPECT_THROW(film.EnableStreaming("FilmTest.spcfilm"), std::runtime_error);
+}
+
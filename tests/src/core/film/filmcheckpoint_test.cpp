@@ -0,0 +1,206 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <filesystem>
+#include "gtest.h"
+#include "core/film/filmcheckpoint.h"
+
+namespace
+{
+    const char* CheckpointPath = "FilmCheckpointTest.spcckpt";
+
+    void SetupFilm(Film& film)
+    {
+        Resolution resolution;
+        resolution.SetWidth(32);
+        resolution.SetHeight(16);
+        film.SetResolution(resolution);
+        film.SetTileSize(8);
+        film.EnableAovs(Aov::Depth);
+        film.EnableVarianceTracking();
+    }
+
+    void ExpectTilesEqual(const FilmTile& a, const FilmTile& b)
+    {
+        for (int y = 0; y < a.GetSize().y; ++y)
+        {
+            for (int x = 0; x < a.GetSize().x; ++x)
+            {
+                EXPECT_EQ(a.GetTileSpacePixel({ x, y }).m_Xyz[1], b.GetTileSpacePixel({ x, y }).m_Xyz[1]);
+                EXPECT_EQ(a.GetTileSpacePixel({ x, y }).m_TotalSplat, b.GetTileSpacePixel({ x, y }).m_TotalSplat);
+                EXPECT_EQ(a.GetPixelVariance({ x, y }), b.GetPixelVariance({ x, y }));
+            }
+        }
+
+        float depthA[8], depthB[8];
+        a.ResolveAovScanline(0, AovType::Depth, depthA);
+        b.ResolveAovScanline(0, AovType::Depth, depthB);
+        EXPECT_TRUE(std::equal(depthA, depthA + 8, depthB));
+    }
+}
+
+TEST(FilmCheckpointTest, RestoresLatestRecordOfEachTile)
+{
+    std::remove(CheckpointPath);
+
+    Film film;
+    SetupFilm(film);
+
+    FilmCheckpoint checkpoint(CheckpointPath);
+    EXPECT_EQ(checkpoint.Open(film, 16), std::vector<int>(8, 0));
+    EXPECT_TRUE(checkpoint.IsOpen());
+
+    film.AddSample({ 9.5, 1.5 }, { 0.1, 0.2, 0.3 }, { 2.0, Normal3(0, 0, 1), RgbCoefficients(1.0) });
+    checkpoint.WriteTile(1, 4, film.GetTile(1));
+    film.AddSample({ 9.5, 1.5 }, { 0.4, 0.5, 0.6 }, { 3.0, Normal3(0, 0, 1), RgbCoefficients(1.0) });
+    film.AddSample({ 30.2, 12.7 }, { 1.0, 1.0, 1.0 });
+    checkpoint.WriteTile(7, 2, film.GetTile(7));
+    checkpoint.WriteTile(1, 8, film.GetTile(1));
+    checkpoint.Close();
+    EXPECT_EQ(checkpoint.GetNumRecordsWritten(), 3);
+
+    Film resumed;
+    SetupFilm(resumed);
+
+    FilmCheckpoint resumedCheckpoint(CheckpointPath);
+    const std::vector<int> samples = resumedCheckpoint.Open(resumed, 16);
+    EXPECT_EQ(samples, std::vector<int>({ 0, 8, 0, 0, 0, 0, 0, 2 }));
+    resumedCheckpoint.Close();
+
+    for (int i = 0; i < film.GetNumTiles(); ++i)
+        ExpectTilesEqual(film.GetTile(i), resumed.GetTile(i));
+
+    // Opening again rewrote the file with only the latest records
+    Film compacted;
+    SetupFilm(compacted);
+    FilmCheckpoint compactedCheckpoint(CheckpointPath);
+    EXPECT_EQ(compactedCheckpoint.Open(compacted, 16), samples);
+    compactedCheckpoint.Close();
+
+    std::remove(CheckpointPath);
+}
+
+TEST(FilmCheckpointTest, IgnoresIncompleteRecords)
+{
+    std::remove(CheckpointPath);
+
+    Film film;
+    SetupFilm(film);
+    film.AddSample({ 1.5, 1.5 }, { 1.0, 1.0, 1.0 });
+
+    FilmCheckpoint checkpoint(CheckpointPath);
+    checkpoint.Open(film, 4);
+    checkpoint.WriteTile(0, 4, film.GetTile(0));
+    checkpoint.WriteTile(2, 4, film.GetTile(2));
+    checkpoint.Close();
+
+    // A process killed while appending leaves part of a record behind
+    std::filesystem::resize_file(CheckpointPath, std::filesystem::file_size(CheckpointPath) - 10);
+
+    Film resumed;
+    SetupFilm(resumed);
+    FilmCheckpoint resumedCheckpoint(CheckpointPath);
+    EXPECT_EQ(resumedCheckpoint.Open(resumed, 4), std::vector<int>({ 4, 0, 0, 0, 0, 0, 0, 0 }));
+    EXPECT_EQ(resumed.GetTile(0).GetTileSpacePixel({ 1, 1 }).m_Xyz[1], film.GetTile(0).GetTileSpacePixel({ 1, 1 }).m_Xyz[1]);
+
+    // Records appended after resuming are not lost behind the damaged one
+    resumedCheckpoint.WriteTile(5, 4, resumed.GetTile(5));
+    resumedCheckpoint.Close();
+
+    Film again;
+    SetupFilm(again);
+    FilmCheckpoint againCheckpoint(CheckpointPath);
+    EXPECT_EQ(againCheckpoint.Open(again, 4), std::vector<int>({ 4, 0, 0, 0, 0, 4, 0, 0 }));
+    againCheckpoint.Close();
+
+    std::remove(CheckpointPath);
+}
+
+TEST(FilmCheckpointTest, CompactsWhileWriting)
+{
+    std::remove(CheckpointPath);
+
+    Film film;
+    SetupFilm(film);
+    film.AddSample({ 1.5, 1.5 }, { 1.0, 1.0, 1.0 });
+
+    FilmCheckpoint checkpoint(CheckpointPath);
+    checkpoint.Open(film, 64);
+    const uintmax_t emptySize = std::filesystem::file_size(CheckpointPath);
+
+    for (int i = 0; i < FilmCheckpoint::MaxRecordsPerTile * film.GetNumTiles(); ++i)
+        checkpoint.WriteTile(i % film.GetNumTiles(), 1 + i / film.GetNumTiles(), film.GetTile(i % film.GetNumTiles()));
+
+    checkpoint.Close();
+    const uintmax_t fullSize = std::filesystem::file_size(CheckpointPath) - emptySize;
+
+    // Every pass appends another record per tile, yet the file never holds more than a few of them
+    checkpoint.Open(film, 64);
+
+    for (int i = 0; i < 10 * film.GetNumTiles(); ++i)
+        checkpoint.WriteTile(i % film.GetNumTiles(), 1 + i / film.GetNumTiles(), film.GetTile(i % film.GetNumTiles()));
+
+    checkpoint.Close();
+    EXPECT_EQ(checkpoint.GetNumRecordsWritten(), 12 * film.GetNumTiles());
+    EXPECT_LE(std::filesystem::file_size(CheckpointPath) - emptySize, fullSize);
+    EXPECT_FALSE(std::filesystem::exists(std::string(CheckpointPath) + ".tmp"));
+
+    Film resumed;
+    SetupFilm(resumed);
+    FilmCheckpoint resumedCheckpoint(CheckpointPath);
+    EXPECT_EQ(resumedCheckpoint.Open(resumed, 64), std::vector<int>(8, 10));
+    resumedCheckpoint.Close();
+    ExpectTilesEqual(film.GetTile(0), resumed.GetTile(0));
+
+    std::remove(CheckpointPath);
+}
+
+TEST(FilmCheckpointTest, RejectsOtherSettings)
+{
+    std::remove(CheckpointPath);
+
+    Film film;
+    SetupFilm(film);
+    FilmCheckpoint checkpoint(CheckpointPath);
+    checkpoint.Open(film, 4);
+    EXPECT_THROW(checkpoint.Open(film, 4), std::runtime_error);
+    checkpoint.Close();
+
+    FilmCheckpoint otherSamples(CheckpointPath);
+    EXPECT_THROW(otherSamples.Open(film, 8), std::runtime_error);
+
+    Film otherTiles;
+    SetupFilm(otherTiles);
+    otherTiles.SetTileSize(16);
+    FilmCheckpoint otherTileSize(CheckpointPath);
+    EXPECT_THROW(otherTileSize.Open(otherTiles, 4), std::runtime_error);
+
+    FilmCheckpoint notOpen(CheckpointPath);
+    EXPECT_THROW(notOpen.WriteTile(0, 4, film.GetTile(0)), std::runtime_error);
+
+    Film streaming;
+    streaming.EnableStreaming("FilmCheckpointTest.spcfilm");
+    FilmCheckpoint streamingCheckpoint(CheckpointPath);
+    EXPECT_THROW(streamingCheckpoint.Open(streaming, 4), std::runtime_error);
+
+    std::remove("FilmCheckpointTest.spcfilm");
+    std::remove(CheckpointPath);
+}
+
@@ -0,0 +1,109 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest.h"
+#include "core/film/filmstream.h"
+#include "core/film/standardresolution.h"
+
+const std::string TestStreamPath = "FilmStreamTest.spcfilm";
+
+TEST(FilmStreamTest, CanBeCreated)
+{
+    ASSERT_NO_THROW(FilmStream stream(TestStreamPath, Resolution640X360()));
+    std::remove(TestStreamPath.c_str());
+}
+
+TEST(FilmStreamTest, ThrowOnInvalidPath)
+{
+    ASSERT_THROW(FilmStream stream("missing_directory/stream.spcfilm", Resolution640X360()), std::runtime_error);
+}
+
+TEST(FilmStreamTest, IsSizedForEntireFilm)
+{
+    {
+        FilmStream stream(TestStreamPath, Resolution640X360());
+    }
+
+    std::ifstream file(TestStreamPath, std::ios::binary | std::ios::ate);
+    EXPECT_EQ((size_t)file.tellg(), 16 + 640 * 360 * 3 * sizeof(float));
+    file.close();
+    std::remove(TestStreamPath.c_str());
+}
+
+TEST(FilmStreamTest, CanWriteTilesInAnyOrder)
+{
+    Resolution resolution;
+    resolution.SetWidth(20);
+    resolution.SetHeight(10);
+
+    FilmStream stream(TestStreamPath, resolution);
+    FilmTile right({ 10, 0 }, { 10, 10 });
+    FilmTile left({ 0, 0 }, { 10, 10 });
+    right.SetPixel({ 0, 9 }, { 1.0, 2.0, 3.0 });
+    left.SplatPixel({ 9, 9 }, { 4.0, 5.0, 6.0 }, 0.5);
+
+    stream.WriteTile(right);
+    stream.WriteTile(left);
+
+    XyzCoefficients xyz = stream.ReadPixel({ 10, 9 });
+    EXPECT_FLOAT_EQ(xyz[0], 1.0);
+    EXPECT_FLOAT_EQ(xyz[1], 2.0);
+    EXPECT_FLOAT_EQ(xyz[2], 3.0);
+
+    // Pixels are resolved by their total splat area
+    xyz = stream.ReadPixel({ 9, 9 });
+    EXPECT_FLOAT_EQ(xyz[0], 4.0);
+    EXPECT_FLOAT_EQ(xyz[1], 5.0);
+    EXPECT_FLOAT_EQ(xyz[2], 6.0);
+
+    // Empty pixels are written as black
+    xyz = stream.ReadPixel({ 0, 0 });
+    EXPECT_FLOAT_EQ(xyz[0], 0.0);
+
+    EXPECT_THROW(stream.ReadPixel({ 20, 0 }), std::invalid_argument);
+    std::remove(TestStreamPath.c_str());
+}
+
+
+TEST(FilmStreamTest, CanReadScanlines)
+{
+    Resolution resolution;
+    resolution.SetWidth(20);
+    resolution.SetHeight(10);
+
+    FilmStream stream(TestStreamPath, resolution);
+    FilmTile right({ 10, 0 }, { 10, 10 });
+    right.SetPixel({ 0, 4 }, { 1.0, 2.0, 3.0 });
+    right.SetPixel({ 9, 4 }, { 4.0, 5.0, 6.0 });
+    stream.WriteTile(right);
+
+    // Scanlines may cross tiles, pixels that were never written read as zero
+    std::vector<float> xyz(3 * 15);
+    stream.ReadScanline({ 5, 4 }, 15, xyz.data());
+    EXPECT_FLOAT_EQ(xyz[0], 0.0f);
+    EXPECT_FLOAT_EQ(xyz[3 * 5 + 0], 1.0f);
+    EXPECT_FLOAT_EQ(xyz[3 * 5 + 2], 3.0f);
+    EXPECT_FLOAT_EQ(xyz[3 * 14 + 1], 5.0f);
+
+    EXPECT_THROW(stream.ReadScanline({ 5, 4 }, 16, xyz.data()), std::invalid_argument);
+    EXPECT_THROW(stream.ReadScanline({ 5, 10 }, 1, xyz.data()), std::invalid_argument);
+    std::remove(TestStreamPath.c_str());
+}
+
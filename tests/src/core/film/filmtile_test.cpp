@@ -18,6 +18,9 @@
 
 #include "gtest.h"
 #include "core/film/filmtile.h"
+#include "core/film/filter/boxfilter.h"
+#include "core/film/filter/gaussianfilter.h"
+#include "system/threading/threadpool.h"
 
 TEST(FilmTileTest, CanBeCreated)
 {
@@ -107,9 +110,9 @@ TEST(FilmTileTest, CanSetPixelValue)
     FilmTile filmTile({ 0, 0 }, { 100, 100 });
     ASSERT_NO_THROW(filmTile.SetPixel({ 50, 50 }, { 0.2, 0.3, 0.4 }));
     Pixel p = filmTile.GetFilmSpacePixel({ 50, 50 });
-    EXPECT_DOUBLE_EQ(p.m_Xyz[0], 0.2);
-    EXPECT_DOUBLE_EQ(p.m_Xyz[1], 0.3);
-    EXPECT_DOUBLE_EQ(p.m_Xyz[2], 0.4);
+    EXPECT_FLOAT_EQ(p.m_Xyz[0], 0.2);
+    EXPECT_FLOAT_EQ(p.m_Xyz[1], 0.3);
+    EXPECT_FLOAT_EQ(p.m_Xyz[2], 0.4);
 }
 
 TEST(FilmTileTest, CanSplatPixelValue)
@@ -119,15 +122,15 @@ TEST(FilmTileTest, CanSplatPixelValue)
     ASSERT_THROW(filmTile.SplatPixel({ 50, 50 }, { 0.2, 0.3, 0.4 }, -0.0001), std::invalid_argument);
     ASSERT_NO_THROW(filmTile.SplatPixel({ 50, 50 }, { 0.2, 0.3, 0.4 }, 0.5));
     Pixel p = filmTile.GetFilmSpacePixel({ 50, 50 });
-    EXPECT_DOUBLE_EQ(p.m_Xyz[0], 0.1);
-    EXPECT_DOUBLE_EQ(p.m_Xyz[1], 0.15);
-    EXPECT_DOUBLE_EQ(p.m_Xyz[2], 0.2);
+    EXPECT_FLOAT_EQ(p.m_Xyz[0], 0.1);
+    EXPECT_FLOAT_EQ(p.m_Xyz[1], 0.15);
+    EXPECT_FLOAT_EQ(p.m_Xyz[2], 0.2);
 
     ASSERT_NO_THROW(filmTile.SplatPixel({ 50, 50 }, { 0.2, 0.3, 0.4 }, 0.5));
     p = filmTile.GetFilmSpacePixel({ 50, 50 });
-    EXPECT_DOUBLE_EQ(p.m_Xyz[0], 0.2);
-    EXPECT_DOUBLE_EQ(p.m_Xyz[1], 0.3);
-    EXPECT_DOUBLE_EQ(p.m_Xyz[2], 0.4);
+    EXPECT_FLOAT_EQ(p.m_Xyz[0], 0.2);
+    EXPECT_FLOAT_EQ(p.m_Xyz[1], 0.3);
+    EXPECT_FLOAT_EQ(p.m_Xyz[2], 0.4);
     ASSERT_THROW(filmTile.SplatPixel({ 50, 50 }, { 0.2, 0.3, 0.4 }, 0.0001), std::invalid_argument);
 }
 
@@ -144,3 +147,352 @@ TEST(FilmTileTest, SplatEpsilonValueSufficient)
     }
 }
 
+TEST(FilmTileTest, CanAtomicSplatPixelValue)
+{
+    FilmTile filmTile({ 0, 0 }, { 100, 100 });
+    ASSERT_THROW(filmTile.AtomicSplatPixel({ 50, 50 }, { 0.2, 0.3, 0.4 }, 0.5), std::runtime_error);
+
+    filmTile.AllocateSplatBuffer();
+    ASSERT_THROW(filmTile.AtomicSplatPixel({ 50, 50 }, { 0.2, 0.3, 0.4 }, 1.0001), std::invalid_argument);
+    ASSERT_THROW(filmTile.AtomicSplatPixel({ 50, 50 }, { 0.2, 0.3, 0.4 }, -0.0001), std::invalid_argument);
+    ASSERT_THROW(filmTile.AtomicSplatPixel({ 100, 50 }, { 0.2, 0.3, 0.4 }, 0.5), std::invalid_argument);
+    ASSERT_NO_THROW(filmTile.AtomicSplatPixel({ 50, 50 }, { 0.2, 0.3, 0.4 }, 0.5));
+    ASSERT_NO_THROW(filmTile.AtomicSplatPixel({ 50, 50 }, { 0.2, 0.3, 0.4 }, 0.5));
+
+    Pixel p = filmTile.GetFilmSpacePixel({ 50, 50 });
+    EXPECT_FLOAT_EQ(p.m_Xyz[0], 0.2);
+    EXPECT_FLOAT_EQ(p.m_Xyz[1], 0.3);
+    EXPECT_FLOAT_EQ(p.m_Xyz[2], 0.4);
+    EXPECT_FLOAT_EQ(p.m_TotalSplat, 1.0);
+    ASSERT_THROW(filmTile.AtomicSplatPixel({ 50, 50 }, { 0.2, 0.3, 0.4 }, 0.0001), std::invalid_argument);
+}
+
+TEST(FilmTileTest, AtomicSplatIsCorrectUnderContention)
+{
+    const int NumThreads = 64;
+    const int NumRounds = 16;
+    const Vector2i tileSize = { 16, 16 };
+
+    // Power of two delta area so that the expected totals are exact
+    const double deltaArea = 1.0 / (NumThreads * NumRounds);
+
+    FilmTile filmTile({ 0, 0 }, tileSize);
+    filmTile.AllocateSplatBuffer();
+
+    {
+        ThreadPool pool(NumThreads);
+        for (int i = 0; i < NumThreads; ++i)
+        {
+            pool.ScheduleTask(0, [&]()
+            {
+                for (int r = 0; r < NumRounds; ++r)
+                    for (int y = 0; y < tileSize.y; ++y)
+                        for (int x = 0; x < tileSize.x; ++x)
+                            filmTile.AtomicSplatPixel({ x, y }, { 1.0, 2.0, 3.0 }, deltaArea);
+            });
+        }
+    }
+
+    for (int y = 0; y < tileSize.y; ++y)
+    {
+        for (int x = 0; x < tileSize.x; ++x)
+        {
+            Pixel p = filmTile.GetTileSpacePixel({ x, y });
+            EXPECT_DOUBLE_EQ(p.m_Xyz[0], 1.0);
+            EXPECT_DOUBLE_EQ(p.m_Xyz[1], 2.0);
+            EXPECT_DOUBLE_EQ(p.m_Xyz[2], 3.0);
+            EXPECT_DOUBLE_EQ(p.m_TotalSplat, 1.0);
+        }
+    }
+}
+
+TEST(FilmTileTest, AtomicSplatRejectsExcessAreaUnderContention)
+{
+    const int NumThreads = 64;
+    std::atomic_int numAccepted = 0;
+    std::atomic_int numRejected = 0;
+
+    FilmTile filmTile({ 0, 0 }, { 4, 4 });
+    filmTile.AllocateSplatBuffer();
+
+    {
+        ThreadPool pool(NumThreads);
+        for (int i = 0; i < NumThreads; ++i)
+        {
+            pool.ScheduleTask(0, [&]()
+            {
+                try
+                {
+                    filmTile.AtomicSplatPixel({ 2, 2 }, { 1.0, 1.0, 1.0 }, 0.25);
+                    numAccepted++;
+                }
+                catch (const std::invalid_argument&)
+                {
+                    numRejected++;
+                }
+            });
+        }
+    }
+
+    EXPECT_EQ(numAccepted, 4);
+    EXPECT_EQ(numRejected, NumThreads - 4);
+    EXPECT_DOUBLE_EQ(filmTile.GetTileSpacePixel({ 2, 2 }).m_TotalSplat, 1.0);
+    EXPECT_DOUBLE_EQ(filmTile.GetTileSpacePixel({ 2, 2 }).m_Xyz[0], 1.0);
+}
+
+TEST(FilmTileTest, AtomicSplatUsesSplatBuffer)
+{
+    FilmTile filmTile({ 0, 0 }, { 10, 10 });
+    EXPECT_FALSE(filmTile.HasSplatBuffer());
+
+    size_t memoryUsage = filmTile.GetMemoryUsage();
+    filmTile.AllocateSplatBuffer();
+    EXPECT_TRUE(filmTile.HasSplatBuffer());
+    EXPECT_EQ(filmTile.GetMemoryUsage(), memoryUsage * 2);
+
+    filmTile.SplatPixel({ 5, 5 }, { 0.5, 0.5, 0.5 }, 0.5);
+    filmTile.AtomicSplatPixel({ 5, 5 }, { 0.25, 0.25, 0.25 }, 0.5);
+
+    Pixel p = filmTile.GetTileSpacePixel({ 5, 5 });
+    EXPECT_FLOAT_EQ(p.m_Xyz[0], 0.375);
+    EXPECT_FLOAT_EQ(p.m_TotalSplat, 1.0);
+}
+
+TEST(FilmTileTest, TracksSplatBufferCoverageSeparately)
+{
+    FilmTile filmTile({ 0, 0 }, { 10, 10 });
+    filmTile.AllocateSplatBuffer();
+
+    filmTile.SplatPixel({ 5, 5 }, { 1.0, 1.0, 1.0 }, 1.0);
+    ASSERT_NO_THROW(filmTile.AtomicSplatPixel({ 5, 5 }, { 0.5, 0.5, 0.5 }, 1.0));
+    EXPECT_THROW(filmTile.SplatPixel({ 5, 5 }, { 1.0, 1.0, 1.0 }, 0.1), std::invalid_argument);
+    EXPECT_THROW(filmTile.AtomicSplatPixel({ 5, 5 }, { 1.0, 1.0, 1.0 }, 0.1), std::invalid_argument);
+
+    Pixel p = filmTile.GetTileSpacePixel({ 5, 5 });
+    EXPECT_FLOAT_EQ(p.m_Xyz[0], 1.5);
+    EXPECT_FLOAT_EQ(p.m_TotalSplat, 2.0);
+}
+
+TEST(FilmTileTest, StoresPixelsAsPlanes)
+{
+    FilmTile filmTile({ 0, 0 }, { 64, 64 });
+    EXPECT_EQ(filmTile.GetMemoryUsage(), 64 * 64 * PixelBuffer::NumChannels * sizeof(FilmChannel));
+}
+
+TEST(FilmTileTest, ThrowOnNegativeApron)
+{
+    ASSERT_THROW(FilmTile filmTile({ 0, 0 }, { 1, 1 }, -1), std::invalid_argument);
+    ASSERT_NO_THROW(FilmTile filmTile({ 0, 0 }, { 1, 1 }, 2));
+}
+
+TEST(FilmTileTest, ApronDoesNotChangeAddressableArea)
+{
+    FilmTile filmTile({ 10, 10 }, { 20, 20 }, 2);
+    EXPECT_EQ(filmTile.GetApron(), 2);
+    EXPECT_EQ(filmTile.GetSize(), Vector2i(20, 20));
+    EXPECT_EQ(filmTile.GetMemoryUsage(), 24 * 24 * PixelBuffer::NumChannels * sizeof(FilmChannel));
+    EXPECT_NO_THROW(filmTile.GetTileSpacePixel({ 0, 0 }));
+    EXPECT_NO_THROW(filmTile.GetTileSpacePixel({ 19, 19 }));
+    EXPECT_THROW(filmTile.GetTileSpacePixel({ -1, 0 }), std::invalid_argument);
+    EXPECT_THROW(filmTile.GetTileSpacePixel({ 20, 19 }), std::invalid_argument);
+}
+
+TEST(FilmTileTest, BoxFilteredSampleLandsInSinglePixel)
+{
+    FilterTable filter(BoxFilter{});
+    FilmTile filmTile({ 10, 10 }, { 20, 20 });
+    filmTile.AddSample({ 15.3, 17.9 }, { 0.2, 0.3, 0.4 }, filter);
+
+    Pixel p = filmTile.GetFilmSpacePixel({ 15, 17 });
+    EXPECT_FLOAT_EQ(p.m_Xyz[0], 0.2);
+    EXPECT_FLOAT_EQ(p.m_Xyz[1], 0.3);
+    EXPECT_FLOAT_EQ(p.m_Xyz[2], 0.4);
+    EXPECT_FLOAT_EQ(p.m_TotalSplat, 1.0);
+
+    EXPECT_FLOAT_EQ(filmTile.GetFilmSpacePixel({ 14, 17 }).m_TotalSplat, 0.0);
+    EXPECT_FLOAT_EQ(filmTile.GetFilmSpacePixel({ 16, 17 }).m_TotalSplat, 0.0);
+    EXPECT_FLOAT_EQ(filmTile.GetFilmSpacePixel({ 15, 16 }).m_TotalSplat, 0.0);
+    EXPECT_FLOAT_EQ(filmTile.GetFilmSpacePixel({ 15, 18 }).m_TotalSplat, 0.0);
+}
+
+TEST(FilmTileTest, FilteredSampleSpansNeighboringPixels)
+{
+    GaussianFilter gaussian(1.5);
+    FilterTable filter(gaussian);
+    FilmTile filmTile({ 0, 0 }, { 20, 20 });
+    filmTile.AddSample({ 10.5, 10.5 }, { 1.0, 1.0, 1.0 }, filter);
+
+    double center = filmTile.GetTileSpacePixel({ 10, 10 }).m_TotalSplat;
+    EXPECT_FLOAT_EQ(center, filter.GetWeight({ 0.0, 0.0 }));
+    EXPECT_FLOAT_EQ(filmTile.GetTileSpacePixel({ 11, 10 }).m_TotalSplat, filter.GetWeight({ 1.0, 0.0 }));
+    EXPECT_FLOAT_EQ(filmTile.GetTileSpacePixel({ 9, 9 }).m_TotalSplat, filter.GetWeight({ 1.0, 1.0 }));
+    EXPECT_LT(filmTile.GetTileSpacePixel({ 11, 10 }).m_TotalSplat, center);
+    EXPECT_FLOAT_EQ(filmTile.GetTileSpacePixel({ 12, 10 }).m_TotalSplat, 0.0);
+}
+
+TEST(FilmTileTest, CanMergeApronIntoNeighbor)
+{
+    FilterTable filter(GaussianFilter(1.5));
+    FilmTile left({ 0, 0 }, { 10, 10 }, filter.GetApron());
+    FilmTile right({ 10, 0 }, { 10, 10 }, filter.GetApron());
+
+    // A sample on the shared edge contributes equally to both tiles
+    left.AddSample({ 9.99, 5.5 }, { 1.0, 1.0, 1.0 }, filter);
+    EXPECT_FLOAT_EQ(right.GetFilmSpacePixel({ 10, 5 }).m_TotalSplat, 0.0);
+
+    right.MergeApron(left);
+    EXPECT_GT(right.GetFilmSpacePixel({ 10, 5 }).m_TotalSplat, 0.0);
+    EXPECT_FLOAT_EQ(right.GetFilmSpacePixel({ 10, 5 }).m_TotalSplat, left.GetFilmSpacePixel({ 9, 5 }).m_TotalSplat);
+    EXPECT_FLOAT_EQ(right.GetFilmSpacePixel({ 11, 5 }).m_TotalSplat, 0.0);
+
+    // Merging a tile into itself is a no-op
+    double weight = left.GetFilmSpacePixel({ 9, 5 }).m_TotalSplat;
+    left.MergeApron(left);
+    EXPECT_FLOAT_EQ(left.GetFilmSpacePixel({ 9, 5 }).m_TotalSplat, weight);
+
+    left.ClearApron();
+    EXPECT_FLOAT_EQ(left.GetFilmSpacePixel({ 9, 5 }).m_TotalSplat, weight);
+    right.MergeApron(left);
+    EXPECT_FLOAT_EQ(right.GetFilmSpacePixel({ 10, 5 }).m_TotalSplat, weight);
+}
+
+TEST(FilmTileTest, CanReleaseAndMakeResident)
+{
+    FilmTile filmTile({ 0, 0 }, { 8, 8 }, 1, false);
+    EXPECT_FALSE(filmTile.IsResident());
+    EXPECT_EQ(filmTile.GetMemoryUsage(), 0);
+
+    filmTile.MakeResident();
+    EXPECT_TRUE(filmTile.IsResident());
+    EXPECT_EQ(filmTile.GetMemoryUsage(), 10 * 10 * PixelBuffer::NumChannels * sizeof(FilmChannel));
+
+    filmTile.SetPixel({ 3, 3 }, { 1.0, 2.0, 3.0 });
+    filmTile.Release();
+    EXPECT_FALSE(filmTile.IsResident());
+    EXPECT_EQ(filmTile.GetMemoryUsage(), 0);
+
+    // Pixels start out empty again after becoming resident
+    filmTile.MakeResident();
+    EXPECT_FLOAT_EQ(filmTile.GetTileSpacePixel({ 3, 3 }).m_TotalSplat, 0.0);
+}
+
+TEST(FilmTileTest, CanTrackVariance)
+{
+    FilmTile filmTile({ 8, 8 }, { 4, 4 }, 1);
+    EXPECT_FALSE(filmTile.HasVarianceBuffer());
+    EXPECT_THROW(filmTile.GetError(), std::runtime_error);
+
+    filmTile.AllocateVarianceBuffer();
+    EXPECT_TRUE(filmTile.HasVarianceBuffer());
+
+    // Samples only count towards the pixel under them, even though the filter spreads them
+    const FilterTable filter(BoxFilter(1.0));
+    filmTile.AddSample({ 9.5, 9.5 }, { 0.0, 1.0, 0.0 }, filter);
+    filmTile.AddSample({ 9.2, 9.7 }, { 0.0, 3.0, 0.0 }, filter);
+    filmTile.AddSample({ 7.5, 7.5 }, { 0.0, 5.0, 0.0 }, filter);
+
+    EXPECT_DOUBLE_EQ(filmTile.GetPixelVariance({ 1, 1 }), 2.0);
+    EXPECT_DOUBLE_EQ(filmTile.GetPixelVariance({ 0, 0 }), 0.0);
+    EXPECT_DOUBLE_EQ(filmTile.GetPixelError({ 1, 1 }), 0.5);
+    EXPECT_THROW(filmTile.GetPixelError({ 4, 0 }), std::invalid_argument);
+
+    // Pixels without samples have not converged
+    EXPECT_EQ(filmTile.GetError(), std::numeric_limits<double>::infinity());
+
+    filmTile.Release();
+    EXPECT_FALSE(filmTile.HasVarianceBuffer());
+}
+
+TEST(FilmTileTest, MortonLayoutStoresSamePixels)
+{
+    FilterTable filter(GaussianFilter(1.5));
+    FilmTile rowMajor({ 20, 10 }, { 13, 11 }, filter.GetApron());
+    FilmTile morton({ 20, 10 }, { 13, 11 }, filter.GetApron(), true, PixelLayout::Morton);
+    EXPECT_EQ(morton.GetLayout(), PixelLayout::Morton);
+
+    for (int i = 0; i < 40; ++i)
+    {
+        Point2 samplePos(19.0 + (i * 7 % 15) + 0.3, 9.0 + (i * 5 % 13) + 0.6);
+        rowMajor.AddSample(samplePos, { i * 0.1, 1.0, 2.0 }, filter);
+        morton.AddSample(samplePos, { i * 0.1, 1.0, 2.0 }, filter);
+    }
+
+    morton.SplatPixel({ 12, 10 }, { 1.0, 1.0, 1.0 }, 0.25);
+    rowMajor.SplatPixel({ 12, 10 }, { 1.0, 1.0, 1.0 }, 0.25);
+
+    for (int y = 0; y < 11; ++y)
+    {
+        FilmTile::ScanlineIterator rowMajorIt = rowMajor.GetScanline(y);
+        FilmTile::ScanlineIterator mortonIt = morton.GetScanline(y);
+
+        for (int x = 0; x < 13; ++x, ++rowMajorIt, ++mortonIt)
+        {
+            ASSERT_TRUE(mortonIt.IsValid());
+            EXPECT_EQ(mortonIt.GetX(), x);
+            EXPECT_FLOAT_EQ((*mortonIt).m_TotalSplat, rowMajor.GetTileSpacePixel({ x, y }).m_TotalSplat);
+            EXPECT_FLOAT_EQ((*mortonIt).m_Xyz[0], (*rowMajorIt).m_Xyz[0]);
+            EXPECT_FLOAT_EQ(morton.GetTileSpacePixel({ x, y }).m_Xyz[0], rowMajor.GetTileSpacePixel({ x, y }).m_Xyz[0]);
+        }
+
+        EXPECT_FALSE(mortonIt.IsValid());
+        EXPECT_FALSE(rowMajorIt.IsValid());
+    }
+}
+
+TEST(FilmTileTest, MortonLayoutMergesAprons)
+{
+    FilterTable filter(GaussianFilter(1.5));
+    FilmTile left({ 0, 0 }, { 10, 10 }, filter.GetApron(), true, PixelLayout::Morton);
+    FilmTile right({ 10, 0 }, { 10, 10 }, filter.GetApron());
+
+    left.AddSample({ 9.99, 5.5 }, { 1.0, 1.0, 1.0 }, filter);
+    right.MergeApron(left);
+    EXPECT_GT(right.GetFilmSpacePixel({ 10, 5 }).m_TotalSplat, 0.0);
+    EXPECT_FLOAT_EQ(right.GetFilmSpacePixel({ 10, 5 }).m_TotalSplat, left.GetFilmSpacePixel({ 9, 5 }).m_TotalSplat);
+}
+
+TEST(FilmTileTest, MortonLayoutPadsToWholeBlocks)
+{
+    const size_t bytesPerPixel = PixelBuffer::NumChannels * sizeof(FilmChannel);
+    FilmTile filmTile({ 0, 0 }, { 64, 64 }, 0, true, PixelLayout::Morton);
+    EXPECT_EQ(filmTile.GetMemoryUsage(), 64 * 64 * bytesPerPixel);
+
+    FilmTile paddedTile({ 0, 0 }, { 13, 11 }, 2, true, PixelLayout::Morton);
+    EXPECT_EQ(paddedTile.GetMemoryUsage(), 24 * 16 * bytesPerPixel);
+}
+
+
+TEST(FilmTileTest, CanReadScanline)
+{
+    const PixelLayout layouts[] = { PixelLayout::RowMajor, PixelLayout::Morton };
+
+    for (PixelLayout layout : layouts)
+    {
+        FilmTile filmTile({ 0, 0 }, { 13, 5 }, 1, true, layout);
+        filmTile.AllocateSplatBuffer();
+
+        for (int y = 0; y < 5; ++y)
+            for (int x = 0; x < 13; ++x)
+                filmTile.SplatPixel({ x, y }, { (double)x, (double)y, 1.0 }, 0.5);
+
+        filmTile.AtomicSplatPixel({ 4, 2 }, { 1.0, 1.0, 1.0 }, 0.25);
+
+        PixelBuffer scanline;
+        filmTile.ReadScanline(2, scanline);
+        EXPECT_EQ(scanline.GetNumPixels(), 13);
+
+        for (int x = 0; x < 13; ++x)
+        {
+            Pixel p = filmTile.GetTileSpacePixel({ x, 2 });
+            EXPECT_FLOAT_EQ(scanline.GetXyz(x)[0], p.m_Xyz[0]);
+            EXPECT_FLOAT_EQ(scanline.GetXyz(x)[1], p.m_Xyz[1]);
+            EXPECT_FLOAT_EQ(scanline.GetXyz(x)[2], p.m_Xyz[2]);
+            EXPECT_FLOAT_EQ(scanline.GetWeight(x), p.m_TotalSplat);
+        }
+
+        EXPECT_FLOAT_EQ(scanline.GetWeight(4), 0.75);
+        EXPECT_THROW(filmTile.ReadScanline(5, scanline), std::invalid_argument);
+        EXPECT_THROW(filmTile.ReadScanline(-1, scanline), std::invalid_argument);
+    }
+}
+
@@ -0,0 +1,50 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest.h"
+#include "core/film/filter/blackmanharrisfilter.h"
+
+TEST(BlackmanHarrisFilterTest, CanBeCreated)
+{
+    ASSERT_NO_THROW(BlackmanHarrisFilter());
+}
+
+TEST(BlackmanHarrisFilterTest, HasDefaultRadius)
+{
+    BlackmanHarrisFilter filter;
+    EXPECT_DOUBLE_EQ(filter.GetRadius(), 1.5);
+}
+
+TEST(BlackmanHarrisFilterTest, HasExpectedValues)
+{
+    BlackmanHarrisFilter filter;
+    EXPECT_NEAR(filter.Evaluate({ 0.0, 0.0 }), 1.0, SMath::Epsilon);
+    EXPECT_NEAR(filter.Evaluate({ 1.5, 0.0 }), 0.0, 1e-4);
+    EXPECT_NEAR(filter.Evaluate({ 0.0, -1.5 }), 0.0, 1e-4);
+}
+
+TEST(BlackmanHarrisFilterTest, DecreasesAwayFromCenter)
+{
+    BlackmanHarrisFilter filter;
+    EXPECT_GT(filter.Evaluate({ 0.0, 0.0 }), filter.Evaluate({ 0.5, 0.0 }));
+    EXPECT_GT(filter.Evaluate({ 0.5, 0.0 }), filter.Evaluate({ 1.0, 0.0 }));
+    EXPECT_GT(filter.Evaluate({ 1.0, 0.0 }), filter.Evaluate({ 1.4, 0.0 }));
+}
+
@@ -0,0 +1,48 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest.h"
+#include "core/film/filter/filter.h"
+
+class FilterStub : public Filter
+{
+public:
+    FilterStub(double radius) : Filter(radius) {}
+    double Evaluate(const Vector2& offset) const override { return 1.0; }
+};
+
+TEST(FilterTest, CanBeCreated)
+{
+    ASSERT_NO_THROW(FilterStub filter(0.5));
+    ASSERT_NO_THROW(FilterStub filter(2.0));
+}
+
+TEST(FilterTest, ThrowOnInvalidRadius)
+{
+    ASSERT_THROW(FilterStub filter(0.0), std::invalid_argument);
+    ASSERT_THROW(FilterStub filter(0.49), std::invalid_argument);
+}
+
+TEST(FilterTest, CanGetRadius)
+{
+    FilterStub filter(1.5);
+    EXPECT_DOUBLE_EQ(filter.GetRadius(), 1.5);
+}
+
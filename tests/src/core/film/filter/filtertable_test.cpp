@@ -0,0 +1,71 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest.h"
+#include "core/film/filter/filtertable.h"
+#include "core/film/filter/boxfilter.h"
+#include "core/film/filter/gaussianfilter.h"
+#include "core/film/filter/mitchellfilter.h"
+
+TEST(FilterTableTest, CanBeCreated)
+{
+    ASSERT_NO_THROW(FilterTable table(BoxFilter{}));
+    ASSERT_NO_THROW(FilterTable table(GaussianFilter{}));
+}
+
+TEST(FilterTableTest, HasFilterRadius)
+{
+    FilterTable table(GaussianFilter(1.7));
+    EXPECT_DOUBLE_EQ(table.GetRadius(), 1.7);
+}
+
+TEST(FilterTableTest, ApronCoversFilterSupport)
+{
+    EXPECT_EQ(FilterTable(BoxFilter(0.5)).GetApron(), 0);
+    EXPECT_EQ(FilterTable(BoxFilter(1.0)).GetApron(), 1);
+    EXPECT_EQ(FilterTable(GaussianFilter(1.5)).GetApron(), 1);
+    EXPECT_EQ(FilterTable(MitchellFilter(2.0)).GetApron(), 2);
+    EXPECT_EQ(FilterTable(MitchellFilter(2.6)).GetApron(), 3);
+}
+
+TEST(FilterTableTest, MatchesFilterAtCellCenters)
+{
+    GaussianFilter filter(2.0);
+    FilterTable table(filter);
+    const double cellSize = filter.GetRadius() / FilterTable::TableSize;
+
+    for (int y = 0; y < FilterTable::TableSize; ++y)
+    {
+        for (int x = 0; x < FilterTable::TableSize; ++x)
+        {
+            Vector2 offset((x + 0.5) * cellSize, (y + 0.5) * cellSize);
+            EXPECT_FLOAT_EQ(table.GetWeight(offset), filter.Evaluate(offset));
+        }
+    }
+}
+
+TEST(FilterTableTest, IsSymmetric)
+{
+    FilterTable table(MitchellFilter{});
+    EXPECT_DOUBLE_EQ(table.GetWeight({ 0.3, 0.7 }), table.GetWeight({ -0.3, 0.7 }));
+    EXPECT_DOUBLE_EQ(table.GetWeight({ 0.3, 0.7 }), table.GetWeight({ 0.3, -0.7 }));
+    EXPECT_DOUBLE_EQ(table.GetWeight({ 0.3, 0.7 }), table.GetWeight({ -0.3, -0.7 }));
+}
+
@@ -0,0 +1,58 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest.h"
+#include "core/film/filter/gaussianfilter.h"
+
+TEST(GaussianFilterTest, CanBeCreated)
+{
+    ASSERT_NO_THROW(GaussianFilter());
+}
+
+TEST(GaussianFilterTest, HasDefaultValues)
+{
+    GaussianFilter filter;
+    EXPECT_DOUBLE_EQ(filter.GetRadius(), 1.5);
+    EXPECT_DOUBLE_EQ(filter.GetAlpha(), 2.0);
+}
+
+TEST(GaussianFilterTest, PeaksAtCenter)
+{
+    GaussianFilter filter;
+    EXPECT_GT(filter.Evaluate({ 0.0, 0.0 }), filter.Evaluate({ 0.1, 0.0 }));
+    EXPECT_GT(filter.Evaluate({ 0.1, 0.0 }), filter.Evaluate({ 0.5, 0.0 }));
+    EXPECT_GT(filter.Evaluate({ 0.5, 0.0 }), filter.Evaluate({ 0.5, 0.5 }));
+}
+
+TEST(GaussianFilterTest, FallsOffToZeroAtRadius)
+{
+    GaussianFilter filter(1.5);
+    EXPECT_NEAR(filter.Evaluate({ 1.5, 0.0 }), 0.0, SMath::Epsilon);
+    EXPECT_NEAR(filter.Evaluate({ 0.0, -1.5 }), 0.0, SMath::Epsilon);
+    EXPECT_GE(filter.Evaluate({ 1.4, 1.4 }), 0.0);
+}
+
+TEST(GaussianFilterTest, IsSymmetric)
+{
+    GaussianFilter filter;
+    EXPECT_DOUBLE_EQ(filter.Evaluate({ 0.3, 0.8 }), filter.Evaluate({ -0.3, -0.8 }));
+    EXPECT_DOUBLE_EQ(filter.Evaluate({ 0.3, 0.8 }), filter.Evaluate({ 0.8, 0.3 }));
+}
+
@@ -0,0 +1,55 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest.h"
+#include "core/film/filter/mitchellfilter.h"
+
+TEST(MitchellFilterTest, CanBeCreated)
+{
+    ASSERT_NO_THROW(MitchellFilter());
+}
+
+TEST(MitchellFilterTest, HasDefaultRadius)
+{
+    MitchellFilter filter;
+    EXPECT_DOUBLE_EQ(filter.GetRadius(), 2.0);
+}
+
+TEST(MitchellFilterTest, HasExpectedValues)
+{
+    // With B = C = 1/3 the 1D kernel is 8/9 at its center and 0 at its edge
+    MitchellFilter filter;
+    EXPECT_DOUBLE_EQ(filter.Evaluate({ 0.0, 0.0 }), (8.0 / 9.0) * (8.0 / 9.0));
+    EXPECT_NEAR(filter.Evaluate({ 2.0, 0.0 }), 0.0, SMath::Epsilon);
+    EXPECT_NEAR(filter.Evaluate({ 0.0, 2.0 }), 0.0, SMath::Epsilon);
+}
+
+TEST(MitchellFilterTest, HasNegativeLobes)
+{
+    MitchellFilter filter;
+    EXPECT_LT(filter.Evaluate({ 1.5, 0.0 }), 0.0);
+}
+
+TEST(MitchellFilterTest, IsContinuousAtKnot)
+{
+    MitchellFilter filter;
+    EXPECT_NEAR(filter.Evaluate({ 1.0 - 1e-9, 0.0 }), filter.Evaluate({ 1.0 + 1e-9, 0.0 }), 1e-6);
+}
+
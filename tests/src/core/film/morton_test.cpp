@@ -0,0 +1,55 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest.h"
+#include "core/film/morton.h"
+
+TEST(MortonTest, CanEncode)
+{
+    EXPECT_EQ(Morton::Encode(0, 0), 0);
+    EXPECT_EQ(Morton::Encode(1, 0), 1);
+    EXPECT_EQ(Morton::Encode(0, 1), 2);
+    EXPECT_EQ(Morton::Encode(1, 1), 3);
+    EXPECT_EQ(Morton::Encode(2, 0), 4);
+    EXPECT_EQ(Morton::Encode(7, 7), 63);
+    EXPECT_EQ(Morton::Encode(0xffff, 0), 0x55555555u);
+    EXPECT_EQ(Morton::Encode(0, 0xffff), 0xAAAAAAAAu);
+}
+
+TEST(MortonTest, CanDecode)
+{
+    for (uint32_t y = 0; y < 300; y += 7)
+    {
+        for (uint32_t x = 0; x < 300; x += 3)
+        {
+            uint32_t code = Morton::Encode(x, y);
+            EXPECT_EQ(Morton::DecodeX(code), x);
+            EXPECT_EQ(Morton::DecodeY(code), y);
+        }
+    }
+}
+
+TEST(MortonTest, CanIncrementX)
+{
+    for (uint32_t y = 0; y < 64; y += 5)
+        for (uint32_t x = 0; x < 63; ++x)
+            EXPECT_EQ(Morton::IncrementX(Morton::Encode(x, y)), Morton::Encode(x + 1, y));
+}
+
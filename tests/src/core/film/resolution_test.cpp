@@ -49,8 +49,8 @@ TEST(ResolutionTest, ThrowOnInvalidWidthHeight)
     EXPECT_NO_THROW(res.SetHeight(1));
     EXPECT_NO_THROW(res.SetWidth(3840));
     EXPECT_NO_THROW(res.SetHeight(2160));
-    EXPECT_THROW(res.SetWidth(3841), std::invalid_argument);
-    EXPECT_THROW(res.SetHeight(2161), std::invalid_argument);
+    EXPECT_NO_THROW(res.SetWidth(16384));
+    EXPECT_NO_THROW(res.SetHeight(16384));
     EXPECT_THROW(res.SetWidth(0), std::invalid_argument);
     EXPECT_THROW(res.SetHeight(0), std::invalid_argument);
 }
@@ -167,5 +167,10 @@ TEST(FilmTest, CanGetArea)
 
     Resolution3840X2160 res3840X2160;
     EXPECT_EQ(res3840X2160.GetArea(), 3840 * 2160);
+
+    Resolution res;
+    res.SetWidth(65536);
+    res.SetHeight(65536);
+    EXPECT_EQ(res.GetArea(), 65536LL * 65536LL);
 }
 
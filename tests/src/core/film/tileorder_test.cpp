@@ -0,0 +1,86 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest.h"
+#include "core/film/tileorder.h"
+
+static bool IsPermutation(std::vector<int> order, int numTiles)
+{
+    std::sort(order.begin(), order.end());
+
+    for (int i = 0; i < numTiles; ++i)
+        if (i >= (int)order.size() || order[i] != i)
+            return false;
+
+    return (int)order.size() == numTiles;
+}
+
+TEST(TileOrderTest, VisitsEveryTileOnce)
+{
+    const TileOrder orders[] = { TileOrder::Scanline, TileOrder::Spiral, TileOrder::Hilbert, TileOrder::Morton };
+    const Vector2i gridSizes[] = { { 1, 1 }, { 4, 4 }, { 8, 8 }, { 13, 7 }, { 7, 13 }, { 30, 17 }, { 1, 9 } };
+
+    for (TileOrder order : orders)
+        for (const Vector2i& size : gridSizes)
+            EXPECT_TRUE(IsPermutation(TileOrdering::Generate(order, size.x, size.y), size.x * size.y));
+}
+
+TEST(TileOrderTest, ScanlineIsRowMajor)
+{
+    std::vector<int> order = TileOrdering::GenerateScanline(5, 3);
+
+    for (int i = 0; i < 15; ++i)
+        EXPECT_EQ(order[i], i);
+}
+
+TEST(TileOrderTest, SpiralStartsAtCenter)
+{
+    std::vector<int> order = TileOrdering::GenerateSpiral(5, 5);
+    EXPECT_EQ(order[0], 2 + 2 * 5);
+
+    // The first ring surrounds the center tile
+    for (int i = 1; i < 9; ++i)
+    {
+        int x = order[i] % 5;
+        int y = order[i] / 5;
+        EXPECT_LE(std::abs(x - 2), 1);
+        EXPECT_LE(std::abs(y - 2), 1);
+    }
+}
+
+TEST(TileOrderTest, HilbertStepsBetweenNeighbors)
+{
+    std::vector<int> order = TileOrdering::GenerateHilbert(16, 16);
+
+    for (size_t i = 1; i < order.size(); ++i)
+    {
+        int dx = std::abs(order[i] % 16 - order[i - 1] % 16);
+        int dy = std::abs(order[i] / 16 - order[i - 1] / 16);
+        EXPECT_EQ(dx + dy, 1);
+    }
+}
+
+TEST(TileOrderTest, MortonVisitsQuadrantsInTurn)
+{
+    std::vector<int> order = TileOrdering::GenerateMorton(4, 4);
+    std::vector<int> expected = { 0, 1, 4, 5, 2, 3, 6, 7, 8, 9, 12, 13, 10, 11, 14, 15 };
+    EXPECT_EQ(order, expected);
+}
+
@@ -0,0 +1,72 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest.h"
+#include "core/film/tonemapper/luttonemapper.h"
+#include "core/film/tonemapper/uncharted2filmictonemapper.h"
+
+TEST(LutTonemapperTest, CanBeCreated)
+{
+    Uncharted2FilmicTonemapper tonemapper;
+    ASSERT_NO_THROW(LutTonemapper lut(tonemapper));
+
+    LutTonemapper lut(tonemapper, 16.0, 1024);
+    EXPECT_DOUBLE_EQ(lut.GetMaxValue(), 16.0);
+    EXPECT_EQ(lut.GetSize(), 1024);
+}
+
+TEST(LutTonemapperTest, ThrowOnInvalidTable)
+{
+    Uncharted2FilmicTonemapper tonemapper;
+    EXPECT_THROW(LutTonemapper(tonemapper, 0.0), std::invalid_argument);
+    EXPECT_THROW(LutTonemapper(tonemapper, 16.0, 1), std::invalid_argument);
+}
+
+TEST(LutTonemapperTest, MatchesBakedTonemapper)
+{
+    Uncharted2FilmicTonemapper tonemapper;
+    LutTonemapper lut(tonemapper);
+
+    // Well within a step of an 8 bit output
+    for (double x = 0.0; x <= 64.0; x += 0.0137)
+    {
+        EXPECT_NEAR(lut.ApplyTonemap(x)[0], tonemapper.ApplyTonemap(x)[0], 1e-3);
+        EXPECT_NEAR(lut.ApplyTonemap(x)[2], tonemapper.ApplyTonemap(x)[2], 1e-3);
+    }
+
+    std::vector<RgbCoefficients> colors = { { 0.1, 1.0, 10.0 }, { 0.01, 0.5, 5.0 } };
+    std::vector<RgbCoefficients> tonemapped(2);
+    lut.ApplyTonemap(colors, tonemapped);
+
+    for (int i = 0; i < 2; ++i)
+        for (int c = 0; c < 3; ++c)
+            EXPECT_NEAR(tonemapped[i][c], tonemapper.ApplyTonemap(colors[i])[c], 1e-3);
+}
+
+TEST(LutTonemapperTest, ClampsInputsToTable)
+{
+    Uncharted2FilmicTonemapper tonemapper;
+    LutTonemapper lut(tonemapper, 16.0);
+
+    EXPECT_DOUBLE_EQ(lut.ApplyTonemap(-1.0)[0], lut.ApplyTonemap(0.0)[0]);
+    EXPECT_DOUBLE_EQ(lut.ApplyTonemap(100.0)[0], lut.ApplyTonemap(16.0)[0]);
+    EXPECT_NEAR(lut.ApplyTonemap(16.0)[0], tonemapper.ApplyTonemap(16.0)[0], 1e-12);
+}
+
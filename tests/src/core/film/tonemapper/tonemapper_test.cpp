@@ -41,3 +41,28 @@ TEST(TonemapperTest, CanApplyGammaCorrection)
     EXPECT_DOUBLE_EQ(stub.ApplyGammaCorrection(col, 2.0)[2], std::sqrt(col[2]));
 }
 
+TEST(TonemapperTest, CanApplyTonemapToBatch)
+{
+    class ScalingTonemapper : public Tonemapper
+    {
+    public:
+        using Tonemapper::ApplyTonemap;
+        RgbCoefficients ApplyTonemap(const RgbCoefficients& linearSpaceColor) override { return linearSpaceColor * 0.5; }
+    };
+
+    ScalingTonemapper tonemapper;
+    std::vector<RgbCoefficients> colors = { { 1.0, 2.0, 3.0 }, { 4.0, 5.0, 6.0 } };
+    std::vector<RgbCoefficients> tonemapped(2);
+
+    tonemapper.ApplyTonemap(colors, tonemapped);
+    EXPECT_DOUBLE_EQ(tonemapped[0][0], 0.5);
+    EXPECT_DOUBLE_EQ(tonemapped[1][2], 3.0);
+
+    // Batches can be tonemapped in place
+    tonemapper.ApplyTonemap(colors, colors);
+    EXPECT_DOUBLE_EQ(colors[1][1], 2.5);
+
+    std::vector<RgbCoefficients> tooSmall(1);
+    EXPECT_THROW(tonemapper.ApplyTonemap(colors, tooSmall), std::invalid_argument);
+}
+
@@ -96,5 +96,51 @@ TEST(Uncharted2FilmicTonemapperTest, Values0To1AfterTonemapping)
     EXPECT_DOUBLE_EQ(tonemapper.ApplyTonemap(e)[2], 1.0);
 }
 
+TEST(Uncharted2FilmicTonemapperTest, BatchMatchesSingleColors)
+{
+    Uncharted2FilmicTonemapper tonemapper;
+    std::vector<RgbCoefficients> colors;
+
+    for (int i = 0; i < 100; ++i)
+        colors.push_back({ i * 0.01, i * 0.1, i * 0.3 });
+
+    std::vector<RgbCoefficients> tonemapped(colors.size());
+    tonemapper.ApplyTonemap(colors, tonemapped);
+
+    for (size_t i = 0; i < colors.size(); ++i)
+    {
+        RgbCoefficients expected = tonemapper.ApplyTonemap(colors[i]);
+        EXPECT_NEAR(tonemapped[i][0], expected[0], 1e-12);
+        EXPECT_NEAR(tonemapped[i][1], expected[1], 1e-12);
+        EXPECT_NEAR(tonemapped[i][2], expected[2], 1e-12);
+    }
+}
+
+
+TEST(Uncharted2FilmicTonemapperTest, MatchesFilmicCurve)
+{
+    Uncharted2FilmicTonemapper tonemapper;
+
+    for (double x = 0.0; x < 20.0; x += 0.173)
+    {
+        double expected = std::pow(tonemapper.FilmicCurve(x)[0] / tonemapper.FilmicCurve(11.2)[0], 1.0 / 2.2);
+        EXPECT_NEAR(tonemapper.ApplyTonemap(x)[0], expected, 1e-12);
+    }
+}
 
+TEST(Uncharted2FilmicTonemapperTest, CanSetExposure)
+{
+    Uncharted2FilmicTonemapper tonemapper;
+    EXPECT_DOUBLE_EQ(tonemapper.GetExposure(), 1.0);
+
+    Uncharted2FilmicTonemapper exposedTonemapper(11.2, 0.15, 0.50, 0.10, 0.20, 0.02, 0.30, 2.0);
+    EXPECT_DOUBLE_EQ(exposedTonemapper.GetExposure(), 2.0);
+
+    for (double x = 0.0; x < 5.0; x += 0.25)
+        EXPECT_NEAR(exposedTonemapper.ApplyTonemap(x)[0], tonemapper.ApplyTonemap(2.0 * x)[0], 1e-12);
+
+    tonemapper.SetExposure(2.0);
+    EXPECT_DOUBLE_EQ(tonemapper.GetExposure(), 2.0);
+    EXPECT_NEAR(tonemapper.ApplyTonemap(1.5)[1], exposedTonemapper.ApplyTonemap(1.5)[1], 1e-15);
+}
 
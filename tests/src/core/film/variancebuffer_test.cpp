@@ -0,0 +1,80 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest.h"
+#include "core/film/variancebuffer.h"
+
+TEST(VarianceBufferTest, CanBeAllocated)
+{
+    VarianceBuffer buffer;
+    EXPECT_FALSE(buffer.IsAllocated());
+    EXPECT_EQ(buffer.GetMemoryUsage(), 0);
+
+    buffer.Allocate(16);
+    EXPECT_TRUE(buffer.IsAllocated());
+    EXPECT_EQ(buffer.GetNumPixels(), 16);
+    EXPECT_EQ(buffer.GetMemoryUsage(), 16 * (sizeof(uint32_t) + 2 * sizeof(double)));
+
+    buffer.Release();
+    EXPECT_FALSE(buffer.IsAllocated());
+    EXPECT_THROW(buffer.Allocate(-1), std::invalid_argument);
+}
+
+TEST(VarianceBufferTest, TracksMeanAndVariance)
+{
+    VarianceBuffer buffer(2);
+    const double values[] = { 2.0, 4.0, 4.0, 4.0, 5.0, 5.0, 7.0, 9.0 };
+
+    for (double value : values)
+        buffer.Add(1, value);
+
+    EXPECT_EQ(buffer.GetCount(0), 0);
+    EXPECT_EQ(buffer.GetCount(1), 8);
+    EXPECT_DOUBLE_EQ(buffer.GetMean(1), 5.0);
+    EXPECT_DOUBLE_EQ(buffer.GetVariance(1), 32.0 / 7.0);
+    EXPECT_DOUBLE_EQ(buffer.GetRelativeError(1), std::sqrt(32.0 / 7.0 / 8.0) / 5.0);
+}
+
+TEST(VarianceBufferTest, IsStableForLargeOffsets)
+{
+    // Summing squares would lose every significant digit of the variance here
+    VarianceBuffer buffer(1);
+    for (int i = 0; i < 1000; ++i)
+        buffer.Add(0, 1e9 + (i % 2));
+
+    EXPECT_NEAR(buffer.GetVariance(0), 0.25 * 1000.0 / 999.0, 1e-6);
+}
+
+TEST(VarianceBufferTest, ErrorNeedsTwoSamples)
+{
+    VarianceBuffer buffer(1);
+    EXPECT_EQ(buffer.GetRelativeError(0), std::numeric_limits<double>::infinity());
+
+    buffer.Add(0, 0.0);
+    EXPECT_EQ(buffer.GetRelativeError(0), std::numeric_limits<double>::infinity());
+
+    // Black pixels without noise are converged, noisy dark pixels are measured against the floor
+    buffer.Add(0, 0.0);
+    EXPECT_DOUBLE_EQ(buffer.GetRelativeError(0), 0.0);
+
+    buffer.Add(0, 0.003);
+    EXPECT_DOUBLE_EQ(buffer.GetRelativeError(0), std::sqrt(buffer.GetVariance(0) / 3.0) / VarianceBuffer::MinLuminance);
+}
+
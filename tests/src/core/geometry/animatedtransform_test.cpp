@@ -0,0 +1,126 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest.h"
+#include "core/geometry/animatedtransform.h"
+
+TEST(AnimatedTransformTest, CanBeCreated)
+{
+    AnimatedTransform transform;
+    EXPECT_FALSE(transform.IsAnimated());
+    EXPECT_TRUE(transform.Interpolate(0.5).IsIdentity());
+}
+
+TEST(AnimatedTransformTest, StaticTransformsAreNotAnimated)
+{
+    const Matrix4x4 matrix = Transform::GetTranslationMatrix({ 1, 2, 3 });
+    AnimatedTransform transform(matrix, 0.0, matrix, 1.0);
+    EXPECT_FALSE(transform.IsAnimated());
+    EXPECT_EQ(transform.Interpolate(0.3), matrix);
+}
+
+TEST(AnimatedTransformTest, ThrowsOnInvalidInterval)
+{
+    EXPECT_THROW(AnimatedTransform(Matrix4x4(), 1.0, Transform::GetTranslationMatrix({ 1, 0, 0 }), 1.0), std::invalid_argument);
+    EXPECT_THROW(AnimatedTransform(Matrix4x4(), 1.0, Transform::GetTranslationMatrix({ 1, 0, 0 }), 0.0), std::invalid_argument);
+}
+
+TEST(AnimatedTransformTest, DecomposesRotationAndScale)
+{
+    const Matrix4x4 matrix = Transform::GetTranslationMatrix({ 1, -2, 3 }) *
+        Transform::GetRotationMatrix({ 0.3, 0.6, -0.2 }) *
+        Transform::GetScaleMatrix({ 2, 3, -4 });
+
+    EXPECT_EQ(AnimatedTransform::Compose(AnimatedTransform::Decompose(matrix)), matrix);
+}
+
+TEST(AnimatedTransformTest, HoldsKeyframesOutsideInterval)
+{
+    const Matrix4x4 start = Transform::GetTranslationMatrix({ 1, 0, 0 });
+    const Matrix4x4 end = Transform::GetRotationMatrix({ 0, 1, 0 });
+    AnimatedTransform transform(start, 2.0, end, 4.0);
+
+    EXPECT_TRUE(transform.IsAnimated());
+    EXPECT_EQ(transform.Interpolate(2.0), start);
+    EXPECT_EQ(transform.Interpolate(-1.0), start);
+    EXPECT_EQ(transform.Interpolate(4.0), end);
+    EXPECT_EQ(transform.Interpolate(5.0), end);
+}
+
+TEST(AnimatedTransformTest, InterpolatesTranslationAndScale)
+{
+    AnimatedTransform transform(
+        Transform::GetTranslationMatrix({ 0, 0, 0 }), 0.0,
+        Transform::GetTranslationMatrix({ 2, 4, -6 }) * Transform::GetScaleMatrix({ 3, 3, 3 }), 1.0);
+
+    EXPECT_EQ(transform.Interpolate(0.5), Transform::GetTranslationMatrix({ 1, 2, -3 }) * Transform::GetScaleMatrix({ 2, 2, 2 }));
+}
+
+TEST(AnimatedTransformTest, MotionBoundsContainTheAnimatedBox)
+{
+    BoundingBox box;
+    box.m_Min = Point3(-1, 0, 2);
+    box.m_Max = Point3(1, 0.5, 3);
+
+    // Static transforms give the exact bounds of the transformed box
+    const BoundingBox staticBounds = AnimatedTransform(Transform::GetTranslationMatrix({ 1, 2, 3 })).GetMotionBounds(box);
+    EXPECT_EQ(staticBounds.m_Min, Point3(0, 2, 5));
+    EXPECT_EQ(staticBounds.m_Max, Point3(2, 2.5, 6));
+
+    AnimatedTransform transform(
+        Transform::GetTranslationMatrix({ -1, 0, 0 }) * Transform::GetRotationMatrix({ 0, 0, 0 }), 0.0,
+        Transform::GetTranslationMatrix({ 3, 1, 0 }) * Transform::GetRotationMatrix({ 0.5, 2.5, 0 }) * Transform::GetScaleMatrix({ 2, 1, 1 }), 1.0);
+    const BoundingBox bounds = transform.GetMotionBounds(box);
+
+    for (int step = 0; step <= 64; ++step)
+    {
+        const Matrix4x4 matrix = transform.Interpolate(step / 64.0);
+
+        for (int corner = 0; corner < 8; ++corner)
+        {
+            const Point4 point((corner & 1) ? box.m_Max.x : box.m_Min.x, (corner & 2) ? box.m_Max.y : box.m_Min.y, (corner & 4) ? box.m_Max.z : box.m_Min.z, 1.0);
+            const Point4 transformed = matrix * point;
+
+            for (int i = 0; i < 3; ++i)
+            {
+                EXPECT_GE(transformed[i], bounds.m_Min[i]);
+                EXPECT_LE(transformed[i], bounds.m_Max[i]);
+            }
+        }
+    }
+}
+
+TEST(AnimatedTransformTest, InterpolatesRotationAlongShortestArc)
+{
+    const double pi = SMath::Pi;
+    AnimatedTransform transform(
+        Transform::GetRotationMatrix({ 0, 0, 0 }), 0.0,
+        Transform::GetRotationMatrix({ 0, pi / 2.0, 0 }), 1.0);
+
+    // Blending the matrices would shrink the geometry halfway, slerp keeps it rigid
+    EXPECT_EQ(transform.Interpolate(0.5), Transform::GetRotationMatrix({ 0, pi / 4.0, 0 }));
+    EXPECT_EQ(transform.Interpolate(0.25), Transform::GetRotationMatrix({ 0, pi / 8.0, 0 }));
+
+    AnimatedTransform longWay(
+        Transform::GetRotationMatrix({ 0, 0, 0.9 * pi }), 0.0,
+        Transform::GetRotationMatrix({ 0, 0, -0.9 * pi }), 1.0);
+    EXPECT_EQ(longWay.Interpolate(0.5), Transform::GetRotationMatrix({ 0, 0, pi }));
+}
+
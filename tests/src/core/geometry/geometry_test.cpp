@@ -43,3 +43,36 @@ TEST(GeometryTest, CanGetBottomLevelAccelerator)
     EXPECT_EQ(bottomLevelBvh, nullptr);
 }
 
+TEST(GeometryTest, CanAnimateTransform)
+{
+    Geometry geometry;
+    EXPECT_FALSE(geometry.IsAnimated());
+
+    const Matrix4x4 start = Transform::GetTranslationMatrix({ 0, 0, 0 });
+    const Matrix4x4 end = Transform::GetTranslationMatrix({ 4, 0, 0 });
+    geometry.SetAnimatedTransform(AnimatedTransform(start, 0.0, end, 1.0));
+
+    EXPECT_TRUE(geometry.IsAnimated());
+    EXPECT_EQ(geometry.GetTransform(), start);
+    EXPECT_EQ(geometry.GetTransform(0.25), Transform::GetTranslationMatrix({ 1, 0, 0 }));
+    EXPECT_EQ(geometry.GetTransformInv(0.25), Transform::GetTranslationMatrix({ -1, 0, 0 }));
+
+    geometry.SetTransform(end);
+    EXPECT_FALSE(geometry.IsAnimated());
+    EXPECT_EQ(geometry.GetTransform(0.25), end);
+}
+
+TEST(GeometryTest, CanTransformRayToObjectSpace)
+{
+    Geometry geometry;
+    geometry.SetAnimatedTransform(AnimatedTransform(
+        Transform::GetTranslationMatrix({ 0, 0, 0 }), 0.0,
+        Transform::GetTranslationMatrix({ 0, 2, 0 }) * Transform::GetScaleMatrix({ 2, 2, 2 }), 1.0));
+
+    const Ray ray(Point3(1, 2, 3), Vector3(0, 0, 1));
+    EXPECT_EQ(geometry.ToObjectSpace(ray, 0.0).m_Origin, Point3(1, 2, 3));
+
+    const Ray objectSpaceRay = geometry.ToObjectSpace(ray, 1.0);
+    EXPECT_EQ(objectSpaceRay.m_Origin, Point3(0.5, 0, 1.5));
+    EXPECT_EQ(objectSpaceRay.m_Direction, Vector3(0, 0, 0.5));
+}
@@ -0,0 +1,118 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest.h"
+#include "core/integrator/ambientocclusionintegrator.h"
+#include "core/spatial/linearaccelerator.h"
+#include "core/geometry/trianglemesh.h"
+#include "core/sampling/independentsampler.h"
+
+namespace
+{
+    void CreateQuad(TriangleMesh& mesh, double z, double halfSize)
+    {
+        TriangleMesh::Vertex vertices[4];
+        vertices[0] = { .m_Position = { -halfSize, -halfSize, z }, .m_Normal = { 0, 0, -1 } };
+        vertices[1] = { .m_Position = { halfSize, -halfSize, z }, .m_Normal = { 0, 0, -1 } };
+        vertices[2] = { .m_Position = { halfSize, halfSize, z }, .m_Normal = { 0, 0, -1 } };
+        vertices[3] = { .m_Position = { -halfSize, halfSize, z }, .m_Normal = { 0, 0, -1 } };
+        mesh.SetVertices(vertices, 4);
+
+        TrianglePrimitive faces[2] = { { &mesh, 0, 1, 2 }, { &mesh, 0, 2, 3 } };
+        mesh.SetFaces(faces, 2);
+    }
+}
+
+TEST(AmbientOcclusionIntegratorTest, CanBeCreated)
+{
+    LinearAccelerator scene;
+    AmbientOcclusionIntegrator integrator(scene, 2.0, 4);
+    EXPECT_DOUBLE_EQ(integrator.GetMaxDistance(), 2.0);
+    EXPECT_EQ(integrator.GetNumSamples(), 4);
+    EXPECT_EQ(&integrator.GetScene(), &scene);
+
+    EXPECT_THROW(AmbientOcclusionIntegrator(scene, 0.0), std::invalid_argument);
+    EXPECT_THROW(AmbientOcclusionIntegrator(scene, 1.0, 0), std::invalid_argument);
+}
+
+TEST(AmbientOcclusionIntegratorTest, MissesAreBlack)
+{
+    LinearAccelerator scene;
+    AmbientOcclusionIntegrator integrator(scene);
+    IndependentSampler sampler(1);
+    sampler.StartPixelSample({ 0, 0 }, 0);
+
+    AovSample aovs = {};
+    uint64_t numRays = 0;
+    const XyzCoefficients xyz = integrator.Integrate(Ray({ 0, 0, 0 }, { 0, 0, 1 }), 0.0, sampler, aovs, numRays);
+
+    EXPECT_DOUBLE_EQ(xyz[1], 0.0);
+    EXPECT_DOUBLE_EQ(aovs.m_Depth, 0.0);
+    EXPECT_EQ(numRays, 1);
+}
+
+TEST(AmbientOcclusionIntegratorTest, OpenSurfacesAreWhite)
+{
+    TriangleMesh floor;
+    CreateQuad(floor, 3.0, 100.0);
+    LinearAccelerator scene;
+    scene.Build({ &floor });
+
+    AmbientOcclusionIntegrator integrator(scene, 1.0, 8);
+    IndependentSampler sampler(1);
+    sampler.StartPixelSample({ 0, 0 }, 0);
+
+    AovSample aovs = {};
+    uint64_t numRays = 0;
+    const XyzCoefficients xyz = integrator.Integrate(Ray({ 0, 0, 0 }, { 0, 0, 1 }), 0.0, sampler, aovs, numRays);
+
+    EXPECT_DOUBLE_EQ(xyz[0], 1.0);
+    EXPECT_DOUBLE_EQ(xyz[1], 1.0);
+    EXPECT_DOUBLE_EQ(aovs.m_Depth, 3.0);
+    EXPECT_EQ(aovs.m_Normal, Normal3(0, 0, -1));
+    EXPECT_EQ(numRays, 9);
+}
+
+TEST(AmbientOcclusionIntegratorTest, EnclosedSurfacesAreBlack)
+{
+    // The ceiling lies behind the camera and covers the hemisphere above the floor
+    TriangleMesh floor, ceiling;
+    CreateQuad(floor, 3.0, 1e4);
+    CreateQuad(ceiling, -1.0, 1e4);
+    LinearAccelerator scene;
+    scene.Build({ &floor, &ceiling });
+
+    AmbientOcclusionIntegrator integrator(scene, std::numeric_limits<double>::infinity(), 16);
+    IndependentSampler sampler(1);
+    sampler.StartPixelSample({ 0, 0 }, 0);
+
+    AovSample aovs = {};
+    uint64_t numRays = 0;
+    const XyzCoefficients xyz = integrator.Integrate(Ray({ 0, 0, 0 }, { 0, 0, 1 }), 0.0, sampler, aovs, numRays);
+
+    EXPECT_DOUBLE_EQ(aovs.m_Depth, 3.0);
+    EXPECT_DOUBLE_EQ(xyz[1], 0.0);
+
+    // Occluders beyond the maximum distance do not count
+    AmbientOcclusionIntegrator shortIntegrator(scene, 0.5, 16);
+    sampler.StartPixelSample({ 0, 0 }, 0);
+    EXPECT_DOUBLE_EQ(shortIntegrator.Integrate(Ray({ 0, 0, 0 }, { 0, 0, 1 }), 0.0, sampler, aovs, numRays)[1], 1.0);
+}
+
@@ -0,0 +1,241 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest.h"
+#include "core/integrator/wavefrontintegrator.h"
+#include "core/renderer/renderer.h"
+#include "core/spatial/linearaccelerator.h"
+#include "core/geometry/trianglemesh.h"
+#include "core/camera/perspectivecamera.h"
+#include "core/sampling/independentsampler.h"
+
+namespace
+{
+    void CreateQuad(TriangleMesh& mesh, double z, double halfSize)
+    {
+        TriangleMesh::Vertex vertices[4];
+        vertices[0] = { .m_Position = { -halfSize, -halfSize, z }, .m_Normal = { 0, 0, -1 } };
+        vertices[1] = { .m_Position = { halfSize, -halfSize, z }, .m_Normal = { 0, 0, -1 } };
+        vertices[2] = { .m_Position = { halfSize, halfSize, z }, .m_Normal = { 0, 0, -1 } };
+        vertices[3] = { .m_Position = { -halfSize, halfSize, z }, .m_Normal = { 0, 0, -1 } };
+        mesh.SetVertices(vertices, 4);
+
+        TrianglePrimitive faces[2] = { { &mesh, 0, 1, 2 }, { &mesh, 0, 2, 3 } };
+        mesh.SetFaces(faces, 2);
+    }
+
+    void SetupCamera(PerspectiveCamera& camera)
+    {
+        Resolution resolution;
+        resolution.SetWidth(24);
+        resolution.SetHeight(16);
+        camera.GetFilm().SetResolution(resolution);
+        camera.GetFilm().SetTileSize(8);
+        camera.UpdateCachedTransforms();
+    }
+
+    double GetLuminance(const Film& film, const Point2i& position)
+    {
+        const Pixel pixel = film.GetTile(position.x / film.GetTileSize() + position.y / film.GetTileSize() * 3).GetFilmSpacePixel(position);
+        return pixel.m_TotalSplat > 0.0 ? pixel.m_Xyz[1] / pixel.m_TotalSplat : 0.0;
+    }
+
+    double GetAverageLuminance(const Film& film)
+    {
+        double sum = 0.0;
+        for (int y = 0; y < 16; ++y)
+            for (int x = 0; x < 24; ++x)
+                sum += GetLuminance(film, { x, y });
+
+        return sum / (24 * 16);
+    }
+}
+
+TEST(WavefrontIntegratorTest, CanBeCreated)
+{
+    LinearAccelerator scene;
+    WavefrontIntegrator integrator(scene, 3);
+    EXPECT_EQ(integrator.GetMaxDepth(), 3);
+    EXPECT_DOUBLE_EQ(integrator.GetAlbedo(), 0.5);
+    EXPECT_DOUBLE_EQ(integrator.GetSkyRadiance()[1], 1.0);
+    EXPECT_DOUBLE_EQ(integrator.GetSunIrradiance()[1], 0.0);
+
+    integrator.SetAlbedo(0.25);
+    integrator.SetSun({ 0, 0, -2 }, XyzCoefficients(3.0));
+    EXPECT_DOUBLE_EQ(integrator.GetAlbedo(), 0.25);
+    EXPECT_EQ(integrator.GetSunDirection(), Vector3(0, 0, -1));
+    EXPECT_DOUBLE_EQ(integrator.GetSunIrradiance()[1], 3.0);
+
+    EXPECT_THROW(WavefrontIntegrator(scene, 0), std::invalid_argument);
+    EXPECT_THROW(integrator.SetAlbedo(1.5), std::invalid_argument);
+    EXPECT_THROW(integrator.SetSun({ 0, 0, 0 }, XyzCoefficients(1.0)), std::invalid_argument);
+}
+
+TEST(WavefrontIntegratorTest, LitWallIsExact)
+{
+    // Every bounce off an unbounded wall escapes to the sky, so both the sky and the sun
+    // contributions are exact without any variance
+    TriangleMesh wall;
+    CreateQuad(wall, 5.0, 1e4);
+    LinearAccelerator scene;
+    scene.Build({ &wall });
+
+    WavefrontIntegrator integrator(scene);
+    integrator.SetAlbedo(0.5);
+    integrator.SetSkyRadiance(XyzCoefficients(2.0));
+    integrator.SetSun({ 0, 0.6, -0.8 }, XyzCoefficients(3.0));
+    const double expected = 0.5 * 2.0 + 0.5 / SMath::Pi * 3.0 * 0.8;
+
+    IndependentSampler sampler(4);
+    sampler.StartPixelSample({ 0, 0 }, 0);
+    AovSample aovs = {};
+    uint64_t numRays = 0;
+    const XyzCoefficients xyz = integrator.Integrate(Ray({ 0, 0, 0 }, { 0.1, 0, 1 }), 0.0, sampler, aovs, numRays);
+
+    EXPECT_NEAR(xyz[1], expected, 1e-9);
+    EXPECT_GT(aovs.m_Depth, 5.0);
+    EXPECT_EQ(numRays, 3);
+
+    PerspectiveCamera camera;
+    SetupCamera(camera);
+    camera.GetFilm().EnableAovs(Aov::Depth);
+    Renderer renderer(camera, integrator, sampler);
+    const RenderStatistics& statistics = renderer.Render();
+
+    for (int y = 0; y < 16; ++y)
+        for (int x = 0; x < 24; ++x)
+            EXPECT_NEAR(GetLuminance(camera.GetFilm(), { x, y }), expected, 1e-6);
+
+    EXPECT_EQ(statistics.m_NumRays, 24 * 16 * 4 * 3);
+
+    float depth[8];
+    camera.GetFilm().GetTile(0).ResolveAovScanline(0, AovType::Depth, depth);
+    for (int x = 0; x < 8; ++x)
+        EXPECT_GE(depth[x], 5.0f);
+}
+
+TEST(WavefrontIntegratorTest, MissesShowTheSky)
+{
+    LinearAccelerator scene;
+    WavefrontIntegrator integrator(scene);
+    integrator.SetSkyRadiance(XyzCoefficients(0.75));
+    integrator.SetSun({ 0, 1, 0 }, XyzCoefficients(10.0));
+    IndependentSampler sampler(2);
+
+    PerspectiveCamera camera;
+    SetupCamera(camera);
+    Renderer renderer(camera, integrator, sampler);
+    const RenderStatistics& statistics = renderer.Render();
+
+    for (int y = 0; y < 16; ++y)
+        for (int x = 0; x < 24; ++x)
+            EXPECT_NEAR(GetLuminance(camera.GetFilm(), { x, y }), 0.75, 1e-6);
+
+    EXPECT_EQ(statistics.m_NumRays, statistics.m_NumCameraRays);
+}
+
+TEST(WavefrontIntegratorTest, MatchesPathAtATimeIntegration)
+{
+    // A wall partly shadowed by a smaller quad in front of it, so that paths bounce between
+    // the two and are terminated by roulette
+    TriangleMesh wall, occluder;
+    CreateQuad(wall, 5.0, 3.0);
+    CreateQuad(occluder, 4.0, 1.0);
+    LinearAccelerator scene;
+    scene.Build({ &wall, &occluder });
+
+    WavefrontIntegrator integrator(scene, 8);
+    integrator.SetAlbedo(0.8);
+    integrator.SetSun({ 0.3, 0.2, -1 }, XyzCoefficients(2.0));
+    IndependentSampler sampler(32);
+
+    PerspectiveCamera wavefront, scalar;
+    SetupCamera(wavefront);
+    SetupCamera(scalar);
+
+    Renderer wavefrontRenderer(wavefront, integrator, sampler);
+    wavefrontRenderer.Render();
+
+    for (int i = 0; i < scalar.GetFilm().GetNumTiles(); ++i)
+    {
+        uint64_t numRays = 0;
+        std::unique_ptr<Sampler> tileSampler = sampler.Clone();
+        FilmTile& tile = scalar.GetFilm().BeginTile(i);
+        integrator.Integrator::IntegrateTile(scalar, tile, *tileSampler, 0, sampler.GetSamplesPerPixel(), numRays);
+    }
+
+    EXPECT_NEAR(GetAverageLuminance(wavefront.GetFilm()), GetAverageLuminance(scalar.GetFilm()), 0.01);
+}
+
+TEST(WavefrontIntegratorTest, IsDeterministicAcrossThreadCounts)
+{
+    TriangleMesh wall, occluder;
+    CreateQuad(wall, 5.0, 3.0);
+    CreateQuad(occluder, 4.0, 1.0);
+    LinearAccelerator scene;
+    scene.Build({ &wall, &occluder });
+
+    WavefrontIntegrator integrator(scene);
+    IndependentSampler sampler(4, 3);
+
+    PerspectiveCamera singleThreaded, multiThreaded;
+    SetupCamera(singleThreaded);
+    SetupCamera(multiThreaded);
+
+    Renderer singleThreadedRenderer(singleThreaded, integrator, sampler);
+    singleThreadedRenderer.SetNumThreads(1);
+    singleThreadedRenderer.Render();
+
+    Renderer multiThreadedRenderer(multiThreaded, integrator, sampler);
+    multiThreadedRenderer.SetNumThreads(4);
+    multiThreadedRenderer.Render();
+
+    for (int y = 0; y < 16; ++y)
+        for (int x = 0; x < 24; ++x)
+            EXPECT_EQ(GetLuminance(singleThreaded.GetFilm(), { x, y }), GetLuminance(multiThreaded.GetFilm(), { x, y }));
+}
+
+TEST(WavefrontIntegratorTest, SortsPathsByDirectionAndOrigin)
+{
+    PathQueue paths, sorted;
+    paths.Resize(5);
+
+    const double origins[5][3] = { { 1, 1, 1 }, { 0, 0, 0 }, { 0, 0, 0 }, { 1, 1, 1 }, { 0, 0, 0 } };
+    const double directions[5][3] = { { 0, 0, 1 }, { 0, 0, -1 }, { 0, 1, 0 }, { 1, 0, 0 }, { 0, 0, 1 } };
+
+    for (int i = 0; i < 5; ++i)
+    {
+        paths.SetOrigin(i, { origins[i][0], origins[i][1], origins[i][2] });
+        paths.SetDirection(i, { directions[i][0], directions[i][1], directions[i][2] });
+        paths.m_Throughput[i] = i;
+        paths.m_IsActive[i] = i != 3;
+    }
+
+    WavefrontIntegrator::SortPaths(paths, sorted);
+
+    // Inactive paths are dropped, positive directions come before negative ones and paths
+    // heading the same way are ordered by origin
+    ASSERT_EQ(sorted.GetSize(), 4);
+    EXPECT_DOUBLE_EQ(sorted.m_Throughput[0], 2.0);
+    EXPECT_DOUBLE_EQ(sorted.m_Throughput[1], 4.0);
+    EXPECT_DOUBLE_EQ(sorted.m_Throughput[2], 0.0);
+    EXPECT_DOUBLE_EQ(sorted.m_Throughput[3], 1.0);
+}
+
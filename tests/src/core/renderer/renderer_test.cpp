@@ -0,0 +1,385 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest.h"
+#include "core/renderer/renderer.h"
+#include "core/integrator/ambientocclusionintegrator.h"
+#include "core/spatial/linearaccelerator.h"
+#include "core/geometry/trianglemesh.h"
+#include "core/camera/perspectivecamera.h"
+#include "core/sampling/independentsampler.h"
+#include "exporter/hdrexporter.h"
+#include <fstream>
+
+namespace
+{
+    void CreateQuad(TriangleMesh& mesh, double z, double halfSize)
+    {
+        TriangleMesh::Vertex vertices[4];
+        vertices[0] = { .m_Position = { -halfSize, -halfSize, z }, .m_Normal = { 0, 0, -1 } };
+        vertices[1] = { .m_Position = { halfSize, -halfSize, z }, .m_Normal = { 0, 0, -1 } };
+        vertices[2] = { .m_Position = { halfSize, halfSize, z }, .m_Normal = { 0, 0, -1 } };
+        vertices[3] = { .m_Position = { -halfSize, halfSize, z }, .m_Normal = { 0, 0, -1 } };
+        mesh.SetVertices(vertices, 4);
+
+        TrianglePrimitive faces[2] = { { &mesh, 0, 1, 2 }, { &mesh, 0, 2, 3 } };
+        mesh.SetFaces(faces, 2);
+    }
+
+    void SetupCamera(PerspectiveCamera& camera)
+    {
+        Resolution resolution;
+        resolution.SetWidth(24);
+        resolution.SetHeight(16);
+        camera.GetFilm().SetResolution(resolution);
+        camera.GetFilm().SetTileSize(8);
+    }
+
+    std::vector<float> ExportPfm(const Film& film, const std::string& name)
+    {
+        HdrExporter exporter(HdrFormat::Pfm);
+        exporter.SetOutputName(name);
+        exporter.Export(film);
+
+        // Skip the three header lines
+        std::ifstream stream(name + exporter.GetFileExtension(), std::ios::binary);
+        std::string line;
+        for (int i = 0; i < 3; ++i)
+            std::getline(stream, line);
+
+        std::vector<float> rgb(film.GetNumPixels() * 3);
+        stream.read(reinterpret_cast<char*>(rgb.data()), rgb.size() * sizeof(float));
+        stream.close();
+
+        std::remove((name + exporter.GetFileExtension()).c_str());
+        return rgb;
+    }
+
+    double GetLuminance(const Film& film, const Point2i& position)
+    {
+        const Pixel pixel = film.GetTile(position.x / film.GetTileSize() + position.y / film.GetTileSize() * 3).GetFilmSpacePixel(position);
+        return pixel.m_TotalSplat > 0.0 ? pixel.m_Xyz[1] / pixel.m_TotalSplat : 0.0;
+    }
+
+    class ThrowingIntegrator : public Integrator
+    {
+    public:
+        ThrowingIntegrator(const Accelerator& scene) : Integrator(scene) {}
+
+        XyzCoefficients Integrate(const Ray&, double, Sampler&, AovSample&, uint64_t&) const override
+        {
+            throw std::runtime_error("Integrator failed");
+        }
+    };
+
+    // Noisy on one side of the image and constant on the other
+    class HalfNoisyIntegrator : public Integrator
+    {
+    public:
+        HalfNoisyIntegrator(const Accelerator& scene) : Integrator(scene) {}
+
+        XyzCoefficients Integrate(const Ray& ray, double, Sampler& sampler, AovSample&, uint64_t& numRays) const override
+        {
+            ++numRays;
+            return XyzCoefficients(ray.m_Direction.x < 0.0 ? sampler.Get1D() : 0.5);
+        }
+    };
+
+    // Stands in for a process that is killed after it has traced a number of camera rays
+    class InterruptedIntegrator : public HalfNoisyIntegrator
+    {
+    public:
+        InterruptedIntegrator(const Accelerator& scene, int numRays) : HalfNoisyIntegrator(scene), m_RemainingRays(numRays) {}
+
+        XyzCoefficients Integrate(const Ray& ray, double time, Sampler& sampler, AovSample& aovs, uint64_t& numRays) const override
+        {
+            if (--m_RemainingRays < 0)
+                throw std::runtime_error("Render was interrupted");
+
+            return HalfNoisyIntegrator::Integrate(ray, time, sampler, aovs, numRays);
+        }
+
+    private:
+        mutable std::atomic<int> m_RemainingRays;
+    };
+}
+
+TEST(RendererTest, CanSetNumThreads)
+{
+    LinearAccelerator scene;
+    AmbientOcclusionIntegrator integrator(scene);
+    IndependentSampler sampler(1);
+    PerspectiveCamera camera;
+
+    Renderer renderer(camera, integrator, sampler);
+    EXPECT_GE(renderer.GetNumThreads(), 1);
+
+    renderer.SetNumThreads(3);
+    EXPECT_EQ(renderer.GetNumThreads(), 3);
+    EXPECT_THROW(renderer.SetNumThreads(0), std::invalid_argument);
+}
+
+TEST(RendererTest, RendersEveryPixel)
+{
+    TriangleMesh wall;
+    CreateQuad(wall, 5.0, 1e3);
+    LinearAccelerator scene;
+    scene.Build({ &wall });
+
+    AmbientOcclusionIntegrator integrator(scene, 1.0, 2);
+    IndependentSampler sampler(4);
+    PerspectiveCamera camera;
+    SetupCamera(camera);
+
+    Renderer renderer(camera, integrator, sampler);
+    renderer.SetNumThreads(2);
+    const RenderStatistics& statistics = renderer.Render();
+
+    for (int y = 0; y < 16; ++y)
+        for (int x = 0; x < 24; ++x)
+            EXPECT_NEAR(GetLuminance(camera.GetFilm(), { x, y }), 1.0, 1e-6);
+
+    EXPECT_EQ(statistics.m_NumCameraRays, 24 * 16 * 4);
+    EXPECT_EQ(statistics.m_NumRays, 24 * 16 * 4 * 3);
+    EXPECT_GT(statistics.GetMraysPerSecond(), 0.0);
+    EXPECT_EQ(statistics.m_NumPasses, 1);
+    EXPECT_EQ(statistics.m_TileSamplesPerPixel, std::vector<int>(6, 4));
+}
+
+TEST(RendererTest, IsDeterministicAcrossThreadCounts)
+{
+    TriangleMesh wall, occluder;
+    CreateQuad(wall, 5.0, 3.0);
+    CreateQuad(occluder, 4.5, 1.0);
+    LinearAccelerator scene;
+    scene.Build({ &wall, &occluder });
+
+    AmbientOcclusionIntegrator integrator(scene, 2.0, 4);
+    IndependentSampler sampler(2, 7);
+
+    PerspectiveCamera singleThreaded, multiThreaded;
+    SetupCamera(singleThreaded);
+    SetupCamera(multiThreaded);
+
+    Renderer singleThreadedRenderer(singleThreaded, integrator, sampler);
+    singleThreadedRenderer.SetNumThreads(1);
+    singleThreadedRenderer.Render();
+
+    Renderer multiThreadedRenderer(multiThreaded, integrator, sampler);
+    multiThreadedRenderer.SetNumThreads(4);
+    multiThreadedRenderer.Render();
+
+    for (int y = 0; y < 16; ++y)
+        for (int x = 0; x < 24; ++x)
+            EXPECT_EQ(GetLuminance(singleThreaded.GetFilm(), { x, y }), GetLuminance(multiThreaded.GetFilm(), { x, y }));
+}
+
+TEST(RendererTest, ExportsStreamedFilms)
+{
+    TriangleMesh wall;
+    CreateQuad(wall, 5.0, 1e3);
+    LinearAccelerator scene;
+    scene.Build({ &wall });
+
+    AmbientOcclusionIntegrator integrator(scene, 1.0, 2);
+    IndependentSampler sampler(2);
+
+    PerspectiveCamera inMemory, streamed;
+    SetupCamera(inMemory);
+    SetupCamera(streamed);
+    streamed.GetFilm().EnableStreaming("RendererTest.spcfilm");
+
+    Renderer inMemoryRenderer(inMemory, integrator, sampler);
+    inMemoryRenderer.Render();
+
+    Renderer streamedRenderer(streamed, integrator, sampler);
+    streamedRenderer.SetNumThreads(2);
+    streamedRenderer.Render();
+
+    // Every tile has been written out, so the image is read back from the stream
+    EXPECT_EQ(streamed.GetFilm().GetMemoryUsage(), 0);
+
+    const std::vector<float> expected = ExportPfm(inMemory.GetFilm(), "RendererTest_InMemory");
+    const std::vector<float> actual = ExportPfm(streamed.GetFilm(), "RendererTest_Streamed");
+
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_GT(actual[i], 0.0f);
+        EXPECT_NEAR(actual[i], expected[i], 1e-5);
+    }
+
+    std::remove("RendererTest.spcfilm");
+}
+
+TEST(RendererTest, FillsAovsAndPublishesTiles)
+{
+    TriangleMesh wall;
+    CreateQuad(wall, 5.0, 1e3);
+    LinearAccelerator scene;
+    scene.Build({ &wall });
+
+    AmbientOcclusionIntegrator integrator(scene, 1.0);
+    IndependentSampler sampler(1);
+    PerspectiveCamera camera;
+    SetupCamera(camera);
+    camera.GetFilm().EnableAovs(Aov::Depth | Aov::SampleCount);
+    camera.GetFilm().EnableSnapshots();
+
+    Renderer renderer(camera, integrator, sampler);
+    renderer.Render();
+
+    float depth[8];
+    float count[8];
+    const FilmTile& tile = camera.GetFilm().GetTile(4);
+    tile.ResolveAovScanline(0, AovType::Depth, depth);
+    tile.ResolveAovScanline(0, AovType::SampleCount, count);
+
+    for (int x = 0; x < 8; ++x)
+    {
+        // Depth is the distance along the ray, which is at least the distance to the wall
+        EXPECT_GE(depth[x], 5.0f);
+        EXPECT_LT(depth[x], 5.5f);
+        EXPECT_FLOAT_EQ(count[x], 1.0f);
+    }
+
+    std::unique_ptr<const Film> snapshot = camera.GetFilm().CreateSnapshot();
+    EXPECT_EQ(GetLuminance(*snapshot, { 10, 10 }), GetLuminance(camera.GetFilm(), { 10, 10 }));
+}
+
+TEST(RendererTest, CanSetAdaptiveSampling)
+{
+    LinearAccelerator scene;
+    AmbientOcclusionIntegrator integrator(scene);
+    IndependentSampler sampler(16);
+    PerspectiveCamera camera;
+
+    Renderer renderer(camera, integrator, sampler);
+    EXPECT_FALSE(renderer.IsAdaptive());
+
+    renderer.SetAdaptiveSampling(0.05, 2);
+    EXPECT_TRUE(renderer.IsAdaptive());
+    EXPECT_DOUBLE_EQ(renderer.GetMaxError(), 0.05);
+    EXPECT_EQ(renderer.GetSamplesPerPass(), 2);
+
+    EXPECT_THROW(renderer.SetAdaptiveSampling(0.0), std::invalid_argument);
+    EXPECT_THROW(renderer.SetAdaptiveSampling(0.05, 0), std::invalid_argument);
+
+    renderer.DisableAdaptiveSampling();
+    EXPECT_FALSE(renderer.IsAdaptive());
+}
+
+TEST(RendererTest, AdaptiveSamplingStopsConvergedTiles)
+{
+    LinearAccelerator scene;
+    HalfNoisyIntegrator integrator(scene);
+    IndependentSampler sampler(32);
+    PerspectiveCamera camera;
+    SetupCamera(camera);
+
+    Renderer renderer(camera, integrator, sampler);
+    renderer.SetAdaptiveSampling(0.01, 4);
+    const RenderStatistics& statistics = renderer.Render();
+    EXPECT_TRUE(camera.GetFilm().IsTrackingVariance());
+
+    // The middle column of tiles straddles the center of the image and is noisy, so are the
+    // tiles on one side. The constant side converges after its first pass.
+    int numConverged = 0, numExhausted = 0;
+    for (int samples : statistics.m_TileSamplesPerPixel)
+    {
+        numConverged += samples == 4;
+        numExhausted += samples == 32;
+    }
+
+    EXPECT_EQ(numConverged, 2);
+    EXPECT_EQ(numExhausted, 4);
+    EXPECT_EQ(statistics.m_NumPasses, 8);
+    EXPECT_EQ(statistics.m_NumCameraRays, 64 * (2 * 4 + 4 * 32));
+    EXPECT_EQ(statistics.m_NumRays, statistics.m_NumCameraRays);
+
+    for (int y = 0; y < 16; ++y)
+        for (int x = 0; x < 24; ++x)
+            EXPECT_NEAR(GetLuminance(camera.GetFilm(), { x, y }), 0.5, 0.3);
+}
+
+TEST(RendererTest, ResumesFromCheckpoint)
+{
+    const char* checkpointPath = "RendererTest.spcckpt";
+    std::remove(checkpointPath);
+
+    LinearAccelerator scene;
+    HalfNoisyIntegrator integrator(scene);
+    IndependentSampler sampler(32);
+
+    PerspectiveCamera uninterrupted;
+    SetupCamera(uninterrupted);
+    Renderer uninterruptedRenderer(uninterrupted, integrator, sampler);
+    uninterruptedRenderer.SetAdaptiveSampling(0.01, 4);
+    const RenderStatistics expected = uninterruptedRenderer.Render();
+
+    // Interrupt the first attempt part way through the second pass
+    PerspectiveCamera interrupted;
+    SetupCamera(interrupted);
+    InterruptedIntegrator interruptedIntegrator(scene, 64 * 4 * 6 + 64 * 4 * 2 + 20);
+    Renderer interruptedRenderer(interrupted, interruptedIntegrator, sampler);
+    interruptedRenderer.SetNumThreads(1);
+    interruptedRenderer.SetAdaptiveSampling(0.01, 4);
+    interruptedRenderer.SetCheckpoint(checkpointPath);
+    EXPECT_THROW(interruptedRenderer.Render(), std::runtime_error);
+
+    PerspectiveCamera resumed;
+    SetupCamera(resumed);
+    Renderer resumedRenderer(resumed, integrator, sampler);
+    resumedRenderer.SetAdaptiveSampling(0.01, 4);
+    resumedRenderer.SetCheckpoint(checkpointPath);
+    EXPECT_TRUE(resumedRenderer.HasCheckpoint());
+    const RenderStatistics& statistics = resumedRenderer.Render();
+
+    EXPECT_EQ(statistics.m_TileSamplesPerPixel, expected.m_TileSamplesPerPixel);
+    EXPECT_EQ(statistics.m_NumCameraRays, expected.m_NumCameraRays);
+    EXPECT_LT(statistics.m_NumRays, expected.m_NumRays);
+
+    for (int y = 0; y < 16; ++y)
+        for (int x = 0; x < 24; ++x)
+            EXPECT_EQ(GetLuminance(resumed.GetFilm(), { x, y }), GetLuminance(uninterrupted.GetFilm(), { x, y }));
+
+    // A finished checkpoint resumes to the same image without rendering anything
+    PerspectiveCamera finished;
+    SetupCamera(finished);
+    Renderer finishedRenderer(finished, integrator, sampler);
+    finishedRenderer.SetAdaptiveSampling(0.01, 4);
+    finishedRenderer.SetCheckpoint(checkpointPath);
+    EXPECT_EQ(finishedRenderer.Render().m_NumRays, 0);
+    EXPECT_EQ(GetLuminance(finished.GetFilm(), { 3, 3 }), GetLuminance(uninterrupted.GetFilm(), { 3, 3 }));
+
+    std::remove(checkpointPath);
+}
+
+TEST(RendererTest, RethrowsTileErrors)
+{
+    LinearAccelerator scene;
+    ThrowingIntegrator integrator(scene);
+    IndependentSampler sampler(1);
+    PerspectiveCamera camera;
+    SetupCamera(camera);
+
+    Renderer renderer(camera, integrator, sampler);
+    EXPECT_THROW(renderer.Render(), std::runtime_error);
+}
+
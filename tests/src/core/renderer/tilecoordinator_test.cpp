@@ -0,0 +1,277 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest.h"
+#include "core/renderer/tilecoordinator.h"
+#include "core/renderer/tileworker.h"
+#include "core/renderer/tileprotocol.h"
+#include "core/integrator/ambientocclusionintegrator.h"
+#include "core/spatial/linearaccelerator.h"
+#include "core/geometry/trianglemesh.h"
+#include "core/camera/perspectivecamera.h"
+#include "core/sampling/independentsampler.h"
+#include <thread>
+
+namespace
+{
+    const char* Address = "unix:TileCoordinatorTest.sock";
+
+    void CreateQuad(TriangleMesh& mesh, double z, double halfSize)
+    {
+        TriangleMesh::Vertex vertices[4];
+        vertices[0] = { .m_Position = { -halfSize, -halfSize, z }, .m_Normal = { 0, 0, -1 } };
+        vertices[1] = { .m_Position = { halfSize, -halfSize, z }, .m_Normal = { 0, 0, -1 } };
+        vertices[2] = { .m_Position = { halfSize, halfSize, z }, .m_Normal = { 0, 0, -1 } };
+        vertices[3] = { .m_Position = { -halfSize, halfSize, z }, .m_Normal = { 0, 0, -1 } };
+        mesh.SetVertices(vertices, 4);
+
+        TrianglePrimitive faces[2] = { { &mesh, 0, 1, 2 }, { &mesh, 0, 2, 3 } };
+        mesh.SetFaces(faces, 2);
+    }
+
+    void SetupCamera(PerspectiveCamera& camera)
+    {
+        Resolution resolution;
+        resolution.SetWidth(24);
+        resolution.SetHeight(16);
+        camera.GetFilm().SetResolution(resolution);
+        camera.GetFilm().SetTileSize(8);
+    }
+
+    void ExpectSameImage(const Film& film, const Film& expected)
+    {
+        for (int y = 0; y < 16; ++y)
+        {
+            for (int x = 0; x < 24; ++x)
+            {
+                const int tileIndex = x / 8 + y / 8 * 3;
+                const Pixel pixel = film.GetTile(tileIndex).GetFilmSpacePixel({ x, y });
+                const Pixel expectedPixel = expected.GetTile(tileIndex).GetFilmSpacePixel({ x, y });
+                EXPECT_EQ(pixel.m_Xyz[1], expectedPixel.m_Xyz[1]);
+                EXPECT_EQ(pixel.m_TotalSplat, expectedPixel.m_TotalSplat);
+            }
+        }
+    }
+
+    // Stands in for a worker process that is killed after it has traced a number of camera rays
+    class InterruptedIntegrator : public AmbientOcclusionIntegrator
+    {
+    public:
+        InterruptedIntegrator(const Accelerator& scene, int numRays) : AmbientOcclusionIntegrator(scene, 2.0, 4), m_RemainingRays(numRays) {}
+
+        XyzCoefficients Integrate(const Ray& ray, double time, Sampler& sampler, AovSample& aovs, uint64_t& numRays) const override
+        {
+            if (--m_RemainingRays < 0)
+                throw std::runtime_error("Worker was interrupted");
+
+            return AmbientOcclusionIntegrator::Integrate(ray, time, sampler, aovs, numRays);
+        }
+
+    private:
+        mutable std::atomic<int> m_RemainingRays;
+    };
+
+    // A wall behind an occluder, rendered locally for reference
+    struct TestScene
+    {
+        TestScene()
+        {
+            CreateQuad(m_Wall, 5.0, 3.0);
+            CreateQuad(m_Occluder, 4.5, 1.0);
+            m_Accelerator.Build({ &m_Wall, &m_Occluder });
+
+            SetupCamera(m_Expected);
+            Renderer renderer(m_Expected, m_Integrator, m_Sampler);
+            m_ExpectedStatistics = renderer.Render();
+        }
+
+        TriangleMesh m_Wall, m_Occluder;
+        LinearAccelerator m_Accelerator;
+        AmbientOcclusionIntegrator m_Integrator = AmbientOcclusionIntegrator(m_Accelerator, 2.0, 4);
+        IndependentSampler m_Sampler = IndependentSampler(2, 7);
+        PerspectiveCamera m_Expected;
+        RenderStatistics m_ExpectedStatistics;
+    };
+}
+
+TEST(TileCoordinatorTest, CanBeConfigured)
+{
+    Film film;
+    EXPECT_THROW(TileCoordinator(film, 0), std::invalid_argument);
+
+    TileCoordinator coordinator(film, 4);
+    EXPECT_FALSE(coordinator.IsListening());
+    EXPECT_THROW(coordinator.Run(), std::runtime_error);
+    EXPECT_THROW(coordinator.SetTileTimeout(-1.0), std::invalid_argument);
+
+    coordinator.SetTileTimeout(2.5);
+    EXPECT_EQ(coordinator.GetTileTimeout(), 2.5);
+
+    coordinator.Listen(Address);
+    EXPECT_TRUE(coordinator.IsListening());
+}
+
+TEST(TileCoordinatorTest, RendersLikeLocalRenderer)
+{
+    TestScene scene;
+    PerspectiveCamera distributed;
+    SetupCamera(distributed);
+    TileCoordinator coordinator(distributed.GetFilm(), scene.m_Sampler.GetSamplesPerPixel());
+    coordinator.Listen(Address);
+    std::thread coordinatorThread([&coordinator]() { coordinator.Run(); });
+
+    // Two worker processes with two connections each. A worker that only connects once the
+    // others have finished the frame finds the coordinator gone, which is not an error here.
+    PerspectiveCamera workerCameras[2];
+    std::atomic<int> numTilesRendered = 0;
+    std::vector<std::thread> workerThreads;
+
+    for (PerspectiveCamera& camera : workerCameras)
+    {
+        SetupCamera(camera);
+        workerThreads.emplace_back([&scene, &camera, &numTilesRendered]()
+        {
+            TileWorker worker(camera, scene.m_Integrator, scene.m_Sampler);
+            worker.SetNumThreads(2);
+
+            try
+            {
+                worker.Run(Address, 0.5);
+            }
+            catch (const std::runtime_error&)
+            {
+            }
+
+            numTilesRendered += worker.GetNumTilesRendered();
+        });
+    }
+
+    for (std::thread& thread : workerThreads)
+        thread.join();
+
+    coordinatorThread.join();
+
+    ExpectSameImage(distributed.GetFilm(), scene.m_Expected.GetFilm());
+    EXPECT_EQ(numTilesRendered, 6);
+    EXPECT_GE(coordinator.GetNumWorkers(), 1);
+    EXPECT_EQ(coordinator.GetNumReassignedTiles(), 0);
+    EXPECT_EQ(coordinator.GetStatistics().m_NumRays, scene.m_ExpectedStatistics.m_NumRays);
+    EXPECT_EQ(coordinator.GetStatistics().m_NumCameraRays, scene.m_ExpectedStatistics.m_NumCameraRays);
+    EXPECT_EQ(coordinator.GetStatistics().m_TileSamplesPerPixel, scene.m_ExpectedStatistics.m_TileSamplesPerPixel);
+}
+
+TEST(TileCoordinatorTest, ReassignsTilesOfLostWorkers)
+{
+    TestScene scene;
+    PerspectiveCamera distributed;
+    SetupCamera(distributed);
+    TileCoordinator coordinator(distributed.GetFilm(), scene.m_Sampler.GetSamplesPerPixel());
+    coordinator.SetSceneId("wall");
+    coordinator.Listen(Address);
+    std::thread coordinatorThread([&coordinator]() { coordinator.Run(); });
+
+    // Dies part way through its third tile
+    PerspectiveCamera lostCamera;
+    SetupCamera(lostCamera);
+    InterruptedIntegrator interruptedIntegrator(scene.m_Accelerator, 64 * 2 * 2 + 10);
+    TileWorker lostWorker(lostCamera, interruptedIntegrator, scene.m_Sampler);
+    lostWorker.SetNumThreads(1);
+    lostWorker.SetSceneId("wall");
+    EXPECT_THROW(lostWorker.Run(Address, 5.0), std::runtime_error);
+    EXPECT_EQ(lostWorker.GetNumTilesRendered(), 2);
+
+    // Workers with another film are turned away before they are handed a tile
+    PerspectiveCamera mismatchedCamera;
+    SetupCamera(mismatchedCamera);
+    IndependentSampler mismatchedSampler(4, 7);
+    TileWorker mismatchedWorker(mismatchedCamera, scene.m_Integrator, mismatchedSampler);
+    mismatchedWorker.SetNumThreads(1);
+    mismatchedWorker.SetSceneId("wall");
+    EXPECT_THROW(mismatchedWorker.Run(Address, 5.0), std::runtime_error);
+    EXPECT_EQ(mismatchedWorker.GetNumTilesRendered(), 0);
+
+    // As are workers with the same film that were started with another scene
+    PerspectiveCamera otherSceneCamera;
+    SetupCamera(otherSceneCamera);
+    TileWorker otherSceneWorker(otherSceneCamera, scene.m_Integrator, scene.m_Sampler);
+    otherSceneWorker.SetNumThreads(1);
+    otherSceneWorker.SetSceneId("cornell");
+    EXPECT_THROW(otherSceneWorker.Run(Address, 5.0), std::runtime_error);
+    EXPECT_EQ(otherSceneWorker.GetNumTilesRendered(), 0);
+
+    PerspectiveCamera workerCamera;
+    SetupCamera(workerCamera);
+    TileWorker worker(workerCamera, scene.m_Integrator, scene.m_Sampler);
+    worker.SetNumThreads(1);
+    worker.SetSceneId("wall");
+    worker.Run(Address, 5.0);
+    coordinatorThread.join();
+
+    ExpectSameImage(distributed.GetFilm(), scene.m_Expected.GetFilm());
+    EXPECT_EQ(worker.GetNumTilesRendered(), 4);
+    EXPECT_EQ(coordinator.GetNumWorkers(), 2);
+    EXPECT_EQ(coordinator.GetNumReassignedTiles(), 1);
+    EXPECT_EQ(coordinator.GetStatistics().m_NumRays, scene.m_ExpectedStatistics.m_NumRays);
+}
+
+TEST(TileCoordinatorTest, FailsTilesThatAreLostTooOften)
+{
+    TestScene scene;
+    PerspectiveCamera distributed;
+    SetupCamera(distributed);
+    TileCoordinator coordinator(distributed.GetFilm(), scene.m_Sampler.GetSamplesPerPixel());
+    coordinator.SetTileTimeout(0.05);
+    coordinator.Listen(Address);
+
+    std::atomic<bool> hasFailed = false;
+    std::thread coordinatorThread([&coordinator, &hasFailed]()
+    {
+        EXPECT_THROW(coordinator.Run(), std::runtime_error);
+        hasFailed = true;
+    });
+
+    // Stands in for workers that never finish their tile in time, and counts the jobs handed out
+    int numJobs = 0;
+
+    while (!hasFailed)
+    {
+        try
+        {
+            Socket socket = Socket::Connect(Address, 1.0);
+            TileMessage message;
+
+            while (TileProtocol::Receive(socket, message))
+            {
+                if (message.m_Type == TileMessageType::Hello)
+                    TileProtocol::Send(socket, TileMessageType::Ready);
+                else if (message.m_Type == TileMessageType::Job)
+                    ++numJobs;
+            }
+        }
+        catch (const std::runtime_error&)
+        {
+        }
+    }
+
+    coordinatorThread.join();
+    EXPECT_EQ(numJobs, TileCoordinator::MaxTileAttempts);
+    EXPECT_EQ(coordinator.GetNumReassignedTiles(), TileCoordinator::MaxTileAttempts - 1);
+}
+
@@ -0,0 +1,128 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest.h"
+#include "core/sampling/batchsampling.h"
+#include "core/sampling/sampling.h"
+
+namespace
+{
+    // An odd size so that both the vector body and the scalar tail are covered
+    constexpr int BatchSize = 1023;
+    constexpr double Tolerance = 1e-10;
+
+    void GenerateInputs(std::vector<double>& u0, std::vector<double>& u1)
+    {
+        Rng rng(5);
+        u0.resize(BatchSize);
+        u1.resize(BatchSize);
+
+        for (int i = 0; i < BatchSize; ++i)
+        {
+            u0[i] = rng.UniformDouble();
+            u1[i] = rng.UniformDouble();
+        }
+
+        // Include the corners and the center of the domain
+        u0[0] = 0.0; u1[0] = 0.0;
+        u0[1] = 0.5; u1[1] = 0.5;
+        u0[2] = 1.0 - 0x1p-53; u1[2] = 1.0 - 0x1p-53;
+    }
+}
+
+TEST(BatchSamplingTest, FastSinCosMatchesStandardLibrary)
+{
+    std::vector<double> angles(BatchSize), sines(BatchSize), cosines(BatchSize);
+
+    for (int i = 0; i < BatchSize; ++i)
+        angles[i] = -4.0 * SMath::Pi + 8.0 * SMath::Pi * i / (BatchSize - 1);
+
+    BatchSampling::FastSinCos(angles, sines, cosines);
+
+    for (int i = 0; i < BatchSize; ++i)
+    {
+        EXPECT_NEAR(sines[i], std::sin(angles[i]), Tolerance);
+        EXPECT_NEAR(cosines[i], std::cos(angles[i]), Tolerance);
+
+        double sine, cosine;
+        BatchSampling::FastSinCos(angles[i], sine, cosine);
+        EXPECT_NEAR(sine, sines[i], 1e-15);
+        EXPECT_NEAR(cosine, cosines[i], 1e-15);
+    }
+}
+
+TEST(BatchSamplingTest, MatchesScalarHemisphereAndSphere)
+{
+    std::vector<double> u0, u1;
+    GenerateInputs(u0, u1);
+    std::vector<double> x(BatchSize), y(BatchSize), z(BatchSize);
+
+    BatchSampling::UniformSampleHemisphere(u0, u1, x, y, z);
+    for (int i = 0; i < BatchSize; ++i)
+    {
+        const Point3 expected = Sampling::UniformSampleHemisphere({ u0[i], u1[i] });
+        EXPECT_NEAR(x[i], expected.x, Tolerance);
+        EXPECT_NEAR(y[i], expected.y, Tolerance);
+        EXPECT_NEAR(z[i], expected.z, Tolerance);
+    }
+
+    BatchSampling::UniformSampleSphere(u0, u1, x, y, z);
+    for (int i = 0; i < BatchSize; ++i)
+    {
+        const Point3 expected = Sampling::UniformSampleSphere({ u0[i], u1[i] });
+        EXPECT_NEAR(x[i], expected.x, Tolerance);
+        EXPECT_NEAR(y[i], expected.y, Tolerance);
+        EXPECT_NEAR(z[i], expected.z, Tolerance);
+    }
+}
+
+TEST(BatchSamplingTest, MatchesScalarDiskAndCosineHemisphere)
+{
+    std::vector<double> u0, u1;
+    GenerateInputs(u0, u1);
+    std::vector<double> x(BatchSize), y(BatchSize), z(BatchSize);
+
+    BatchSampling::ConcentricSampleDisk(u0, u1, x, y);
+    for (int i = 0; i < BatchSize; ++i)
+    {
+        const Point2 expected = Sampling::ConcentricSampleDisk({ u0[i], u1[i] });
+        EXPECT_NEAR(x[i], expected.x, Tolerance);
+        EXPECT_NEAR(y[i], expected.y, Tolerance);
+    }
+
+    BatchSampling::CosineSampleHemisphere(u0, u1, x, y, z);
+    for (int i = 0; i < BatchSize; ++i)
+    {
+        const Point3 expected = Sampling::CosineSampleHemisphere({ u0[i], u1[i] });
+        EXPECT_NEAR(x[i], expected.x, Tolerance);
+        EXPECT_NEAR(y[i], expected.y, Tolerance);
+
+        // z = sqrt(1 - r^2) amplifies tiny errors at the rim, so compare before the square root
+        EXPECT_NEAR(z[i] * z[i], expected.z * expected.z, Tolerance);
+    }
+}
+
+TEST(BatchSamplingTest, ThrowsOnMismatchedSpans)
+{
+    std::vector<double> u(8), v(7), x(8), y(8), z(8);
+    EXPECT_THROW(BatchSampling::UniformSampleSphere(u, v, x, y, z), std::invalid_argument);
+    EXPECT_THROW(BatchSampling::ConcentricSampleDisk(u, u, x, v), std::invalid_argument);
+}
+
@@ -0,0 +1,62 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest.h"
+#include "core/sampling/haltonsampler.h"
+#include "core/sampling/lowdiscrepancy.h"
+
+TEST(HaltonSamplerTest, SamplesStayWithinUnitInterval)
+{
+    HaltonSampler sampler(64);
+
+    for (int i = 0; i < 64; ++i)
+    {
+        sampler.StartPixelSample({ 1, 2 }, i);
+
+        for (int d = 0; d < LowDiscrepancy::NumPrimes + 4; ++d)
+        {
+            const double value = sampler.Get1D();
+            EXPECT_GE(value, 0.0);
+            EXPECT_LT(value, 1.0);
+        }
+    }
+}
+
+TEST(HaltonSamplerTest, PixelsAreDecorrelated)
+{
+    HaltonSampler sampler(16);
+    sampler.StartPixelSample({ 0, 0 }, 3);
+    const Point2 a = sampler.Get2D();
+    sampler.StartPixelSample({ 1, 0 }, 3);
+    const Point2 b = sampler.Get2D();
+    EXPECT_NE(a.x, b.x);
+
+    // Successive samples of a pixel are stratified like the base 2 radical inverse
+    std::vector<int> strata(8, 0);
+    for (int i = 0; i < 8; ++i)
+    {
+        sampler.StartPixelSample({ 4, 4 }, i);
+        strata[(int)(sampler.Get1D() * 8)]++;
+    }
+
+    for (int count : strata)
+        EXPECT_EQ(count, 1);
+}
+
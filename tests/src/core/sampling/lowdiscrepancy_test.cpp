@@ -0,0 +1,78 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest.h"
+#include "core/sampling/lowdiscrepancy.h"
+
+TEST(LowDiscrepancyTest, CanReverseBits)
+{
+    EXPECT_EQ(LowDiscrepancy::ReverseBits32(1), 0x80000000u);
+    EXPECT_EQ(LowDiscrepancy::ReverseBits32(0x0000000f), 0xf0000000u);
+    EXPECT_EQ(LowDiscrepancy::ReverseBits32(LowDiscrepancy::ReverseBits32(0x12345678)), 0x12345678u);
+}
+
+TEST(LowDiscrepancyTest, CanComputeRadicalInverse)
+{
+    EXPECT_DOUBLE_EQ(LowDiscrepancy::RadicalInverse(0, 1), 0.5);
+    EXPECT_DOUBLE_EQ(LowDiscrepancy::RadicalInverse(0, 3), 0.75);
+    EXPECT_DOUBLE_EQ(LowDiscrepancy::RadicalInverse(1, 1), 1.0 / 3.0);
+    EXPECT_DOUBLE_EQ(LowDiscrepancy::RadicalInverse(1, 5), 2.0 / 3.0 + 1.0 / 9.0);
+    EXPECT_THROW(LowDiscrepancy::RadicalInverse(LowDiscrepancy::NumPrimes, 1), std::invalid_argument);
+}
+
+TEST(LowDiscrepancyTest, CanSampleSobol)
+{
+    const double expected[] = { 0.0, 0.5, 0.75, 0.25, 0.625, 0.125, 0.375, 0.875 };
+
+    for (int i = 0; i < 8; ++i)
+    {
+        EXPECT_DOUBLE_EQ(LowDiscrepancy::ToUnitInterval(LowDiscrepancy::SobolSample0(i)), LowDiscrepancy::RadicalInverse(0, i));
+        EXPECT_DOUBLE_EQ(LowDiscrepancy::ToUnitInterval(LowDiscrepancy::SobolSample1(i)), expected[i]);
+    }
+}
+
+TEST(LowDiscrepancyTest, OwenScramblingKeepsStratification)
+{
+    for (uint32_t seed : { 1u, 12345u, 0xdeadbeefu })
+    {
+        std::vector<int> strata(64, 0);
+
+        for (uint32_t i = 0; i < 64; ++i)
+            strata[(int)(LowDiscrepancy::ToUnitInterval(LowDiscrepancy::OwenScramble(LowDiscrepancy::SobolSample0(i), seed)) * 64)]++;
+
+        for (int count : strata)
+            EXPECT_EQ(count, 1);
+    }
+}
+
+TEST(LowDiscrepancyTest, PermutationElementsArePermutations)
+{
+    for (uint32_t length : { 1u, 7u, 16u, 100u })
+    {
+        std::vector<int> counts(length, 0);
+
+        for (uint32_t i = 0; i < length; ++i)
+            counts[LowDiscrepancy::PermutationElement(i, length, 42)]++;
+
+        for (int count : counts)
+            EXPECT_EQ(count, 1);
+    }
+}
+
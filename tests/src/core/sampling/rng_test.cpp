@@ -0,0 +1,93 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest.h"
+#include "core/sampling/rng.h"
+
+TEST(RngTest, IsDeterministic)
+{
+    Rng a(42, 7);
+    Rng b(42, 7);
+
+    for (int i = 0; i < 100; ++i)
+        EXPECT_EQ(a.UniformUInt32(), b.UniformUInt32());
+}
+
+TEST(RngTest, SequencesAreIndependent)
+{
+    Rng a(1);
+    Rng b(2);
+    int numEqual = 0;
+
+    for (int i = 0; i < 100; ++i)
+        numEqual += a.UniformUInt32() == b.UniformUInt32();
+
+    EXPECT_LT(numEqual, 2);
+}
+
+TEST(RngTest, GeneratesUnitInterval)
+{
+    Rng rng;
+    double mean = 0.0;
+
+    for (int i = 0; i < 100000; ++i)
+    {
+        const double value = rng.UniformDouble();
+        EXPECT_GE(value, 0.0);
+        EXPECT_LT(value, 1.0);
+        mean += value / 100000;
+    }
+
+    EXPECT_NEAR(mean, 0.5, 0.01);
+}
+
+TEST(RngTest, CanAdvance)
+{
+    Rng stepped(3);
+    Rng advanced(3);
+
+    for (int i = 0; i < 1000; ++i)
+        stepped.UniformUInt32();
+
+    advanced.Advance(1000);
+    EXPECT_EQ(stepped.UniformUInt32(), advanced.UniformUInt32());
+
+    // Stepping back returns to earlier values
+    const uint32_t value = advanced.UniformUInt32();
+    advanced.Advance(-1);
+    EXPECT_EQ(advanced.UniformUInt32(), value);
+}
+
+TEST(RngTest, PixelSamplesAreReproducible)
+{
+    Rng a, b;
+    a.SetPixelSample({ 10, 20 }, 3);
+    b.SetPixelSample({ 10, 20 }, 3);
+    EXPECT_EQ(a.UniformUInt32(), b.UniformUInt32());
+
+    // Neighboring pixels and samples start on different values
+    b.SetPixelSample({ 11, 20 }, 3);
+    a.SetPixelSample({ 10, 20 }, 3);
+    EXPECT_NE(a.UniformUInt32(), b.UniformUInt32());
+    b.SetPixelSample({ 10, 20 }, 4);
+    a.SetPixelSample({ 10, 20 }, 3);
+    EXPECT_NE(a.UniformUInt32(), b.UniformUInt32());
+}
+
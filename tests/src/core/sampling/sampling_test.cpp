@@ -86,9 +86,11 @@ TEST(SamplingTest, CanSampleHemisphereUniformly)
 
     std::vector<Point3> samples(numSamples);
 
+    Rng rng;
+
     for (int i = 0; i < numSamples; ++i)
     {
-        Point3 sample = Sampling::UniformSampleHemisphere();
+        Point3 sample = Sampling::UniformSampleHemisphere(rng.UniformPoint2());
 
         // Points must be on the surface of the sphere
         EXPECT_LE(std::abs(Point3::Distance(sample, {}) - 1.0), SMath::Epsilon);
@@ -109,9 +111,11 @@ TEST(SamplingTest, CanSampleSphereUniformly)
 
     std::vector<Point3> samples(numSamples);
 
+    Rng rng;
+
     for (int i = 0; i < numSamples; ++i)
     {
-        Point3 sample = Sampling::UniformSampleSphere();
+        Point3 sample = Sampling::UniformSampleSphere(rng.UniformPoint2());
 
         // Points must be on the surface of the sphere
         EXPECT_LE(std::abs(Point3::Distance(sample, {}) - 1.0), SMath::Epsilon);
@@ -129,9 +133,11 @@ TEST(SamplingTest, CanSampleDiskUniformly_RejectionMethod)
 
     std::vector<Point2> samples(numSamples);
 
+    Rng rng;
+
     for (int i = 0; i < numSamples; ++i)
     {
-        Point2 sample = Sampling::RejectionSampleDisk();
+        Point2 sample = Sampling::RejectionSampleDisk(rng);
 
         // Points must be within the disk
         EXPECT_LE(Point2::Distance(sample, {}) - 1.0, 1.0 + SMath::Epsilon);
@@ -149,9 +155,11 @@ TEST(SamplingTest, CanSampleDiskUniformly_ConcentricMethod)
 
     std::vector<Point2> samples(numSamples);
 
+    Rng rng;
+
     for (int i = 0; i < numSamples; ++i)
     {
-        Point2 sample = Sampling::ConcentricSampleDisk();
+        Point2 sample = Sampling::ConcentricSampleDisk(rng.UniformPoint2());
 
         // Points must be within the disk
         EXPECT_LE(Point2::Distance(sample, {}) - 1.0, 1.0 + SMath::Epsilon);
@@ -160,3 +168,28 @@ TEST(SamplingTest, CanSampleDiskUniformly_ConcentricMethod)
 
     CheckUniformity(samples, SMath::Pi);
 }
+
+TEST(SamplingTest, CanSampleHemisphereByCosine)
+{
+    Rng rng(7);
+    double meanCosTheta = 0.0;
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        Point3 sample = Sampling::CosineSampleHemisphere(rng.UniformPoint2());
+        EXPECT_LE(std::abs(Point3::Distance(sample, {}) - 1.0), SMath::Epsilon);
+        EXPECT_GE(sample.z, 0.0);
+        meanCosTheta += sample.z / 10000;
+    }
+
+    // The mean of cos theta under a cosine distribution is 2/3
+    EXPECT_NEAR(meanCosTheta, 2.0 / 3.0, 0.01);
+}
+
+TEST(SamplingTest, SamplesAreDeterministic)
+{
+    const Point2 u(0.25, 0.75);
+    EXPECT_EQ(Point3::Distance(Sampling::UniformSampleSphere(u), Sampling::UniformSampleSphere(u)), 0.0);
+    EXPECT_EQ(Point2::Distance(Sampling::ConcentricSampleDisk({ 0.5, 0.5 }), {}), 0.0);
+    EXPECT_NEAR(Sampling::UniformSampleHemisphere({ 1.0, 0.0 }).y, 1.0, SMath::Epsilon);
+}
@@ -0,0 +1,72 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest.h"
+#include "core/sampling/sobolsampler.h"
+
+TEST(SobolSamplerTest, RequiresPowerOfTwoSampleCount)
+{
+    EXPECT_NO_THROW(SobolSampler(64));
+    EXPECT_THROW(SobolSampler(48), std::invalid_argument);
+    EXPECT_THROW(SobolSampler(0), std::invalid_argument);
+}
+
+TEST(SobolSamplerTest, PixelSamplesFormNets)
+{
+    const int numSamples = 16;
+    SobolSampler sampler(numSamples);
+    std::vector<Point2> samples;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        sampler.StartPixelSample({ 9, 4 }, i);
+        sampler.Get1D();
+        samples.push_back(sampler.Get2D());
+    }
+
+    // Every elementary interval of area 1/16 holds exactly one sample
+    for (int log2X = 0; log2X <= 4; ++log2X)
+    {
+        const int cellsX = 1 << log2X;
+        const int cellsY = numSamples / cellsX;
+        std::vector<int> counts(numSamples, 0);
+
+        for (const Point2& sample : samples)
+            counts[(int)(sample.x * cellsX) + cellsX * (int)(sample.y * cellsY)]++;
+
+        for (int count : counts)
+            EXPECT_EQ(count, 1);
+    }
+}
+
+TEST(SobolSamplerTest, DimensionsAreDecorrelated)
+{
+    SobolSampler sampler(16);
+    sampler.StartPixelSample({ 2, 2 }, 0);
+    const Point2 first = sampler.Get2D();
+    const Point2 second = sampler.Get2D();
+    EXPECT_NE(first.x, second.x);
+    EXPECT_EQ(sampler.GetDimension(), 4);
+
+    std::unique_ptr<Sampler> clone = sampler.Clone();
+    clone->StartPixelSample({ 2, 2 }, 0);
+    EXPECT_EQ(clone->Get2D().x, first.x);
+}
+
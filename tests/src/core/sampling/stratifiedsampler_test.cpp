@@ -0,0 +1,66 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest.h"
+#include "core/sampling/stratifiedsampler.h"
+
+TEST(StratifiedSamplerTest, CanBeCreated)
+{
+    StratifiedSampler sampler(4, 2);
+    EXPECT_EQ(sampler.GetSamplesPerPixel(), 8);
+    EXPECT_TRUE(sampler.IsJittered());
+    EXPECT_THROW(StratifiedSampler(0, 4), std::invalid_argument);
+}
+
+TEST(StratifiedSamplerTest, SamplesEveryStratumOnce)
+{
+    StratifiedSampler sampler(4, 4);
+    std::vector<int> strata2D(16, 0);
+    std::vector<int> strata1D(16, 0);
+
+    for (int i = 0; i < 16; ++i)
+    {
+        sampler.StartPixelSample({ 3, 5 }, i);
+        const double u = sampler.Get1D();
+        const Point2 uv = sampler.Get2D();
+        EXPECT_EQ(sampler.GetDimension(), 3);
+
+        strata1D[(int)(u * 16)]++;
+        strata2D[(int)(uv.x * 4) + 4 * (int)(uv.y * 4)]++;
+    }
+
+    for (int i = 0; i < 16; ++i)
+    {
+        EXPECT_EQ(strata1D[i], 1);
+        EXPECT_EQ(strata2D[i], 1);
+    }
+}
+
+TEST(StratifiedSamplerTest, IsDeterministic)
+{
+    StratifiedSampler sampler(4, 4);
+    std::unique_ptr<Sampler> clone = sampler.Clone();
+
+    sampler.StartPixelSample({ 7, 1 }, 5);
+    clone->StartPixelSample({ 7, 1 }, 5);
+    EXPECT_EQ(sampler.Get1D(), clone->Get1D());
+    EXPECT_EQ(sampler.GetPixel2D().x, clone->GetPixel2D().x);
+}
+
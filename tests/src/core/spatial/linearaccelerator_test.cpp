@@ -0,0 +1,115 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest.h"
+#include "core/spatial/linearaccelerator.h"
+#include "core/geometry/trianglemesh.h"
+
+namespace
+{
+    // Unit square in the xy plane at the given depth, facing the negative z axis
+    void CreateQuad(TriangleMesh& mesh, double z, double halfSize = 0.5)
+    {
+        TriangleMesh::Vertex vertices[4];
+        vertices[0] = { .m_Position = { -halfSize, -halfSize, z }, .m_Normal = { 0, 0, -1 } };
+        vertices[1] = { .m_Position = { halfSize, -halfSize, z }, .m_Normal = { 0, 0, -1 } };
+        vertices[2] = { .m_Position = { halfSize, halfSize, z }, .m_Normal = { 0, 0, -1 } };
+        vertices[3] = { .m_Position = { -halfSize, halfSize, z }, .m_Normal = { 0, 0, -1 } };
+        mesh.SetVertices(vertices, 4);
+
+        TrianglePrimitive faces[2] = { { &mesh, 0, 1, 2 }, { &mesh, 0, 2, 3 } };
+        mesh.SetFaces(faces, 2);
+    }
+}
+
+TEST(LinearAcceleratorTest, CanBeCreated)
+{
+    LinearAccelerator accelerator;
+    EXPECT_EQ(accelerator.GetNumPrimitives(), 0);
+    EXPECT_FALSE(accelerator.Intersect(Ray({ 0, 0, 0 }, { 0, 0, 1 }), 0.0));
+}
+
+TEST(LinearAcceleratorTest, ThrowsOnNullGeometry)
+{
+    LinearAccelerator accelerator;
+    EXPECT_THROW(accelerator.Build({ nullptr }), std::invalid_argument);
+}
+
+TEST(LinearAcceleratorTest, FindsClosestHit)
+{
+    TriangleMesh near, far;
+    CreateQuad(near, 2.0);
+    CreateQuad(far, 5.0);
+
+    LinearAccelerator accelerator;
+    accelerator.Build({ &far, &near });
+    EXPECT_EQ(accelerator.GetNumPrimitives(), 4);
+
+    double tHit;
+    SurfaceInteraction surface;
+    ASSERT_TRUE(accelerator.Intersect(Ray({ 0.1, 0.2, 0 }, { 0, 0, 1 }), 0.0, &tHit, &surface));
+    EXPECT_DOUBLE_EQ(tHit, 2.0);
+    EXPECT_EQ(surface.m_Point, Point3(0.1, 0.2, 2.0));
+
+    EXPECT_TRUE(accelerator.Intersect(Ray({ 0.1, 0.2, 0 }, { 0, 0, 1 }), 0.0));
+    EXPECT_FALSE(accelerator.Intersect(Ray({ 0.1, 0.2, 0 }, { 0, 0, 1 }, 1.0), 0.0));
+    EXPECT_FALSE(accelerator.Intersect(Ray({ 2.0, 0.2, 0 }, { 0, 0, 1 }), 0.0, &tHit, &surface));
+}
+
+TEST(LinearAcceleratorTest, IntersectsTransformedGeometry)
+{
+    TriangleMesh mesh;
+    CreateQuad(mesh, 0.0);
+    mesh.SetTransform(Transform::GetTranslationMatrix({ 10, 0, 4 }) * Transform::GetScaleMatrix({ 2, 2, 2 }));
+
+    LinearAccelerator accelerator;
+    accelerator.Build({ &mesh });
+
+    double tHit;
+    SurfaceInteraction surface;
+    ASSERT_TRUE(accelerator.Intersect(Ray({ 10.8, 0, 0 }, { 0, 0, 1 }), 0.0, &tHit, &surface));
+    EXPECT_DOUBLE_EQ(tHit, 4.0);
+    EXPECT_EQ(surface.m_Point, Point3(10.8, 0, 4));
+    EXPECT_EQ(surface.m_Normal, Normal3(0, 0, -1));
+    EXPECT_FALSE(accelerator.Intersect(Ray({ 0, 0, 0 }, { 0, 0, 1 }), 0.0));
+}
+
+TEST(LinearAcceleratorTest, IntersectsMovingGeometryAtRayTime)
+{
+    TriangleMesh mesh;
+    CreateQuad(mesh, 3.0);
+    mesh.SetAnimatedTransform(AnimatedTransform(
+        Transform::GetTranslationMatrix({ 0, 0, 0 }), 0.0,
+        Transform::GetTranslationMatrix({ 4, 0, 0 }), 1.0));
+
+    LinearAccelerator accelerator;
+    accelerator.Build({ &mesh });
+
+    const Ray ray({ 2, 0, 0 }, { 0, 0, 1 });
+    EXPECT_FALSE(accelerator.Intersect(ray, 0.0));
+    EXPECT_TRUE(accelerator.Intersect(ray, 0.5));
+    EXPECT_FALSE(accelerator.Intersect(ray, 1.0));
+
+    double tHit;
+    SurfaceInteraction surface;
+    ASSERT_TRUE(accelerator.Intersect(ray, 0.5, &tHit, &surface));
+    EXPECT_EQ(surface.m_Point, Point3(2, 0, 3));
+}
+
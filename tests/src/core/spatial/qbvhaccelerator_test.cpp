@@ -0,0 +1,194 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest.h"
+#include <random>
+#include "core/spatial/qbvhaccelerator.h"
+#include "core/spatial/linearaccelerator.h"
+#include "core/geometry/trianglemesh.h"
+
+namespace
+{
+    // Unit square in the xy plane at the given depth, facing the negative z axis
+    void CreateQuad(TriangleMesh& mesh, double z, double halfSize = 0.5)
+    {
+        TriangleMesh::Vertex vertices[4];
+        vertices[0] = { .m_Position = { -halfSize, -halfSize, z }, .m_Normal = { 0, 0, -1 } };
+        vertices[1] = { .m_Position = { halfSize, -halfSize, z }, .m_Normal = { 0, 0, -1 } };
+        vertices[2] = { .m_Position = { halfSize, halfSize, z }, .m_Normal = { 0, 0, -1 } };
+        vertices[3] = { .m_Position = { -halfSize, halfSize, z }, .m_Normal = { 0, 0, -1 } };
+        mesh.SetVertices(vertices, 4);
+
+        TrianglePrimitive faces[2] = { { &mesh, 0, 1, 2 }, { &mesh, 0, 2, 3 } };
+        mesh.SetFaces(faces, 2);
+    }
+
+    // Randomly placed and oriented triangles in a unit cube around the origin
+    void CreateTriangleSoup(TriangleMesh& mesh, int numTriangles, std::mt19937& rng)
+    {
+        std::uniform_real_distribution<double> position(-1.0, 1.0);
+        std::uniform_real_distribution<double> offset(-0.1, 0.1);
+        std::vector<TriangleMesh::Vertex> vertices;
+
+        for (int i = 0; i < numTriangles; ++i)
+        {
+            const Point3 center(position(rng), position(rng), position(rng));
+
+            for (int j = 0; j < 3; ++j)
+                vertices.push_back({ .m_Position = center + Vector3(offset(rng), offset(rng), offset(rng)), .m_Normal = { 0, 0, -1 } });
+        }
+
+        mesh.SetVertices(vertices.data(), (uint32_t)vertices.size());
+
+        std::vector<TrianglePrimitive> faces;
+        for (uint32_t i = 0; i < (uint32_t)numTriangles; ++i)
+            faces.emplace_back(&mesh, 3 * i, 3 * i + 1, 3 * i + 2);
+
+        mesh.SetFaces(faces.data(), (uint32_t)faces.size());
+    }
+}
+
+TEST(QBvhAcceleratorTest, CanBeCreated)
+{
+    QBvhAccelerator accelerator;
+    EXPECT_EQ(accelerator.GetNumPrimitives(), 0);
+    EXPECT_FALSE(accelerator.Intersect(Ray({ 0, 0, 0 }, { 0, 0, 1 }), 0.0));
+
+    accelerator.Build({});
+    EXPECT_FALSE(accelerator.Intersect(Ray({ 0, 0, 0 }, { 0, 0, 1 }), 0.0));
+}
+
+TEST(QBvhAcceleratorTest, ThrowsOnNullGeometry)
+{
+    QBvhAccelerator accelerator;
+    EXPECT_THROW(accelerator.Build({ nullptr }), std::invalid_argument);
+}
+
+TEST(QBvhAcceleratorTest, FindsClosestHit)
+{
+    TriangleMesh near, far;
+    CreateQuad(near, 2.0);
+    CreateQuad(far, 5.0);
+
+    QBvhAccelerator accelerator;
+    accelerator.Build({ &far, &near });
+    EXPECT_EQ(accelerator.GetNumPrimitives(), 4);
+
+    double tHit;
+    SurfaceInteraction surface;
+    ASSERT_TRUE(accelerator.Intersect(Ray({ 0.1, 0.2, 0 }, { 0, 0, 1 }), 0.0, &tHit, &surface));
+    EXPECT_DOUBLE_EQ(tHit, 2.0);
+    EXPECT_EQ(surface.m_Point, Point3(0.1, 0.2, 2.0));
+
+    EXPECT_TRUE(accelerator.Intersect(Ray({ 0.1, 0.2, 0 }, { 0, 0, 1 }), 0.0));
+    EXPECT_FALSE(accelerator.Intersect(Ray({ 0.1, 0.2, 0 }, { 0, 0, 1 }, 1.0), 0.0));
+    EXPECT_FALSE(accelerator.Intersect(Ray({ 2.0, 0.2, 0 }, { 0, 0, 1 }), 0.0, &tHit, &surface));
+}
+
+TEST(QBvhAcceleratorTest, IntersectsTransformedGeometry)
+{
+    TriangleMesh mesh;
+    CreateQuad(mesh, 0.0);
+    mesh.SetTransform(Transform::GetTranslationMatrix({ 10, 0, 4 }) * Transform::GetScaleMatrix({ 2, 2, 2 }));
+
+    QBvhAccelerator accelerator;
+    accelerator.Build({ &mesh });
+
+    double tHit;
+    SurfaceInteraction surface;
+    ASSERT_TRUE(accelerator.Intersect(Ray({ 10.8, 0, 0 }, { 0, 0, 1 }), 0.0, &tHit, &surface));
+    EXPECT_DOUBLE_EQ(tHit, 4.0);
+    EXPECT_EQ(surface.m_Point, Point3(10.8, 0, 4));
+    EXPECT_EQ(surface.m_Normal, Normal3(0, 0, -1));
+    EXPECT_FALSE(accelerator.Intersect(Ray({ 0, 0, 0 }, { 0, 0, 1 }), 0.0));
+}
+
+TEST(QBvhAcceleratorTest, IntersectsMovingGeometryAtRayTime)
+{
+    TriangleMesh mesh;
+    CreateQuad(mesh, 3.0);
+    mesh.SetAnimatedTransform(AnimatedTransform(
+        Transform::GetTranslationMatrix({ 0, 0, 0 }), 0.0,
+        Transform::GetTranslationMatrix({ 4, 0, 0 }), 1.0));
+
+    QBvhAccelerator accelerator;
+    accelerator.Build({ &mesh });
+
+    const Ray ray({ 2, 0, 0 }, { 0, 0, 1 });
+    EXPECT_FALSE(accelerator.Intersect(ray, 0.0));
+    EXPECT_TRUE(accelerator.Intersect(ray, 0.5));
+    EXPECT_FALSE(accelerator.Intersect(ray, 1.0));
+
+    double tHit;
+    SurfaceInteraction surface;
+    ASSERT_TRUE(accelerator.Intersect(ray, 0.5, &tHit, &surface));
+    EXPECT_EQ(surface.m_Point, Point3(2, 0, 3));
+}
+
+TEST(QBvhAcceleratorTest, MatchesLinearAccelerator)
+{
+    std::mt19937 rng(7);
+    TriangleMesh still, placed, moving;
+    CreateTriangleSoup(still, 500, rng);
+    CreateTriangleSoup(placed, 300, rng);
+    CreateTriangleSoup(moving, 300, rng);
+    placed.SetTransform(Transform::GetTranslationMatrix({ 1.5, 0, 0 }) * Transform::GetRotationMatrix({ 0.3, 0.2, 0.1 }));
+    moving.SetAnimatedTransform(AnimatedTransform(
+        Transform::GetTranslationMatrix({ -1, 0, 0 }), 0.0,
+        Transform::GetTranslationMatrix({ 0, 1, 0 }) * Transform::GetRotationMatrix({ 0, 1.5, 0 }) * Transform::GetScaleMatrix({ 1.5, 1, 1 }), 1.0));
+
+    QBvhAccelerator qbvh;
+    LinearAccelerator linear;
+    qbvh.Build({ &still, &placed, &moving });
+    linear.Build({ &still, &placed, &moving });
+    EXPECT_EQ(qbvh.GetNumPrimitives(), linear.GetNumPrimitives());
+    EXPECT_GT(qbvh.GetNumNodes(), 3);
+
+    std::uniform_real_distribution<double> position(-2.0, 2.0);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    int numHits = 0;
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        const Point3 origin(position(rng), position(rng), -4.0);
+        const Point3 target(position(rng), position(rng), 2.0);
+        const Ray ray(origin, target - origin, i % 4 == 0 ? 5.0 : std::numeric_limits<double>::infinity());
+        const double time = unit(rng);
+
+        double qbvhHit, linearHit;
+        SurfaceInteraction qbvhSurface, linearSurface;
+        const bool isHit = linear.Intersect(ray, time, &linearHit, &linearSurface);
+        ASSERT_EQ(qbvh.Intersect(ray, time, &qbvhHit, &qbvhSurface), isHit);
+        ASSERT_EQ(qbvh.Intersect(ray, time), isHit);
+
+        if (isHit)
+        {
+            EXPECT_DOUBLE_EQ(qbvhHit, linearHit);
+            EXPECT_EQ(qbvhSurface.m_Primitive, linearSurface.m_Primitive);
+            EXPECT_EQ(qbvhSurface.m_Normal, linearSurface.m_Normal);
+            ++numHits;
+        }
+    }
+
+    // Rays both hit and miss the scene
+    EXPECT_GT(numHits, 200);
+    EXPECT_LT(numHits, 1800);
+}
+
@@ -0,0 +1,314 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest.h"
+#include "exporter/hdrexporter.h"
+#include "core/spectrum/sampledspectrum.h"
+#include "system/compression/zlib.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+// The implementation is compiled into the library, see system/compression/zlib.cpp
+#include "stb/stb_image.h"
+
+namespace
+{
+    void FillGradient(Film& film, int width, int height)
+    {
+        Resolution resolution;
+        resolution.SetWidth(width);
+        resolution.SetHeight(height);
+
+        film.SetResolution(resolution);
+        film.SetTileSize(16);
+
+        for (int y = 0; y < height; ++y)
+            for (int x = 0; x < width; ++x)
+                film.GetTile({ x, y }).SplatPixel(film.GetTile({ x, y }).FilmToTileSpace({ x, y }), { 4.0 * x / width, 0.5, 2.0 * y / height }, 1.0);
+    }
+
+    std::vector<char> ReadFile(const std::string& path)
+    {
+        std::ifstream stream(path, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    }
+}
+
+TEST(HdrExporterTest, CanBeCreated)
+{
+    ASSERT_NO_THROW(HdrExporter exporter);
+}
+
+TEST(HdrExporterTest, HasDefaultOutputName)
+{
+    HdrExporter exporter;
+    EXPECT_EQ(exporter.GetOutputName(), "Spectre_Output");
+    EXPECT_EQ(exporter.GetFormat(), HdrFormat::Exr);
+}
+
+TEST(HdrExporterTest, MatchesFileExtensionToFormat)
+{
+    HdrExporter exporter(HdrFormat::Pfm);
+    EXPECT_EQ(exporter.GetFileExtension(), ".pfm");
+    exporter.SetFormat(HdrFormat::Radiance);
+    EXPECT_EQ(exporter.GetFileExtension(), ".hdr");
+    exporter.SetFormat(HdrFormat::Exr);
+    EXPECT_EQ(exporter.GetFileExtension(), ".exr");
+}
+
+TEST(HdrExporterTest, ExtractsLinearRgb)
+{
+    Film film;
+    FillGradient(film, 40, 20);
+
+    HdrExporter exporter;
+    exporter.SetNumThreads(4);
+    std::vector<float> data = exporter.ExtractPixelData(film);
+    ASSERT_EQ(data.size(), 40 * 20 * 3);
+
+    // Values above one are kept as they are
+    for (int y = 0; y < 20; ++y)
+    {
+        for (int x = 0; x < 40; ++x)
+        {
+            RgbCoefficients rgb = SampledSpectrum::XyzToRgb({ 4.0 * x / 40, 0.5, 2.0 * y / 20 });
+
+            for (int c = 0; c < 3; ++c)
+                EXPECT_NEAR(data[(y * 40 + x) * 3 + c], rgb[c], 1e-5);
+        }
+    }
+}
+
+TEST(HdrExporterTest, EncodesRgbe)
+{
+    unsigned char rgbe[4];
+    const float black[3] = { 0.0f, 0.0f, 0.0f };
+    HdrExporter::EncodeRgbe(black, rgbe);
+    EXPECT_EQ(rgbe[3], 0);
+
+    const float rgb[3] = { 1.0f, 0.5f, -1.0f };
+    HdrExporter::EncodeRgbe(rgb, rgbe);
+    EXPECT_EQ(rgbe[0], 128);
+    EXPECT_EQ(rgbe[1], 64);
+    EXPECT_EQ(rgbe[2], 0);
+    EXPECT_EQ(rgbe[3], 129);
+}
+
+TEST(HdrExporterTest, RunLengthEncodesScanlines)
+{
+    // Long runs of a single color collapse into a few bytes
+    std::vector<float> rgb(300 * 3, 2.0f);
+    std::vector<char> scanline;
+    HdrExporter::EncodeRadianceScanline(rgb.data(), 300, scanline);
+    EXPECT_LT(scanline.size(), 40);
+    EXPECT_EQ(scanline[0], 2);
+    EXPECT_EQ(scanline[1], 2);
+
+    // Scanlines outside the encodable range are written flat
+    scanline.clear();
+    HdrExporter::EncodeRadianceScanline(rgb.data(), 4, scanline);
+    EXPECT_EQ(scanline.size(), 16);
+}
+
+TEST(HdrExporterTest, ExportsRadiance)
+{
+    Film film;
+    FillGradient(film, 70, 30);
+
+    HdrExporter exporter(HdrFormat::Radiance);
+    exporter.SetOutputName("Spectre_HdrTest");
+    ASSERT_NO_THROW(exporter.Export(film));
+
+    std::vector<char> file = ReadFile("Spectre_HdrTest.hdr");
+    int width, height, channels;
+    float* pixels = stbi_loadf_from_memory((const stbi_uc*)file.data(), (int)file.size(), &width, &height, &channels, 3);
+    ASSERT_NE(pixels, nullptr);
+    EXPECT_EQ(width, 70);
+    EXPECT_EQ(height, 30);
+
+    // Components share an exponent, so precision is relative to the brightest component of each pixel
+    std::vector<float> expected = exporter.ExtractPixelData(film);
+    for (size_t i = 0; i < expected.size(); i += 3)
+    {
+        const float maxComponent = std::max({ expected[i], expected[i + 1], expected[i + 2] });
+
+        for (int c = 0; c < 3; ++c)
+            EXPECT_NEAR(pixels[i + c], std::max(expected[i + c], 0.0f), maxComponent / 128.0f);
+    }
+
+    stbi_image_free(pixels);
+    std::filesystem::remove("Spectre_HdrTest.hdr");
+}
+
+TEST(HdrExporterTest, ExportsPfm)
+{
+    Film film;
+    FillGradient(film, 20, 10);
+
+    HdrExporter exporter(HdrFormat::Pfm);
+    exporter.SetOutputName("Spectre_HdrTest");
+    ASSERT_NO_THROW(exporter.Export(film));
+
+    std::vector<char> file = ReadFile("Spectre_HdrTest.pfm");
+    const std::string header = "PF\n20 10\n-1.0\n";
+    ASSERT_EQ(file.size(), header.size() + 20 * 10 * 3 * sizeof(float));
+    EXPECT_EQ(std::string(file.begin(), file.begin() + header.size()), header);
+
+    // The first stored scanline is the bottom of the image
+    std::vector<float> expected = exporter.ExtractPixelData(film);
+    std::vector<float> stored(20 * 10 * 3);
+    std::memcpy(stored.data(), file.data() + header.size(), stored.size() * sizeof(float));
+
+    for (int y = 0; y < 10; ++y)
+        for (int i = 0; i < 20 * 3; ++i)
+            EXPECT_EQ(stored[(9 - y) * 20 * 3 + i], expected[y * 20 * 3 + i]);
+
+    std::filesystem::remove("Spectre_HdrTest.pfm");
+}
+
+TEST(HdrExporterTest, ExrBlocksRoundTrip)
+{
+    const int width = 37;
+    const int numScanlines = 5;
+
+    std::vector<float> rgb(width * (numScanlines + 1) * 3);
+    for (size_t i = 0; i < rgb.size(); ++i)
+        rgb[i] = (float)(i % 17) * 0.25f;
+
+    std::vector<HdrExporter::ExrChannel> channels = { { "B", rgb.data() + 2, 3 }, { "G", rgb.data() + 1, 3 }, { "R", rgb.data(), 3 } };
+    std::vector<char> block = HdrExporter::EncodeExrBlock(channels, width, 1, numScanlines);
+    const int rawSize = width * numScanlines * 3 * sizeof(float);
+    ASSERT_LT(block.size(), rawSize);
+
+    std::vector<char> decoded = Zlib::Decompress(block.data(), block.size());
+    ASSERT_EQ(decoded.size(), rawSize);
+
+    // Undo the predictor and the byte split
+    std::vector<unsigned char> predicted(decoded.begin(), decoded.end());
+
+    for (int i = 1; i < rawSize; ++i)
+        predicted[i] = (unsigned char)(predicted[i - 1] + predicted[i] - 128);
+
+    std::vector<unsigned char> raw(rawSize);
+    const int half = (rawSize + 1) / 2;
+    for (int i = 0; i < rawSize; ++i)
+        raw[i] = predicted[(i & 1) ? half + i / 2 : i / 2];
+
+    std::vector<float> planar(width * numScanlines * 3);
+    std::memcpy(planar.data(), raw.data(), rawSize);
+
+    // Channels come back as B, G, R planes per scanline, starting at the first requested scanline
+    for (int y = 0; y < numScanlines; ++y)
+        for (int c = 0; c < 3; ++c)
+            for (int x = 0; x < width; ++x)
+                EXPECT_EQ(planar[(y * 3 + c) * width + x], rgb[((y + 1) * width + x) * 3 + (2 - c)]);
+}
+
+TEST(HdrExporterTest, ExtractsAovs)
+{
+    Film film;
+    FillGradient(film, 40, 20);
+    film.EnableAovs(Aov::Depth | Aov::Normal);
+
+    for (int y = 0; y < 20; ++y)
+        for (int x = 0; x < 40; ++x)
+            film.GetTile({ x, y }).AddAovSample(film.GetTile({ x, y }).FilmToTileSpace({ x, y }), { (double)x, Normal3(0.0, 0.0, (double)y), RgbCoefficients(0.0) });
+
+    HdrExporter exporter;
+    std::vector<float> depth = exporter.ExtractAovData(film, AovType::Depth);
+    std::vector<float> normals = exporter.ExtractAovData(film, AovType::Normal);
+    ASSERT_EQ(depth.size(), 40 * 20);
+    ASSERT_EQ(normals.size(), 40 * 20 * 3);
+
+    for (int y = 0; y < 20; ++y)
+    {
+        for (int x = 0; x < 40; ++x)
+        {
+            EXPECT_FLOAT_EQ(depth[y * 40 + x], x);
+            EXPECT_FLOAT_EQ(normals[(y * 40 + x) * 3 + 2], y);
+        }
+    }
+
+    EXPECT_EQ(HdrExporter::GetAovChannelNames(AovType::Normal), std::vector<std::string>({ "normal.X", "normal.Y", "normal.Z" }));
+    EXPECT_EQ(HdrExporter::GetAovChannelNames(AovType::Depth), std::vector<std::string>({ "depth" }));
+}
+
+TEST(HdrExporterTest, ExportsAovs)
+{
+    Film film;
+    FillGradient(film, 20, 10);
+    film.EnableAovs(Aov::Albedo | Aov::SampleCount);
+
+    HdrExporter exporter(HdrFormat::Exr);
+    exporter.SetOutputName("Spectre_HdrTest");
+    ASSERT_NO_THROW(exporter.Export(film));
+
+    // Every AOV component becomes an EXR channel
+    std::vector<char> file = ReadFile("Spectre_HdrTest.exr");
+    for (const std::string& name : { "albedo.R", "albedo.G", "albedo.B", "sampleCount" })
+        EXPECT_NE(std::search(file.begin(), file.end(), name.begin(), name.end()), file.end());
+
+    // Other formats write AOVs next to the image
+    exporter.SetFormat(HdrFormat::Pfm);
+    ASSERT_NO_THROW(exporter.Export(film));
+    EXPECT_TRUE(std::filesystem::exists("Spectre_HdrTest.albedo.pfm"));
+    file = ReadFile("Spectre_HdrTest.sampleCount.pfm");
+    EXPECT_EQ(std::string(file.begin(), file.begin() + 3), "Pf\n");
+
+    for (const char* path : { "Spectre_HdrTest.exr", "Spectre_HdrTest.pfm", "Spectre_HdrTest.albedo.pfm", "Spectre_HdrTest.sampleCount.pfm" })
+        std::filesystem::remove(path);
+}
+
+TEST(HdrExporterTest, ExportsExr)
+{
+    Film film;
+    FillGradient(film, 50, 40);
+
+    HdrExporter exporter(HdrFormat::Exr);
+    exporter.SetOutputName("Spectre_HdrTest");
+    ASSERT_NO_THROW(exporter.Export(film));
+
+    std::vector<char> file = ReadFile("Spectre_HdrTest.exr");
+    ASSERT_GT(file.size(), 8);
+
+    int32_t magic, version;
+    std::memcpy(&magic, file.data(), 4);
+    std::memcpy(&version, file.data() + 4, 4);
+    EXPECT_EQ(magic, 20000630);
+    EXPECT_EQ(version, 2);
+
+    // The header ends right before the offset table, whose first entry points past the table
+    const std::string headerEnd = std::string("screenWindowWidth\0float\0", 24);
+    auto position = std::search(file.begin(), file.end(), headerEnd.begin(), headerEnd.end());
+    ASSERT_NE(position, file.end());
+    const size_t tableOffset = (position - file.begin()) + headerEnd.size() + 4 + 4 + 1;
+
+    uint64_t firstChunk;
+    std::memcpy(&firstChunk, file.data() + tableOffset, sizeof(uint64_t));
+    EXPECT_EQ(firstChunk, tableOffset + 3 * sizeof(uint64_t));
+
+    int32_t firstScanline;
+    std::memcpy(&firstScanline, file.data() + firstChunk, sizeof(int32_t));
+    EXPECT_EQ(firstScanline, 0);
+
+    std::filesystem::remove("Spectre_HdrTest.exr");
+}
+
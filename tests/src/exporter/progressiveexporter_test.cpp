@@ -0,0 +1,100 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest.h"
+#include "exporter/progressiveexporter.h"
+#include "core/film/standardresolution.h"
+
+namespace
+{
+    class RecordingExporter : public Exporter
+    {
+    public:
+        void Export(const Film& film) const override
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_LastSplat = film.GetTile(0).GetFilmSpacePixel({ 0, 0 }).m_TotalSplat;
+        }
+
+        double GetLastSplat() const
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            return m_LastSplat;
+        }
+
+    private:
+        mutable std::mutex m_Mutex;
+        mutable double m_LastSplat = -1.0;
+    };
+
+    class FailingExporter : public Exporter
+    {
+    public:
+        void Export(const Film& film) const override { throw std::runtime_error("Export failed"); }
+    };
+}
+
+TEST(ProgressiveExporterTest, RequiresExporter)
+{
+    EXPECT_THROW(ProgressiveExporter(nullptr), std::invalid_argument);
+    EXPECT_THROW(ProgressiveExporter(std::make_shared<RecordingExporter>(), std::chrono::milliseconds(0)), std::invalid_argument);
+}
+
+TEST(ProgressiveExporterTest, ExportsPublishedTilesInBackground)
+{
+    Film film;
+    film.SetResolution(Resolution640X360());
+
+    std::shared_ptr<RecordingExporter> exporter = std::make_shared<RecordingExporter>();
+    ProgressiveExporter progressive(exporter, std::chrono::milliseconds(1));
+    EXPECT_FALSE(film.HasSnapshots());
+    progressive.Start(film);
+    EXPECT_TRUE(progressive.IsRunning());
+    EXPECT_TRUE(film.HasSnapshots());
+    EXPECT_THROW(progressive.Start(film), std::runtime_error);
+
+    // Rendering continues while snapshots are exported
+    for (int i = 0; i < 100; ++i)
+    {
+        film.GetTile(0).SplatPixel({ 0, 0 }, { 1.0, 1.0, 1.0 }, 0.01);
+        film.PublishTile(0);
+        progressive.RequestExport();
+    }
+
+    progressive.Stop();
+    EXPECT_FALSE(progressive.IsRunning());
+    EXPECT_FALSE(film.HasSnapshots());
+    EXPECT_GE(progressive.GetNumExports(), 1);
+
+    // Stopping always writes the final state
+    EXPECT_NEAR(exporter->GetLastSplat(), 1.0, 1e-5);
+}
+
+TEST(ProgressiveExporterTest, ReportsExportErrorsOnStop)
+{
+    Film film;
+    film.SetResolution(Resolution640X360());
+
+    ProgressiveExporter progressive(std::make_shared<FailingExporter>(), std::chrono::milliseconds(1));
+    progressive.Start(film);
+    EXPECT_THROW(progressive.Stop(), std::runtime_error);
+    EXPECT_EQ(progressive.GetNumExports(), 0);
+}
+
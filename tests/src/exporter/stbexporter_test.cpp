@@ -20,6 +20,7 @@
 
 #include "gtest.h"
 #include "exporter/stbexporter.h"
+#include "core/spectrum/sampledspectrum.h"
 #include <filesystem>
 
 TEST(StbExporterTest, CanBeCreated)
@@ -48,3 +49,42 @@ TEST(ExporterTest, FilmCanBeExported)
     EXPECT_TRUE(std::filesystem::exists(exporter.GetOutputName() + ".png"));
 }
 
+TEST(StbExporterTest, ExtractsTilesInParallel)
+{
+    Resolution resolution;
+    resolution.SetWidth(150);
+    resolution.SetHeight(100);
+
+    const PixelLayout layouts[] = { PixelLayout::RowMajor, PixelLayout::Morton };
+
+    for (PixelLayout layout : layouts)
+    {
+        Film film;
+        film.SetResolution(resolution);
+        film.SetTileSize(32);
+        film.SetPixelLayout(layout);
+
+        // Leave the last column empty
+        for (int y = 0; y < 100; ++y)
+            for (int x = 0; x < 149; ++x)
+                film.GetTile({ x, y }).SplatPixel(film.GetTile({ x, y }).FilmToTileSpace({ x, y }), { x / 150.0, y / 100.0, 0.3 }, 0.5);
+
+        StbExporter exporter;
+        exporter.SetNumThreads(4);
+        EXPECT_EQ(exporter.GetNumThreads(), 4);
+        std::vector<char> data = exporter.ExtractPixelData(film);
+        ASSERT_EQ(data.size(), 150 * 100 * 3);
+
+        for (int y = 0; y < 100; ++y)
+        {
+            for (int x = 0; x < 150; ++x)
+            {
+                RgbCoefficients rgb = x < 149 ? SampledSpectrum::XyzToRgb({ x / 150.0, y / 100.0, 0.3 }) : RgbCoefficients(0.0);
+
+                for (int c = 0; c < 3; ++c)
+                    EXPECT_EQ(data[(y * 150 + x) * 3 + c], (char)std::clamp(rgb[c] * 255.0, 0.0, 255.0));
+            }
+        }
+    }
+}
+
@@ -0,0 +1,87 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest.h"
+#include "system/network/socket.h"
+#include <thread>
+
+TEST(SocketTest, CanSendOverUnixSockets)
+{
+    Socket listener = Socket::Listen("unix:SocketTest.sock");
+    ASSERT_TRUE(listener.IsOpen());
+
+    std::thread client([]()
+    {
+        Socket socket = Socket::Connect("unix:SocketTest.sock");
+        const int value = 42;
+        socket.Send(&value, sizeof(value));
+    });
+
+    Socket connection = listener.Accept();
+    int value = 0;
+    EXPECT_TRUE(connection.Receive(&value, sizeof(value)));
+    EXPECT_EQ(value, 42);
+    client.join();
+
+    // The client has closed its end
+    EXPECT_FALSE(connection.Receive(&value, sizeof(value)));
+}
+
+TEST(SocketTest, CanSendOverTcp)
+{
+    Socket listener = Socket::Listen("127.0.0.1:0");
+    const int port = listener.GetPort();
+    EXPECT_GT(port, 0);
+
+    std::thread client([port]()
+    {
+        Socket socket = Socket::Connect("127.0.0.1:" + std::to_string(port));
+        std::vector<char> data(1 << 20, 'x');
+        socket.Send(data.data(), data.size());
+    });
+
+    EXPECT_TRUE(listener.WaitReadable(5000));
+    Socket connection = listener.Accept();
+    std::vector<char> data(1 << 20);
+    EXPECT_TRUE(connection.Receive(data.data(), data.size()));
+    EXPECT_EQ(std::count(data.begin(), data.end(), 'x'), 1 << 20);
+    client.join();
+}
+
+TEST(SocketTest, ReportsConnectionErrors)
+{
+    EXPECT_THROW(Socket::Listen("localhost"), std::invalid_argument);
+    EXPECT_THROW(Socket::Connect("unix:SocketTest.missing"), std::runtime_error);
+
+    Socket listener = Socket::Listen("unix:SocketTest.sock");
+    std::thread client([]() { Socket socket = Socket::Connect("unix:SocketTest.sock"); socket.Send("ab", 2); });
+    Socket connection = listener.Accept();
+    client.join();
+
+    // A message cut short is an error, and so is waiting for longer than the timeout
+    char data[4];
+    EXPECT_THROW(connection.Receive(data, sizeof(data)), std::runtime_error);
+
+    Socket idle = Socket::Connect("unix:SocketTest.sock");
+    Socket idleConnection = listener.Accept();
+    idleConnection.SetReceiveTimeout(0.05);
+    EXPECT_THROW(idleConnection.Receive(data, sizeof(data)), std::runtime_error);
+}
+
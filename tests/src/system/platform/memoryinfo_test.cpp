@@ -0,0 +1,34 @@
+/*
+    This file is part of Spectre, an open-source physically based
+    spectral raytracing library.
+
+    Copyright (c) 2020-2023 Samuel Van Allen - All rights reserved.
+
+    Spectre is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest.h"
+#include "system/platform/memoryinfo.h"
+
+TEST(MemoryInfoTest, CanGetPeakResidentSetSize)
+{
+    const size_t peakSize = MemoryInfo::GetPeakResidentSetSize();
+    EXPECT_GT(peakSize, 0);
+
+    // Touching more memory than the process has ever used raises the peak
+    std::vector<char> buffer(peakSize + (64 << 20), 1);
+    EXPECT_GT(MemoryInfo::GetPeakResidentSetSize(), peakSize);
+    EXPECT_EQ(buffer.back(), 1);
+}
+